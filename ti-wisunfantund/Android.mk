@@ -78,6 +78,11 @@ $(LOCAL_PATH)/src/version.c: $(LOCAL_PATH)/src/version.c.in
 	sed 's/SOURCE_VERSION/"$(LOCAL_PRIVATE_SOURCE_VERSION)"/' < $< > $@
 
 NCP_SPINEL_SRC_FILES := $(wildcard $(LOCAL_PATH)/src/ncp-spinel/*.cpp) $(wildcard $(LOCAL_PATH)/src/ncp-spinel/*.c)
+NCP_SPINEL_SRC_FILES := $(filter-out \
+	$(LOCAL_PATH)/src/ncp-spinel/spinel-ncp-sim.c \
+	$(LOCAL_PATH)/src/ncp-spinel/spinel_frame_test.cpp \
+	$(LOCAL_PATH)/src/ncp-spinel/spinel_frame_bench.cpp \
+	,$(NCP_SPINEL_SRC_FILES))
 
 LOCAL_SRC_FILES := \
 	src/ipc-dbus/DBUSIPCServer.cpp \
@@ -116,8 +121,13 @@ LOCAL_SRC_FILES := \
 	src/util/SuperSocket.cpp \
 	src/util/EventHandler.cpp \
 	src/util/TunnelIPv6Interface.cpp \
+	src/util/NetlinkRouteManager.cpp \
 	src/util/ValueMap.cpp \
 	src/util/Timer.cpp \
+	src/util/FileExporter.cpp \
+	src/util/PropertyChangeQueue.cpp \
+	src/util/FrameTrace.cpp \
+	src/util/hdlc.c \
 	src/util/sec-random.c \
 	src/missing/strlcpy/strlcpy.c \
 	$(NCP_SPINEL_SRC_FILES:$(LOCAL_PATH)/%=%) \
@@ -141,6 +151,7 @@ LOCAL_C_INCLUDES := \
 	$(LOCAL_PATH)/src/wpantund \
 	$(LOCAL_PATH)/third_party/fgetln \
 	$(LOCAL_PATH)/third_party/assert-macros \
+	$(LOCAL_PATH)/third_party/openthread/src/ncp \
 	$(NULL)
 
 LOCAL_DEFAULT_VERSION := $(shell cat $(LOCAL_PATH)/.default-version)
@@ -184,6 +195,7 @@ LOCAL_SRC_FILES := \
 	src/util/string-utils.c \
 	src/wpantund/wpan-error.c \
 	$(WPANCTL_SRC_FILES:$(LOCAL_PATH)/%=%) \
+	third_party/openthread/src/ncp/spinel.c \
 	$(NULL)
 
 LOCAL_SHARED_LIBRARIES := libdbus
@@ -0,0 +1,208 @@
+#!/bin/bash
+#
+# Copyright (c) 2026 Texas Instruments
+# All rights reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#    http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+#
+# Runs wfantund against `spinel-ncp-sim` for a set of scenarios and
+# reports, for each, the end-to-end latency and throughput of traffic
+# from the simulated nodes to the host and back, how long it takes to
+# read the connected devices list, and the CPU used by wfantund and by
+# the simulator. Needs root (for the TUN interface) and a system bus.
+#
+
+set -e
+
+BUILD_DIR=.
+DURATION=20
+INTERFACE=wfansim0
+SCENARIOS=()
+
+usage ()
+{
+	echo "usage: $0 [options]"
+	echo
+	echo "-B, --build-dir <dir>     wfantund build tree (default .)"
+	echo "-d, --duration <seconds>  Time measured per scenario (default $DURATION)"
+	echo "-i, --interface <name>    TUN interface to use (default $INTERFACE)"
+	echo "-s, --scenario <name:options>"
+	echo "                          Run this scenario, passing the options to"
+	echo "                          spinel-ncp-sim. May be repeated. Replaces the"
+	echo "                          default scenarios."
+}
+
+while [ $# -gt 0 ]
+do
+	case "$1" in
+	-B|--build-dir) BUILD_DIR="$2"; shift ;;
+	-d|--duration) DURATION="$2"; shift ;;
+	-i|--interface) INTERFACE="$2"; shift ;;
+	-s|--scenario) SCENARIOS+=("$2"); shift ;;
+	-h|--help) usage; exit 0 ;;
+	*) usage >&2; exit 1 ;;
+	esac
+	shift
+done
+
+if [ ${#SCENARIOS[@]} -eq 0 ]
+then
+	SCENARIOS=(
+		"idle-50:--nodes 50"
+		"echo-50:--nodes 50 --rate 50"
+		"echo-500-115k:--nodes 500 --rate 100 --baud 115200"
+		"echo-500-921k:--nodes 500 --rate 100 --baud 921600"
+		"churn-500:--nodes 500 --churn 5 --rejoin 5 --rate 20 --baud 460800"
+		"deep-1000:--nodes 1000 --depth 12 --churn 1 --rate 50 --baud 921600"
+	)
+fi
+
+WFANTUND="$BUILD_DIR/src/wpantund/wfantund"
+NCP_PLUGIN="$BUILD_DIR/src/ncp-spinel/.libs/ncp-spinel.so"
+NCP_SIM="$BUILD_DIR/src/ncp-spinel/spinel-ncp-sim"
+
+for f in "$WFANTUND" "$NCP_PLUGIN" "$NCP_SIM"
+do
+	if [ ! -x "$f" ] && [ ! -f "$f" ]
+	then
+		echo "$0: $f not found, point --build-dir at a built tree" >&2
+		exit 1
+	fi
+done
+
+WORK_DIR=$(mktemp -d)
+CLK_TCK=$(getconf CLK_TCK)
+WFANTUND_PID=
+
+cleanup ()
+{
+	if [ -n "$WFANTUND_PID" ]
+	then
+		kill "$WFANTUND_PID" 2> /dev/null || true
+		wait "$WFANTUND_PID" 2> /dev/null || true
+	fi
+	rm -rf "$WORK_DIR"
+}
+trap cleanup EXIT
+
+prop_get ()
+{
+	dbus-send --system --print-reply --reply-timeout=10000 \
+		--dest=com.nestlabs.WPANTunnelDriver \
+		"/com/nestlabs/WPANTunnelDriver/$INTERFACE" \
+		com.nestlabs.WPANTunnelDriver.PropGet "string:$1" 2> /dev/null
+}
+
+# utime + stime of a process, in clock ticks.
+cpu_ticks ()
+{
+	awk '{ sub(/.*\) /, ""); print $12 + $13 }' "/proc/$1/stat"
+}
+
+now_ms ()
+{
+	echo $(( $(date +%s%N) / 1000000 ))
+}
+
+stat_value ()
+{
+	sed -n "s/^$1=//p" "$2"
+}
+
+printf "%-16s %6s %7s %9s %9s %8s %8s %8s %7s %9s %8s %8s\n" \
+	scenario nodes baud "to-host/s" "replies/s" "rtt-p50" "rtt-p99" "rtt-max" drops "getcd-ms" "wfantund" "sim"
+
+for scenario in "${SCENARIOS[@]}"
+do
+	name="${scenario%%:*}"
+	options="${scenario#*:}"
+	stats="$WORK_DIR/$name.stats"
+
+	"$WFANTUND" \
+		-s "system:$NCP_SIM $options --stats $stats" \
+		-o Config:TUN:InterfaceName "$INTERFACE" \
+		-o Config:NCP:DriverName "$NCP_PLUGIN" \
+		> "$WORK_DIR/$name.log" 2>&1 &
+	WFANTUND_PID=$!
+
+	# Wait for the simulated network to come up.
+	for i in $(seq 50)
+	do
+		if prop_get NCP:State | grep -q associated
+		then
+			break
+		fi
+		sleep 0.2
+	done
+
+	sim_pid=$(pgrep -n -f "spinel-ncp-sim .*--stats $stats" || true)
+
+	if [ -z "$sim_pid" ] || ! prop_get NCP:State | grep -q associated
+	then
+		echo "$name: wfantund did not come up, see $WORK_DIR/$name.log" >&2
+		trap - EXIT
+		kill "$WFANTUND_PID" 2> /dev/null || true
+		exit 1
+	fi
+
+	# Let initialization traffic settle, then start counting.
+	sleep 1
+	kill -USR2 "$sim_pid"
+	wfantund_start=$(cpu_ticks "$WFANTUND_PID")
+	sim_start=$(cpu_ticks "$sim_pid")
+	start_ms=$(now_ms)
+
+	getcd_total=0
+	getcd_count=0
+	end_ms=$(( start_ms + DURATION * 1000 ))
+
+	while [ "$(now_ms)" -lt "$end_ms" ]
+	do
+		t0=$(now_ms)
+		prop_get ConnectedDevices:All:Binary > /dev/null || true
+		getcd_total=$(( getcd_total + $(now_ms) - t0 ))
+		getcd_count=$(( getcd_count + 1 ))
+		sleep 1
+	done
+
+	elapsed_ms=$(( $(now_ms) - start_ms ))
+	wfantund_cpu=$(( ($(cpu_ticks "$WFANTUND_PID") - wfantund_start) * 1000000 / CLK_TCK / elapsed_ms ))
+	sim_cpu=$(( ($(cpu_ticks "$sim_pid") - sim_start) * 1000000 / CLK_TCK / elapsed_ms ))
+
+	kill "$WFANTUND_PID"
+	wait "$WFANTUND_PID" 2> /dev/null || true
+	WFANTUND_PID=
+
+	# The simulator writes its statistics once the pty goes away.
+	for i in $(seq 50)
+	do
+		[ -s "$stats" ] && grep -q '^cpu_sys_s=' "$stats" && break
+		sleep 0.1
+	done
+
+	elapsed_s=$(stat_value elapsed_s "$stats")
+
+	printf "%-16s %6s %7s %9.1f %9.1f %8s %8s %8s %7s %9d %5d.%d%% %5d.%d%%\n" \
+		"$name" \
+		"$(stat_value nodes "$stats")" \
+		"$(stat_value baud "$stats")" \
+		"$(echo "$(stat_value net_to_host "$stats") $elapsed_s" | awk '{ print $1 / $2 }')" \
+		"$(echo "$(stat_value echo_replies "$stats") $elapsed_s" | awk '{ print $1 / $2 }')" \
+		"$(stat_value rtt_p50_ms "$stats")" \
+		"$(stat_value rtt_p99_ms "$stats")" \
+		"$(stat_value rtt_max_ms "$stats")" \
+		"$(stat_value net_to_host_dropped "$stats")" \
+		"$(( getcd_count ? getcd_total / getcd_count : 0 ))" \
+		"$(( wfantund_cpu / 10 ))" "$(( wfantund_cpu % 10 ))" \
+		"$(( sim_cpu / 10 ))" "$(( sim_cpu % 10 ))"
+done
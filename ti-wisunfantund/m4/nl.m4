@@ -141,6 +141,38 @@ AC_SUBST(FUZZ_LDFLAGS)
 AC_SUBST(FUZZ_LIBS)
 ])
 
+AC_DEFUN([NL_CXX11_SOURCE],[AC_LANG_SOURCE([[#include <atomic>
+template <typename... T> struct count;
+template <> struct count<> { static const int value = 0; };
+template <typename H, typename... T> struct count<H, T...> { static const int value = 1 + count<T...>::value; };
+static_assert(count<char, int, long>::value == 3, "variadic templates");
+std::atomic<unsigned int> counter(0);
+int main(void) { return static_cast<int>(counter.fetch_add(1u, std::memory_order_relaxed)); }]])])
+
+dnl Makes sure the C++ compiler takes C++11 (variadic templates and
+dnl <atomic>), adding -std=c++11 to CXXFLAGS if that is what it needs.
+AC_DEFUN([NL_CHECK_CXX11], [
+	AC_LANG_PUSH([C++])
+
+	AC_MSG_CHECKING([whether $CXX supports C++11])
+	AC_COMPILE_IFELSE([NL_CXX11_SOURCE], [
+		AC_MSG_RESULT([yes])
+	], [
+		nl_check_cxx11_CXXFLAGS="${CXXFLAGS}"
+		CXXFLAGS="${CXXFLAGS} -std=c++11"
+		AC_COMPILE_IFELSE([NL_CXX11_SOURCE], [
+			AC_MSG_RESULT([with -std=c++11])
+		], [
+			AC_MSG_RESULT([no])
+			CXXFLAGS="${nl_check_cxx11_CXXFLAGS}"
+			$1
+		])
+		unset nl_check_cxx11_CXXFLAGS
+	])
+
+	AC_LANG_POP([C++])
+])
+
 AC_DEFUN([NL_CHECK_BOOST_SIGNALS2], [
 	AC_LANG_PUSH([C++])
 
@@ -43,7 +43,9 @@
 #include "DBUSHelpers.h"
 #include <errno.h>
 #include <algorithm>
+#include <vector>
 #include "any-to.h"
+#include "nlpt.h"
 #include "wpan-dbus.h"
 
 using namespace DBUSHelpers;
@@ -109,6 +111,27 @@ DBUSIPCServer::DBUSIPCServer():
 		&DBUSIPCServer::dbus_message_handler,
 	};
 
+	if (!dbus_connection_set_watch_functions(
+			mConnection,
+			&DBUSIPCServer::add_watch,
+			&DBUSIPCServer::remove_watch,
+			&DBUSIPCServer::toggle_watch,
+			(void*)this,
+			NULL
+		)
+		|| !dbus_connection_set_timeout_functions(
+			mConnection,
+			&DBUSIPCServer::add_timeout,
+			&DBUSIPCServer::remove_timeout,
+			&DBUSIPCServer::toggle_timeout,
+			(void*)this,
+			NULL
+		)
+	) {
+		dbus_set_error_const(&error, DBUS_ERROR_NO_MEMORY, "Unable to set DBus watch and timeout functions");
+		goto bail;
+	}
+
 	require(
 		dbus_connection_register_object_path(
 			mConnection,
@@ -144,75 +167,195 @@ DBUSIPCServer::~DBUSIPCServer()
 		gDBusObjectManagerMatchString,
 		NULL
 	);
+	dbus_connection_set_watch_functions(mConnection, NULL, NULL, NULL, NULL, NULL);
+	dbus_connection_set_timeout_functions(mConnection, NULL, NULL, NULL, NULL, NULL);
 	dbus_connection_unref(mConnection);
 }
 
+dbus_bool_t
+DBUSIPCServer::add_watch(DBusWatch *watch, void *user_data)
+{
+	static_cast<DBUSIPCServer*>(user_data)->mWatches.insert(watch);
+	return TRUE;
+}
+
+void
+DBUSIPCServer::remove_watch(DBusWatch *watch, void *user_data)
+{
+	static_cast<DBUSIPCServer*>(user_data)->mWatches.erase(watch);
+}
+
+void
+DBUSIPCServer::toggle_watch(DBusWatch *watch, void *user_data)
+{
+	// Watches are checked for being enabled whenever they are used.
+}
+
+dbus_bool_t
+DBUSIPCServer::add_timeout(DBusTimeout *timeout, void *user_data)
+{
+	static_cast<DBUSIPCServer*>(user_data)->mTimeouts[timeout] = time_ms() + dbus_timeout_get_interval(timeout);
+	return TRUE;
+}
+
+void
+DBUSIPCServer::remove_timeout(DBusTimeout *timeout, void *user_data)
+{
+	static_cast<DBUSIPCServer*>(user_data)->mTimeouts.erase(timeout);
+}
+
+void
+DBUSIPCServer::toggle_timeout(DBusTimeout *timeout, void *user_data)
+{
+	// The interval starts over whenever a timeout is turned back on.
+	static_cast<DBUSIPCServer*>(user_data)->mTimeouts[timeout] = time_ms() + dbus_timeout_get_interval(timeout);
+}
+
 cms_t
 DBUSIPCServer::get_ms_to_next_event()
 {
+	std::map<DBusTimeout*, cms_t>::const_iterator iter;
 	cms_t ret = CMS_DISTANT_FUTURE;
 
-	/* We could set up some sort of complicated mechanism
-	 * using the dbus_timer objects to actually calculate this
-	 * correctly, however we aren't really using any of the
-	 * timer-dependent stuff in DBus. As such, the following
-	 * seems to suffice. If we want wpantund to do things
-	 * like handle response timeouts in a timely manner then
-	 * we will need to go ahead and fully implement such a
-	 * mechanism. */
-
 	if (dbus_connection_get_dispatch_status(mConnection) == DBUS_DISPATCH_DATA_REMAINS) {
 		ret = 0;
 	}
 
-	if (dbus_connection_has_messages_to_send(mConnection)) {
-		ret = 0;
+	for (iter = mTimeouts.begin(); iter != mTimeouts.end(); ++iter) {
+		if (dbus_timeout_get_enabled(iter->first)) {
+			ret = std::min(ret, std::max(iter->second - time_ms(), 0));
+		}
 	}
 
+	// Batched property change signals which are waiting to go out.
+	ret = std::min(ret, mAPI.get_ms_to_next_event());
+
 	return ret;
 }
 
+void
+DBUSIPCServer::handle_watches(void)
+{
+	// Handling a watch may add or remove others, so work from a copy
+	// and skip those which have gone away in the meantime.
+	std::vector<DBusWatch*> watches(mWatches.begin(), mWatches.end());
+	std::vector<DBusWatch*>::iterator iter;
+
+	for (iter = watches.begin(); iter != watches.end(); ++iter) {
+		DBusWatch* watch = *iter;
+		unsigned int watch_flags;
+		unsigned int flags = 0;
+		int fd;
+
+		if (!mWatches.count(watch) || !dbus_watch_get_enabled(watch)) {
+			continue;
+		}
+
+		watch_flags = dbus_watch_get_flags(watch);
+		fd = dbus_watch_get_unix_fd(watch);
+
+		// Use what the main loop's select() already found out about
+		// this descriptor rather than asking the kernel again.
+		if ((watch_flags & DBUS_WATCH_READABLE) && nlpt_hook_check_read_fd_source(NULL, fd)) {
+			flags |= DBUS_WATCH_READABLE;
+		}
+
+		if ((watch_flags & DBUS_WATCH_WRITABLE) && nlpt_hook_check_write_fd_source(NULL, fd)) {
+			flags |= DBUS_WATCH_WRITABLE;
+		}
+
+		if (flags != 0) {
+			dbus_watch_handle(watch, flags);
+		}
+	}
+}
+
+void
+DBUSIPCServer::handle_timeouts(void)
+{
+	std::vector<DBusTimeout*> timeouts;
+	std::vector<DBusTimeout*>::iterator iter;
+	std::map<DBusTimeout*, cms_t>::iterator timeout_iter;
+	cms_t now = time_ms();
+
+	for (timeout_iter = mTimeouts.begin(); timeout_iter != mTimeouts.end(); ++timeout_iter) {
+		if ((timeout_iter->second - now <= 0) && dbus_timeout_get_enabled(timeout_iter->first)) {
+			timeouts.push_back(timeout_iter->first);
+		}
+	}
+
+	for (iter = timeouts.begin(); iter != timeouts.end(); ++iter) {
+		timeout_iter = mTimeouts.find(*iter);
+
+		if (timeout_iter != mTimeouts.end()) {
+			// Timeouts keep firing every interval until removed.
+			timeout_iter->second = now + dbus_timeout_get_interval(*iter);
+			dbus_timeout_handle(*iter);
+		}
+	}
+}
+
 void
 DBUSIPCServer::process(void)
 {
-	dbus_connection_read_write_dispatch(mConnection, 0);
+	const cms_t start = time_ms();
+	int count = 0;
+
+	handle_watches();
+	handle_timeouts();
+
+	// Dispatch everything which has been read in one go, rather than a
+	// single message per run through the main loop, within a budget.
+	while (dbus_connection_get_dispatch_status(mConnection) == DBUS_DISPATCH_DATA_REMAINS) {
+		if ((count >= DBUS_DISPATCH_MESSAGE_BUDGET) || (CMS_SINCE(start) >= DBUS_DISPATCH_TIME_BUDGET)) {
+			break;
+		}
+
+		dbus_connection_dispatch(mConnection);
+		count++;
+	}
+
+	mAPI.process();
 }
 
 int
 DBUSIPCServer::update_fd_set(fd_set *read_fd_set, fd_set *write_fd_set, fd_set *error_fd_set, int *max_fd, cms_t *timeout)
 {
-	int ret = -1;
-	int unix_fd = -1;
+	std::set<DBusWatch*>::const_iterator iter;
 
-	require(dbus_connection_get_unix_fd(mConnection, &unix_fd), bail);
+	for (iter = mWatches.begin(); iter != mWatches.end(); ++iter) {
+		unsigned int flags = dbus_watch_get_flags(*iter);
+		int fd = dbus_watch_get_unix_fd(*iter);
 
-	if (read_fd_set != NULL) {
-		FD_SET(unix_fd, read_fd_set);
-	}
+		if ((fd < 0) || !dbus_watch_get_enabled(*iter)) {
+			continue;
+		}
 
-	if (error_fd_set != NULL) {
-		FD_SET(unix_fd, error_fd_set);
-	}
+		if ((read_fd_set != NULL) && (flags & DBUS_WATCH_READABLE)) {
+			FD_SET(fd, read_fd_set);
+		}
 
-	if ((write_fd_set != NULL) && dbus_connection_has_messages_to_send(mConnection)) {
-		FD_SET(unix_fd, write_fd_set);
-	}
+		if ((write_fd_set != NULL) && (flags & DBUS_WATCH_WRITABLE)) {
+			FD_SET(fd, write_fd_set);
+		}
 
-	if ((max_fd != NULL)) {
-		*max_fd = std::max(*max_fd, unix_fd);
+		if (error_fd_set != NULL) {
+			FD_SET(fd, error_fd_set);
+		}
+
+		if (max_fd != NULL) {
+			*max_fd = std::max(*max_fd, fd);
+		}
 	}
 
 	if (timeout != NULL) {
 		*timeout = std::min(*timeout, get_ms_to_next_event());
 	}
 
-	ret = 0;
-bail:
-	return ret;
+	return 0;
 }
 
 
-
 void
 DBUSIPCServer::interface_added(const std::string& interface_name)
 {
@@ -25,12 +25,18 @@
 
 #include "IPCServer.h"
 #include <map>
+#include <set>
 #include <dbus/dbus.h>
 #include <boost/signals2/signal.hpp>
 #include <boost/bind.hpp>
 
 #include "DBusIPCAPI.h"
 
+// Limits on how many inbound DBus messages are dispatched per run
+// through the main loop, so a burst of requests cannot starve the NCP.
+#define DBUS_DISPATCH_MESSAGE_BUDGET            64 // messages per main loop iteration
+#define DBUS_DISPATCH_TIME_BUDGET               10 // milliseconds per main loop iteration
+
 namespace nl {
 namespace wpantund {
 
@@ -60,8 +66,22 @@ private:
 	void interface_added(const std::string& interface_name);
 	void interface_removed(const std::string& interface_name);
 
+	// libdbus tells us which file descriptors and timers it needs
+	// through these, so we can fold them into the main loop.
+	static dbus_bool_t add_watch(DBusWatch *watch, void *user_data);
+	static void remove_watch(DBusWatch *watch, void *user_data);
+	static void toggle_watch(DBusWatch *watch, void *user_data);
+	static dbus_bool_t add_timeout(DBusTimeout *timeout, void *user_data);
+	static void remove_timeout(DBusTimeout *timeout, void *user_data);
+	static void toggle_timeout(DBusTimeout *timeout, void *user_data);
+
+	void handle_watches(void);
+	void handle_timeouts(void);
+
 private:
 	DBusConnection *mConnection;
+	std::set<DBusWatch*> mWatches;
+	std::map<DBusTimeout*, cms_t> mTimeouts; // When each timeout fires next
 	std::map<std::string, NCPControlInterface*> mInterfaceMap;
 	std::map<std::string, std::string> mExternalInterfaceMap;
 	DBusIPCAPI mAPI;
@@ -46,20 +46,34 @@
 
 #include "DBUSHelpers.h"
 #include "any-to.h"
+#include "string-utils.h"
 
 using namespace DBUSHelpers;
 using namespace nl;
 using namespace nl::wpantund;
 
+static const char gNameOwnerChangedMatchString[] =
+	"type='signal'"
+	",sender='" DBUS_SERVICE_DBUS "'"
+	",interface='" DBUS_INTERFACE_DBUS "'"
+	",member='NameOwnerChanged'"
+	;
+
 DBusIPCAPI::DBusIPCAPI(DBusConnection *connection)
 	:mConnection(connection)
 {
 	dbus_connection_ref(mConnection);
 	init_callback_tables();
+
+	// Lets us forget the PropertiesSubscribe clients which go away.
+	dbus_bus_add_match(mConnection, gNameOwnerChangedMatchString, NULL);
+	dbus_connection_add_filter(mConnection, &DBusIPCAPI::dbus_name_owner_changed_filter, (void*)this, NULL);
 }
 
 DBusIPCAPI::~DBusIPCAPI()
 {
+	dbus_connection_remove_filter(mConnection, &DBusIPCAPI::dbus_name_owner_changed_filter, (void*)this);
+	dbus_bus_remove_match(mConnection, gNameOwnerChangedMatchString, NULL);
 	dbus_connection_unref(mConnection);
 }
 
@@ -102,6 +116,10 @@ DBusIPCAPI::init_callback_tables()
 
 	INTERFACE_CALLBACK_CONNECT(WPANTUND_IF_CMD_PROP_GET, interface_prop_get_handler);
 	INTERFACE_CALLBACK_CONNECT(WPANTUND_IF_CMD_PROP_SET, interface_prop_set_handler);
+	INTERFACE_CALLBACK_CONNECT(WPANTUND_IF_CMD_PROP_GET_MANY, interface_prop_get_many_handler);
+	INTERFACE_CALLBACK_CONNECT(WPANTUND_IF_CMD_PROP_SET_MANY, interface_prop_set_many_handler);
+	INTERFACE_CALLBACK_CONNECT(WPANTUND_IF_CMD_PROPS_SUBSCRIBE, interface_props_subscribe_handler);
+	INTERFACE_CALLBACK_CONNECT(WPANTUND_IF_CMD_PROPS_UNSUBSCRIBE, interface_props_unsubscribe_handler);
 	INTERFACE_CALLBACK_CONNECT(WPANTUND_IF_CMD_PROP_INSERT, interface_prop_insert_handler);
 	INTERFACE_CALLBACK_CONNECT(WPANTUND_IF_CMD_PROP_REMOVE, interface_prop_remove_handler);
 
@@ -166,6 +184,26 @@ DBusIPCAPI::add_interface(NCPControlInterface* interface)
 	            (void*)cb_data
 	            ), bail);
 
+	{
+		PropertyChangeStream& stream = mPropertyChangeStreams[interface];
+		boost::any value;
+
+		value = interface->property_get_value(kWPANTUNDProperty_ConfigDaemonPropertyChangeInterval);
+		if (!value.empty()) {
+			stream.mBroadcast.set_interval(any_to_int(value));
+		}
+
+		value = interface->property_get_value(kWPANTUNDProperty_ConfigDaemonPropertyChangeBatchSize);
+		if (!value.empty()) {
+			stream.mBroadcast.set_batch_size(any_to_int(value));
+		}
+
+		value = interface->property_get_value(kWPANTUNDProperty_ConfigDaemonPropChangedInterval);
+		if (!value.empty()) {
+			stream.mPropChanged.set_interval(any_to_int(value));
+		}
+	}
+
 	interface->mOnPropertyChanged.connect(
 	    boost::bind(
 			&DBusIPCAPI::property_changed,
@@ -203,6 +241,16 @@ DBusIPCAPI::add_interface(NCPControlInterface* interface)
 		)
 	);
 
+	interface->mOnTopologyChange.connect(
+		boost::bind(
+			&DBusIPCAPI::received_topology_change,
+			this,
+			interface,
+			_1,
+			_2
+		)
+	);
+
 bail:
 	return 0;
 }
@@ -369,6 +417,42 @@ DBusIPCAPI::received_network_time_update(
 	dbus_message_unref(signal);
 }
 
+void
+DBusIPCAPI::received_topology_change(
+	NCPControlInterface* interface, NCPControlInterface::TopologyChange change, const ValueMap &delta)
+{
+	DBusMessageIter iter;
+	DBusMessage* signal;
+	const char* name;
+
+	switch (change) {
+	case NCPControlInterface::TOPOLOGY_NODE_JOINED:
+		name = WPANTUND_IF_SIGNAL_NODE_JOINED;
+		break;
+	case NCPControlInterface::TOPOLOGY_NODE_LEFT:
+		name = WPANTUND_IF_SIGNAL_NODE_LEFT;
+		break;
+	default:
+		name = WPANTUND_IF_SIGNAL_PARENT_CHANGED;
+		break;
+	}
+
+	signal = dbus_message_new_signal(
+		path_for_iface(interface).c_str(),
+		WPAN_TUNNEL_DBUS_INTERFACE,
+		name
+	);
+
+	if (signal) {
+		dbus_message_iter_init_append(signal, &iter);
+
+		append_any_to_dbus_iter(&iter, delta);
+
+		dbus_connection_send(mConnection, signal, NULL);
+		dbus_message_unref(signal);
+	}
+}
+
 static void
 ipc_append_energy_scan_result_dict(
     DBusMessageIter *iter, const EnergyScanResultEntry& energy_scan_result
@@ -416,8 +500,140 @@ DBusIPCAPI::received_energy_scan_result(NCPControlInterface* interface,
 	dbus_message_unref(signal);
 }
 
+// Properties which can change many times a second, such as counters
+// and link quality readings. Only the latest value of these matters,
+// so their PropChanged signals may be held back and merged.
+static bool
+is_noisy_property(const std::string& key)
+{
+	static const char* const kNoisyPrefixes[] = {
+		"NCP:Counter:",
+		kWPANTUNDProperty_NCPRSSI,
+		"LinkMetrics:",
+		kWPANTUNDProperty_ThreadNeighborTable,
+		kWPANTUNDProperty_ThreadChildTable,
+		kWPANTUNDProperty_JamDetectionStatus,
+		kWPANTUNDProperty_NetworkTopologyGeneration,
+	};
+
+	for (size_t i = 0; i < sizeof(kNoisyPrefixes) / sizeof(kNoisyPrefixes[0]); i++) {
+		if (strcasehasprefix(key.c_str(), kNoisyPrefixes[i])) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
 void
 DBusIPCAPI::property_changed(NCPControlInterface* interface,const std::string& key, const boost::any& value)
+{
+	PropertyChangeStream& stream = mPropertyChangeStreams[interface];
+	std::map<std::string, PropertyChangeQueue>::iterator iter;
+	bool is_due;
+
+	if (key == kWPANTUNDProperty_ConfigDaemonPropertyChangeInterval) {
+		stream.mBroadcast.set_interval(any_to_int(value));
+	} else if (key == kWPANTUNDProperty_ConfigDaemonPropertyChangeBatchSize) {
+		stream.mBroadcast.set_batch_size(any_to_int(value));
+	} else if (key == kWPANTUNDProperty_ConfigDaemonPropChangedInterval) {
+		stream.mPropChanged.set_interval(any_to_int(value));
+	}
+
+	// Turning the value into a string is not free, and some properties
+	// change many times a second.
+	if (setlogmask(0) & LOG_MASK(LOG_DEBUG)) {
+		syslog(LOG_DEBUG, "DBusAPI:PropChanged: %s - value: %s", key.c_str(), any_to_string(value).c_str());
+	}
+
+	// Clients of the per property signal rely on seeing every value,
+	// in order (NCP:State going through "associating" and back, say).
+	// Noisy properties are the exception: at most one PropChanged per
+	// interval, carrying the latest value.
+	if ((stream.mPropChanged.get_interval() > 0) && is_noisy_property(key)) {
+		is_due = stream.mPropChanged.queue(key, value);
+	} else {
+		send_prop_changed(interface, key, value);
+		is_due = false;
+	}
+
+	is_due |= stream.mBroadcast.queue(key, value);
+
+	for (iter = stream.mSubscribers.begin(); iter != stream.mSubscribers.end(); ++iter) {
+		is_due |= iter->second.queue(key, value);
+	}
+
+	if (is_due) {
+		flush_property_changes(interface, stream);
+	}
+}
+
+void
+DBusIPCAPI::flush_property_changes(NCPControlInterface* interface, PropertyChangeStream& stream)
+{
+	std::map<std::string, PropertyChangeQueue>::iterator iter;
+	ValueMap values;
+
+	if (stream.mPropChanged.is_due()) {
+		ValueMap::const_iterator value_iter;
+
+		stream.mPropChanged.flush(values);
+
+		for (value_iter = values.begin(); value_iter != values.end(); ++value_iter) {
+			send_prop_changed(interface, value_iter->first, value_iter->second);
+		}
+	}
+
+	if (stream.mBroadcast.is_due()) {
+		stream.mBroadcast.flush(values);
+
+		if (!send_properties_changed(interface, values, NULL)) {
+			stream.mBroadcast.did_fail_to_send(static_cast<int>(values.size()));
+		}
+	}
+
+	for (iter = stream.mSubscribers.begin(); iter != stream.mSubscribers.end(); ++iter) {
+		if (iter->second.is_due()) {
+			iter->second.flush(values);
+
+			if (!send_properties_changed(interface, values, iter->first.c_str())) {
+				iter->second.did_fail_to_send(static_cast<int>(values.size()));
+			}
+		}
+	}
+}
+
+void
+DBusIPCAPI::process(void)
+{
+	std::map<NCPControlInterface*, PropertyChangeStream>::iterator iter;
+
+	for (iter = mPropertyChangeStreams.begin(); iter != mPropertyChangeStreams.end(); ++iter) {
+		flush_property_changes(iter->first, iter->second);
+	}
+}
+
+cms_t
+DBusIPCAPI::get_ms_to_next_event(void)
+{
+	std::map<NCPControlInterface*, PropertyChangeStream>::const_iterator iter;
+	std::map<std::string, PropertyChangeQueue>::const_iterator sub_iter;
+	cms_t ret = CMS_DISTANT_FUTURE;
+
+	for (iter = mPropertyChangeStreams.begin(); iter != mPropertyChangeStreams.end(); ++iter) {
+		ret = std::min(ret, iter->second.mBroadcast.get_ms_to_flush());
+		ret = std::min(ret, iter->second.mPropChanged.get_ms_to_flush());
+
+		for (sub_iter = iter->second.mSubscribers.begin(); sub_iter != iter->second.mSubscribers.end(); ++sub_iter) {
+			ret = std::min(ret, sub_iter->second.get_ms_to_flush());
+		}
+	}
+
+	return ret;
+}
+
+void
+DBusIPCAPI::send_prop_changed(NCPControlInterface* interface, const std::string& key, const boost::any& value)
 {
 	DBusMessageIter iter;
 	DBusMessage* signal;
@@ -441,8 +657,6 @@ DBusIPCAPI::property_changed(NCPControlInterface* interface,const std::string& k
 
 	path = path_for_iface(interface) + "/Property/" + key_as_path;
 
-	syslog(LOG_DEBUG, "DBusAPI:PropChanged: %s - value: %s", path.c_str(), any_to_string(value).c_str());
-
 	signal = dbus_message_new_signal(
 		path.c_str(),
 		WPAN_TUNNEL_DBUS_INTERFACE,
@@ -460,6 +674,116 @@ DBusIPCAPI::property_changed(NCPControlInterface* interface,const std::string& k
 	}
 }
 
+bool
+DBusIPCAPI::send_properties_changed(NCPControlInterface* interface, const ValueMap& values, const char* destination)
+{
+	DBusMessageIter iter;
+	DBusMessage* signal;
+	bool ret = false;
+
+	signal = dbus_message_new_signal(
+		path_for_iface(interface).c_str(),
+		WPAN_TUNNEL_DBUS_INTERFACE,
+		WPANTUND_IF_SIGNAL_PROPS_CHANGED
+    );
+
+	require(signal != NULL, bail);
+
+	if (destination != NULL) {
+		require(dbus_message_set_destination(signal, destination), bail);
+	}
+
+	dbus_message_iter_init_append(signal, &iter);
+	append_any_to_dbus_iter(&iter, values);
+
+	ret = dbus_connection_send(mConnection, signal, NULL);
+
+bail:
+	if (signal) {
+		dbus_message_unref(signal);
+	}
+
+	return ret;
+}
+
+DBusHandlerResult
+DBusIPCAPI::interface_props_subscribe_handler(
+	NCPControlInterface* interface,
+	DBusMessage *        message
+) {
+	PropertyChangeStream& stream = mPropertyChangeStreams[interface];
+	const char* sender = dbus_message_get_sender(message);
+	uint32_t interval = 0;
+	int ret = kWPANTUNDStatus_InvalidArgument;
+
+	dbus_message_get_args(
+		message, NULL,
+		DBUS_TYPE_UINT32, &interval,
+		DBUS_TYPE_INVALID
+	);
+
+	if ((sender != NULL) && (interval <= INT32_MAX)) {
+		// Unlike the broadcast stream, a subscriber is never sent more
+		// than one signal per interval, however many properties changed.
+		stream.mSubscribers[sender].set_interval(static_cast<cms_t>(interval));
+		ret = kWPANTUNDStatus_Ok;
+	}
+
+	dbus_message_ref(message);
+	CallbackWithStatus_Helper(ret, message);
+
+	return DBUS_HANDLER_RESULT_HANDLED;
+}
+
+DBusHandlerResult
+DBusIPCAPI::interface_props_unsubscribe_handler(
+	NCPControlInterface* interface,
+	DBusMessage *        message
+) {
+	PropertyChangeStream& stream = mPropertyChangeStreams[interface];
+	const char* sender = dbus_message_get_sender(message);
+
+	if (sender != NULL) {
+		stream.mSubscribers.erase(sender);
+	}
+
+	dbus_message_ref(message);
+	CallbackWithStatus_Helper(kWPANTUNDStatus_Ok, message);
+
+	return DBUS_HANDLER_RESULT_HANDLED;
+}
+
+DBusHandlerResult
+DBusIPCAPI::dbus_name_owner_changed_filter(
+    DBusConnection *connection,
+    DBusMessage *   message,
+    void *          user_data
+) {
+	DBusIPCAPI* self = static_cast<DBusIPCAPI*>(user_data);
+	std::map<NCPControlInterface*, PropertyChangeStream>::iterator iter;
+	const char* name = NULL;
+	const char* old_owner = NULL;
+	const char* new_owner = NULL;
+
+	if (dbus_message_is_signal(message, DBUS_INTERFACE_DBUS, "NameOwnerChanged")
+		&& dbus_message_get_args(
+			message, NULL,
+			DBUS_TYPE_STRING, &name,
+			DBUS_TYPE_STRING, &old_owner,
+			DBUS_TYPE_STRING, &new_owner,
+			DBUS_TYPE_INVALID
+		)
+		&& (new_owner[0] == 0)
+	) {
+		for (iter = self->mPropertyChangeStreams.begin(); iter != self->mPropertyChangeStreams.end(); ++iter) {
+			iter->second.mSubscribers.erase(name);
+		}
+	}
+
+	// Other filters may want this signal too.
+	return DBUS_HANDLER_RESULT_NOT_YET_HANDLED;
+}
+
 void
 DBusIPCAPI::status_response_helper(
     int ret, NCPControlInterface* interface, DBusMessage *message
@@ -969,6 +1293,279 @@ bail:
 	return ret;
 }
 
+// Replies with the overall status, then for PropGetMany the values
+// read (`a{sv}`) and the status of every key which could not be read
+// (`a{si}`), or for PropSetMany the status of every key (`a{si}`).
+void
+DBusIPCAPI::prop_many_reply(boost::shared_ptr<PropManyContext> context, bool is_get)
+{
+	DBusMessage *reply = dbus_message_new_method_return(context->mMessage);
+	DBusMessageIter iter;
+	DBusMessageIter dict;
+	std::map<std::string, int>::const_iterator status_iter;
+	int status = kWPANTUNDStatus_Ok;
+
+	syslog(LOG_DEBUG, "Sending DBus response for \"%s\" to \"%s\"", dbus_message_get_member(context->mMessage), dbus_message_get_sender(context->mMessage));
+
+	if (reply) {
+		// Sets report the first failure as the overall status, so that
+		// clients only looking at it still notice.
+		if (!is_get) {
+			for (status_iter = context->mStatus.begin(); status_iter != context->mStatus.end(); ++status_iter) {
+				if (status_iter->second != kWPANTUNDStatus_Ok) {
+					status = status_iter->second;
+					break;
+				}
+			}
+		}
+
+		dbus_message_iter_init_append(reply, &iter);
+		dbus_message_iter_append_basic(&iter, DBUS_TYPE_INT32, &status);
+
+		if (is_get) {
+			append_any_to_dbus_iter(&iter, context->mValues);
+		}
+
+		dbus_message_iter_open_container(
+			&iter,
+			DBUS_TYPE_ARRAY,
+			DBUS_DICT_ENTRY_BEGIN_CHAR_AS_STRING
+				DBUS_TYPE_STRING_AS_STRING
+				DBUS_TYPE_INT32_AS_STRING
+			DBUS_DICT_ENTRY_END_CHAR_AS_STRING,
+			&dict
+		);
+
+		for (status_iter = context->mStatus.begin(); status_iter != context->mStatus.end(); ++status_iter) {
+			DBusMessageIter entry;
+			const char* key_cstr = status_iter->first.c_str();
+			int key_status = status_iter->second;
+
+			if (is_get && (key_status == kWPANTUNDStatus_Ok)) {
+				continue;
+			}
+
+			dbus_message_iter_open_container(&dict, DBUS_TYPE_DICT_ENTRY, NULL, &entry);
+			dbus_message_iter_append_basic(&entry, DBUS_TYPE_STRING, &key_cstr);
+			dbus_message_iter_append_basic(&entry, DBUS_TYPE_INT32, &key_status);
+			dbus_message_iter_close_container(&dict, &entry);
+		}
+
+		dbus_message_iter_close_container(&iter, &dict);
+
+		dbus_connection_send(mConnection, reply, NULL);
+		dbus_message_unref(reply);
+	}
+
+	dbus_message_unref(context->mMessage);
+}
+
+void
+DBusIPCAPI::prop_get_many_did_finish(int status, const boost::any& value, const std::string& key, boost::shared_ptr<PropManyContext> context)
+{
+	if (!status && value.empty()) {
+		status = kWPANTUNDStatus_PropertyEmpty;
+	}
+
+	if (!status) {
+		context->mValues[key] = value;
+	}
+
+	context->mStatus[key] = status;
+
+	if (--context->mPending == 0) {
+		prop_many_reply(context, true);
+	}
+}
+
+// Fans out a get made through a property handle to every name which
+// was asked for and resolved to that handle.
+void
+DBusIPCAPI::prop_get_many_handle_did_finish(int status, const boost::any& value, const std::list<std::string>& keys, boost::shared_ptr<PropManyContext> context)
+{
+	std::list<std::string>::const_iterator key_iter;
+
+	for (key_iter = keys.begin(); key_iter != keys.end(); ++key_iter) {
+		prop_get_many_did_finish(status, value, *key_iter, context);
+	}
+}
+
+void
+DBusIPCAPI::prop_set_many_did_finish(int status, const std::string& key, boost::shared_ptr<PropManyContext> context)
+{
+	context->mStatus[key] = status;
+
+	if (--context->mPending == 0) {
+		prop_many_reply(context, false);
+	}
+}
+
+DBusHandlerResult
+DBusIPCAPI::interface_prop_get_many_handler(
+	NCPControlInterface* interface,
+	DBusMessage *        message
+) {
+	DBusHandlerResult ret = DBUS_HANDLER_RESULT_NOT_YET_HANDLED;
+	boost::shared_ptr<PropManyContext> context(new PropManyContext);
+	std::map<std::string, std::string> keys;
+	std::map<std::string, std::string>::const_iterator key_iter;
+	std::map<NCPControlInterface::PropertyHandle, std::list<std::string> > handles;
+	std::map<NCPControlInterface::PropertyHandle, std::list<std::string> >::const_iterator handle_iter;
+	DBusMessageIter iter;
+	DBusMessageIter list_iter;
+
+	dbus_message_iter_init(message, &iter);
+
+	require(dbus_message_iter_get_arg_type(&iter) == DBUS_TYPE_ARRAY, bail);
+	require(dbus_message_iter_get_element_type(&iter) == DBUS_TYPE_STRING, bail);
+
+	dbus_message_iter_recurse(&iter, &list_iter);
+
+	for (; dbus_message_iter_get_arg_type(&list_iter) == DBUS_TYPE_STRING; dbus_message_iter_next(&list_iter)) {
+		const char* property_key_cstr = "";
+		std::string property_key;
+
+		dbus_message_iter_get_basic(&list_iter, &property_key_cstr);
+		property_key = property_key_cstr;
+
+		if (interface->translate_deprecated_property(property_key)) {
+			syslog(LOG_WARNING, "PropGetMany: Property \"%s\" is deprecated. Please use \"%s\" instead.", property_key_cstr, property_key.c_str());
+		}
+
+		// Answered under the name it was asked for. A name asked
+		// for twice is only read once.
+		keys[property_key_cstr] = property_key;
+	}
+
+	dbus_message_ref(message);
+
+	context->mMessage = message;
+
+	// Held by the loop itself, so that gets answered right away can't
+	// send the reply before every get has been started.
+	context->mPending = 1;
+
+	// Start every get before any of them goes out to the NCP, so that
+	// those reading the same NCP property are merged.
+	interface->begin_property_batch();
+
+	// Names are resolved to handles once, so that names for the same
+	// property (in another case, or a deprecated alias) share one get.
+	// Those without a handle are read by name.
+	for (key_iter = keys.begin(); key_iter != keys.end(); ++key_iter) {
+		NCPControlInterface::PropertyHandle handle = interface->get_property_handle(key_iter->second);
+
+		context->mPending++;
+
+		if (handle != NCPControlInterface::kInvalidPropertyHandle) {
+			handles[handle].push_back(key_iter->first);
+		} else {
+			interface->property_get_value(
+				key_iter->second,
+				boost::bind(&DBusIPCAPI::prop_get_many_did_finish, this, _1, _2, key_iter->first, context)
+			);
+		}
+	}
+
+	for (handle_iter = handles.begin(); handle_iter != handles.end(); ++handle_iter) {
+		interface->property_get_value_with_handle(
+			handle_iter->first,
+			boost::bind(&DBusIPCAPI::prop_get_many_handle_did_finish, this, _1, _2, handle_iter->second, context)
+		);
+	}
+
+	interface->end_property_batch();
+
+	if (--context->mPending == 0) {
+		prop_many_reply(context, true);
+	}
+
+	ret = DBUS_HANDLER_RESULT_HANDLED;
+
+bail:
+	return ret;
+}
+
+DBusHandlerResult
+DBusIPCAPI::interface_prop_set_many_handler(
+	NCPControlInterface* interface,
+	DBusMessage *        message
+) {
+	DBusHandlerResult ret = DBUS_HANDLER_RESULT_NOT_YET_HANDLED;
+	boost::shared_ptr<PropManyContext> context(new PropManyContext);
+	std::list<std::pair<std::string, boost::any> > values;
+	std::list<std::pair<std::string, boost::any> >::iterator value_iter;
+	DBusMessageIter iter;
+	DBusMessageIter dict_iter;
+
+	dbus_message_iter_init(message, &iter);
+
+	require(dbus_message_iter_get_arg_type(&iter) == DBUS_TYPE_ARRAY, bail);
+	require(dbus_message_iter_get_element_type(&iter) == DBUS_TYPE_DICT_ENTRY, bail);
+
+	dbus_message_iter_recurse(&iter, &dict_iter);
+
+	for (; dbus_message_iter_get_arg_type(&dict_iter) == DBUS_TYPE_DICT_ENTRY; dbus_message_iter_next(&dict_iter)) {
+		DBusMessageIter entry_iter;
+		const char* property_key_cstr = "";
+		std::string property_key;
+		boost::any property_value;
+
+		dbus_message_iter_recurse(&dict_iter, &entry_iter);
+
+		require(dbus_message_iter_get_arg_type(&entry_iter) == DBUS_TYPE_STRING, bail);
+
+		dbus_message_iter_get_basic(&entry_iter, &property_key_cstr);
+		dbus_message_iter_next(&entry_iter);
+
+		property_key = property_key_cstr;
+		property_value = any_from_dbus_iter(&entry_iter);
+
+		// Only the last value given for a key is set.
+		for (value_iter = values.begin(); value_iter != values.end(); ++value_iter) {
+			if (value_iter->first == property_key) {
+				values.erase(value_iter);
+				break;
+			}
+		}
+
+		values.push_back(std::make_pair(property_key, property_value));
+	}
+
+	dbus_message_ref(message);
+
+	context->mMessage = message;
+	context->mPending = 1;
+
+	// Sets are started in the order given, and are queued up on the
+	// NCP side in that same order.
+	for (value_iter = values.begin(); value_iter != values.end(); ++value_iter) {
+		std::string property_key = value_iter->first;
+		boost::any property_value = value_iter->second;
+
+		if (interface->translate_deprecated_property(property_key, property_value)) {
+			syslog(LOG_WARNING, "PropSetMany: Property \"%s\" is deprecated. Please use \"%s\" instead.", value_iter->first.c_str(), property_key.c_str());
+		}
+
+		// Answered under the name it was given as.
+		context->mPending++;
+		interface->property_set_value(
+			property_key,
+			property_value,
+			boost::bind(&DBusIPCAPI::prop_set_many_did_finish, this, _1, value_iter->first, context)
+		);
+	}
+
+	if (--context->mPending == 0) {
+		prop_many_reply(context, false);
+	}
+
+	ret = DBUS_HANDLER_RESULT_HANDLED;
+
+bail:
+	return ret;
+}
+
 DBusHandlerResult
 DBusIPCAPI::reset_NCP(
 	NCPControlInterface* interface,
@@ -28,18 +28,19 @@
 #include <boost/bind.hpp>
 #include <boost/any.hpp>
 #include <boost/function.hpp>
+#include <boost/shared_ptr.hpp>
 
 #include "NetworkInstance.h"
 #include "NCPTypes.h"
 #include "Data.h"
 #include "time-utils.h"
 #include "ValueMap.h"
+#include "NCPControlInterface.h"
+#include "PropertyChangeQueue.h"
 
 namespace nl {
 namespace wpantund {
 
-class NCPControlInterface;
-
 class DBusIPCAPI {
 public:
 	DBusIPCAPI(DBusConnection *connection);
@@ -47,6 +48,10 @@ public:
 
 	int add_interface(NCPControlInterface* interface);
 
+	// Sends the property changes which are due.
+	void process(void);
+	cms_t get_ms_to_next_event(void);
+
 private:
 
 	DBusHandlerResult message_handler(
@@ -61,6 +66,12 @@ private:
 		void *user_data
 	);
 
+	static DBusHandlerResult dbus_name_owner_changed_filter(
+		DBusConnection *connection,
+		DBusMessage *message,
+		void *user_data
+	);
+
 	void init_callback_tables(void);
 
 	std::string path_for_iface(NCPControlInterface* interface);
@@ -72,6 +83,20 @@ private:
 
 	void status_response_helper(int ret, NCPControlInterface* interface, DBusMessage *original_message);
 
+	// Results of the gets or sets of a PropGetMany/PropSetMany call,
+	// which is answered once the last of them has finished.
+	struct PropManyContext {
+		DBusMessage *mMessage;
+		int mPending;
+		ValueMap mValues;
+		std::map<std::string, int> mStatus;
+	};
+
+	void prop_get_many_did_finish(int status, const boost::any& value, const std::string& key, boost::shared_ptr<PropManyContext> context);
+	void prop_get_many_handle_did_finish(int status, const boost::any& value, const std::list<std::string>& keys, boost::shared_ptr<PropManyContext> context);
+	void prop_set_many_did_finish(int status, const std::string& key, boost::shared_ptr<PropManyContext> context);
+	void prop_many_reply(boost::shared_ptr<PropManyContext> context, bool is_get);
+
 	// TODO: Remove these...
 	//void scan_response_helper(int ret, DBusMessage *original_message);
 	//void energy_scan_response_helper(int ret, DBusMessage *original_message);
@@ -79,7 +104,23 @@ private:
 	// ------------------------------------------------------------------------
 
 	void property_changed(NCPControlInterface* interface, const std::string& key, const boost::any& value);
+
+	// Property changes waiting to be signaled for an interface: the
+	// broadcast stream, one queue per client which asked (with
+	// PropertiesSubscribe) for its own rate, and the noisy properties
+	// whose per property PropChanged signals are being held back.
+	struct PropertyChangeStream {
+		PropertyChangeQueue mBroadcast;
+		std::map<std::string, PropertyChangeQueue> mSubscribers;
+		PropertyChangeQueue mPropChanged;
+	};
+
+	void flush_property_changes(NCPControlInterface* interface, PropertyChangeStream& stream);
+	void send_prop_changed(NCPControlInterface* interface, const std::string& key, const boost::any& value);
+	bool send_properties_changed(NCPControlInterface* interface, const ValueMap& values, const char* destination);
 	void received_beacon(NCPControlInterface* interface, const WPAN::NetworkInstance& network);
+	void received_topology_change(NCPControlInterface* interface, NCPControlInterface::TopologyChange change,
+	                              const ValueMap& delta);
 	void received_energy_scan_result(NCPControlInterface* interface, const EnergyScanResultEntry& energy_scan_result);
 	void received_network_time_update(NCPControlInterface* interface, const ValueMap& network_time_update);
 
@@ -169,6 +210,26 @@ private:
 		DBusMessage *        message
 	);
 
+	DBusHandlerResult interface_prop_get_many_handler(
+		NCPControlInterface* interface,
+		DBusMessage *        message
+	);
+
+	DBusHandlerResult interface_prop_set_many_handler(
+		NCPControlInterface* interface,
+		DBusMessage *        message
+	);
+
+	DBusHandlerResult interface_props_subscribe_handler(
+		NCPControlInterface* interface,
+		DBusMessage *        message
+	);
+
+	DBusHandlerResult interface_props_unsubscribe_handler(
+		NCPControlInterface* interface,
+		DBusMessage *        message
+	);
+
 	DBusHandlerResult interface_prop_insert_handler(
 		NCPControlInterface* interface,
 		DBusMessage *        message
@@ -323,6 +384,7 @@ private:
 
 	DBusConnection *mConnection;
 	std::map<std::string, boost::function<interface_handler_cb> > mInterfaceCallbackTable;
+	std::map<NCPControlInterface*, PropertyChangeStream> mPropertyChangeStreams;
 }; // class DBusIPCAPI
 
 }; // namespace nl
@@ -0,0 +1,189 @@
+/*
+ *
+ * Copyright (c) 2026 Texas Instruments
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *    Description:
+ *      Measures how many PropGet requests a running wpantund answers
+ *      per second over the system bus, with a given number of them
+ *      kept in flight. Without an in flight count, runs 1, 32 and 128.
+ *
+ *      Usage: propget_bench [interface] [property] [requests] [in flight]
+ *
+ */
+
+#if HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <dbus/dbus.h>
+#include "wpan-dbus.h"
+
+#define STALL_TIMEOUT_MS    5000
+
+static double
+now_seconds(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static dbus_bool_t
+send_prop_get(DBusConnection* connection, const char* path, const char* property)
+{
+	DBusMessage* message;
+	dbus_bool_t ret = FALSE;
+
+	message = dbus_message_new_method_call(
+		WPAN_TUNNEL_DBUS_NAME,
+		path,
+		WPAN_TUNNEL_DBUS_INTERFACE,
+		WPANTUND_IF_CMD_PROP_GET
+	);
+
+	if (message != NULL) {
+		ret = dbus_message_append_args(message, DBUS_TYPE_STRING, &property, DBUS_TYPE_INVALID)
+			&& dbus_connection_send(connection, message, NULL);
+		dbus_message_unref(message);
+	}
+
+	return ret;
+}
+
+// Returns true if `message` is a reply carrying a status of zero.
+static dbus_bool_t
+reply_is_ok(DBusMessage* message)
+{
+	DBusMessageIter iter;
+	int32_t status = -1;
+
+	if ((dbus_message_get_type(message) != DBUS_MESSAGE_TYPE_METHOD_RETURN)
+	 || !dbus_message_iter_init(message, &iter)
+	 || (dbus_message_iter_get_arg_type(&iter) != DBUS_TYPE_INT32)
+	) {
+		return FALSE;
+	}
+
+	dbus_message_iter_get_basic(&iter, &status);
+
+	return status == 0;
+}
+
+static int
+run(DBusConnection* connection, const char* path, const char* property, int request_count, int in_flight_max)
+{
+	int sent = 0;
+	int done = 0;
+	int errors = 0;
+	double begin = now_seconds();
+	double last_progress = begin;
+	double elapsed;
+
+	while (done < request_count) {
+		DBusMessage* message;
+
+		while ((sent - done < in_flight_max) && (sent < request_count)) {
+			if (!send_prop_get(connection, path, property)) {
+				fprintf(stderr, "Unable to send PropGet\n");
+				return -1;
+			}
+			sent++;
+		}
+
+		if (!dbus_connection_read_write(connection, 100)) {
+			fprintf(stderr, "Lost the connection to the bus\n");
+			return -1;
+		}
+
+		while ((message = dbus_connection_pop_message(connection)) != NULL) {
+			int type = dbus_message_get_type(message);
+
+			if ((type == DBUS_MESSAGE_TYPE_METHOD_RETURN) || (type == DBUS_MESSAGE_TYPE_ERROR)) {
+				if (!reply_is_ok(message)) {
+					if (errors == 0 && type == DBUS_MESSAGE_TYPE_ERROR) {
+						fprintf(stderr, "%s\n", dbus_message_get_error_name(message));
+					}
+					errors++;
+				}
+				done++;
+				last_progress = now_seconds();
+			}
+
+			dbus_message_unref(message);
+		}
+
+		if ((now_seconds() - last_progress) * 1000 > STALL_TIMEOUT_MS) {
+			fprintf(stderr, "No reply for %d ms, %d of %d requests answered\n", STALL_TIMEOUT_MS, done, request_count);
+			return -1;
+		}
+	}
+
+	elapsed = now_seconds() - begin;
+
+	printf("%9d %9d %10.3f %12.0f %8d\n", in_flight_max, request_count, elapsed, request_count / elapsed, errors);
+
+	return (errors == 0) ? 0 : -1;
+}
+
+int
+main(int argc, char* argv[])
+{
+	static const int default_in_flight[] = { 1, 32, 128 };
+	const char* interface_name = (argc > 1) ? argv[1] : "wpan0";
+	const char* property = (argc > 2) ? argv[2] : kWPANTUNDProperty_NCPState;
+	int request_count = (argc > 3) ? atoi(argv[3]) : 20000;
+	char path[128];
+	DBusConnection* connection;
+	DBusError error;
+	int ret = 0;
+	size_t i;
+
+	if (request_count <= 0) {
+		fprintf(stderr, "usage: %s [interface] [property] [requests] [in flight]\n", argv[0]);
+		return EXIT_FAILURE;
+	}
+
+	snprintf(path, sizeof(path), "%s/%s", WPAN_TUNNEL_DBUS_PATH, interface_name);
+
+	dbus_error_init(&error);
+	connection = dbus_bus_get(DBUS_BUS_SYSTEM, &error);
+
+	if (connection == NULL) {
+		fprintf(stderr, "Unable to connect to the system bus: %s\n", error.message);
+		dbus_error_free(&error);
+		return EXIT_FAILURE;
+	}
+
+	printf("PropGet %s on %s\n\n", property, path);
+	printf("%9s %9s %10s %12s %8s\n", "in flight", "requests", "seconds", "requests/s", "errors");
+
+	if (argc > 4) {
+		ret = run(connection, path, property, request_count, atoi(argv[4]) > 0 ? atoi(argv[4]) : 1);
+	} else {
+		for (i = 0; (ret == 0) && (i < sizeof(default_in_flight) / sizeof(default_in_flight[0])); i++) {
+			ret = run(connection, path, property, request_count, default_in_flight[i]);
+		}
+	}
+
+	dbus_connection_unref(connection);
+
+	return (ret == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
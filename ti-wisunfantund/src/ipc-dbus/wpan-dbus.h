@@ -76,9 +76,14 @@
 
 #define WPANTUND_IF_CMD_PROP_GET              "PropGet"
 #define WPANTUND_IF_CMD_PROP_SET              "PropSet"
+#define WPANTUND_IF_CMD_PROP_GET_MANY         "PropGetMany"
+#define WPANTUND_IF_CMD_PROP_SET_MANY         "PropSetMany"
 #define WPANTUND_IF_CMD_PROP_INSERT           "PropInsert"
 #define WPANTUND_IF_CMD_PROP_REMOVE           "PropRemove"
 #define WPANTUND_IF_SIGNAL_PROP_CHANGED       "PropChanged"
+#define WPANTUND_IF_SIGNAL_PROPS_CHANGED      "PropertiesChanged"
+#define WPANTUND_IF_CMD_PROPS_SUBSCRIBE       "PropertiesSubscribe"
+#define WPANTUND_IF_CMD_PROPS_UNSUBSCRIBE     "PropertiesUnsubscribe"
 
 #define WPANTUND_IF_CMD_JOINER_ATTACH         "JoinerAttach"
 #define WPANTUND_IF_CMD_JOINER_COMMISSIONING  "JoinerCommissioning" // Deprecated, please use JOINER_START and STOP
@@ -97,6 +102,10 @@
 
 #define WPANTUND_IF_SIGNAL_NETWORK_TIME_UPDATE "NetworkTimeUpdate"
 
+#define WPANTUND_IF_SIGNAL_NODE_JOINED        "NodeJoined"
+#define WPANTUND_IF_SIGNAL_NODE_LEFT          "NodeLeft"
+#define WPANTUND_IF_SIGNAL_PARENT_CHANGED     "ParentChanged"
+
 #define WPANTUND_IF_CMD_LINK_METRICS_QUERY        "LinkMetricsQuery"
 #define WPANTUND_IF_CMD_LINK_METRICS_PROBE        "LinkMetricsProbe"
 #define WPANTUND_IF_CMD_LINK_METRICS_MGMT_FORWARD "LinkMetricsMgmtForward"
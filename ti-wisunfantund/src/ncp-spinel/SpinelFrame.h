@@ -0,0 +1,414 @@
+/*
+ *
+ * Copyright (c) 2026 Texas Instruments
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *    Description:
+ *      Spinel frame layouts described as a list of types, encoded and
+ *      decoded without going through a format string or a `va_list`.
+ *
+ *      `spinel::Frame<uint8_t, spinel::PackedUint, spinel::Data>` reads
+ *      and writes the same bytes as the format "CiD" does with
+ *      `spinel_datatype_pack()`/`spinel_datatype_unpack()`, but the
+ *      layout is walked at compile time, every argument is type
+ *      checked, and nothing is allocated.
+ *
+ */
+
+#ifndef __wpantund__SpinelFrame__
+#define __wpantund__SpinelFrame__
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <type_traits>
+#include "spinel.h"
+#include "Data.h"
+
+namespace nl {
+namespace wpantund {
+namespace spinel {
+
+// Field types with no C++ type of their own. The integer types,
+// `bool`, `spinel_ipv6addr_t`, `spinel_eui64_t` and `spinel_eui48_t`
+// are used directly.
+struct PackedUint { };  // 'i', packed unsigned integer.
+struct DataWlen { };    // 'd', data prefixed with its 16-bit length.
+struct Data { };        // 'D' as the last field, the rest of the frame.
+
+// Same as `SPINEL_MAX_PACK_LENGTH`, which spinel.c keeps to itself.
+enum { kMaxPackLength = 32767 };
+
+// The value of a `Data` or `DataWlen` field. When decoding, points
+// into the frame being decoded.
+struct Bytes {
+	const uint8_t* ptr;
+	spinel_size_t len;
+
+	Bytes(void) : ptr(NULL), len(0) { }
+	Bytes(const uint8_t* p, spinel_size_t l) : ptr(p), len(l) { }
+	Bytes(const nl::Data& data) : ptr(data.data()), len(static_cast<spinel_size_t>(data.size())) { }
+};
+
+// Describes how one field is encoded. Each specialization provides:
+//
+//  * `Value`, what `encode()` takes, and `Decoded`, what `decode()`
+//    gives back.
+//  * `kMaxSize`, the most bytes the field can take in a frame.
+//  * `size(value)`, the bytes `value` takes, or -1 if it cannot be
+//    encoded.
+//  * `encode(out, value)`, which writes `value` and returns the
+//    byte after it.
+//  * `decode(in, end, out)`, which reads the field and returns the
+//    byte after it, or NULL if the field is not valid.
+template <typename T> struct Field;
+
+namespace internal {
+
+template <typename T>
+struct LittleEndianField {
+	typedef T Value;
+	typedef T Decoded;
+
+	enum { kMaxSize = sizeof(T) };
+
+	static spinel_ssize_t size(Value) { return sizeof(T); }
+
+	static uint8_t* encode(uint8_t* out, Value value) {
+		uint64_t bits = static_cast<uint64_t>(value);
+
+		for (size_t i = 0; i < sizeof(T); i++) {
+			out[i] = static_cast<uint8_t>(bits >> (8 * i));
+		}
+
+		return out + sizeof(T);
+	}
+
+	static const uint8_t* decode(const uint8_t* in, const uint8_t* end, Decoded* out) {
+		uint64_t bits = 0;
+
+		if (static_cast<size_t>(end - in) < sizeof(T)) {
+			return NULL;
+		}
+
+		for (size_t i = 0; i < sizeof(T); i++) {
+			bits |= static_cast<uint64_t>(in[i]) << (8 * i);
+		}
+
+		*out = static_cast<T>(bits);
+
+		return in + sizeof(T);
+	}
+};
+
+template <typename T>
+struct VerbatimField {
+	typedef T Value;
+	typedef T Decoded;
+
+	enum { kMaxSize = sizeof(T) };
+
+	static spinel_ssize_t size(const Value&) { return sizeof(T); }
+
+	static uint8_t* encode(uint8_t* out, const Value& value) {
+		memcpy(out, &value, sizeof(T));
+		return out + sizeof(T);
+	}
+
+	static const uint8_t* decode(const uint8_t* in, const uint8_t* end, Decoded* out) {
+		if (static_cast<size_t>(end - in) < sizeof(T)) {
+			return NULL;
+		}
+
+		memcpy(out, in, sizeof(T));
+
+		return in + sizeof(T);
+	}
+};
+
+}; // namespace internal
+
+template <> struct Field<uint8_t> : internal::LittleEndianField<uint8_t> { };
+template <> struct Field<int8_t> : internal::LittleEndianField<int8_t> { };
+template <> struct Field<uint16_t> : internal::LittleEndianField<uint16_t> { };
+template <> struct Field<int16_t> : internal::LittleEndianField<int16_t> { };
+template <> struct Field<uint32_t> : internal::LittleEndianField<uint32_t> { };
+template <> struct Field<int32_t> : internal::LittleEndianField<int32_t> { };
+template <> struct Field<uint64_t> : internal::LittleEndianField<uint64_t> { };
+template <> struct Field<int64_t> : internal::LittleEndianField<int64_t> { };
+
+template <> struct Field<spinel_ipv6addr_t> : internal::VerbatimField<spinel_ipv6addr_t> { };
+template <> struct Field<spinel_eui64_t> : internal::VerbatimField<spinel_eui64_t> { };
+template <> struct Field<spinel_eui48_t> : internal::VerbatimField<spinel_eui48_t> { };
+
+template <>
+struct Field<bool> {
+	typedef bool Value;
+	typedef bool Decoded;
+
+	enum { kMaxSize = 1 };
+
+	static spinel_ssize_t size(Value) { return 1; }
+
+	static uint8_t* encode(uint8_t* out, Value value) {
+		*out = value ? 1 : 0;
+		return out + 1;
+	}
+
+	static const uint8_t* decode(const uint8_t* in, const uint8_t* end, Decoded* out) {
+		if (in == end) {
+			return NULL;
+		}
+
+		*out = (*in != 0);
+
+		return in + 1;
+	}
+};
+
+// Packed unsigned integers are limited to `SPINEL_MAX_UINT_PACKED`,
+// so they never take more than three bytes.
+template <>
+struct Field<PackedUint> {
+	typedef unsigned int Value;
+	typedef unsigned int Decoded;
+
+	enum { kMaxSize = 3 };
+
+	static spinel_ssize_t size(Value value) {
+		if (value < (1 << 7)) {
+			return 1;
+		} else if (value < (1 << 14)) {
+			return 2;
+		} else if (value < SPINEL_MAX_UINT_PACKED) {
+			return 3;
+		}
+		return -1;
+	}
+
+	static uint8_t* encode(uint8_t* out, Value value) {
+		while (value >= 0x80) {
+			*out++ = static_cast<uint8_t>(value & 0x7F) | 0x80;
+			value >>= 7;
+		}
+
+		*out++ = static_cast<uint8_t>(value);
+
+		return out;
+	}
+
+	static const uint8_t* decode(const uint8_t* in, const uint8_t* end, Decoded* out) {
+		unsigned int value = 0;
+		unsigned int shift = 0;
+		uint8_t byte;
+
+		do {
+			if ((in == end) || (shift >= sizeof(unsigned int) * 8)) {
+				return NULL;
+			}
+
+			byte = *in++;
+			value |= static_cast<unsigned int>(byte & 0x7F) << shift;
+			shift += 7;
+		} while ((byte & 0x80) != 0);
+
+		if (value >= SPINEL_MAX_UINT_PACKED) {
+			return NULL;
+		}
+
+		*out = value;
+
+		return in;
+	}
+};
+
+template <>
+struct Field<DataWlen> {
+	typedef Bytes Value;
+	typedef Bytes Decoded;
+
+	enum { kMaxSize = 2 + SPINEL_FRAME_MAX_SIZE };
+
+	static spinel_ssize_t size(const Value& value) {
+		if (value.len > 0xFFFF) {
+			return -1;
+		}
+		return static_cast<spinel_ssize_t>(2 + value.len);
+	}
+
+	static uint8_t* encode(uint8_t* out, const Value& value) {
+		out[0] = static_cast<uint8_t>(value.len);
+		out[1] = static_cast<uint8_t>(value.len >> 8);
+
+		if (value.len != 0) {
+			memcpy(out + 2, value.ptr, value.len);
+		}
+
+		return out + 2 + value.len;
+	}
+
+	static const uint8_t* decode(const uint8_t* in, const uint8_t* end, Decoded* out) {
+		spinel_size_t len;
+
+		if (end - in < 2) {
+			return NULL;
+		}
+
+		len = in[0] | (in[1] << 8);
+
+		if ((len >= SPINEL_FRAME_MAX_SIZE) || (static_cast<spinel_size_t>(end - in - 2) < len)) {
+			return NULL;
+		}
+
+		*out = Bytes(in + 2, len);
+
+		return in + 2 + len;
+	}
+};
+
+template <>
+struct Field<Data> {
+	typedef Bytes Value;
+	typedef Bytes Decoded;
+
+	enum { kMaxSize = SPINEL_FRAME_MAX_SIZE };
+
+	static spinel_ssize_t size(const Value& value) { return static_cast<spinel_ssize_t>(value.len); }
+
+	static uint8_t* encode(uint8_t* out, const Value& value) {
+		if (value.len != 0) {
+			memcpy(out, value.ptr, value.len);
+		}
+
+		return out + value.len;
+	}
+
+	static const uint8_t* decode(const uint8_t* in, const uint8_t* end, Decoded* out) {
+		*out = Bytes(in, static_cast<spinel_size_t>(end - in));
+		return end;
+	}
+};
+
+namespace internal {
+
+template <typename... Ts> struct Codec;
+
+template <>
+struct Codec<> {
+	enum { kMaxSize = 0 };
+
+	static spinel_ssize_t size(void) { return 0; }
+
+	static uint8_t* encode(uint8_t* out) { return out; }
+
+	static const uint8_t* decode(const uint8_t* in, const uint8_t*) { return in; }
+};
+
+template <typename T, typename... Rest>
+struct Codec<T, Rest...> {
+	static_assert(
+		sizeof...(Rest) == 0 || !std::is_same<T, Data>::value,
+		"spinel::Data can only be the last field, use spinel::DataWlen"
+	);
+
+	enum { kMaxSize = Field<T>::kMaxSize + Codec<Rest...>::kMaxSize };
+
+	static spinel_ssize_t size(const typename Field<T>::Value& value, const typename Field<Rest>::Value&... rest) {
+		spinel_ssize_t head = Field<T>::size(value);
+		spinel_ssize_t tail = Codec<Rest...>::size(rest...);
+
+		return ((head < 0) || (tail < 0)) ? -1 : head + tail;
+	}
+
+	static uint8_t* encode(uint8_t* out, const typename Field<T>::Value& value, const typename Field<Rest>::Value&... rest) {
+		return Codec<Rest...>::encode(Field<T>::encode(out, value), rest...);
+	}
+
+	static const uint8_t* decode(const uint8_t* in, const uint8_t* end, typename Field<T>::Decoded* out, typename Field<Rest>::Decoded*... rest) {
+		typename Field<T>::Decoded ignored;
+
+		in = Field<T>::decode(in, end, (out != NULL) ? out : &ignored);
+
+		return (in == NULL) ? NULL : Codec<Rest...>::decode(in, end, rest...);
+	}
+};
+
+}; // namespace internal
+
+// A spinel frame, or the start of one, made of the given fields in
+// order.
+template <typename... Fields>
+struct Frame {
+	typedef internal::Codec<Fields...> Codec;
+
+	// The most bytes a frame with this layout can take. A buffer this
+	// big always fits one.
+	enum { kMaxSize = Codec::kMaxSize };
+
+	// Returns the bytes the frame takes, or -1 if one of the values
+	// cannot be encoded.
+	static spinel_ssize_t size(const typename Field<Fields>::Value&... values) {
+		return Codec::size(values...);
+	}
+
+	// Same contract as `spinel_datatype_pack()`: returns the size of
+	// the frame, which is larger than `buffer_len` if it did not fit
+	// (in which case nothing is written), or -1 if one of the values
+	// cannot be encoded.
+	static spinel_ssize_t encode(uint8_t* buffer, spinel_size_t buffer_len, const typename Field<Fields>::Value&... values) {
+		spinel_ssize_t len = Codec::size(values...);
+
+		if ((len >= 0) && (static_cast<spinel_size_t>(len) <= buffer_len)) {
+			Codec::encode(buffer, values...);
+		}
+
+		return len;
+	}
+
+	// Returns the frame in a `Data` of exactly its size, or an empty
+	// one if one of the values cannot be encoded.
+	static nl::Data pack(const typename Field<Fields>::Value&... values) {
+		spinel_ssize_t len = Codec::size(values...);
+		nl::Data ret(len > 0 ? static_cast<size_t>(len) : 0);
+
+		if (len > 0) {
+			Codec::encode(ret.data(), values...);
+		}
+
+		return ret;
+	}
+
+	// Same contract as `spinel_datatype_unpack()`: returns the number
+	// of bytes read, or -1 if the frame does not match the layout.
+	// Pass NULL for fields that are not needed. Outputs are only
+	// complete when the whole frame could be read.
+	static spinel_ssize_t decode(const uint8_t* buffer, spinel_size_t buffer_len, typename Field<Fields>::Decoded*... out) {
+		const uint8_t* end;
+
+		if (buffer_len > static_cast<spinel_size_t>(kMaxPackLength)) {
+			return -1;
+		}
+
+		end = Codec::decode(buffer, buffer + buffer_len, out...);
+
+		return (end == NULL) ? -1 : static_cast<spinel_ssize_t>(end - buffer);
+	}
+};
+
+}; // namespace spinel
+}; // namespace wpantund
+}; // namespace nl
+
+#endif /* defined(__wpantund__SpinelFrame__) */
@@ -1158,6 +1158,20 @@ SpinelNCPControlInterface::property_get_value(
 	mNCPInstance->property_get_value(in_key, cb);
 }
 
+NCPControlInterface::PropertyHandle
+SpinelNCPControlInterface::get_property_handle(const std::string& key)
+{
+	return mNCPInstance->get_property_handle(key);
+}
+
+void
+SpinelNCPControlInterface::property_get_value_with_handle(
+	PropertyHandle handle,
+	CallbackWithStatusArg1 cb
+) {
+	mNCPInstance->property_get_value_with_handle(handle, cb);
+}
+
 void
 SpinelNCPControlInterface::property_set_value(
 	const std::string& key,
@@ -1167,6 +1181,18 @@ SpinelNCPControlInterface::property_set_value(
 	mNCPInstance->property_set_value(key, value, cb);
 }
 
+void
+SpinelNCPControlInterface::begin_property_batch(void)
+{
+	mNCPInstance->begin_property_batch();
+}
+
+void
+SpinelNCPControlInterface::end_property_batch(void)
+{
+	mNCPInstance->end_property_batch();
+}
+
 void
 SpinelNCPControlInterface::reset_NCP(
 	CallbackWithStatus cb
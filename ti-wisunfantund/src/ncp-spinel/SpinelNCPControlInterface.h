@@ -114,12 +114,23 @@ public:
 		CallbackWithStatusArg1 cb
 	);
 
+	virtual PropertyHandle get_property_handle(const std::string& key);
+
+	virtual void property_get_value_with_handle(
+		PropertyHandle handle,
+		CallbackWithStatusArg1 cb
+	);
+
 	virtual void property_set_value(
 		const std::string& key,
 		const boost::any& value,
 		CallbackWithStatus cb
 	);
 
+	virtual void begin_property_batch(void);
+
+	virtual void end_property_batch(void);
+
 	virtual void reset_NCP(
 		CallbackWithStatus cb
 	);
@@ -0,0 +1,131 @@
+/*
+ *
+ * Copyright (c) 2026 Texas Instruments
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef __wpantund__SpinelNCPDispatchTable__
+#define __wpantund__SpinelNCPDispatchTable__
+
+#include <map>
+#include <vector>
+#include <stdint.h>
+
+namespace nl {
+namespace wpantund {
+
+// Handlers for the spinel properties reported by the NCP, keyed by
+// property. Keys below `kDenseKeyLimit` (every standard, Thread and
+// Wi-SUN property) are found through a flat index; the rare vendor keys
+// above it go through a map. Each entry also counts how often its
+// handler ran and how long it took.
+template <typename Handler>
+class SpinelDispatchTable
+{
+public:
+	enum
+	{
+		kDenseKeyLimit = 0x2000,
+	};
+
+	struct Entry
+	{
+		unsigned int mKey;
+		Handler mHandler;
+		uint32_t mCount;
+		uint32_t mMaxUs;
+		uint64_t mTotalUs;
+	};
+
+public:
+	SpinelDispatchTable()
+		: mDenseIndex(kDenseKeyLimit, 0)
+		, mUnhandledCount(0)
+	{
+	}
+
+	// Returns false if `key` already has a handler.
+	bool insert(unsigned int key, Handler handler)
+	{
+		Entry entry;
+
+		if (find(key) != NULL) {
+			return false;
+		}
+
+		entry.mKey = key;
+		entry.mHandler = handler;
+		entry.mCount = 0;
+		entry.mMaxUs = 0;
+		entry.mTotalUs = 0;
+
+		mEntries.push_back(entry);
+
+		// Indexes are stored plus one, so that zero means no handler.
+		if (key < kDenseKeyLimit) {
+			mDenseIndex[key] = static_cast<uint16_t>(mEntries.size());
+		} else {
+			mSparseIndex[key] = static_cast<uint16_t>(mEntries.size());
+		}
+
+		return true;
+	}
+
+	// Returns the entry for `key`, or NULL. The pointer is only good
+	// until the next `insert()`.
+	Entry* find(unsigned int key)
+	{
+		uint16_t index = 0;
+
+		if (key < kDenseKeyLimit) {
+			index = mDenseIndex[key];
+		} else {
+			std::map<unsigned int, uint16_t>::const_iterator iter = mSparseIndex.find(key);
+
+			if (iter != mSparseIndex.end()) {
+				index = iter->second;
+			}
+		}
+
+		return (index == 0) ? NULL : &mEntries[index - 1];
+	}
+
+	void record(Entry* entry, uint32_t elapsed_us)
+	{
+		entry->mCount++;
+		entry->mTotalUs += elapsed_us;
+
+		if (elapsed_us > entry->mMaxUs) {
+			entry->mMaxUs = elapsed_us;
+		}
+	}
+
+	void record_unhandled(void) { mUnhandledCount++; }
+	uint32_t get_unhandled_count(void) const { return mUnhandledCount; }
+
+	const std::vector<Entry>& entries(void) const { return mEntries; }
+
+private:
+	std::vector<Entry> mEntries;
+	std::vector<uint16_t> mDenseIndex;
+	std::map<unsigned int, uint16_t> mSparseIndex;
+	uint32_t mUnhandledCount;
+};
+
+}; // namespace wpantund
+}; // namespace nl
+
+#endif /* defined(__wpantund__SpinelNCPDispatchTable__) */
@@ -30,30 +30,8 @@
 #include <stdexcept>
 #include <sys/file.h>
 #include "SuperSocket.h"
-
-/*
-* Do to the complex flows incorporated into the wfantund flow, it can be helpful
-* to visualize the hex bytes sent to the NCP over UART. These bytes can be compared to
-* SPINEL protocol documentation to verify the intended commands are being sent to the
-* ncp, and to see what other commands might be accompanying the desired commands.
-* (e.g. when sending a reset, there is a lot of built-in logic in addition to the reset)
-* 
-* For debugging, a temporary file in the directory of execution is created, called
-* "DriverToNCPDump.txt". To use this, set SPINEL_DATA_DUMP_TO_FILE to 1. The first
-* debug section prints the hex bytes to be sent before framing, and the second section
-* prints the hex bytes that compose the entire SPINEL frame.
-* 
-* To see the SPINEL frames before framing from NCP to Driver, the "NCPToDriverDump.txt"
-* file shows the data coming in
-*/
-#define SPINEL_DATA_DUMP_TO_FILE 0
-
-#if SPINEL_DATA_DUMP_TO_FILE == 1
-	#include <iostream>
-	#include <fstream>
-	std::ofstream DriverToNCPDump ("DriverToNCPDump.txt");
-	std::ofstream NCPToDriverDump ("NCPToDriverDump.txt");
-#endif
+#include "hdlc.h"
+#include "SpinelFrame.h"
 
 #if OPENTHREAD_ENABLE_NCP_SPINEL_ENCRYPTER
 #include "spinel_encrypter.hpp"
@@ -62,83 +40,51 @@
 using namespace nl;
 using namespace wpantund;
 
-#define HDLC_BYTE_FLAG             0x7E
-#define HDLC_BYTE_ESC              0x7D
-#define HDLC_BYTE_XON              0x11
-#define HDLC_BYTE_XOFF             0x13
-#define HDLC_BYTE_SPECIAL          0xF8
-#define HDLC_ESCAPE_XFORM          0x20
-
-static bool
-hdlc_byte_needs_escape(uint8_t byte)
+// Everything in an outbound STREAM_NET frame before the packet itself,
+// which is read from the tunnel straight into place after it. Takes
+// five bytes, as the command and both keys encode to a single byte.
+typedef spinel::Frame<uint8_t, spinel::PackedUint, spinel::PackedUint, uint16_t> StreamNetHeader;
+
+enum { kStreamNetHeaderLen = 5 };
+
+static_assert(
+	(SPINEL_CMD_PROP_VALUE_SET < 0x80) && (SPINEL_PROP_STREAM_NET < 0x80) && (SPINEL_PROP_STREAM_NET_INSECURE < 0x80),
+	"STREAM_NET header is no longer five bytes"
+);
+
+// Pulls bytes out of `mInboundStagingBuffer` and unescapes them into
+// `mInboundFrame`. Returns true once a closing flag has been seen, at
+// which point `mInboundFrameSize` holds the length of the frame
+// (including its two FCS bytes) and `mInboundFrameHDLCCRC` holds the CRC
+// residue. Returns false when the staging buffer has been drained
+// without completing a frame; the partial frame is kept so the next read
+// can finish it.
+bool
+SpinelNCPInstance::hdlc_deframe_staged_bytes(void)
 {
-	switch(byte) {
-	case HDLC_BYTE_SPECIAL:
-	case HDLC_BYTE_ESC:
-	case HDLC_BYTE_FLAG:
-	case HDLC_BYTE_XOFF:
-	case HDLC_BYTE_XON:
-		return true;
-
-	default:
-		return false;
+	while (mInboundStagingOffset < mInboundStagingLen) {
+		ssize_t frame_len;
+
+		mInboundStagingOffset += hdlc_deframe(
+			&mInboundDeframer,
+			&mInboundStagingBuffer[mInboundStagingOffset],
+			mInboundStagingLen - mInboundStagingOffset,
+			&frame_len
+		);
+
+		if (mInboundDeframer.overrun_count != mInboundOverrunCount) {
+			mInboundOverrunCount = mInboundDeframer.overrun_count;
+			syslog(LOG_ERR, "[NCP->]: Frame too big, dropped");
+		}
+
+		if (frame_len >= 0) {
+			mInboundFrameSize = static_cast<spinel_size_t>(frame_len);
+			mInboundFrameHDLCCRC = mInboundDeframer.crc;
+			return true;
+		}
 	}
-}
 
-static uint16_t
-hdlc_crc16(uint16_t aFcs, uint8_t aByte)
-{
-#if 1
-	// CRC-16/CCITT, CRC-16/CCITT-TRUE, CRC-CCITT
-	// width=16 poly=0x1021 init=0x0000 refin=true refout=true xorout=0x0000 check=0x2189 name="KERMIT"
-	// http://reveng.sourceforge.net/crc-catalogue/16.htm#crc.cat.kermit
-    static const uint16_t sFcsTable[256] =
-    {
-        0x0000, 0x1189, 0x2312, 0x329b, 0x4624, 0x57ad, 0x6536, 0x74bf,
-        0x8c48, 0x9dc1, 0xaf5a, 0xbed3, 0xca6c, 0xdbe5, 0xe97e, 0xf8f7,
-        0x1081, 0x0108, 0x3393, 0x221a, 0x56a5, 0x472c, 0x75b7, 0x643e,
-        0x9cc9, 0x8d40, 0xbfdb, 0xae52, 0xdaed, 0xcb64, 0xf9ff, 0xe876,
-        0x2102, 0x308b, 0x0210, 0x1399, 0x6726, 0x76af, 0x4434, 0x55bd,
-        0xad4a, 0xbcc3, 0x8e58, 0x9fd1, 0xeb6e, 0xfae7, 0xc87c, 0xd9f5,
-        0x3183, 0x200a, 0x1291, 0x0318, 0x77a7, 0x662e, 0x54b5, 0x453c,
-        0xbdcb, 0xac42, 0x9ed9, 0x8f50, 0xfbef, 0xea66, 0xd8fd, 0xc974,
-        0x4204, 0x538d, 0x6116, 0x709f, 0x0420, 0x15a9, 0x2732, 0x36bb,
-        0xce4c, 0xdfc5, 0xed5e, 0xfcd7, 0x8868, 0x99e1, 0xab7a, 0xbaf3,
-        0x5285, 0x430c, 0x7197, 0x601e, 0x14a1, 0x0528, 0x37b3, 0x263a,
-        0xdecd, 0xcf44, 0xfddf, 0xec56, 0x98e9, 0x8960, 0xbbfb, 0xaa72,
-        0x6306, 0x728f, 0x4014, 0x519d, 0x2522, 0x34ab, 0x0630, 0x17b9,
-        0xef4e, 0xfec7, 0xcc5c, 0xddd5, 0xa96a, 0xb8e3, 0x8a78, 0x9bf1,
-        0x7387, 0x620e, 0x5095, 0x411c, 0x35a3, 0x242a, 0x16b1, 0x0738,
-        0xffcf, 0xee46, 0xdcdd, 0xcd54, 0xb9eb, 0xa862, 0x9af9, 0x8b70,
-        0x8408, 0x9581, 0xa71a, 0xb693, 0xc22c, 0xd3a5, 0xe13e, 0xf0b7,
-        0x0840, 0x19c9, 0x2b52, 0x3adb, 0x4e64, 0x5fed, 0x6d76, 0x7cff,
-        0x9489, 0x8500, 0xb79b, 0xa612, 0xd2ad, 0xc324, 0xf1bf, 0xe036,
-        0x18c1, 0x0948, 0x3bd3, 0x2a5a, 0x5ee5, 0x4f6c, 0x7df7, 0x6c7e,
-        0xa50a, 0xb483, 0x8618, 0x9791, 0xe32e, 0xf2a7, 0xc03c, 0xd1b5,
-        0x2942, 0x38cb, 0x0a50, 0x1bd9, 0x6f66, 0x7eef, 0x4c74, 0x5dfd,
-        0xb58b, 0xa402, 0x9699, 0x8710, 0xf3af, 0xe226, 0xd0bd, 0xc134,
-        0x39c3, 0x284a, 0x1ad1, 0x0b58, 0x7fe7, 0x6e6e, 0x5cf5, 0x4d7c,
-        0xc60c, 0xd785, 0xe51e, 0xf497, 0x8028, 0x91a1, 0xa33a, 0xb2b3,
-        0x4a44, 0x5bcd, 0x6956, 0x78df, 0x0c60, 0x1de9, 0x2f72, 0x3efb,
-        0xd68d, 0xc704, 0xf59f, 0xe416, 0x90a9, 0x8120, 0xb3bb, 0xa232,
-        0x5ac5, 0x4b4c, 0x79d7, 0x685e, 0x1ce1, 0x0d68, 0x3ff3, 0x2e7a,
-        0xe70e, 0xf687, 0xc41c, 0xd595, 0xa12a, 0xb0a3, 0x8238, 0x93b1,
-        0x6b46, 0x7acf, 0x4854, 0x59dd, 0x2d62, 0x3ceb, 0x0e70, 0x1ff9,
-        0xf78f, 0xe606, 0xd49d, 0xc514, 0xb1ab, 0xa022, 0x92b9, 0x8330,
-        0x7bc7, 0x6a4e, 0x58d5, 0x495c, 0x3de3, 0x2c6a, 0x1ef1, 0x0f78
-    };
-    return (aFcs >> 8) ^ sFcsTable[(aFcs ^ aByte) & 0xff];
-#else
-	// CRC-16/CCITT-FALSE, same CRC as 802.15.4
-	// width=16 poly=0x1021 init=0xffff refin=false refout=false xorout=0x0000 check=0x29b1 name="CRC-16/CCITT-FALSE"
-	// http://reveng.sourceforge.net/crc-catalogue/16.htm#crc.cat.crc-16-ccitt-false
-	aFcs = (uint16_t)((aFcs >> 8) | (aFcs << 8));
-	aFcs ^= aByte;
-	aFcs ^= ((aFcs & 0xff) >> 4);
-	aFcs ^= (aFcs << 12);
-	aFcs ^= ((aFcs & 0xff) << 5);
-	return aFcs;
-#endif
+	return false;
 }
 
 char
@@ -147,7 +93,6 @@ SpinelNCPInstance::ncp_to_driver_pump()
 	struct nlpt*const pt = &mNCPToDriverPumpPT;
 //	unsigned int prop_key = 0;
 	unsigned int command_value = 0;
-	uint8_t byte;
 
 	// Automatically detect socket resets and behave accordingly.
 	if (mSerialAdapter->did_reset()) {
@@ -155,11 +100,17 @@ SpinelNCPInstance::ncp_to_driver_pump()
 		NLPT_INIT(&mNCPToDriverPumpPT);
 		NLPT_INIT(&mDriverToNCPPumpPT);
 
+		// Anything still staged predates the reset.
+		mInboundStagingLen = 0;
+		mInboundStagingOffset = 0;
+		hdlc_deframer_reset(&mInboundDeframer);
+
 		process_event(EVENT_NCP_CONN_RESET);
 	}
 
 	NLPT_BEGIN(pt);
 
+#if WPANTUND_SPINEL_USE_FLEN
 	// This macro abstracts the logic to read a single character into
 	// `data`, in a protothreads-friendly way.
 #define READ_CHARACTER(pt, data, on_fail) \
@@ -176,20 +127,30 @@ SpinelNCPInstance::ncp_to_driver_pump()
 		} \
 		break ; \
 	};
+#endif
 
 	while (!ncp_state_is_detached_from_ncp(get_ncp_state())) {
 		mInboundHeader = 0;
-		mInboundFrameSize = 0;
 
-		// Yield until the socket is readable. We do a
-		// yield here instead of a wait because we want to
-		// only handle one packet per run through the main loop.
-		// Using `YIELD` instead of `WAIT` guarantees that we
-		// will yield control of the protothread at least once,
-		// even if the socket is already readable.
-		NLPT_YIELD_UNTIL_READABLE_OR_COND(pt, mSerialAdapter->get_read_fd(), mSerialAdapter->can_read());
+		// Once this run through the main loop has used up its
+		// inbound frame or time budget we yield, so that the
+		// IPC servers and the tunnel interface get their turn.
+		// Anything still waiting behind us counts as starvation.
+		if (inbound_budget_exhausted()) {
+			if ((mInboundStagingOffset < mInboundStagingLen) || mSerialAdapter->can_read()) {
+				inbound_budget_did_starve();
+			}
+			NLPT_YIELD(pt);
+		}
 
 #if WPANTUND_SPINEL_USE_FLEN
+		mInboundFrameSize = 0;
+
+		// Wait until the socket is readable. The budget check
+		// above makes sure we still yield control of the
+		// protothread when frames keep arriving.
+		NLPT_WAIT_UNTIL_READABLE_OR_COND(pt, mSerialAdapter->get_read_fd(), mSerialAdapter->can_read());
+
 		do {
 			READ_CHARACTER(pt, (void*)&mInboundFrame[0], on_error);
 
@@ -238,88 +199,108 @@ SpinelNCPInstance::ncp_to_driver_pump()
 		);
 #else // if WPANTUND_SPINEL_USE_FLEN
 
-		mInboundFrameSize = 0;
-		mInboundFrameHDLCCRC = 0xffff;
+		// With the reader thread running, whole frames come off its
+		// ring. Otherwise deframe whatever is still sitting in the
+		// staging buffer before going back to the serial adapter for
+		// more. A single read can carry several frames, all of which
+		// get handled here without touching the socket again.
+		if (mReaderThread) {
+			ssize_t frame_len;
 
-		do {
-			READ_CHARACTER(pt, &byte, on_error);
+			frame_len = mReaderThread->pull_frame(mInboundFrame, sizeof(mInboundFrame), &mInboundFrameHDLCCRC);
 
-			if (byte == HDLC_BYTE_FLAG) {
-				break;
-			}
-			if (byte == HDLC_BYTE_ESC) {
-				READ_CHARACTER(pt, &byte, on_error);
-				if (byte == HDLC_BYTE_FLAG) {
-					break;
-				} else {
-					byte ^= HDLC_ESCAPE_XFORM;
-				}
+			if (frame_len == 0) {
+				NLPT_WAIT_UNTIL_READABLE_OR_COND(pt, mSerialAdapter->get_read_fd(), mSerialAdapter->can_read());
+				continue;
 			}
 
-			if (mInboundFrameSize >= 2) {
-				mInboundFrameHDLCCRC = hdlc_crc16(mInboundFrameHDLCCRC, mInboundFrame[mInboundFrameSize-2]);
+			if (frame_len < 0) {
+				syslog(LOG_ERR, "[-NCP-]: Socket error on read: %s %d",
+				       strerror((int)-frame_len), (int)(-frame_len));
+				signal_fatal_error(ERRORCODE_ERRNO);
+				goto on_error;
 			}
 
-			require(mInboundFrameSize < sizeof(mInboundFrame), on_error);
+			mInboundFrameSize = static_cast<spinel_size_t>(frame_len);
+
+		} else if (!hdlc_deframe_staged_bytes()) {
+			ssize_t read_len;
+
+			// Wait until the socket is readable. If more bytes are
+			// already queued up we go straight back for them; the
+			// budget check at the top of the loop is what hands
+			// control back to the main loop.
+			NLPT_WAIT_UNTIL_READABLE_OR_COND(pt, mSerialAdapter->get_read_fd(), mSerialAdapter->can_read());
 
-			mInboundFrame[mInboundFrameSize++] = byte;
+			read_len = mSerialAdapter->read(mInboundStagingBuffer, sizeof(mInboundStagingBuffer));
+
+			if (read_len < 0) {
+				syslog(LOG_ERR, "[-NCP-]: Socket error on read: %s %d",
+				       strerror((int)-read_len), (int)(-read_len));
+				signal_fatal_error(ERRORCODE_ERRNO);
+				goto on_error;
+			}
 
-		} while(true);
+			mInboundStagingLen = static_cast<size_t>(read_len);
+			mInboundStagingOffset = 0;
+			continue;
+		}
 
 		if (mInboundFrameSize <= 2) {
 			continue;
 		}
 
 		mInboundFrameSize -= 2;
-		mInboundFrameHDLCCRC ^= 0xFFFF;
 
 #if !FUZZING_BUILD_MODE_UNSAFE_FOR_PRODUCTION // Don't do CRC checks when in fuzzing mode
-		{
+		// The running CRC covers the frame check sequence as well, so
+		// an intact frame always leaves the same residue behind.
+		if (mInboundFrameHDLCCRC != HDLC_GOOD_FCS) {
 			uint16_t frame_crc = (mInboundFrame[mInboundFrameSize]|(mInboundFrame[mInboundFrameSize+1]<<8));
-			if (mInboundFrameHDLCCRC != frame_crc) {
-
-				int i;
-				static const uint8_t kAsciiCR = 13;
-				static const uint8_t kAsciiBEL = 7;
-
-				syslog(LOG_ERR, "[NCP->]: Frame CRC Mismatch: Calc:0x%04X != Frame:0x%04X, Garbage on line?", mInboundFrameHDLCCRC, frame_crc);
-
-				// This frame might be an ASCII backtrace, so we check to
-				// see if all of the characters are ascii characters, and if
-				// so we dump out this packet directly to syslog.
-
-				mInboundFrameSize += 2;
-
-				for (i = 0; i < mInboundFrameSize; i++) {
-					// Acceptable control codes
-					if (mInboundFrame[i] >= kAsciiBEL && mInboundFrame[i] <= kAsciiCR) {
-						continue;
-					}
-					// NUL characters are OK.
-					if (mInboundFrame[i] == 0) {
-						continue;
-					}
-					// Acceptable characters
-					if (mInboundFrame[i] >= 32 && mInboundFrame[i] <= 127) {
-						continue;
-					}
-
-					syslog(LOG_ERR, "[NCP->]: Garbage is not ASCII ([%d]=%d)", i, mInboundFrame[i]);
-					break;
-				}
+			uint16_t calc_crc = hdlc_crc16_block(0xffff, mInboundFrame, mInboundFrameSize) ^ 0xFFFF;
+			spinel_size_t i;
+			static const uint8_t kAsciiCR = 13;
+			static const uint8_t kAsciiBEL = 7;
+
+			syslog(LOG_ERR, "[NCP->]: Frame CRC Mismatch: Calc:0x%04X != Frame:0x%04X, Garbage on line?", calc_crc, frame_crc);
+
+			// This frame might be an ASCII backtrace, so we check to
+			// see if all of the characters are ascii characters, and if
+			// so we dump out this packet directly to syslog.
 
-				if (i == mInboundFrameSize) {
-					handle_ncp_debug_stream(mInboundFrame, mInboundFrameSize);
+			mInboundFrameSize += 2;
+
+			for (i = 0; i < mInboundFrameSize; i++) {
+				// Acceptable control codes
+				if (mInboundFrame[i] >= kAsciiBEL && mInboundFrame[i] <= kAsciiCR) {
+					continue;
+				}
+				// NUL characters are OK.
+				if (mInboundFrame[i] == 0) {
+					continue;
+				}
+				// Acceptable characters
+				if (mInboundFrame[i] >= 32 && mInboundFrame[i] <= 127) {
+					continue;
 				}
 
-				continue;
+				syslog(LOG_ERR, "[NCP->]: Garbage is not ASCII ([%u]=%d)", i, mInboundFrame[i]);
+				break;
+			}
+
+			if (i == mInboundFrameSize) {
+				handle_ncp_debug_stream(mInboundFrame, mInboundFrameSize);
 			}
+
+			continue;
 		}
 
 #endif // !FUZZING_BUILD_MODE_UNSAFE_FOR_PRODUCTION
 
 #endif // else WPANTUND_SPINEL_USE_FLEN
 
+		mInboundFrameCount++;
+
 		if (pt->last_errno) {
 			syslog(LOG_ERR, "[-NCP-]: Socket error on read: %s", strerror(pt->last_errno));
 			errno = pt->last_errno;
@@ -337,7 +318,7 @@ SpinelNCPInstance::ncp_to_driver_pump()
 		mInboundFrameSize = dataLen;
 #endif // OPENTHREAD_ENABLE_NCP_SPINEL_ENCRYPTER
 
-		if (spinel_datatype_unpack(mInboundFrame, mInboundFrameSize, "Ci", &mInboundHeader, &command_value) > 0) {
+		if (spinel::Frame<uint8_t, spinel::PackedUint>::decode(mInboundFrame, mInboundFrameSize, &mInboundHeader, &command_value) > 0) {
 			if ((mInboundHeader&SPINEL_HEADER_FLAG) != SPINEL_HEADER_FLAG) {
 				// Unrecognized frame.
 				syslog(LOG_ERR, "[-NCP-]: Unrecognized frame (0x%02X)", mInboundHeader);
@@ -354,17 +335,6 @@ SpinelNCPInstance::ncp_to_driver_pump()
 
 			log_spinel_frame(kNCPToDriver, mInboundFrame, mInboundFrameSize);
 
-			#if SPINEL_DATA_DUMP_TO_FILE == 1
-				// Print each hex byte to be sent out
-				int bufferIndex;
-				for(bufferIndex = 0; bufferIndex < mInboundFrameSize; bufferIndex++) {
-					NCPToDriverDump << std::hex << mInboundFrame[bufferIndex] / 16;
-					NCPToDriverDump << std::hex << mInboundFrame[bufferIndex] % 16;
-					NCPToDriverDump << " ";
-				}
-				NCPToDriverDump << std::endl;
-			#endif
-
 			handle_ncp_spinel_callback(command_value, mInboundFrame, mInboundFrameSize);
 		}
 	} // while (!ncp_state_is_detached_from_ncp(get_ncp_state()))
@@ -375,6 +345,258 @@ on_error:;
 	NLPT_END(pt);
 }
 
+bool
+SpinelNCPInstance::outbound_queue_has_room(OutboundFrameClass frame_class) const
+{
+	const OutboundQueue& queue = mOutboundQueue[frame_class];
+
+	return !queue.mFrames.full()
+	    && (queue.mFrameBytes.space_available() >= static_cast<int>(sizeof(mOutboundBufferEscaped)));
+}
+
+bool
+SpinelNCPInstance::outbound_queues_empty(void) const
+{
+	for (int i = 0; i < kOutboundFrameClassCount; i++) {
+		if (!mOutboundQueue[i].mFrames.empty()) {
+			return false;
+		}
+	}
+	return true;
+}
+
+// Frames the given spinel frame and appends it to the queue for
+// `frame_class`. The frame is transformed in place when the spinel
+// encrypter is enabled, which is why the size of the buffer holding
+// it is needed. `has_callback` marks the frame `mOutboundCallback` is
+// waiting on. The caller must have checked that there is room.
+bool
+SpinelNCPInstance::enqueue_outbound_frame(OutboundFrameClass frame_class, uint8_t *frame_ptr, spinel_ssize_t frame_len,
+	size_t frame_buffer_size, bool has_callback)
+{
+	OutboundQueue& queue = mOutboundQueue[frame_class];
+	OutboundFrameInfo info;
+	uint8_t header = 0;
+	unsigned int command = 0;
+
+#if VERBOSE_DEBUG
+	// Very verbose debugging. Dumps out all outbound packets.
+	{
+		char readable_buffer[300];
+		encode_data_into_string(frame_ptr,
+		                        frame_len,
+		                        readable_buffer,
+		                        sizeof(readable_buffer),
+		                        0);
+		syslog(LOG_DEBUG, "\t↳ %s", (const char*)readable_buffer);
+	}
+#endif // VERBOSE_DEBUG
+
+	(void)spinel::Frame<uint8_t, spinel::PackedUint>::decode(frame_ptr, frame_len, &header, &command);
+
+	memset(&info, 0, sizeof(info));
+	info.mClass = frame_class;
+	info.mEnqueueTime = time_ms();
+	info.mHasCallback = has_callback;
+	info.mIsReset = (command == SPINEL_CMD_RESET);
+
+#if WPANTUND_SPINEL_USE_FLEN
+	(void)frame_buffer_size;
+
+	mOutboundBufferEscaped[0] = HDLC_BYTE_FLAG;
+	mOutboundBufferEscaped[1] = (frame_len >> 8);
+	mOutboundBufferEscaped[2] = (frame_len & 0xFF);
+	memcpy(&mOutboundBufferEscaped[3], frame_ptr, frame_len);
+	mOutboundBufferEscapedLen = frame_len + 3;
+#else
+
+	{
+#if OPENTHREAD_ENABLE_NCP_SPINEL_ENCRYPTER
+		size_t dataLen = frame_len;
+		if (!SpinelEncrypter::EncryptOutbound(frame_ptr, frame_buffer_size, &dataLen))
+		{
+			syslog(LOG_ERR, "[-NCP-]: Unable to transform outbound data");
+			return false;
+		}
+		frame_len = dataLen;
+#else
+		(void)frame_buffer_size;
+#endif // OPENTHREAD_ENABLE_NCP_SPINEL_ENCRYPTER
+
+		mOutboundBufferEscaped[0] = HDLC_BYTE_FLAG;
+		mOutboundBufferEscapedLen = 1 + hdlc_encode(&mOutboundBufferEscaped[1], frame_ptr, frame_len);
+		mOutboundBufferEscaped[mOutboundBufferEscapedLen++] = HDLC_BYTE_FLAG;
+	}
+
+#endif // WPANTUND_SPINEL_USE_FLEN
+
+	info.mLength = mOutboundBufferEscapedLen;
+
+	queue.mFrameBytes.push(mOutboundBufferEscaped, mOutboundBufferEscapedLen);
+	queue.mFrames.write(info);
+
+	return true;
+}
+
+// Reads one IPv6 packet from the tunnel interface(s) and queues it as
+// a data frame. Returns -1 on a fatal read error, 0 otherwise, even if
+// the packet ended up being filtered out.
+int
+SpinelNCPInstance::read_outbound_data_frame(void)
+{
+	spinel_ssize_t len = 0;
+
+	if (mPrimaryInterface->can_read()) {
+		len = (spinel_ssize_t)mPrimaryInterface->read(
+			&mOutboundDataBuffer[kStreamNetHeaderLen],
+			sizeof(mOutboundDataBuffer) - kStreamNetHeaderLen
+		);
+		mOutboundDataBufferType = FRAME_TYPE_DATA;
+	} else if (static_cast<bool>(mLegacyInterface)) {
+		len = (spinel_ssize_t)mLegacyInterface->read(
+			&mOutboundDataBuffer[kStreamNetHeaderLen],
+			sizeof(mOutboundDataBuffer) - kStreamNetHeaderLen
+		);
+		mOutboundDataBufferType = FRAME_TYPE_LEGACY_DATA;
+	}
+
+	if (0 > len) {
+		syslog(LOG_ERR,
+		       "driver_to_ncp_pump: Socket error on read: %s",
+		       strerror(errno));
+		signal_fatal_error(ERRORCODE_ERRNO);
+		return -1;
+	}
+
+	if (len == 0) {
+		// No packet...?
+		return 0;
+	}
+
+	if (!should_forward_ncpbound_frame(&mOutboundDataBufferType, &mOutboundDataBuffer[kStreamNetHeaderLen], len)) {
+		return 0;
+	}
+
+	if (get_ncp_state() == CREDENTIALS_NEEDED) {
+		mOutboundDataBufferType = FRAME_TYPE_INSECURE_DATA;
+	}
+
+	{
+		uint8_t header = SPINEL_HEADER_FLAG | SPINEL_HEADER_IID_0;
+		unsigned int prop_key = SPINEL_PROP_STREAM_NET;
+
+		if (mOutboundDataBufferType == FRAME_TYPE_INSECURE_DATA) {
+			prop_key = SPINEL_PROP_STREAM_NET_INSECURE;
+
+		} else if (mOutboundDataBufferType != FRAME_TYPE_DATA) {
+			header = SPINEL_HEADER_FLAG | SPINEL_HEADER_IID_1;
+		}
+
+		StreamNetHeader::encode(mOutboundDataBuffer, kStreamNetHeaderLen,
+			header, SPINEL_CMD_PROP_VALUE_SET, prop_key, static_cast<uint16_t>(len));
+	}
+
+	len += kStreamNetHeaderLen;
+
+	log_spinel_frame(kDriverToNCP, mOutboundDataBuffer, len);
+
+	if (!enqueue_outbound_frame(kOutboundFrameClassData, mOutboundDataBuffer, len, sizeof(mOutboundDataBuffer), false)) {
+		mOutboundQueue[kOutboundFrameClassData].mDropCount++;
+	}
+
+	return 0;
+}
+
+// Moves as many whole frames as will fit into `mOutboundBatchBuffer`,
+// taking every queued control frame before any data frame.
+void
+SpinelNCPInstance::prepare_outbound_batch(void)
+{
+	mOutboundBatchLen = 0;
+	mOutboundBatchCount = 0;
+
+	for (int i = 0; i < kOutboundFrameClassCount; i++) {
+		OutboundQueue& queue = mOutboundQueue[i];
+
+		while (!queue.mFrames.empty() && (mOutboundBatchCount < SPINEL_OUTBOUND_BATCH_MAX_FRAMES)) {
+			const OutboundFrameInfo* info = queue.mFrames.front();
+
+			if (mOutboundBatchLen + info->mLength > static_cast<spinel_ssize_t>(sizeof(mOutboundBatchBuffer))) {
+				return;
+			}
+
+			queue.mFrameBytes.pull(&mOutboundBatchBuffer[mOutboundBatchLen], info->mLength);
+			mOutboundBatchLen += info->mLength;
+			mOutboundBatch[mOutboundBatchCount++] = *info;
+			queue.mFrames.remove();
+
+			// The NCP won't be around to hear anything sent after a reset.
+			if (mOutboundBatch[mOutboundBatchCount - 1].mIsReset) {
+				return;
+			}
+		}
+	}
+}
+
+// Accounts for the frames of the batch which was just written. Returns
+// true if the batch carried the frame `mOutboundCallback` is waiting on.
+bool
+SpinelNCPInstance::complete_outbound_batch(void)
+{
+	const cms_t now = time_ms();
+	bool has_callback = false;
+
+	for (int i = 0; i < mOutboundBatchCount; i++) {
+		const OutboundFrameInfo& info = mOutboundBatch[i];
+		OutboundQueue& queue = mOutboundQueue[info.mClass];
+		cms_t latency = now - info.mEnqueueTime;
+
+		queue.mSentCount++;
+		queue.mLatencySum += latency;
+		if (latency > queue.mLatencyMax) {
+			queue.mLatencyMax = latency;
+		}
+
+		has_callback |= info.mHasCallback;
+
+#if HAVE_LIBUDEV
+		if (info.mIsReset) {
+			hard_reset_ncp();
+		}
+#endif
+	}
+
+	mOutboundBatchLen = 0;
+	mOutboundBatchCount = 0;
+
+	return has_callback;
+}
+
+// Throws away everything still queued. If the pending command was among
+// the dropped frames, its callback is fired with `status`.
+void
+SpinelNCPInstance::flush_outbound_queues(int status)
+{
+	bool has_callback = false;
+
+	for (int i = 0; i < kOutboundFrameClassCount; i++) {
+		OutboundQueue& queue = mOutboundQueue[i];
+
+		while (!queue.mFrames.empty()) {
+			queue.mDropCount++;
+			has_callback |= queue.mFrames.front()->mHasCallback;
+			queue.mFrames.remove();
+		}
+
+		queue.mFrameBytes.clear();
+	}
+
+	if (has_callback && !mOutboundCallback.empty()) {
+		mOutboundCallback(status);
+		mOutboundCallback.clear();
+	}
+}
+
 char
 SpinelNCPInstance::driver_to_ncp_pump()
 {
@@ -382,15 +604,12 @@ SpinelNCPInstance::driver_to_ncp_pump()
 
 	NLPT_BEGIN(pt);
 
-	while (!ncp_state_is_detached_from_ncp(get_ncp_state())) {
-		// If there is an outbound callback at this
-		// point, then we assume it is stale and
-		// immediately clear it out.
-		if (!mOutboundCallback.empty()) {
-			mOutboundCallback(kWPANTUNDStatus_Canceled);
-			mOutboundCallback.clear();
-		}
+	// Anything still queued at this point was meant for an
+	// NCP session which is gone, so get rid of it.
+	flush_outbound_queues(kWPANTUNDStatus_Canceled);
+	mOutboundPumpIsIdle = false;
 
+	while (!ncp_state_is_detached_from_ncp(get_ncp_state())) {
 		// Wait for a packet to be available from interface OR management queue.
 		if (mOutboundBufferLen > 0) {
 			// If there is something in the outbound queue,
@@ -398,111 +617,80 @@ SpinelNCPInstance::driver_to_ncp_pump()
 			// will delay processing.
 
 #if FUZZING_BUILD_MODE_UNSAFE_FOR_PRODUCTION
+		} else if (!outbound_queues_empty()) {
+			NLPT_YIELD(pt);
+
 		} else {
-			NLPT_YIELD_UNTIL(pt,(mOutboundBufferLen > 0));
+			mOutboundPumpIsIdle = true;
+			NLPT_YIELD_UNTIL(pt,(mOutboundBufferLen > 0) || !outbound_queues_empty());
 		}
 #else
+		} else if (!outbound_queues_empty()) {
+			// Frames are still queued from the last pass. Give
+			// the rest of the main loop a turn, and wait for the
+			// NCP to be able to take the next batch.
+			NLPT_YIELD_UNTIL_WRITABLE_OR_COND(
+				pt,
+				mSerialAdapter->get_write_fd(),
+				(mOutboundBufferLen > 0)
+			);
+
 		} else if (static_cast<bool>(mLegacyInterface) && is_legacy_interface_enabled()) {
+			mOutboundPumpIsIdle = true;
 			NLPT_YIELD_UNTIL_READABLE2_OR_COND(
 				pt,
 				mPrimaryInterface->get_read_fd(),
 				mLegacyInterface->get_read_fd(),
 				(mOutboundBufferLen > 0)
+				|| !outbound_queues_empty()
 				|| mLegacyInterface->can_read()
 				|| mPrimaryInterface->can_read()
 			);
 
 		} else {
+			mOutboundPumpIsIdle = true;
 			NLPT_YIELD_UNTIL_READABLE_OR_COND(
 				pt,
 				mPrimaryInterface->get_read_fd(),
-				mPrimaryInterface->can_read() || (mOutboundBufferLen > 0)
+				mPrimaryInterface->can_read() || (mOutboundBufferLen > 0) || !outbound_queues_empty()
 			);
 		}
 #endif
 
-		// Get packet or management command, and also
-		// perform any necessary filtering.
-		if (mOutboundBufferLen > 0) {
+		mOutboundPumpIsIdle = false;
+
+		// Queue up the management command, if there is one. The
+		// command buffer is only released once the frame is
+		// queued, which is what holds off the next command.
+		if ((mOutboundBufferLen > 0) && outbound_queue_has_room(kOutboundFrameClassControl)) {
 			log_spinel_frame(kDriverToNCP, mOutboundBuffer, mOutboundBufferLen);
-		} else {
-			// There is an IPv6 packet waiting on one of the tunnel interfaces.
-
-			if (mPrimaryInterface->can_read()) {
-				mOutboundBufferLen = (spinel_ssize_t)mPrimaryInterface->read(
-					&mOutboundBuffer[5],
-					sizeof(mOutboundBuffer)-5
-				);
-				mOutboundBufferType = FRAME_TYPE_DATA;
-			} else if (static_cast<bool>(mLegacyInterface)) {
-				mOutboundBufferLen = (spinel_ssize_t)mLegacyInterface->read(
-					&mOutboundBuffer[5],
-					sizeof(mOutboundBuffer)-5
-				);
-				mOutboundBufferType = FRAME_TYPE_LEGACY_DATA;
-			}
 
-			if (0 > mOutboundBufferLen) {
-				syslog(LOG_ERR,
-				       "driver_to_ncp_pump: Socket error on read: %s",
-				       strerror(errno));
-				signal_fatal_error(ERRORCODE_ERRNO);
+			if (!enqueue_outbound_frame(kOutboundFrameClassControl, mOutboundBuffer, mOutboundBufferLen,
+			                            sizeof(mOutboundBuffer), !mOutboundCallback.empty())) {
 				break;
 			}
 
-			if (mOutboundBufferLen <= 0) {
-				// No packet...?
-				mOutboundBufferLen = 0;
-				continue;
-			}
-
-			if (!should_forward_ncpbound_frame(&mOutboundBufferType, &mOutboundBuffer[5], mOutboundBufferLen)) {
-				mOutboundBufferLen = 0;
-				continue;
-			}
-
-			if (get_ncp_state() == CREDENTIALS_NEEDED) {
-				mOutboundBufferType = FRAME_TYPE_INSECURE_DATA;
-			}
-
-			mOutboundBuffer[3] = (mOutboundBufferLen & 0xFF);
-			mOutboundBuffer[4] = ((mOutboundBufferLen >> 8) & 0xFF);
-
-			mOutboundBufferLen += 5;
-
-			mOutboundBuffer[0] = SPINEL_HEADER_FLAG | SPINEL_HEADER_IID_0;
-			mOutboundBuffer[1] = SPINEL_CMD_PROP_VALUE_SET;
-
-			if (mOutboundBufferType == FRAME_TYPE_DATA) {
-				mOutboundBuffer[2] = SPINEL_PROP_STREAM_NET;
-
-			} else if (mOutboundBufferType == FRAME_TYPE_INSECURE_DATA) {
-				mOutboundBuffer[2] = SPINEL_PROP_STREAM_NET_INSECURE;
-
-			} else {
-				mOutboundBuffer[0] = SPINEL_HEADER_FLAG | SPINEL_HEADER_IID_1;
-				mOutboundBuffer[2] = SPINEL_PROP_STREAM_NET;
-			}
+			mOutboundBufferLen = 0;
 		}
 
-#if VERBOSE_DEBUG
-		// Very verbose debugging. Dumps out all outbound packets.
-		{
-			char readable_buffer[300];
-			encode_data_into_string(mOutboundBuffer,
-			                        mOutboundBufferLen,
-			                        readable_buffer,
-			                        sizeof(readable_buffer),
-			                        0);
-			syslog(LOG_DEBUG, "\t↳ %s", (const char*)readable_buffer);
+#if !FUZZING_BUILD_MODE_UNSAFE_FOR_PRODUCTION
+		// Drain whatever IPv6 packets are waiting on the tunnel
+		// interfaces, for as long as there is room to queue them.
+		// Once the queue is full we leave them with the kernel.
+		while (outbound_queue_has_room(kOutboundFrameClassData)
+		  && ( mPrimaryInterface->can_read()
+		    || (static_cast<bool>(mLegacyInterface) && mLegacyInterface->can_read())
+		  )
+		) {
+			require_noerr(read_outbound_data_frame(), on_error);
 		}
-#endif // VERBOSE_DEBUG
+#endif
 
+		if (outbound_queues_empty()) {
+			continue;
+		}
 
-#if WPANTUND_SPINEL_USE_FLEN
-		mOutboundBufferHeader[0] = HDLC_BYTE_FLAG;
-		mOutboundBufferHeader[1] = (mOutboundBufferLen >> 8);
-		mOutboundBufferHeader[2] = (mOutboundBufferLen & 0xFF);
+		prepare_outbound_batch();
 
 		mOutboundBufferSent = 0;
 
@@ -510,116 +698,28 @@ SpinelNCPInstance::driver_to_ncp_pump()
 		NLPT_ASYNC_WRITE_STREAM(
 			pt,
 			mSerialAdapter.get(),
-			mOutboundBufferHeader,
-			mOutboundBufferLen + sizeof(mOutboundBufferHeader)
+			mOutboundBatchBuffer,
+			mOutboundBatchLen
 		);
 		mOutboundBufferSent += pt->byte_count;
-#else
 
-		#if SPINEL_DATA_DUMP_TO_FILE == 1
-			// Print each hex byte to be sent out
-			int bufferIndex;
-			for(bufferIndex = 0; bufferIndex < mOutboundBufferLen; bufferIndex++) {
-				DriverToNCPDump << std::hex << mOutboundBuffer[bufferIndex] / 16;
-				DriverToNCPDump << std::hex << mOutboundBuffer[bufferIndex] % 16;
-				DriverToNCPDump << " ";
-			}
-			DriverToNCPDump << std::endl;
-		#endif
-
-		mOutboundBufferEscapedLen = 1;
-		mOutboundBufferEscaped[0] = HDLC_BYTE_FLAG;
-		{
-			spinel_ssize_t i;
-			uint8_t byte;
-			uint16_t crc(0xFFFF);
-
-#if OPENTHREAD_ENABLE_NCP_SPINEL_ENCRYPTER
-			size_t dataLen = mOutboundBufferLen;
-			if (!SpinelEncrypter::EncryptOutbound(mOutboundBuffer, sizeof(mOutboundBuffer), &dataLen))
-			{
-				syslog(LOG_ERR, "[-NCP-]: Unable to transform outbound data");
-				break;
+		if (complete_outbound_batch() && (pt->last_errno == 0)) {
+			// Go ahead and fire off the "did send" callback.
+			if (!mOutboundCallback.empty()) {
+				mOutboundCallback(kWPANTUNDStatus_Ok);
+				mOutboundCallback.clear();
 			}
-			mOutboundBufferLen = dataLen;
-#endif // OPENTHREAD_ENABLE_NCP_SPINEL_ENCRYPTER
-
-			for (i = 0; i < mOutboundBufferLen; i++) {
-				byte = mOutboundBuffer[i];
-				crc = hdlc_crc16(crc, byte);
-				if (hdlc_byte_needs_escape(byte)) {
-					mOutboundBufferEscaped[mOutboundBufferEscapedLen++] = HDLC_BYTE_ESC;
-					mOutboundBufferEscaped[mOutboundBufferEscapedLen++] = byte ^ HDLC_ESCAPE_XFORM;
-				} else {
-					mOutboundBufferEscaped[mOutboundBufferEscapedLen++] = byte;
-				}
-			}
-			crc ^= 0xFFFF;
-			byte = (crc & 0xFF);
-			if (hdlc_byte_needs_escape(byte)) {
-				mOutboundBufferEscaped[mOutboundBufferEscapedLen++] = HDLC_BYTE_ESC;
-				mOutboundBufferEscaped[mOutboundBufferEscapedLen++] = byte ^ HDLC_ESCAPE_XFORM;
-			} else {
-				mOutboundBufferEscaped[mOutboundBufferEscapedLen++] = byte;
-			}
-			byte = ((crc>>8) & 0xFF);
-			if (hdlc_byte_needs_escape(byte)) {
-				mOutboundBufferEscaped[mOutboundBufferEscapedLen++] = HDLC_BYTE_ESC;
-				mOutboundBufferEscaped[mOutboundBufferEscapedLen++] = byte ^ HDLC_ESCAPE_XFORM;
-			} else {
-				mOutboundBufferEscaped[mOutboundBufferEscapedLen++] = byte;
-			}
-			mOutboundBufferEscaped[mOutboundBufferEscapedLen++] = HDLC_BYTE_FLAG;
 		}
 
-		mOutboundBufferSent = 0;
-
-		#if SPINEL_DATA_DUMP_TO_FILE == 1
-			// Print each hex byte that is getting sent
-			for(bufferIndex = 0; bufferIndex < mOutboundBufferEscapedLen; bufferIndex++) {
-				DriverToNCPDump << std::hex << mOutboundBufferEscaped[bufferIndex] / 16;
-				DriverToNCPDump << std::hex << mOutboundBufferEscaped[bufferIndex] % 16;
-				DriverToNCPDump << " ";
-			}
-			DriverToNCPDump << std::endl << std::endl;
-			DriverToNCPDump.close();
-		#endif
-
-		// Go ahead send
-		NLPT_ASYNC_WRITE_STREAM(
-			pt,
-			mSerialAdapter.get(),
-			mOutboundBufferEscaped,
-			mOutboundBufferEscapedLen
-		);
-		mOutboundBufferSent += pt->byte_count;
-#endif
-
-#if HAVE_LIBUDEV
-		uint8_t header = 0;
-		unsigned int command = 0;
-		(void)spinel_datatype_unpack(mOutboundBuffer, mOutboundBufferLen, "CiD", &header,
-					     &command, NULL, 0);
-		if (command == SPINEL_CMD_RESET) {
-			hard_reset_ncp();
-		}
-#endif
-
-		mOutboundBufferLen = 0;
-
 		require(pt->last_errno == 0, on_error);
 
-		// Go ahead and fire off the "did send" callback.
-		if (!mOutboundCallback.empty()) {
-			mOutboundCallback(kWPANTUNDStatus_Ok);
-			mOutboundCallback.clear();
-		}
-
 	} // while(true)
 
 on_error:
 	// If we get here, we will restart the protothread at the next iteration.
 
+	flush_outbound_queues(kWPANTUNDStatus_Failure);
+
 	if (!mOutboundCallback.empty()) {
 		mOutboundCallback(kWPANTUNDStatus_Failure);
 		mOutboundCallback.clear();
@@ -298,6 +298,7 @@ SpinelNCPInstance::vprocess_init(int event, va_list args)
 		if (mDriverState == INITIALIZING) {
 			syslog(LOG_ERR, "Unexpected reset during NCP initialization.");
 			mFailureCount++;
+			mInitGeneration++;
 			PT_INIT(&mSubPT);
 		} else if (mDriverState == INITIALIZING_WAITING_FOR_RESET) {
 			mDriverState = INITIALIZING;
@@ -329,6 +330,8 @@ SpinelNCPInstance::vprocess_init(int event, va_list args)
 
 	syslog(LOG_INFO, "Initializing NCP");
 
+	mInitStartTime = time_ms();
+
 	set_initializing_ncp(true);
 
 	change_ncp_state(UNINITIALIZED);
@@ -364,6 +367,10 @@ SpinelNCPInstance::vprocess_init(int event, va_list args)
 	mAsyncChList = "";
 	mDodagRouteDest = "";
 
+	// Until the NCP reports them again, answer with the last known values.
+	mPropertyCache.begin_revalidation();
+	replay_property_cache();
+
 	mDriverState = INITIALIZING_WAITING_FOR_RESET;
 
 	if (mResetIsExpected) {
@@ -501,71 +508,47 @@ SpinelNCPInstance::vprocess_init(int event, va_list args)
 				{ SPINEL_PROP_NET_NETWORK_NAME, 0 },
 			};
 
-			for (mSubPTIndex = 0; mSubPTIndex < sizeof(props_to_fetch) / sizeof(props_to_fetch[0]); mSubPTIndex++) {
-				if ((props_to_fetch[mSubPTIndex].capability != 0)
-					&& !mCapabilities.count(props_to_fetch[mSubPTIndex].capability)
+			mInitCommands.clear();
+
+			for (size_t i = 0; i < sizeof(props_to_fetch) / sizeof(props_to_fetch[0]); i++) {
+				if ((props_to_fetch[i].capability != 0)
+					&& !mCapabilities.count(props_to_fetch[i].capability)
 				) {
 					continue;
 				}
 
-				CONTROL_REQUIRE_PREP_TO_SEND_COMMAND_WITHIN(NCP_DEFAULT_COMMAND_SEND_TIMEOUT, on_error);
-				GetInstance(this)->mOutboundBufferLen = spinel_cmd_prop_value_get(
-					GetInstance(this)->mOutboundBuffer, sizeof(GetInstance(this)->mOutboundBuffer),
-					props_to_fetch[mSubPTIndex].property);
-				CONTROL_REQUIRE_OUTBOUND_BUFFER_FLUSHED_WITHIN(NCP_DEFAULT_COMMAND_SEND_TIMEOUT, on_error);
-#ifndef TI_WISUN_FAN
-				/* Known Issue: Junk Char Observed at start of wfantund */
-				CONTROL_REQUIRE_COMMAND_RESPONSE_WITHIN(NCP_DEFAULT_COMMAND_RESPONSE_TIMEOUT, on_error);
-#endif
-
-				status = peek_ncp_callback_status(event, args);
-
-				if (status != 0) {
-					syslog(LOG_WARNING, "Unsuccessful fetching property %s from NCP: \"%s\" (%d)",
-						spinel_prop_key_to_cstr(props_to_fetch[mSubPTIndex].property),
-						spinel_status_to_cstr(static_cast<spinel_status_t>(status)), status);
-				}
+				mInitCommands.push_back(InitCommand(
+					SpinelPackData(SPINEL_FRAME_PACK_CMD_PROP_VALUE_GET, props_to_fetch[i].property),
+					spinel_prop_key_to_cstr(props_to_fetch[i].property)
+				));
 			}
 
 			// Restore all the saved settings
-			for (mSettingsIter = mSettings.begin(); mSettingsIter != mSettings.end(); mSettingsIter++) {
+			for (SettingsMap::iterator iter = mSettings.begin(); iter != mSettings.end(); iter++) {
 
-				syslog(LOG_NOTICE, "Restoring property \"%s\" on NCP", mSettingsIter->first.c_str());
+				syslog(LOG_NOTICE, "Restoring property \"%s\" on NCP", iter->first.c_str());
 
 				// Skip the settings if capability is not present.
-				if ((mSettingsIter->second.mCapability != 0) &&!mCapabilities.count(mSettingsIter->second.mCapability)) {
+				if ((iter->second.mCapability != 0) && !mCapabilities.count(iter->second.mCapability)) {
 					continue;
 				}
 
-				CONTROL_REQUIRE_PREP_TO_SEND_COMMAND_WITHIN(NCP_DEFAULT_COMMAND_SEND_TIMEOUT, on_error);
-
-				if (mSettingsIter->second.mSpinelCommand.size() > sizeof(GetInstance(this)->mOutboundBuffer))
+				if (iter->second.mSpinelCommand.size() > sizeof(GetInstance(this)->mOutboundBuffer))
 				{
 					syslog(LOG_WARNING,
 						"Spinel command for restoring property \"%s\" does not fit in outbound buffer (require %d bytes but only %u bytes available)",
-						mSettingsIter->first.c_str(),
-						(int)mSettingsIter->second.mSpinelCommand.size(),
+						iter->first.c_str(),
+						(int)iter->second.mSpinelCommand.size(),
 						(unsigned int)sizeof(GetInstance(this)->mOutboundBuffer)
 					);
 
 					continue;
 				}
 
-				GetInstance(this)->mOutboundBufferLen = (spinel_ssize_t)mSettingsIter->second.mSpinelCommand.size();
-				memcpy(GetInstance(this)->mOutboundBuffer, mSettingsIter->second.mSpinelCommand.data(), mSettingsIter->second.mSpinelCommand.size());
-
-				CONTROL_REQUIRE_OUTBOUND_BUFFER_FLUSHED_WITHIN(NCP_DEFAULT_COMMAND_SEND_TIMEOUT, on_error);
-#ifndef TI_WISUN_FAN
-				/* Known Issue: Junk Char Observed at start of wfantund */
-				CONTROL_REQUIRE_COMMAND_RESPONSE_WITHIN(NCP_DEFAULT_COMMAND_RESPONSE_TIMEOUT, on_error);
-#endif
-
-				status = peek_ncp_callback_status(event, args);
-
-				if (status != 0) {
-					syslog(LOG_WARNING, "Unsuccessful in restoring property \"%s\" on NCP: \"%s\" (%d)", mSettingsIter->first.c_str(), spinel_status_to_cstr(static_cast<spinel_status_t>(status)), status);
-				}
+				mInitCommands.push_back(InitCommand(iter->second.mSpinelCommand, iter->first, true));
 			}
+
+			EH_SPAWN(&mInitCommandsPT, vprocess_init_commands(event, args));
 		}
 
 		break;
@@ -585,7 +568,117 @@ on_error:
 	set_initializing_ncp(false);
 	mDriverState = NORMAL_OPERATION;
 
-	syslog(LOG_NOTICE, "Finished initializing NCP");
+	mInitDuration = time_ms() - mInitStartTime;
+
+	syslog(LOG_NOTICE, "Finished initializing NCP in %d ms", static_cast<int>(mInitDuration));
+
+	if (mEnabled) {
+		property_cache_did_revalidate();
+	}
+
+	EH_END();
+}
+
+bool
+SpinelNCPInstance::can_send_init_command(void) const
+{
+	return (mInitCommandsInFlight < SPINEL_INIT_MAX_COMMANDS_IN_FLIGHT)
+		&& (mTransactionCount < SPINEL_MAX_TRANSACTIONS)
+		&& outbound_queue_has_room(kOutboundFrameClassControl);
+}
+
+void
+SpinelNCPInstance::init_command_did_finish(int status, const boost::any& value, unsigned int generation, const InitCommand& command)
+{
+	// Left over from an initialization which has since been restarted.
+	if (generation != mInitGeneration) {
+		return;
+	}
+
+	mInitCommandsInFlight--;
+
+	if (status != kWPANTUNDStatus_Ok) {
+		mInitFailedCommands.push_back(command);
+	}
+}
+
+// Sends every command in `mInitCommands`, keeping up to
+// SPINEL_INIT_MAX_COMMANDS_IN_FLIGHT of them waiting on a reply at any
+// time. Replies update the instance through handle_ncp_spinel_value_is()
+// like any other. Once everything has been answered (or has timed out),
+// the commands which failed are sent once more. TI_WISUN_FAN builds do
+// not wait for the replies at all, as before.
+int
+SpinelNCPInstance::vprocess_init_commands(int event, va_list args)
+{
+	EH_BEGIN_SUB(&mInitCommandsPT);
+
+	mInitGeneration++;
+	mInitCommandsInFlight = 0;
+	mInitRetryCount = 0;
+	mInitFailedCommands.clear();
+
+#ifndef TI_WISUN_FAN
+	for (mInitRound = 0; mInitRound <= SPINEL_INIT_MAX_RETRIES; mInitRound++) {
+		if (mInitRound > 0) {
+			if (mInitFailedCommands.empty()) {
+				break;
+			}
+
+			syslog(LOG_NOTICE, "Retrying %d command(s) which failed during initialization", (int)mInitFailedCommands.size());
+
+			mInitRetryCount += static_cast<int>(mInitFailedCommands.size());
+			mInitCommands.swap(mInitFailedCommands);
+			mInitFailedCommands.clear();
+		}
+
+		while (!mInitCommands.empty() || (mInitCommandsInFlight != 0)) {
+			while (!mInitCommands.empty() && can_send_init_command()) {
+				if (send_spinel_transaction(
+					mInitCommands.front().mSpinelCommand,
+					ReplyUnpacker(),
+					boost::bind(&SpinelNCPInstance::init_command_did_finish, this, _1, _2, mInitGeneration, mInitCommands.front())
+				)) {
+					mInitCommandsInFlight++;
+				} else {
+					mInitFailedCommands.push_back(mInitCommands.front());
+				}
+				mInitCommands.pop_front();
+			}
+
+			EH_WAIT_UNTIL(mInitCommands.empty() ? (mInitCommandsInFlight == 0) : can_send_init_command());
+		}
+	}
+#else
+	/* Known Issue: Junk Char Observed at start of wfantund */
+	// Replies this early may be lost, so the commands are only sent,
+	// and nothing waits on (or retries) their replies. Those which do
+	// arrive are handled like any other.
+	while (!mInitCommands.empty()) {
+		EH_WAIT_UNTIL((mTransactionCount < SPINEL_MAX_TRANSACTIONS)
+			&& outbound_queue_has_room(kOutboundFrameClassControl));
+
+		if (!send_spinel_transaction(mInitCommands.front().mSpinelCommand, ReplyUnpacker(), NilReturn())) {
+			mInitFailedCommands.push_back(mInitCommands.front());
+		}
+		mInitCommands.pop_front();
+	}
+#endif
+
+	for (std::list<InitCommand>::iterator iter = mInitFailedCommands.begin(); iter != mInitFailedCommands.end(); ++iter) {
+		if (iter->mIsRestore) {
+			syslog(LOG_WARNING, "Unsuccessful in restoring property \"%s\" on NCP", iter->mName.c_str());
+		} else {
+			syslog(LOG_WARNING, "Unsuccessful fetching property %s from NCP", iter->mName.c_str());
+		}
+	}
+
+	if (mInitRetryCount != 0) {
+		syslog(LOG_NOTICE, "Initialization retried %d command(s), %d still failed",
+			mInitRetryCount, (int)mInitFailedCommands.size());
+	}
+
+	mInitFailedCommands.clear();
 
 	EH_END();
 }
@@ -25,7 +25,6 @@
 
 #include <sys/stat.h>
 #include <iostream>
-#include <fstream>
 #include <algorithm>
 #include <inttypes.h>
 #include "SpinelNCPInstance.h"
@@ -36,12 +35,15 @@
 #include "socket-utils.h"
 #include <stdexcept>
 #include <sys/file.h>
+#include <sys/ioctl.h>
 #include "SuperSocket.h"
 #include "SpinelNCPTask.h"
 #include "SpinelNCPTaskWake.h"
 #include "SpinelNCPTaskSendCommand.h"
 #include "SpinelNCPTaskJoin.h"
 #include "SpinelNCPTaskGetNetworkTopology.h"
+#include "SpinelNCPTaskGetTopologySnapshot.h"
+#include "SpinelNCPTaskGetConnectedDevices.h"
 #include "SpinelNCPTaskGetMsgBufferCounters.h"
 #include "SpinelNCPThreadDataset.h"
 #include "any-to.h"
@@ -50,8 +52,15 @@
 #include <string>
 #include <string.h>
 #include "string-utils.h"
+#include "FileExporter.h"
+#include "FrameTrace.h"
+#include "SpinelFrame.h"
 #include "../src/wpanctl/webserver-config.h"
 
+#if __linux__
+#include <linux/serial.h>
+#endif
+
 #define kWPANTUND_Allowlist_RssiOverrideDisabled    127
 #define kWPANTUND_SpinelPropValueDumpLen            8
 
@@ -61,7 +70,6 @@ WPANTUND_DEFINE_NCPINSTANCE_PLUGIN(spinel, SpinelNCPInstance);
 
 int MacFilterList[MAC_FILTER_LIST_SIZE * 2];
 std::string MacFilterListString[MAC_FILTER_LIST_SIZE];
-const std::string app_path_main = "/var/local/wisunwebapp/";
 const std::string app_path = "/var/local/wisunwebapp/txt_files/";
 const std::string connecteddevices_filename = app_path + "connected_devices.txt";
 const std::string numconnected_filename = app_path + "num_connected.txt";
@@ -385,6 +393,10 @@ SpinelNCPInstance::SpinelNCPInstance(const Settings& settings) :
 	mInboundFrameDataType = 0;
 	mInboundFrameHDLCCRC = 0;
 	mInboundFrameSize = 0;
+	hdlc_deframer_init(&mInboundDeframer, mInboundFrame, sizeof(mInboundFrame));
+	mInboundOverrunCount = 0;
+	mInboundStagingLen = 0;
+	mInboundStagingOffset = 0;
 	mInboundHeader = 0;
 	mIsCommissioned = false;
 	mFilterRLOCAddresses = true;
@@ -397,14 +409,43 @@ SpinelNCPInstance::SpinelNCPInstance(const Settings& settings) :
 	mOutboundBufferEscapedLen = 0;
 	mOutboundBufferLen = 0;
 	mOutboundBufferSent = 0;
-	mOutboundBufferType = 0;
+	mOutboundDataBufferType = 0;
+	mOutboundBatchLen = 0;
+	mOutboundBatchCount = 0;
+	mOutboundPumpIsIdle = false;
+	mTransactionCount = 0;
+	mLastTransactionTID = 0;
+	mPropertyBatchDepth = 0;
+	mInitCommandsInFlight = 0;
+	mInitRound = 0;
+	mInitRetryCount = 0;
+	mInitGeneration = 0;
+	mInitStartTime = 0;
+	mInitDuration = 0;
+	mPropertyCacheIsReplaying = false;
+	mTopologySnapshotTime = 0;
+	mTopologySnapshotValid = false;
+	mTopologyRefreshPending = false;
+	mTopologyRefreshAgain = false;
+	mTopologyRefreshTime = time_ms() - SPINEL_TOPOLOGY_REFRESH_MIN_INTERVAL;
+	mTopologyGeneration = 0;
+	mTopology.set_change_handler(boost::bind(&SpinelNCPInstance::topology_did_change, this, _1, _2, _3, _4));
+	for (int i = 0; i < SPINEL_TRANSACTION_TABLE_SIZE; i++) {
+		mTransactions[i].mInUse = false;
+		mTransactions[i].mDeadline = 0;
+	}
+	for (int i = 0; i < kOutboundFrameClassCount; i++) {
+		mOutboundQueue[i].mDropCount = 0;
+		mOutboundQueue[i].mSentCount = 0;
+		mOutboundQueue[i].mLatencySum = 0;
+		mOutboundQueue[i].mLatencyMax = 0;
+	}
 #if WPANTUND_NCP_RESET_EXPECTED_ON_START
 	mResetIsExpected = true;
 #else
 	mResetIsExpected = false;
 #endif
 	mSetSteeringDataWhenJoinable = false;
-	mSubPTIndex = 0;
 	mTXPower = 0;
 	mThreadMode = 0;
 	mXPANIDWasExplicitlySet = false;
@@ -422,6 +463,7 @@ SpinelNCPInstance::SpinelNCPInstance(const Settings& settings) :
 	regsiter_all_set_handlers();
 	regsiter_all_insert_handlers();
 	regsiter_all_remove_handlers();
+	register_all_value_is_handlers();
 
 	memset(mSteeringDataAddress, 0xff, sizeof(mSteeringDataAddress));
 
@@ -445,15 +487,16 @@ SpinelNCPInstance::SpinelNCPInstance(const Settings& settings) :
 	if(WEBSERVER_APP == 1)
 	{
 		/* remove the files if they exist */
-		remove((const char*)connecteddevices_filename.c_str());
-		remove((const char*)all_connecteddevices_filename.c_str());
-		remove((const char*)numconnected_filename.c_str());
+		FileExporter::shared().remove(connecteddevices_filename);
+		FileExporter::shared().remove(all_connecteddevices_filename);
+		FileExporter::shared().remove(numconnected_filename);
 	}
 
 }
 
 SpinelNCPInstance::~SpinelNCPInstance()
 {
+	cancel_spinel_transactions(kWPANTUNDStatus_Canceled);
 }
 
 std::string
@@ -532,6 +575,26 @@ SpinelNCPInstance::get_ms_to_next_event(void)
 		}
 	}
 
+	if (mTransactionCount != 0) {
+		cms_t tmp_cms = get_ms_to_next_transaction_timeout();
+		if (tmp_cms < cms) {
+			cms = tmp_cms;
+		}
+	}
+
+	// Frames were queued behind the back of the idle outbound pump,
+	// make sure it gets to run on the next pass.
+	if (mOutboundPumpIsIdle && !outbound_queues_empty()) {
+		cms = 0;
+	}
+
+	if (mTopologyRefreshAgain && !mTopologyRefreshPending) {
+		cms_t tmp_cms = SPINEL_TOPOLOGY_REFRESH_MIN_INTERVAL - CMS_SINCE(mTopologyRefreshTime);
+		if (tmp_cms < cms) {
+			cms = tmp_cms;
+		}
+	}
+
 	if (cms > mVendorCustom.get_ms_to_next_event()) {
 		cms = mVendorCustom.get_ms_to_next_event();
 	}
@@ -781,9 +844,7 @@ unpack_dodag_route(const uint8_t *data_in, spinel_size_t data_len, boost::any& v
 
 		// concat the first ip address to the name of the file
 		std::string dodag_route_file_name = app_path + last_ip_str + '-' + dodag_route_begin_str;
-		std::ofstream myfile(dodag_route_file_name);
-		myfile << (ret_str) << std::endl;
-		myfile.close();
+		FileExporter::shared().write(dodag_route_file_name, ret_str + "\n");
 	}
 	
 	return ret;
@@ -792,12 +853,6 @@ unpack_dodag_route(const uint8_t *data_in, spinel_size_t data_len, boost::any& v
 static int
 unpack_dodag_route_dest(const uint8_t *data_in, spinel_size_t data_len, boost::any& value)
 {
-	if(WEBSERVER_APP == 1)
-	{
-		mkdir(app_path_main.c_str(), 0777);
-		mkdir(app_path.c_str(), 0777);
-	}
-
 	uint8_t *entry_ptr = NULL;
 	spinel_size_t entry_len = 0;
 	spinel_ssize_t len = 0;
@@ -825,12 +880,6 @@ unpack_dodag_route_dest(const uint8_t *data_in, spinel_size_t data_len, boost::a
 static int
 unpack_num_connected(const uint8_t *data_in, spinel_size_t data_len, boost::any& value)
 {
-	if(WEBSERVER_APP == 1)
-	{
-		mkdir(app_path_main.c_str(), 0777);
-		mkdir(app_path.c_str(), 0777);
-	}
-
 	int connected_devices = 0;
 	spinel_datatype_unpack(data_in, data_len, "S", &connected_devices);
 	value = connected_devices;
@@ -842,9 +891,7 @@ unpack_num_connected(const uint8_t *data_in, spinel_size_t data_len, boost::any&
 	{
 		print_str.append("Created file and num_connected_devices is in it.");
 		print_str.append(any_to_string(connected_devices) + "\n");		
-		std::ofstream myfile(numconnected_filename);
-		myfile << (connected_devices) << ":" << std::endl;
-		myfile.close();
+		FileExporter::shared().write(numconnected_filename, any_to_string(connected_devices) + ":\n");
 	}
 	value = print_str;
 	return ret;
@@ -912,6 +959,112 @@ unpack_connected_devices(const uint8_t *data_in, spinel_size_t data_len, boost::
 	return ret;
 }
 
+// Structured forms of the properties above. The addresses are copied
+// out as raw 16 byte `Data` values; nothing is formatted as text.
+
+static int
+unpack_dodag_route_dest_binary(const uint8_t *data_in, spinel_size_t data_len, boost::any& value)
+{
+	int ret = kWPANTUNDStatus_Failure;
+	const uint8_t *entry_ptr = NULL;
+	spinel_size_t entry_len = 0;
+	spinel_ssize_t len;
+
+	len = spinel_datatype_unpack(data_in, data_len, SPINEL_DATATYPE_DATA_S, &entry_ptr, &entry_len);
+	require(len > 0 && entry_len >= sizeof(struct in6_addr), bail);
+
+	value = Data(entry_ptr, sizeof(struct in6_addr));
+	ret = kWPANTUNDStatus_Ok;
+
+bail:
+	return ret;
+}
+
+static int
+unpack_dodag_route_structured(const uint8_t *data_in, spinel_size_t data_len, boost::any& value, bool as_val_map)
+{
+	int ret = kWPANTUNDStatus_Failure;
+	const uint8_t *entry_ptr = NULL;
+	spinel_size_t entry_len = 0;
+	spinel_ssize_t len;
+	unsigned int path_cost;
+	std::list<Data> hops;
+
+	len = spinel_datatype_unpack(data_in, data_len, SPINEL_DATATYPE_DATA_S, &entry_ptr, &entry_len);
+	require(len > 0 && entry_len >= 1, bail);
+
+	// The path cost is followed by `path_cost + 1` addresses, starting
+	// at the root and ending at the destination.
+	path_cost = entry_ptr[0];
+	require(entry_len >= 1 + (path_cost + 1) * sizeof(struct in6_addr), bail);
+
+	if (!as_val_map) {
+		value = Data(entry_ptr, 1 + (path_cost + 1) * sizeof(struct in6_addr));
+		ret = kWPANTUNDStatus_Ok;
+		goto bail;
+	}
+
+	for (unsigned int i = 0; i <= path_cost; i++) {
+		hops.push_back(Data(entry_ptr + 1 + i * sizeof(struct in6_addr), sizeof(struct in6_addr)));
+	}
+
+	{
+		ValueMap result;
+
+		result[kWPANTUNDValueMapKey_DodagRoute_PathCost] = boost::any(static_cast<uint8_t>(path_cost));
+		result[kWPANTUNDValueMapKey_DodagRoute_Address] = boost::any(hops.back());
+		result[kWPANTUNDValueMapKey_DodagRoute_Hops] = boost::any(hops);
+
+		value = result;
+	}
+
+	ret = kWPANTUNDStatus_Ok;
+
+bail:
+	return ret;
+}
+
+static int
+unpack_connected_devices_structured(const uint8_t *data_in, spinel_size_t data_len, boost::any& value, bool as_val_map)
+{
+	int ret = kWPANTUNDStatus_Failure;
+	const uint8_t *entry_ptr = NULL;
+	spinel_size_t entry_len = 0;
+	spinel_ssize_t len;
+	std::list<Data> addresses;
+
+	len = spinel_datatype_unpack(data_in, data_len, SPINEL_DATATYPE_DATA_S, &entry_ptr, &entry_len);
+	require(len > 0 && entry_len >= 1, bail);
+
+	if (!as_val_map) {
+		// Trailing bytes which do not make up a whole address are dropped.
+		entry_len = 1 + ((entry_len - 1) / sizeof(struct in6_addr)) * sizeof(struct in6_addr);
+		value = Data(entry_ptr, entry_len);
+		ret = kWPANTUNDStatus_Ok;
+		goto bail;
+	}
+
+	for (spinel_size_t i = 1; i + sizeof(struct in6_addr) <= entry_len; i += sizeof(struct in6_addr)) {
+		addresses.push_back(Data(entry_ptr + i, sizeof(struct in6_addr)));
+	}
+
+	{
+		ValueMap result;
+
+		// The first byte is the block ID, with the MSB set on the last block.
+		result[kWPANTUNDValueMapKey_ConnectedDevices_BlockId] = boost::any(static_cast<uint8_t>(entry_ptr[0] & 0x7F));
+		result[kWPANTUNDValueMapKey_ConnectedDevices_LastBlock] = boost::any((entry_ptr[0] & 0x80) != 0);
+		result[kWPANTUNDValueMapKey_ConnectedDevices_Addresses] = boost::any(addresses);
+
+		value = result;
+	}
+
+	ret = kWPANTUNDStatus_Ok;
+
+bail:
+	return ret;
+}
+
 static int
 unpack_mac_allowlist_entries(const uint8_t *data_in, spinel_size_t data_len, boost::any& value, bool as_val_map)
 {
@@ -2548,24 +2701,306 @@ void
 SpinelNCPInstance::get_spinel_prop(CallbackWithStatusArg1 cb, spinel_prop_key_t prop_key,
 	const std::string &reply_format)
 {
-	start_new_task(SpinelNCPTaskSendCommand::Factory(this)
-		.set_callback(cb)
-		.add_command(SpinelPackData(SPINEL_FRAME_PACK_CMD_PROP_VALUE_GET, prop_key))
-		.set_reply_format(reply_format)
-		.finish()
-	);
+	get_spinel_prop_with_unpacker(cb, prop_key, SpinelNCPTaskSendCommand::simple_reply_unpacker(reply_format));
+}
+
+// Answers from the property cache when the NCP has reported the value
+// recently enough, and asks the NCP otherwise.
+void
+SpinelNCPInstance::get_spinel_prop_cached(CallbackWithStatusArg1 cb, spinel_prop_key_t prop_key,
+	const std::string &reply_format)
+{
+	const Data *value = mPropertyCache.get_confirmed_value(prop_key, SPINEL_CACHED_GET_MAX_AGE);
+
+	if (value != NULL) {
+		boost::any result;
+		int status = SpinelNCPTaskSendCommand::simple_reply_unpacker(reply_format)(value->data(),
+			static_cast<spinel_size_t>(value->size()), result);
+
+		if (status == kWPANTUNDStatus_Ok) {
+			cb(status, result);
+			return;
+		}
+	}
+
+	get_spinel_prop(cb, prop_key, reply_format);
 }
 
 void
 SpinelNCPInstance::get_spinel_prop_with_unpacker(CallbackWithStatusArg1 cb, spinel_prop_key_t prop_key,
 	ReplyUnpacker unpacker)
 {
-	start_new_task(SpinelNCPTaskSendCommand::Factory(this)
-		.set_callback(cb)
-		.add_command(SpinelPackData(SPINEL_FRAME_PACK_CMD_PROP_VALUE_GET, prop_key))
-		.set_reply_unpacker(unpacker)
-		.finish()
-	);
+	if (mPropertyBatchDepth > 0) {
+		BatchedGet get;
+
+		get.mCallback = cb;
+		get.mUnpacker = unpacker;
+		mBatchedGets[prop_key].push_back(get);
+
+	} else {
+		send_spinel_prop_get(cb, prop_key, unpacker);
+	}
+}
+
+void
+SpinelNCPInstance::send_spinel_prop_get(CallbackWithStatusArg1 cb, spinel_prop_key_t prop_key,
+	ReplyUnpacker unpacker)
+{
+	Data command = SpinelPackData(SPINEL_FRAME_PACK_CMD_PROP_VALUE_GET, prop_key);
+
+	if (!start_spinel_transaction(command, unpacker, cb)) {
+		start_new_task(SpinelNCPTaskSendCommand::Factory(this)
+			.set_callback(cb)
+			.add_command(command)
+			.set_reply_unpacker(unpacker)
+			.finish()
+		);
+	}
+}
+
+// ----------------------------------------------------------------------------
+// Property batches
+//
+// While a batch is open, gets of spinel properties are held back. When
+// it is closed, each spinel property is read from the NCP once, and the
+// reply is unpacked separately for every get which asked for it (for
+// instance `DodagRoute` and `DodagRoute:AsValMap` in the same batch).
+
+static int
+unpack_raw_reply(const uint8_t* data_in, spinel_size_t data_len, boost::any& value)
+{
+	value = Data(data_in, data_len);
+	return kWPANTUNDStatus_Ok;
+}
+
+void
+SpinelNCPInstance::begin_property_batch(void)
+{
+	mPropertyBatchDepth++;
+}
+
+void
+SpinelNCPInstance::end_property_batch(void)
+{
+	std::map<spinel_prop_key_t, std::list<BatchedGet> > gets;
+	std::map<spinel_prop_key_t, std::list<BatchedGet> >::iterator iter;
+
+	if ((mPropertyBatchDepth == 0) || (--mPropertyBatchDepth != 0)) {
+		return;
+	}
+
+	gets.swap(mBatchedGets);
+
+	for (iter = gets.begin(); iter != gets.end(); ++iter) {
+		if (iter->second.size() == 1) {
+			send_spinel_prop_get(iter->second.front().mCallback, iter->first, iter->second.front().mUnpacker);
+		} else {
+			send_spinel_prop_get(
+				boost::bind(&SpinelNCPInstance::batched_get_did_finish, this, _1, _2, iter->second),
+				iter->first,
+				&unpack_raw_reply
+			);
+		}
+	}
+}
+
+void
+SpinelNCPInstance::batched_get_did_finish(int status, const boost::any& value, const std::list<BatchedGet>& gets)
+{
+	std::list<BatchedGet>::const_iterator iter;
+	Data raw;
+
+	if ((status == kWPANTUNDStatus_Ok) && (value.type() == typeid(Data))) {
+		raw = boost::any_cast<Data>(value);
+	}
+
+	for (iter = gets.begin(); iter != gets.end(); ++iter) {
+		boost::any unpacked;
+		int get_status = status;
+
+		if ((get_status == kWPANTUNDStatus_Ok) && iter->mUnpacker) {
+			get_status = iter->mUnpacker(raw.data(), static_cast<spinel_size_t>(raw.size()), unpacked);
+		}
+
+		iter->mCallback(get_status, unpacked);
+	}
+}
+
+// ----------------------------------------------------------------------------
+// Pipelined property gets
+//
+// A property get has no side effects, so there is no need for it to
+// wait behind other commands in the task queue. Each one is sent right
+// away with a TID of its own, and the reply is matched back to it by
+// that TID. Anything else (and any get which can't be pipelined right
+// now) still goes through the task queue.
+
+spinel_tid_t
+SpinelNCPInstance::get_next_free_tid(spinel_tid_t tid) const
+{
+	do {
+		tid = SPINEL_GET_NEXT_TID(tid);
+	} while (mTransactions[tid].mInUse);
+
+	return tid;
+}
+
+bool
+SpinelNCPInstance::start_spinel_transaction(const Data& command, ReplyUnpacker unpacker, CallbackWithStatusArg1 cb)
+{
+	bool ret = false;
+
+	// Gets issued while other commands are queued up must not
+	// overtake them, or they could read back a stale value.
+	require_quiet(mTaskQueue.empty(), bail);
+	require_quiet(!ncp_state_is_detached_from_ncp(get_ncp_state()), bail);
+	require_quiet(!ncp_state_is_sleeping(get_ncp_state()), bail);
+	require_quiet(!is_initializing_ncp(), bail);
+
+	ret = send_spinel_transaction(command, unpacker, cb);
+
+bail:
+	return ret;
+}
+
+// Sends `command` with a TID of its own and records it in the
+// transaction table. Also used by the initialization protothread,
+// which does its own checks on the state of the NCP.
+bool
+SpinelNCPInstance::send_spinel_transaction(const Data& command, ReplyUnpacker unpacker, CallbackWithStatusArg1 cb)
+{
+	uint8_t frame[SPINEL_FRAME_BUFFER_SIZE];
+	spinel_tid_t tid;
+	bool ret = false;
+
+	require_quiet(mTransactionCount < SPINEL_MAX_TRANSACTIONS, bail);
+	require_quiet(outbound_queue_has_room(kOutboundFrameClassControl), bail);
+	require(command.size() < sizeof(frame), bail);
+
+	// Never hand out the TID of the command most recently sent by a
+	// task, its reply may still be on its way.
+	tid = mLastTransactionTID;
+	do {
+		tid = get_next_free_tid(tid);
+	} while (tid == mLastTID);
+
+	memcpy(frame, command.data(), command.size());
+	frame[0] = SPINEL_HEADER_FLAG | SPINEL_HEADER_IID_0 | (tid << SPINEL_HEADER_TID_SHIFT);
+
+	log_spinel_frame(kDriverToNCP, frame, static_cast<spinel_size_t>(command.size()));
+
+	require(enqueue_outbound_frame(kOutboundFrameClassControl, frame, static_cast<spinel_ssize_t>(command.size()),
+	                               sizeof(frame), false), bail);
+
+	mTransactions[tid].mInUse = true;
+	mTransactions[tid].mDeadline = time_ms() + NCP_DEFAULT_COMMAND_RESPONSE_TIMEOUT * MSEC_PER_SEC;
+	mTransactions[tid].mCallback = cb;
+	mTransactions[tid].mUnpacker = unpacker;
+	mTransactionCount++;
+	mLastTransactionTID = tid;
+
+	ret = true;
+
+bail:
+	return ret;
+}
+
+void
+SpinelNCPInstance::complete_spinel_transaction(spinel_tid_t tid, spinel_prop_key_t key, const uint8_t* value_data_ptr,
+	spinel_size_t value_data_len)
+{
+	SpinelTransaction& transaction = mTransactions[tid];
+	CallbackWithStatusArg1 cb;
+	boost::any value;
+	int status = kWPANTUNDStatus_Ok;
+
+	if (!transaction.mInUse) {
+		return;
+	}
+
+	if (key == SPINEL_PROP_LAST_STATUS) {
+		if (spinel_datatype_unpack(value_data_ptr, value_data_len, "i", &status) <= 0) {
+			status = SPINEL_STATUS_PARSE_ERROR;
+		}
+		if (status) {
+			status = spinel_status_to_wpantund_status(status);
+		}
+	}
+
+	if ((status == kWPANTUNDStatus_Ok) && transaction.mUnpacker) {
+		status = transaction.mUnpacker(value_data_ptr, value_data_len, value);
+	}
+
+	if (status != kWPANTUNDStatus_Ok) {
+		syslog(LOG_ERR, "Transaction %d encountered an error: %d (0x%08X)", tid, status, status);
+	}
+
+	// Free up the slot before calling back, the callback
+	// may well want to start another transaction.
+	cb = transaction.mCallback;
+	transaction.mInUse = false;
+	transaction.mCallback = CallbackWithStatusArg1();
+	transaction.mUnpacker = ReplyUnpacker();
+	mTransactionCount--;
+
+	cb(status, value);
+}
+
+void
+SpinelNCPInstance::expire_spinel_transactions(void)
+{
+	const cms_t now = time_ms();
+
+	for (spinel_tid_t tid = 1; (mTransactionCount != 0) && (tid < SPINEL_TRANSACTION_TABLE_SIZE); tid++) {
+		SpinelTransaction& transaction = mTransactions[tid];
+
+		if (transaction.mInUse && (transaction.mDeadline - now <= 0)) {
+			CallbackWithStatusArg1 cb(transaction.mCallback);
+
+			syslog(LOG_ERR, "Transaction %d timed out", tid);
+
+			transaction.mInUse = false;
+			transaction.mCallback = CallbackWithStatusArg1();
+			transaction.mUnpacker = ReplyUnpacker();
+			mTransactionCount--;
+
+			cb(kWPANTUNDStatus_Timeout, boost::any());
+		}
+	}
+}
+
+void
+SpinelNCPInstance::cancel_spinel_transactions(int status)
+{
+	for (spinel_tid_t tid = 1; (mTransactionCount != 0) && (tid < SPINEL_TRANSACTION_TABLE_SIZE); tid++) {
+		SpinelTransaction& transaction = mTransactions[tid];
+
+		if (transaction.mInUse) {
+			CallbackWithStatusArg1 cb(transaction.mCallback);
+
+			transaction.mInUse = false;
+			transaction.mCallback = CallbackWithStatusArg1();
+			transaction.mUnpacker = ReplyUnpacker();
+			mTransactionCount--;
+
+			cb(status, boost::any());
+		}
+	}
+}
+
+cms_t
+SpinelNCPInstance::get_ms_to_next_transaction_timeout(void) const
+{
+	const cms_t now = time_ms();
+	cms_t ret = CMS_DISTANT_FUTURE;
+
+	for (spinel_tid_t tid = 1; tid < SPINEL_TRANSACTION_TABLE_SIZE; tid++) {
+		if (mTransactions[tid].mInUse && (mTransactions[tid].mDeadline - now < ret)) {
+			ret = mTransactions[tid].mDeadline - now;
+		}
+	}
+
+	return (ret < 0) ? 0 : ret;
 }
 
 void SpinelNCPInstance::check_capability_prop_get(CallbackWithStatusArg1 cb, const std::string &prop_name,
@@ -2606,6 +3041,15 @@ SpinelNCPInstance::register_get_handler_spinel_simple(const char *prop_name, spi
 		boost::bind(&SpinelNCPInstance::get_spinel_prop, this, _1, prop_key, std::string(reply_format)));
 }
 
+void
+SpinelNCPInstance::register_get_handler_spinel_cached(const char *prop_name, spinel_prop_key_t prop_key,
+	const char *reply_format)
+{
+	register_get_handler(
+		prop_name,
+		boost::bind(&SpinelNCPInstance::get_spinel_prop_cached, this, _1, prop_key, std::string(reply_format)));
+}
+
 void
 SpinelNCPInstance::register_get_handler_spinel_unpacker(const char *prop_name, spinel_prop_key_t prop_key,
 	ReplyUnpacker unpacker)
@@ -2639,14 +3083,19 @@ void
 SpinelNCPInstance::regsiter_all_get_handlers(void)
 {
 	// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-	// Properties associated with a spinel property with simple packing format
+	// Properties associated with a spinel property with simple packing format,
+	// answered from the property cache while the NCP's value is recent
 
-	register_get_handler_spinel_simple(
+	register_get_handler_spinel_cached(
 		kWPANTUNDProperty_NCPCCAThreshold,
 		SPINEL_PROP_PHY_CCA_THRESHOLD, SPINEL_DATATYPE_INT8_S);
-	register_get_handler_spinel_simple(
+	register_get_handler_spinel_cached(
 		kWPANTUNDProperty_NCPTXPower,
 		SPINEL_PROP_PHY_TX_POWER, SPINEL_DATATYPE_INT8_S);
+
+	// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+	// Properties associated with a spinel property with simple packing format
+
 	register_get_handler_spinel_simple(
 		kWPANTUNDProperty_NCPFrequency,
 		SPINEL_PROP_PHY_FREQ, SPINEL_DATATYPE_INT32_S);
@@ -3051,9 +3500,24 @@ SpinelNCPInstance::regsiter_all_get_handlers(void)
 	register_get_handler_spinel_unpacker(
 		kWPANTUNDProperty_DodagRoute,
 		SPINEL_PROP_DODAG_ROUTE, unpack_dodag_route);
+	register_get_handler_spinel_unpacker(
+		kWPANTUNDProperty_DodagRouteDestBinary,
+		SPINEL_PROP_DODAG_ROUTE_DEST, unpack_dodag_route_dest_binary);
+	register_get_handler_spinel_unpacker(
+		kWPANTUNDProperty_DodagRouteAsValMap,
+		SPINEL_PROP_DODAG_ROUTE, boost::bind(unpack_dodag_route_structured, _1, _2, _3, /* as_val_map */ true));
+	register_get_handler_spinel_unpacker(
+		kWPANTUNDProperty_DodagRouteBinary,
+		SPINEL_PROP_DODAG_ROUTE, boost::bind(unpack_dodag_route_structured, _1, _2, _3, /* as_val_map */ false));
 	register_get_handler_spinel_unpacker(
 		kWPANTUNDProperty_ConnectedDevices,
 		SPINEL_PROP_CONNECTED_DEVICES, unpack_connected_devices);
+	register_get_handler_spinel_unpacker(
+		kWPANTUNDProperty_ConnectedDevicesAsValMap,
+		SPINEL_PROP_CONNECTED_DEVICES, boost::bind(unpack_connected_devices_structured, _1, _2, _3, /* as_val_map */ true));
+	register_get_handler_spinel_unpacker(
+		kWPANTUNDProperty_ConnectedDevicesBinary,
+		SPINEL_PROP_CONNECTED_DEVICES, boost::bind(unpack_connected_devices_structured, _1, _2, _3, /* as_val_map */ false));
 	register_get_handler_spinel_unpacker(
 		kWPANTUNDProperty_NumConnectedDevices,
 		SPINEL_PROP_NUM_CONNECTED_DEVICES, unpack_num_connected);
@@ -3246,7 +3710,52 @@ SpinelNCPInstance::regsiter_all_get_handlers(void)
 		kWPANTUNDProperty_IPv6LinkLocalAddress,
 		boost::bind(&SpinelNCPInstance::get_prop_IPv6LinkLocalAddress, this, _1));
 	register_get_handler(
-		kWPANTUNDProperty_ThreadChildTable,
+		kWPANTUNDProperty_DaemonOutboundQueueDepth,
+		boost::bind(&SpinelNCPInstance::get_prop_DaemonOutboundQueueDepth, this, _1));
+	register_get_handler(
+		kWPANTUNDProperty_DaemonOutboundQueueDrops,
+		boost::bind(&SpinelNCPInstance::get_prop_DaemonOutboundQueueDrops, this, _1));
+	register_get_handler(
+		kWPANTUNDProperty_DaemonOutboundQueueLatency,
+		boost::bind(&SpinelNCPInstance::get_prop_DaemonOutboundQueueLatency, this, _1));
+	register_get_handler(
+		kWPANTUNDProperty_DaemonNCPInitTime,
+		boost::bind(&SpinelNCPInstance::get_prop_DaemonNCPInitTime, this, _1));
+	register_get_handler(
+		kWPANTUNDProperty_DaemonPropertyCache,
+		boost::bind(&SpinelNCPInstance::get_prop_DaemonPropertyCache, this, _1));
+	register_get_handler(
+		kWPANTUNDProperty_DaemonInboundPropertyStats,
+		boost::bind(&SpinelNCPInstance::get_prop_DaemonInboundPropertyStats, this, _1));
+	register_get_handler(
+		kWPANTUNDProperty_ConfigDaemonSerialReaderThread,
+		boost::bind(&SpinelNCPInstance::get_prop_ConfigDaemonSerialReaderThread, this, _1));
+	register_get_handler(
+		kWPANTUNDProperty_DaemonSerialStats,
+		boost::bind(&SpinelNCPInstance::get_prop_DaemonSerialStats, this, _1));
+	register_get_handler(
+		kWPANTUNDProperty_ConfigDaemonPropertyCachePath,
+		boost::bind(&SpinelNCPInstance::get_prop_ConfigDaemonPropertyCachePath, this, _1));
+	register_get_handler(
+		kWPANTUNDProperty_NetworkTopology,
+		boost::bind(&SpinelNCPInstance::get_prop_NetworkTopology, this, _1));
+	register_get_handler(
+		kWPANTUNDProperty_NetworkTopologyAsValMap,
+		boost::bind(&SpinelNCPInstance::get_prop_NetworkTopologyAsValMap, this, _1));
+	register_get_handler(
+		kWPANTUNDProperty_NetworkTopologyBinary,
+		boost::bind(&SpinelNCPInstance::get_prop_NetworkTopologyBinary, this, _1));
+	register_get_handler(
+		kWPANTUNDProperty_NetworkTopologyGeneration,
+		boost::bind(&SpinelNCPInstance::get_prop_NetworkTopologyGeneration, this, _1));
+	register_get_handler(
+		kWPANTUNDProperty_ConnectedDevicesAll,
+		boost::bind(&SpinelNCPInstance::get_prop_ConnectedDevicesAll, this, _1));
+	register_get_handler(
+		kWPANTUNDProperty_ConnectedDevicesAllBinary,
+		boost::bind(&SpinelNCPInstance::get_prop_ConnectedDevicesAllBinary, this, _1));
+	register_get_handler(
+		kWPANTUNDProperty_ThreadChildTable,
 		boost::bind(&SpinelNCPInstance::get_prop_ThreadChildTable, this, _1));
 	register_get_handler(
 		kWPANTUNDProperty_ThreadChildTableAsValMap,
@@ -3823,6 +4332,383 @@ SpinelNCPInstance::get_prop_DaemonTickleOnHostDidWake(CallbackWithStatusArg1 cb)
 	cb(kWPANTUNDStatus_Ok, boost::any(mTickleOnHostDidWake));
 }
 
+void
+SpinelNCPInstance::get_prop_DaemonOutboundQueueDepth(CallbackWithStatusArg1 cb)
+{
+	ValueMap result;
+
+	result[kWPANTUNDValueMapKey_OutboundQueue_Control] = boost::any(mOutboundQueue[kOutboundFrameClassControl].mFrames.size());
+	result[kWPANTUNDValueMapKey_OutboundQueue_Data] = boost::any(mOutboundQueue[kOutboundFrameClassData].mFrames.size());
+
+	cb(kWPANTUNDStatus_Ok, boost::any(result));
+}
+
+void
+SpinelNCPInstance::get_prop_DaemonOutboundQueueDrops(CallbackWithStatusArg1 cb)
+{
+	ValueMap result;
+
+	result[kWPANTUNDValueMapKey_OutboundQueue_Control] = boost::any(mOutboundQueue[kOutboundFrameClassControl].mDropCount);
+	result[kWPANTUNDValueMapKey_OutboundQueue_Data] = boost::any(mOutboundQueue[kOutboundFrameClassData].mDropCount);
+
+	cb(kWPANTUNDStatus_Ok, boost::any(result));
+}
+
+static uint32_t
+average_outbound_latency(uint64_t latency_sum, uint32_t sent_count)
+{
+	return (sent_count == 0) ? 0 : static_cast<uint32_t>(latency_sum / sent_count);
+}
+
+void
+SpinelNCPInstance::get_prop_DaemonOutboundQueueLatency(CallbackWithStatusArg1 cb)
+{
+	const OutboundQueue& control = mOutboundQueue[kOutboundFrameClassControl];
+	const OutboundQueue& data = mOutboundQueue[kOutboundFrameClassData];
+	ValueMap result;
+
+	result[kWPANTUNDValueMapKey_OutboundQueue_ControlAvg] = boost::any(average_outbound_latency(control.mLatencySum, control.mSentCount));
+	result[kWPANTUNDValueMapKey_OutboundQueue_ControlMax] = boost::any(static_cast<uint32_t>(control.mLatencyMax));
+	result[kWPANTUNDValueMapKey_OutboundQueue_DataAvg] = boost::any(average_outbound_latency(data.mLatencySum, data.mSentCount));
+	result[kWPANTUNDValueMapKey_OutboundQueue_DataMax] = boost::any(static_cast<uint32_t>(data.mLatencyMax));
+
+	cb(kWPANTUNDStatus_Ok, boost::any(result));
+}
+
+void
+SpinelNCPInstance::get_prop_DaemonNCPInitTime(CallbackWithStatusArg1 cb)
+{
+	cb(kWPANTUNDStatus_Ok, boost::any(static_cast<uint32_t>(mInitDuration)));
+}
+
+void
+SpinelNCPInstance::get_prop_DaemonPropertyCache(CallbackWithStatusArg1 cb)
+{
+	ValueMap result;
+
+	result[kWPANTUNDValueMapKey_PropertyCache_State] = boost::any(std::string(mPropertyCache.get_state_cstr()));
+	result[kWPANTUNDValueMapKey_PropertyCache_Entries] = boost::any(static_cast<uint32_t>(mPropertyCache.size()));
+	result[kWPANTUNDValueMapKey_PropertyCache_Age] = boost::any(mPropertyCache.get_age());
+	result[kWPANTUNDValueMapKey_PropertyCache_NCPVersion] = boost::any(mPropertyCache.get_ncp_version());
+
+	cb(kWPANTUNDStatus_Ok, boost::any(result));
+}
+
+void
+SpinelNCPInstance::get_prop_ConfigDaemonPropertyCachePath(CallbackWithStatusArg1 cb)
+{
+	cb(kWPANTUNDStatus_Ok, boost::any(mPropertyCache.get_path()));
+}
+
+static bool
+value_is_entry_took_longer(const SpinelNCPInstance::ValueIsHandlerTable::Entry& lhs, const SpinelNCPInstance::ValueIsHandlerTable::Entry& rhs)
+{
+	return lhs.mTotalUs > rhs.mTotalUs;
+}
+
+void
+SpinelNCPInstance::get_prop_DaemonInboundPropertyStats(CallbackWithStatusArg1 cb)
+{
+	std::vector<ValueIsHandlerTable::Entry> entries(mValueIsHandlers.entries());
+	std::vector<ValueIsHandlerTable::Entry>::const_iterator iter;
+	std::list<std::string> result;
+	char c_string[200];
+
+	std::sort(entries.begin(), entries.end(), &value_is_entry_took_longer);
+
+	for (iter = entries.begin(); iter != entries.end(); ++iter) {
+		if (iter->mCount == 0) {
+			continue;
+		}
+
+		snprintf(c_string, sizeof(c_string), "%-44s count:%-8u avg:%uus max:%uus",
+			spinel_prop_key_to_cstr(static_cast<spinel_prop_key_t>(iter->mKey)),
+			iter->mCount,
+			static_cast<uint32_t>(iter->mTotalUs / iter->mCount),
+			iter->mMaxUs
+		);
+		result.push_back(c_string);
+	}
+
+	snprintf(c_string, sizeof(c_string), "%-44s count:%u", "(unhandled)", mValueIsHandlers.get_unhandled_count());
+	result.push_back(c_string);
+
+	cb(kWPANTUNDStatus_Ok, boost::any(result));
+}
+
+// Moves reading the serial port onto a thread of its own, or back onto
+// the main loop. Bytes read but not yet handled on the side being
+// switched away from are dropped.
+bool
+SpinelNCPInstance::set_reader_thread_enabled(bool enabled)
+{
+	if (enabled == (mReaderThread != NULL)) {
+		return true;
+	}
+
+	if (enabled) {
+		mReaderThread.reset(new SpinelNCPReaderThread(mRawSerialAdapter));
+
+		if (!mReaderThread->start()) {
+			mReaderThread.reset();
+			return false;
+		}
+
+		set_socket_adapter(mReaderThread);
+
+	} else {
+		mReaderThread->stop();
+		set_socket_adapter(boost::shared_ptr<SocketAdapter>());
+		mReaderThread.reset();
+	}
+
+	mInboundStagingLen = 0;
+	mInboundStagingOffset = 0;
+	hdlc_deframer_reset(&mInboundDeframer);
+
+	// The pump may be waiting on the old file descriptor.
+	NLPT_INIT(&mNCPToDriverPumpPT);
+
+	syslog(LOG_NOTICE, "Serial reader thread %s", enabled ? "started" : "stopped");
+
+	return true;
+}
+
+void
+SpinelNCPInstance::get_prop_ConfigDaemonSerialReaderThread(CallbackWithStatusArg1 cb)
+{
+	cb(kWPANTUNDStatus_Ok, boost::any(mReaderThread != NULL));
+}
+
+void
+SpinelNCPInstance::set_prop_ConfigDaemonSerialReaderThread(const boost::any &value, CallbackWithStatus cb)
+{
+#if WPANTUND_SPINEL_USE_FLEN
+	cb(kWPANTUNDStatus_FeatureNotSupported);
+#else
+	cb(set_reader_thread_enabled(any_to_bool(value)) ? kWPANTUNDStatus_Ok : kWPANTUNDStatus_Failure);
+#endif
+}
+
+void
+SpinelNCPInstance::get_prop_DaemonSerialStats(CallbackWithStatusArg1 cb)
+{
+	ValueMap result;
+	int32_t uart_rx = -1;
+	int32_t uart_overrun = -1;
+	int32_t uart_buf_overrun = -1;
+	uint32_t oversize = mInboundDeframer.overrun_count;
+
+#if __linux__ && defined(TIOCGICOUNT)
+	// Counted by the UART driver, so they cover the time before the
+	// reader thread was started as well. Not available on ptys,
+	// sockets and the like.
+	struct serial_icounter_struct icount;
+
+	if (ioctl(mRawSerialAdapter->get_read_fd(), TIOCGICOUNT, &icount) == 0) {
+		uart_rx = icount.rx;
+		uart_overrun = icount.overrun;
+		uart_buf_overrun = icount.buf_overrun;
+	}
+#endif
+
+	result[kWPANTUNDValueMapKey_SerialStats_ReaderThread] = boost::any(mReaderThread != NULL);
+
+	if (mReaderThread) {
+		SpinelNCPReaderThread::Stats stats = mReaderThread->get_stats();
+
+		result[kWPANTUNDValueMapKey_SerialStats_Reads] = boost::any(stats.mReads);
+		result[kWPANTUNDValueMapKey_SerialStats_Frames] = boost::any(stats.mFrames);
+		result[kWPANTUNDValueMapKey_SerialStats_RingDrops] = boost::any(stats.mRingDrops);
+		result[kWPANTUNDValueMapKey_SerialStats_RingHighWater] = boost::any(stats.mRingHighWater);
+		oversize += stats.mOversize;
+	}
+
+	result[kWPANTUNDValueMapKey_SerialStats_Oversize] = boost::any(oversize);
+	result[kWPANTUNDValueMapKey_SerialStats_UartRx] = boost::any(uart_rx);
+	result[kWPANTUNDValueMapKey_SerialStats_UartOverrun] = boost::any(uart_overrun);
+	result[kWPANTUNDValueMapKey_SerialStats_UartBufOverrun] = boost::any(uart_buf_overrun);
+
+	cb(kWPANTUNDStatus_Ok, boost::any(result));
+}
+
+// Runs every cached value through handle_ncp_spinel_value_is(), as if
+// the NCP had just reported it.
+void
+SpinelNCPInstance::replay_property_cache(void)
+{
+	mPropertyCacheIsReplaying = true;
+	mPropertyCache.for_each(boost::bind(&SpinelNCPInstance::handle_ncp_spinel_value_is, this, _1, _2, _3));
+	mPropertyCacheIsReplaying = false;
+}
+
+// Called once initialization has fetched every property from the NCP.
+void
+SpinelNCPInstance::property_cache_did_revalidate(void)
+{
+	int dropped;
+
+	if (mPropertyCache.identity_did_change()) {
+		syslog(LOG_NOTICE, "Cached properties came from another NCP, now using those of \"%s\"", mNCPVersionString.c_str());
+	}
+
+	dropped = mPropertyCache.finish_revalidation();
+
+	if (dropped > 0) {
+		syslog(LOG_NOTICE, "Dropped %d cached properties which the NCP did not report again", dropped);
+	}
+
+	mPropertyCache.save();
+}
+
+bool
+SpinelNCPInstance::topology_snapshot_is_fresh(void) const
+{
+	return mTopologySnapshotValid && (CMS_SINCE(mTopologySnapshotTime) < SPINEL_TOPOLOGY_SNAPSHOT_MAX_AGE);
+}
+
+void
+SpinelNCPInstance::get_topology_snapshot(CallbackWithStatusArg1 cb, int result_format)
+{
+	SpinelNCPTaskGetTopologySnapshot::ResultFormat format =
+		static_cast<SpinelNCPTaskGetTopologySnapshot::ResultFormat>(result_format);
+
+	if (topology_snapshot_is_fresh()) {
+		cb(kWPANTUNDStatus_Ok, SpinelNCPTaskGetTopologySnapshot::format_snapshot(mTopology, format));
+	} else {
+		start_new_task(boost::shared_ptr<SpinelNCPTask>(
+			new SpinelNCPTaskGetTopologySnapshot(this, cb, format)
+		));
+	}
+}
+
+// Walks the whole network again in the background, so that nodes which
+// have left get noticed without anyone asking for the topology. Each walk
+// costs a UART round trip or two per node, so walks are spaced at least
+// SPINEL_TOPOLOGY_REFRESH_MIN_INTERVAL apart; one asked for sooner is
+// started by process() once that time is up.
+void
+SpinelNCPInstance::refresh_topology(void)
+{
+	if (mTopologyRefreshPending) {
+		mTopologyRefreshAgain = true;
+	} else if (!ncp_state_is_associated(get_ncp_state())) {
+		mTopologyRefreshAgain = false;
+	} else if (CMS_SINCE(mTopologyRefreshTime) < SPINEL_TOPOLOGY_REFRESH_MIN_INTERVAL) {
+		mTopologyRefreshAgain = true;
+	} else {
+		mTopologyRefreshPending = true;
+		mTopologyRefreshAgain = false;
+		start_new_task(boost::shared_ptr<SpinelNCPTask>(
+			new SpinelNCPTaskGetTopologySnapshot(
+				this,
+				boost::bind(&SpinelNCPInstance::handle_topology_refresh, this, _1, _2),
+				SpinelNCPTaskGetTopologySnapshot::kResultFormat_Binary,
+				false
+			)
+		));
+	}
+}
+
+void
+SpinelNCPInstance::handle_topology_refresh(int status, const boost::any& value)
+{
+	mTopologyRefreshPending = false;
+	mTopologyRefreshTime = time_ms();
+
+	if (status != kWPANTUNDStatus_Ok) {
+		syslog(LOG_WARNING, "Background topology refresh failed: %d", status);
+	}
+}
+
+void
+SpinelNCPInstance::topology_did_change(TopologyGraph::ChangeType type, const struct in6_addr &address,
+	const TopologyGraph::Node &node, const TopologyGraph::Node *old_node)
+{
+	NCPControlInterface::TopologyChange change = NCPControlInterface::TOPOLOGY_PARENT_CHANGED;
+	ValueMap delta;
+
+	if (type == TopologyGraph::kNodeJoined) {
+		change = NCPControlInterface::TOPOLOGY_NODE_JOINED;
+	} else if (type == TopologyGraph::kNodeLeft) {
+		change = NCPControlInterface::TOPOLOGY_NODE_LEFT;
+	}
+
+	mTopologyGeneration++;
+
+	delta[kWPANTUNDValueMapKey_Topology_Address] = in6_addr_to_string(address);
+
+	if (node.mHasParent) {
+		delta[kWPANTUNDValueMapKey_Topology_Parent] = in6_addr_to_string(node.mParent);
+	}
+
+	if ((old_node != NULL) && old_node->mHasParent) {
+		delta[kWPANTUNDValueMapKey_Topology_OldParent] = in6_addr_to_string(old_node->mParent);
+	}
+
+	if (node.mPathCost != TopologyGraph::kUnknownPathCost) {
+		delta[kWPANTUNDValueMapKey_Topology_PathCost] = node.mPathCost;
+	}
+
+	delta[kWPANTUNDValueMapKey_Topology_Generation] = mTopologyGeneration;
+
+	handle_topology_change(change, delta);
+}
+
+// Forgets the whole graph. No signal is sent per node; the generation
+// jumps instead, which tells clients to read the topology again.
+void
+SpinelNCPInstance::reset_topology(void)
+{
+	mTopologySnapshotValid = false;
+
+	if (!mTopology.empty()) {
+		mTopology.clear();
+		mTopologyGeneration++;
+		signal_property_changed(kWPANTUNDProperty_NetworkTopologyGeneration, mTopologyGeneration);
+	}
+}
+
+void
+SpinelNCPInstance::get_prop_NetworkTopologyGeneration(CallbackWithStatusArg1 cb)
+{
+	cb(kWPANTUNDStatus_Ok, boost::any(mTopologyGeneration));
+}
+
+void
+SpinelNCPInstance::get_prop_NetworkTopology(CallbackWithStatusArg1 cb)
+{
+	get_topology_snapshot(cb, SpinelNCPTaskGetTopologySnapshot::kResultFormat_StringArray);
+}
+
+void
+SpinelNCPInstance::get_prop_NetworkTopologyAsValMap(CallbackWithStatusArg1 cb)
+{
+	get_topology_snapshot(cb, SpinelNCPTaskGetTopologySnapshot::kResultFormat_ValueMapArray);
+}
+
+void
+SpinelNCPInstance::get_prop_NetworkTopologyBinary(CallbackWithStatusArg1 cb)
+{
+	get_topology_snapshot(cb, SpinelNCPTaskGetTopologySnapshot::kResultFormat_Binary);
+}
+
+void
+SpinelNCPInstance::get_prop_ConnectedDevicesAll(CallbackWithStatusArg1 cb)
+{
+	start_new_task(boost::shared_ptr<SpinelNCPTask>(
+		new SpinelNCPTaskGetConnectedDevices(this, cb, SpinelNCPTaskGetConnectedDevices::kResultFormat_StringArray)
+	));
+}
+
+void
+SpinelNCPInstance::get_prop_ConnectedDevicesAllBinary(CallbackWithStatusArg1 cb)
+{
+	start_new_task(boost::shared_ptr<SpinelNCPTask>(
+		new SpinelNCPTaskGetConnectedDevices(this, cb, SpinelNCPTaskGetConnectedDevices::kResultFormat_Binary)
+	));
+}
+
 void
 SpinelNCPInstance::get_prop_POSIXAppRCPVersionCached(CallbackWithStatusArg1 cb)
 {
@@ -3841,7 +4727,7 @@ SpinelNCPInstance::property_get_value(
 	CallbackWithStatusArg1 cb
 ) {
 	if (!is_initializing_ncp()) {
-		syslog(LOG_INFO, "property_get_value: key: \"%s\"", key.c_str());
+		syslog(LOG_DEBUG, "property_get_value: key: \"%s\"", key.c_str());
 	}
 
 	if (mVendorCustom.is_property_key_supported(key)) {
@@ -3851,6 +4737,17 @@ SpinelNCPInstance::property_get_value(
 	}
 }
 
+NCPInstanceBase::PropertyHandle
+SpinelNCPInstance::get_property_handle(const std::string& key) const
+{
+	// Vendor custom keys are served by name, ahead of the base handlers.
+	if (mVendorCustom.is_property_key_supported(key)) {
+		return kInvalidPropertyHandle;
+	}
+
+	return NCPInstanceBase::get_property_handle(key);
+}
+
 // ----------------------------------------------------------------------------
 // Property Set Handlers
 
@@ -4260,6 +5157,12 @@ SpinelNCPInstance::regsiter_all_set_handlers(void)
 	register_set_handler(
 		kWPANTUNDProperty_NetworkKey,
 		boost::bind(&SpinelNCPInstance::set_prop_NetworkKey, this, _1, _2));
+	register_set_handler(
+		kWPANTUNDProperty_ConfigDaemonPropertyCachePath,
+		boost::bind(&SpinelNCPInstance::set_prop_ConfigDaemonPropertyCachePath, this, _1, _2));
+	register_set_handler(
+		kWPANTUNDProperty_ConfigDaemonSerialReaderThread,
+		boost::bind(&SpinelNCPInstance::set_prop_ConfigDaemonSerialReaderThread, this, _1, _2));
 	register_set_handler(
 		kWPANTUNDProperty_InterfaceUp,
 		boost::bind(&SpinelNCPInstance::set_prop_InterfaceUp, this, _1, _2));
@@ -4622,6 +5525,32 @@ SpinelNCPInstance::set_prop_NetworkKey(const boost::any &value, CallbackWithStat
 	}
 }
 
+void
+SpinelNCPInstance::set_prop_ConfigDaemonPropertyCachePath(const boost::any &value, CallbackWithStatus cb)
+{
+	mPropertyCache.set_path(any_to_string(value));
+
+	if (mPropertyCache.get_state() == PropertyCache::kStateFresh) {
+		// Already confirmed by the NCP, just write them out to the new place.
+		mPropertyCache.save();
+
+	} else if ((get_ncp_state() == UNINITIALIZED) || is_initializing_ncp()) {
+		int count = mPropertyCache.load();
+
+		if (count > 0) {
+			syslog(LOG_NOTICE,
+				"Loaded %d cached properties of NCP \"%s\", last confirmed %u seconds ago",
+				count,
+				mPropertyCache.get_ncp_version().c_str(),
+				mPropertyCache.get_age()
+			);
+			replay_property_cache();
+		}
+	}
+
+	cb(kWPANTUNDStatus_Ok);
+}
+
 void
 SpinelNCPInstance::set_prop_InterfaceUp(const boost::any &value, CallbackWithStatus cb)
 {
@@ -5373,9 +6302,10 @@ SpinelNCPInstance::reset_tasks(wpantund_status_t status)
 		mTaskQueue.front()->finish(status);
 		mTaskQueue.pop_front();
 	}
+	cancel_spinel_transactions(status);
 }
 
-void
+bool
 SpinelNCPInstance::handle_ncp_spinel_value_is_ON_MESH_NETS(const uint8_t *value_data_ptr, spinel_size_t value_data_len)
 {
 	std::multimap<IPv6Prefix, OnMeshPrefixEntry>::iterator iter;
@@ -5477,9 +6407,11 @@ SpinelNCPInstance::handle_ncp_spinel_value_is_ON_MESH_NETS(const uint8_t *value_
 			);
 		}
 	}
+
+	return true;
 }
 
-void
+bool
 SpinelNCPInstance::handle_ncp_spinel_value_is_OFF_MESH_ROUTES(const uint8_t* value_data_ptr, spinel_size_t value_data_len)
 {
 	std::multimap<IPv6Prefix, OffMeshRouteEntry>::iterator iter;
@@ -5568,9 +6500,11 @@ SpinelNCPInstance::handle_ncp_spinel_value_is_OFF_MESH_ROUTES(const uint8_t* val
 				iter->second.get_preference(), iter->second.is_stable(), iter->second.get_rloc());
 		}
 	}
+
+	return true;
 }
 
-void
+bool
 SpinelNCPInstance::handle_ncp_spinel_value_is_SERVICES(const uint8_t* value_data_ptr, spinel_size_t value_data_len)
 {
 	uint32_t enterprise_number;
@@ -5635,1210 +6569,1694 @@ SpinelNCPInstance::handle_ncp_spinel_value_is_SERVICES(const uint8_t* value_data
 			service_was_removed(kOriginThreadNCP, iter->get_enterprise_number(), iter->get_service_data());
 		}
 	}
-}
 
-void
-SpinelNCPInstance::handle_ncp_spinel_value_is(spinel_prop_key_t key, const uint8_t* value_data_ptr, spinel_size_t value_data_len)
-{
-	const uint8_t *original_value_data_ptr = value_data_ptr;
-	spinel_size_t original_value_data_len = value_data_len;
+	return true;
+}
 
-	syslog(LOG_INFO, "KEY ID: %u", key);
-	if (key == SPINEL_PROP_LAST_STATUS) {
-		spinel_status_t status = SPINEL_STATUS_OK;
-		spinel_datatype_unpack(value_data_ptr, value_data_len, "i", &status);
-		syslog(LOG_INFO, "[-NCP-]: Last status (%s, %d)", spinel_status_to_cstr(status), status);
-		if ((status >= SPINEL_STATUS_RESET__BEGIN) && (status <= SPINEL_STATUS_RESET__END)) {
-			//syslog(LOG_NOTICE, "[-NCP-]: NCP was reset (%s, %d)", spinel_status_to_cstr(status), status);
-			//process_event(EVENT_NCP_RESET, status);
-			if (!mResetIsExpected && (mDriverState == NORMAL_OPERATION)) {
-				wpantund_status_t wstatus = kWPANTUNDStatus_NCP_Reset;
-				switch(status) {
-				case SPINEL_STATUS_RESET_CRASH:
-				case SPINEL_STATUS_RESET_FAULT:
-				case SPINEL_STATUS_RESET_ASSERT:
-				case SPINEL_STATUS_RESET_WATCHDOG:
-				case SPINEL_STATUS_RESET_OTHER:
-					wstatus = kWPANTUNDStatus_NCP_Crashed;
-					break;
-				default:
-					break;
-				}
-				reset_tasks(wstatus);
+bool
+SpinelNCPInstance::handle_ncp_spinel_value_is_LAST_STATUS(const uint8_t* value_data_ptr, spinel_size_t value_data_len)
+{
+	spinel_status_t status = SPINEL_STATUS_OK;
+	spinel_datatype_unpack(value_data_ptr, value_data_len, "i", &status);
+	syslog(LOG_INFO, "[-NCP-]: Last status (%s, %d)", spinel_status_to_cstr(status), status);
+	if ((status >= SPINEL_STATUS_RESET__BEGIN) && (status <= SPINEL_STATUS_RESET__END)) {
+		//syslog(LOG_NOTICE, "[-NCP-]: NCP was reset (%s, %d)", spinel_status_to_cstr(status), status);
+		//process_event(EVENT_NCP_RESET, status);
+		if (!mResetIsExpected && (mDriverState == NORMAL_OPERATION)) {
+			wpantund_status_t wstatus = kWPANTUNDStatus_NCP_Reset;
+			switch(status) {
+			case SPINEL_STATUS_RESET_CRASH:
+			case SPINEL_STATUS_RESET_FAULT:
+			case SPINEL_STATUS_RESET_ASSERT:
+			case SPINEL_STATUS_RESET_WATCHDOG:
+			case SPINEL_STATUS_RESET_OTHER:
+				wstatus = kWPANTUNDStatus_NCP_Crashed;
+				break;
+			default:
+				break;
 			}
+			reset_tasks(wstatus);
+		}
 
-			if (mDriverState == NORMAL_OPERATION) {
-				reinitialize_ncp();
-			}
-			mResetIsExpected = false;
-			return;
-		} else if ((status >= SPINEL_STATUS_JOIN__BEGIN) && (status <= SPINEL_STATUS_JOIN__END)) {
-			if (status == SPINEL_STATUS_JOIN_SUCCESS) {
-				change_ncp_state(COMMISSIONED);
-			}
-			else {
-				change_ncp_state(CREDENTIALS_NEEDED);
-			}
-		} else if (status == SPINEL_STATUS_INVALID_COMMAND) {
-			syslog(LOG_NOTICE, "[-NCP-]: COMMAND NOT RECOGNIZED");
+		if (mDriverState == NORMAL_OPERATION) {
+			reinitialize_ncp();
 		}
-	} else if (key == SPINEL_PROP_NCP_VERSION) {
-		const char* ncp_version = NULL;
-		spinel_ssize_t len = spinel_datatype_unpack(value_data_ptr, value_data_len, "U", &ncp_version);
-		if ((len <= 0) || (ncp_version == NULL)) {
-			syslog(LOG_CRIT, "[-NCP-]: Got a corrupted NCP version");
-			// TODO: Properly handle NCP Misbehavior
-			//change_ncp_state(FAULT);
-		} else {
-			set_ncp_version_string(ncp_version);
+		mResetIsExpected = false;
+		return false;
+	} else if ((status >= SPINEL_STATUS_JOIN__BEGIN) && (status <= SPINEL_STATUS_JOIN__END)) {
+		if (status == SPINEL_STATUS_JOIN_SUCCESS) {
+			change_ncp_state(COMMISSIONED);
 		}
-
-	} else if (key == SPINEL_PROP_INTERFACE_TYPE) {
-		unsigned int interface_type = 0;
-		spinel_datatype_unpack(value_data_ptr, value_data_len, "i", &interface_type);
-
-		if (interface_type != SPINEL_PROTOCOL_TYPE_THREAD) {
-			syslog(LOG_CRIT, "[-NCP-]: NCP is using unsupported protocol type (%d)", interface_type);
-			change_ncp_state(FAULT);
+		else {
+			change_ncp_state(CREDENTIALS_NEEDED);
 		}
+	} else if (status == SPINEL_STATUS_INVALID_COMMAND) {
+		syslog(LOG_NOTICE, "[-NCP-]: COMMAND NOT RECOGNIZED");
+	}
 
-		set_ncp_interface_type(interface_type);
+	return true;
+}
 
-	} else if (key == SPINEL_PROP_DODAG_ROUTE_DEST) {
-		uint8_t *entry_ptr = NULL;
-		spinel_size_t entry_len = 0;
-		spinel_ssize_t len = 0;
-		len = spinel_datatype_unpack(value_data_ptr, value_data_len, "D", &entry_ptr, &entry_len);
-		std::string ret = "";
-
-		for (int x = 0; x < DODAG_ROUTE_SIZE/2; x+=2){
-			char str_to_add[4];
-			sprintf(str_to_add, "%02x", entry_ptr[x]);
-			ret.append(str_to_add);
-			sprintf(str_to_add, "%02x:", entry_ptr[x + 1]);
-			ret.append(str_to_add);
-		}
-		set_dodag_route_string(ret);
+bool
+SpinelNCPInstance::handle_ncp_spinel_value_is_NCP_VERSION(const uint8_t* value_data_ptr, spinel_size_t value_data_len)
+{
+	const char* ncp_version = NULL;
+	spinel_ssize_t len = spinel_datatype_unpack(value_data_ptr, value_data_len, "U", &ncp_version);
+	if ((len <= 0) || (ncp_version == NULL)) {
+		syslog(LOG_CRIT, "[-NCP-]: Got a corrupted NCP version");
+		// TODO: Properly handle NCP Misbehavior
+		//change_ncp_state(FAULT);
+	} else {
+		set_ncp_version_string(ncp_version);
+	}
 
-		int array [DODAG_ROUTE_SIZE];
-		for (int x = 0; x < DODAG_ROUTE_SIZE; x++){
-			array[x] = entry_ptr[x];
-		}
-		set_dodag_route_array(array);
-
-	} else if (key == SPINEL_PROP_PHY_CCA_THRESHOLD) {
-		unsigned int cca_threshold = 0;
-		spinel_datatype_unpack(value_data_ptr, value_data_len, "c", &cca_threshold);
-		set_ncp_cca_threshold(cca_threshold);
-
-	} else if (key == SPINEL_PROP_NUM_CONNECTED_DEVICES) {
-		int connected_devices = 0;
-		spinel_datatype_unpack(value_data_ptr, value_data_len, "S", &connected_devices);
-		set_num_connected_devices(connected_devices);
-
-	} else if (key == SPINEL_PROP_PHY_CH_SPACING) {
-		int ch_spacing = 0;
-		spinel_datatype_unpack(value_data_ptr, value_data_len, "S", &ch_spacing);
-		set_ch_spacing(ch_spacing);
-
-	} else if (key == SPINEL_PROP_MAC_BC_INTERVAL) {
-		int bc_interval = 0;
-		spinel_datatype_unpack(value_data_ptr, value_data_len, "L", &bc_interval);
-		set_bc_interval(bc_interval);
-
-	} else if (key == SPINEL_PROP_MAC_UC_DWELL_INTERVAL) {
-		unsigned int uc_dwell_interval = 0;
-		spinel_datatype_unpack(value_data_ptr, value_data_len, "C", &uc_dwell_interval);
-		set_uc_dwell_interval(uc_dwell_interval);
-
-	} else if (key == SPINEL_PROP_MAC_BC_DWELL_INTERVAL) {
-		unsigned int bc_dwell_interval = 0;
-		spinel_datatype_unpack(value_data_ptr, value_data_len, "C", &bc_dwell_interval);
-		set_bc_dwell_interval(bc_dwell_interval);
-
-	} else if (key == SPINEL_PROP_MAC_UC_CHANNEL_FUNCTION) {
-		unsigned int uc_channel_function = 0;
-		spinel_datatype_unpack(value_data_ptr, value_data_len, "C", &uc_channel_function);
-		set_uc_channel_function(uc_channel_function);
-
-	} else if (key == SPINEL_PROP_MAC_BC_CHANNEL_FUNCTION) {
-		unsigned int bc_channel_function = 0;
-		spinel_datatype_unpack(value_data_ptr, value_data_len, "C", &bc_channel_function);
-		set_bc_channel_function(bc_channel_function);
-
-	} else if (key == SPINEL_PROP_MAC_FILTER_MODE) {
-		unsigned int filter_mode = 0;
-		spinel_datatype_unpack(value_data_ptr, value_data_len, "C", &filter_mode);
-		set_mac_filter_mode(filter_mode);
-
-	} else if (key == SPINEL_PROP_PHY_CHO_CENTER_FREQ) {
-		int ch0_mhz = 0;
-		int ch0_khz = 0;
-		uint8_t *entry_ptr = NULL;
-		spinel_size_t entry_len = 0;
-		spinel_ssize_t len = 0;
-		spinel_datatype_unpack(value_data_ptr, value_data_len, "SS", &ch0_mhz, &ch0_khz);
-		set_ch0_center_freq(ch0_mhz, ch0_khz);
+	return true;
+}
 
-	} else if (key == SPINEL_PROP_MAC_MAC_FILTER_LIST) {
-		unsigned int *entry_ptr = NULL;
-		spinel_size_t entry_len = 0;
-		spinel_ssize_t len = 0;
+bool
+SpinelNCPInstance::handle_ncp_spinel_value_is_INTERFACE_TYPE(const uint8_t* value_data_ptr, spinel_size_t value_data_len)
+{
+	unsigned int interface_type = 0;
+	spinel_datatype_unpack(value_data_ptr, value_data_len, "i", &interface_type);
 
-		len = spinel_datatype_unpack(value_data_ptr, value_data_len, "E", &entry_ptr);
-		std::string ret_string [MAC_FILTER_LIST_SIZE];
+	if (interface_type != SPINEL_PROTOCOL_TYPE_THREAD) {
+		syslog(LOG_CRIT, "[-NCP-]: NCP is using unsupported protocol type (%d)", interface_type);
+		change_ncp_state(FAULT);
+	}
 
-		for (int x = 0; x < MAC_FILTER_LIST_SIZE; x++){
-			ret_string[x] = "";
-		}
-		int ret_int [MAC_FILTER_LIST_SIZE * 2];
-		int string_count = 0;
-
-		for (int x = 0; x < (MAC_FILTER_LIST_SIZE * 2); x += 2) {
-			char str_to_add[17];
-			if (x > len) {
-				sprintf(str_to_add, "00000000");
-				ret_string[string_count] = str_to_add;
-				ret_string[string_count].append(str_to_add);
-				ret_int[x] = 0;
-				ret_int[x + 1] = 0;
-				string_count++;
-			}
-			else {
-				sprintf(str_to_add, "%08x", entry_ptr[x]);
-				ret_string[string_count] = str_to_add;
-				ret_int[x] = entry_ptr[x];
-				sprintf(str_to_add, "%08x", entry_ptr[x + 1]);
-				ret_string[string_count].append(str_to_add);
-				ret_int[x + 1] = entry_ptr[x + 1];
-				string_count++;
-			}
-		}
-		set_mac_filter_list(ret_int);
-		for (int x = 0; x < MAC_FILTER_LIST_SIZE * 2; x++){
-			MacFilterList[x] = ret_int[x];
-		}
-		set_mac_filter_list_string(ret_string);
-		for (int x = 0; x < MAC_FILTER_LIST_SIZE; x++){
-			MacFilterListString[x] = ret_string[x];
-		}
+	set_ncp_interface_type(interface_type);
 
-	} else if (key == SPINEL_PROP_PHY_UNICAST_CHANNEL_LIST) {
-		unsigned int unicast_channel_list = 0;
-		spinel_datatype_unpack(value_data_ptr, value_data_len, "i", &unicast_channel_list);
+	return true;
+}
 
-		uint8_t *entry_ptr = NULL;
-		spinel_size_t entry_len = 0;
-		spinel_ssize_t len = 0;
-		len = spinel_datatype_unpack(value_data_ptr, value_data_len, "D", &entry_ptr, &entry_len);
-		std::string ret = "";
+bool
+SpinelNCPInstance::handle_ncp_spinel_value_is_DODAG_ROUTE_DEST(const uint8_t* value_data_ptr, spinel_size_t value_data_len)
+{
+	uint8_t *entry_ptr = NULL;
+	spinel_size_t entry_len = 0;
+	spinel_ssize_t len = 0;
+	len = spinel_datatype_unpack(value_data_ptr, value_data_len, "D", &entry_ptr, &entry_len);
+	std::string ret = "";
 
-		for (int x = 0; x < (len - 1); x++){
-			char str_to_add[4];
-			sprintf(str_to_add, "%02x:", entry_ptr[x]);
-			ret.append(str_to_add);
-		}
-		char final_str_to_add[4];
-		sprintf(final_str_to_add, "%02x", entry_ptr[len - 1]);
-		ret.append(final_str_to_add);
-		set_unicast_channel_list(ret);
-
-		int array [len];
-		for (int x = 0; x < (len); x++){
-			array[x] = entry_ptr[x];
-		}
-		set_unicast_array(array);
+	for (int x = 0; x < DODAG_ROUTE_SIZE/2; x+=2){
+		char str_to_add[4];
+		sprintf(str_to_add, "%02x", entry_ptr[x]);
+		ret.append(str_to_add);
+		sprintf(str_to_add, "%02x:", entry_ptr[x + 1]);
+		ret.append(str_to_add);
+	}
+	set_dodag_route_string(ret);
 
-	} else if (key == SPINEL_PROP_PHY_BROADCAST_CHANNEL_LIST) {
-		unsigned int broadcast_channel_list = 0;
-		spinel_datatype_unpack(value_data_ptr, value_data_len, "i", &broadcast_channel_list);
+	int array [DODAG_ROUTE_SIZE];
+	for (int x = 0; x < DODAG_ROUTE_SIZE; x++){
+		array[x] = entry_ptr[x];
+	}
+	set_dodag_route_array(array);
 
-		uint8_t *entry_ptr = NULL;
-		spinel_size_t entry_len = 0;
-		spinel_ssize_t len = 0;
-		len = spinel_datatype_unpack(value_data_ptr, value_data_len, "D", &entry_ptr, &entry_len);
-		std::string ret = "";
+	return true;
+}
+
+bool
+SpinelNCPInstance::handle_ncp_spinel_value_is_PHY_CCA_THRESHOLD(const uint8_t* value_data_ptr, spinel_size_t value_data_len)
+{
+	unsigned int cca_threshold = 0;
+	spinel_datatype_unpack(value_data_ptr, value_data_len, "c", &cca_threshold);
+	set_ncp_cca_threshold(cca_threshold);
+
+	return true;
+}
 
-		for (int x = 0; x < (len - 1); x++){
-			char str_to_add[4];
-			sprintf(str_to_add, "%02x:", entry_ptr[x]);
-			ret.append(str_to_add);
+bool
+SpinelNCPInstance::handle_ncp_spinel_value_is_NUM_CONNECTED_DEVICES(const uint8_t* value_data_ptr, spinel_size_t value_data_len)
+{
+	int connected_devices = 0;
+	spinel_datatype_unpack(value_data_ptr, value_data_len, "S", &connected_devices);
+
+	// Once someone has looked at the topology, keep it current.
+	if ((connected_devices != mNumConnectedDevices) && !mTopology.empty()) {
+		refresh_topology();
+	}
+
+	set_num_connected_devices(connected_devices);
+
+	return true;
+}
+
+bool
+SpinelNCPInstance::handle_ncp_spinel_value_is_CONNECTED_DEVICES(const uint8_t* value_data_ptr, spinel_size_t value_data_len)
+{
+	std::vector<struct in6_addr> devices;
+	bool is_last_block = false;
+
+	if (TopologyGraph::parse_connected_devices_block(value_data_ptr, value_data_len, devices, is_last_block) == kWPANTUNDStatus_Ok) {
+		for (std::vector<struct in6_addr>::iterator it = devices.begin(); it != devices.end(); ++it) {
+			mTopology.add_node(*it);
 		}
-		char final_str_to_add[4];
-		sprintf(final_str_to_add, "%02x", entry_ptr[len - 1]);
-		ret.append(final_str_to_add);
-		set_broadcast_channel_list(ret);
-
-		int array [len];
-		for (int x = 0; x < (len); x++){
-			array[x] = entry_ptr[x];
+	}
+
+	return true;
+}
+
+bool
+SpinelNCPInstance::handle_ncp_spinel_value_is_DODAG_ROUTE(const uint8_t* value_data_ptr, spinel_size_t value_data_len)
+{
+	std::vector<struct in6_addr> route;
+
+	// SPINEL_PROP_IPV6_LL_ADDR shares this key. A link-local address is
+	// exactly one IPv6 address, while a route is a path cost byte
+	// followed by at least one address, so the length tells them apart.
+	if (value_data_len == sizeof(struct in6_addr)) {
+		struct in6_addr *addr = NULL;
+
+		spinel_datatype_unpack(value_data_ptr, value_data_len, SPINEL_DATATYPE_IPv6ADDR_S, &addr);
+		if (addr != NULL) {
+			syslog(LOG_INFO, "[-NCP-]: Link-local IPv6 address \"%s\"", in6_addr_to_string(*addr).c_str());
 		}
-		set_broadcast_array(array);
+		update_link_local_address(addr);
 
-	} else if (key == SPINEL_PROP_PHY_ASYNC_CHANNEL_LIST) {
-		unsigned int async_channel_list = 0;
-		spinel_datatype_unpack(value_data_ptr, value_data_len, "i", &async_channel_list);
+	} else if (TopologyGraph::parse_dodag_route(value_data_ptr, value_data_len, route) == kWPANTUNDStatus_Ok) {
+		mTopology.add_route(route);
+	}
 
-		uint8_t *entry_ptr = NULL;
-		spinel_size_t entry_len = 0;
-		spinel_ssize_t len = 0;
-		len = spinel_datatype_unpack(value_data_ptr, value_data_len, "D", &entry_ptr, &entry_len);
-		std::string ret = "";
+	return true;
+}
 
-		for (int x = 0; x < (len - 1); x++){
-			char str_to_add[4];
-			sprintf(str_to_add, "%02x:", entry_ptr[x]);
-			ret.append(str_to_add);
+bool
+SpinelNCPInstance::handle_ncp_spinel_value_is_PHY_CH_SPACING(const uint8_t* value_data_ptr, spinel_size_t value_data_len)
+{
+	int ch_spacing = 0;
+	spinel_datatype_unpack(value_data_ptr, value_data_len, "S", &ch_spacing);
+	set_ch_spacing(ch_spacing);
+
+	return true;
+}
+
+bool
+SpinelNCPInstance::handle_ncp_spinel_value_is_MAC_BC_INTERVAL(const uint8_t* value_data_ptr, spinel_size_t value_data_len)
+{
+	int bc_interval = 0;
+	spinel_datatype_unpack(value_data_ptr, value_data_len, "L", &bc_interval);
+	set_bc_interval(bc_interval);
+
+	return true;
+}
+
+bool
+SpinelNCPInstance::handle_ncp_spinel_value_is_MAC_UC_DWELL_INTERVAL(const uint8_t* value_data_ptr, spinel_size_t value_data_len)
+{
+	unsigned int uc_dwell_interval = 0;
+	spinel_datatype_unpack(value_data_ptr, value_data_len, "C", &uc_dwell_interval);
+	set_uc_dwell_interval(uc_dwell_interval);
+
+	return true;
+}
+
+bool
+SpinelNCPInstance::handle_ncp_spinel_value_is_MAC_BC_DWELL_INTERVAL(const uint8_t* value_data_ptr, spinel_size_t value_data_len)
+{
+	unsigned int bc_dwell_interval = 0;
+	spinel_datatype_unpack(value_data_ptr, value_data_len, "C", &bc_dwell_interval);
+	set_bc_dwell_interval(bc_dwell_interval);
+
+	return true;
+}
+
+bool
+SpinelNCPInstance::handle_ncp_spinel_value_is_MAC_UC_CHANNEL_FUNCTION(const uint8_t* value_data_ptr, spinel_size_t value_data_len)
+{
+	unsigned int uc_channel_function = 0;
+	spinel_datatype_unpack(value_data_ptr, value_data_len, "C", &uc_channel_function);
+	set_uc_channel_function(uc_channel_function);
+
+	return true;
+}
+
+bool
+SpinelNCPInstance::handle_ncp_spinel_value_is_MAC_BC_CHANNEL_FUNCTION(const uint8_t* value_data_ptr, spinel_size_t value_data_len)
+{
+	unsigned int bc_channel_function = 0;
+	spinel_datatype_unpack(value_data_ptr, value_data_len, "C", &bc_channel_function);
+	set_bc_channel_function(bc_channel_function);
+
+	return true;
+}
+
+bool
+SpinelNCPInstance::handle_ncp_spinel_value_is_MAC_FILTER_MODE(const uint8_t* value_data_ptr, spinel_size_t value_data_len)
+{
+	unsigned int filter_mode = 0;
+	spinel_datatype_unpack(value_data_ptr, value_data_len, "C", &filter_mode);
+	set_mac_filter_mode(filter_mode);
+
+	return true;
+}
+
+bool
+SpinelNCPInstance::handle_ncp_spinel_value_is_PHY_CHO_CENTER_FREQ(const uint8_t* value_data_ptr, spinel_size_t value_data_len)
+{
+	int ch0_mhz = 0;
+	int ch0_khz = 0;
+	uint8_t *entry_ptr = NULL;
+	spinel_size_t entry_len = 0;
+	spinel_ssize_t len = 0;
+	spinel_datatype_unpack(value_data_ptr, value_data_len, "SS", &ch0_mhz, &ch0_khz);
+	set_ch0_center_freq(ch0_mhz, ch0_khz);
+
+	return true;
+}
+
+bool
+SpinelNCPInstance::handle_ncp_spinel_value_is_MAC_MAC_FILTER_LIST(const uint8_t* value_data_ptr, spinel_size_t value_data_len)
+{
+	unsigned int *entry_ptr = NULL;
+	spinel_size_t entry_len = 0;
+	spinel_ssize_t len = 0;
+
+	len = spinel_datatype_unpack(value_data_ptr, value_data_len, "E", &entry_ptr);
+	std::string ret_string [MAC_FILTER_LIST_SIZE];
+
+	for (int x = 0; x < MAC_FILTER_LIST_SIZE; x++){
+		ret_string[x] = "";
+	}
+	int ret_int [MAC_FILTER_LIST_SIZE * 2];
+	int string_count = 0;
+
+	for (int x = 0; x < (MAC_FILTER_LIST_SIZE * 2); x += 2) {
+		char str_to_add[17];
+		if (x > len) {
+			sprintf(str_to_add, "00000000");
+			ret_string[string_count] = str_to_add;
+			ret_string[string_count].append(str_to_add);
+			ret_int[x] = 0;
+			ret_int[x + 1] = 0;
+			string_count++;
 		}
-		char final_str_to_add[4];
-		sprintf(final_str_to_add, "%02x", entry_ptr[len - 1]);
-		ret.append(final_str_to_add);
-		set_async_channel_list(ret);
-
-		int array [len];
-		for (int x = 0; x < (len); x++){
-			array[x] = entry_ptr[x];
+		else {
+			sprintf(str_to_add, "%08x", entry_ptr[x]);
+			ret_string[string_count] = str_to_add;
+			ret_int[x] = entry_ptr[x];
+			sprintf(str_to_add, "%08x", entry_ptr[x + 1]);
+			ret_string[string_count].append(str_to_add);
+			ret_int[x + 1] = entry_ptr[x + 1];
+			string_count++;
 		}
-		set_async_array(array);
+	}
+	set_mac_filter_list(ret_int);
+	for (int x = 0; x < MAC_FILTER_LIST_SIZE * 2; x++){
+		MacFilterList[x] = ret_int[x];
+	}
+	set_mac_filter_list_string(ret_string);
+	for (int x = 0; x < MAC_FILTER_LIST_SIZE; x++){
+		MacFilterListString[x] = ret_string[x];
+	}
 
-	} else if (key == SPINEL_PROP_PROTOCOL_VERSION) {
-		unsigned int protocol_version_major = 0;
-		unsigned int protocol_version_minor = 0;
-		spinel_datatype_unpack(value_data_ptr, value_data_len, "ii", &protocol_version_major, &protocol_version_minor);
+	return true;
+}
 
-		set_ncp_protocol_version(protocol_version_major, protocol_version_minor);
+bool
+SpinelNCPInstance::handle_ncp_spinel_value_is_PHY_UNICAST_CHANNEL_LIST(const uint8_t* value_data_ptr, spinel_size_t value_data_len)
+{
+	unsigned int unicast_channel_list = 0;
+	spinel_datatype_unpack(value_data_ptr, value_data_len, "i", &unicast_channel_list);
 
-		if (protocol_version_major != SPINEL_PROTOCOL_VERSION_THREAD_MAJOR) {
-			syslog(LOG_CRIT, "[-NCP-]: NCP is using unsupported protocol version (NCP:%d, wpantund:%d)", protocol_version_major, SPINEL_PROTOCOL_VERSION_THREAD_MAJOR);
-			change_ncp_state(FAULT);
-		}
+	uint8_t *entry_ptr = NULL;
+	spinel_size_t entry_len = 0;
+	spinel_ssize_t len = 0;
+	len = spinel_datatype_unpack(value_data_ptr, value_data_len, "D", &entry_ptr, &entry_len);
+	std::string ret = "";
 
-		if (protocol_version_minor != SPINEL_PROTOCOL_VERSION_THREAD_MINOR) {
-			syslog(LOG_WARNING, "[-NCP-]: NCP is using different protocol minor version (NCP:%d, wpantund:%d)", protocol_version_minor, SPINEL_PROTOCOL_VERSION_THREAD_MINOR);
-		}
+	for (int x = 0; x < (len - 1); x++){
+		char str_to_add[4];
+		sprintf(str_to_add, "%02x:", entry_ptr[x]);
+		ret.append(str_to_add);
+	}
+	char final_str_to_add[4];
+	sprintf(final_str_to_add, "%02x", entry_ptr[len - 1]);
+	ret.append(final_str_to_add);
+	set_unicast_channel_list(ret);
 
-	} else if (key == SPINEL_PROP_PHY_REGION) {
-		uint8_t region = 0;
-		spinel_datatype_unpack(value_data_ptr, value_data_len, SPINEL_DATATYPE_UINT8_S, &region);
-		set_ncp_region(region);
-
-	} else if (key == SPINEL_PROP_PHY_MODE_ID) {
-		uint8_t mode_id = 0;
-		spinel_datatype_unpack(value_data_ptr, value_data_len, SPINEL_DATATYPE_UINT8_S, &mode_id);
-		set_ncp_mode_id(mode_id);
-
-	} else if (key == SPINEL_PROP_CAPS) {
-		const uint8_t* data_ptr = value_data_ptr;
-		spinel_size_t data_len = value_data_len;
-		std::set<unsigned int> capabilities;
-
-		while(data_len != 0) {
-			unsigned int value = 0;
-			spinel_ssize_t parse_len = spinel_datatype_unpack(data_ptr, data_len, SPINEL_DATATYPE_UINT_PACKED_S, &value);
-			if (parse_len <= 0) {
-				syslog(LOG_WARNING, "[-NCP-]: Capability Parse failure");
-				break;
-			}
-			capabilities.insert(value);
-			syslog(LOG_INFO, "[-NCP-]: Capability (%s, %d)", spinel_capability_to_cstr(value), value);
+	int array [len];
+	for (int x = 0; x < (len); x++){
+		array[x] = entry_ptr[x];
+	}
+	set_unicast_array(array);
+
+	return true;
+}
+
+bool
+SpinelNCPInstance::handle_ncp_spinel_value_is_PHY_BROADCAST_CHANNEL_LIST(const uint8_t* value_data_ptr, spinel_size_t value_data_len)
+{
+	unsigned int broadcast_channel_list = 0;
+	spinel_datatype_unpack(value_data_ptr, value_data_len, "i", &broadcast_channel_list);
+
+	uint8_t *entry_ptr = NULL;
+	spinel_size_t entry_len = 0;
+	spinel_ssize_t len = 0;
+	len = spinel_datatype_unpack(value_data_ptr, value_data_len, "D", &entry_ptr, &entry_len);
+	std::string ret = "";
+
+	for (int x = 0; x < (len - 1); x++){
+		char str_to_add[4];
+		sprintf(str_to_add, "%02x:", entry_ptr[x]);
+		ret.append(str_to_add);
+	}
+	char final_str_to_add[4];
+	sprintf(final_str_to_add, "%02x", entry_ptr[len - 1]);
+	ret.append(final_str_to_add);
+	set_broadcast_channel_list(ret);
+
+	int array [len];
+	for (int x = 0; x < (len); x++){
+		array[x] = entry_ptr[x];
+	}
+	set_broadcast_array(array);
+
+	return true;
+}
+
+bool
+SpinelNCPInstance::handle_ncp_spinel_value_is_PHY_ASYNC_CHANNEL_LIST(const uint8_t* value_data_ptr, spinel_size_t value_data_len)
+{
+	unsigned int async_channel_list = 0;
+	spinel_datatype_unpack(value_data_ptr, value_data_len, "i", &async_channel_list);
+
+	uint8_t *entry_ptr = NULL;
+	spinel_size_t entry_len = 0;
+	spinel_ssize_t len = 0;
+	len = spinel_datatype_unpack(value_data_ptr, value_data_len, "D", &entry_ptr, &entry_len);
+	std::string ret = "";
+
+	for (int x = 0; x < (len - 1); x++){
+		char str_to_add[4];
+		sprintf(str_to_add, "%02x:", entry_ptr[x]);
+		ret.append(str_to_add);
+	}
+	char final_str_to_add[4];
+	sprintf(final_str_to_add, "%02x", entry_ptr[len - 1]);
+	ret.append(final_str_to_add);
+	set_async_channel_list(ret);
+
+	int array [len];
+	for (int x = 0; x < (len); x++){
+		array[x] = entry_ptr[x];
+	}
+	set_async_array(array);
+
+	return true;
+}
+
+bool
+SpinelNCPInstance::handle_ncp_spinel_value_is_PROTOCOL_VERSION(const uint8_t* value_data_ptr, spinel_size_t value_data_len)
+{
+	unsigned int protocol_version_major = 0;
+	unsigned int protocol_version_minor = 0;
+	spinel_datatype_unpack(value_data_ptr, value_data_len, "ii", &protocol_version_major, &protocol_version_minor);
+
+	set_ncp_protocol_version(protocol_version_major, protocol_version_minor);
+
+	if (protocol_version_major != SPINEL_PROTOCOL_VERSION_THREAD_MAJOR) {
+		syslog(LOG_CRIT, "[-NCP-]: NCP is using unsupported protocol version (NCP:%d, wpantund:%d)", protocol_version_major, SPINEL_PROTOCOL_VERSION_THREAD_MAJOR);
+		change_ncp_state(FAULT);
+	}
+
+	if (protocol_version_minor != SPINEL_PROTOCOL_VERSION_THREAD_MINOR) {
+		syslog(LOG_WARNING, "[-NCP-]: NCP is using different protocol minor version (NCP:%d, wpantund:%d)", protocol_version_minor, SPINEL_PROTOCOL_VERSION_THREAD_MINOR);
+	}
+
+	return true;
+}
+
+bool
+SpinelNCPInstance::handle_ncp_spinel_value_is_PHY_REGION(const uint8_t* value_data_ptr, spinel_size_t value_data_len)
+{
+	uint8_t region = 0;
+	spinel_datatype_unpack(value_data_ptr, value_data_len, SPINEL_DATATYPE_UINT8_S, &region);
+	set_ncp_region(region);
+
+	return true;
+}
+
+bool
+SpinelNCPInstance::handle_ncp_spinel_value_is_PHY_MODE_ID(const uint8_t* value_data_ptr, spinel_size_t value_data_len)
+{
+	uint8_t mode_id = 0;
+	spinel_datatype_unpack(value_data_ptr, value_data_len, SPINEL_DATATYPE_UINT8_S, &mode_id);
+	set_ncp_mode_id(mode_id);
+
+	return true;
+}
 
-			data_ptr += parse_len;
-			data_len -= parse_len;
+bool
+SpinelNCPInstance::handle_ncp_spinel_value_is_CAPS(const uint8_t* value_data_ptr, spinel_size_t value_data_len)
+{
+	const uint8_t* data_ptr = value_data_ptr;
+	spinel_size_t data_len = value_data_len;
+	std::set<unsigned int> capabilities;
+
+	while(data_len != 0) {
+		unsigned int value = 0;
+		spinel_ssize_t parse_len = spinel_datatype_unpack(data_ptr, data_len, SPINEL_DATATYPE_UINT_PACKED_S, &value);
+		if (parse_len <= 0) {
+			syslog(LOG_WARNING, "[-NCP-]: Capability Parse failure");
+			break;
 		}
+		capabilities.insert(value);
+		syslog(LOG_INFO, "[-NCP-]: Capability (%s, %d)", spinel_capability_to_cstr(value), value);
+
+		data_ptr += parse_len;
+		data_len -= parse_len;
+	}
+
+	if (capabilities != mCapabilities) {
+		mCapabilities = capabilities;
+	}
+
+	return true;
+}
 
-		if (capabilities != mCapabilities) {
-			mCapabilities = capabilities;
+bool
+SpinelNCPInstance::handle_ncp_spinel_value_is_NET_NETWORK_NAME(const uint8_t* value_data_ptr, spinel_size_t value_data_len)
+{
+	const char* value = NULL;
+	spinel_ssize_t len = spinel_datatype_unpack(value_data_ptr, value_data_len, "U", &value);
+
+	if ((len <= 0) || (value == NULL)) {
+		syslog(LOG_CRIT, "[-NCP-]: Got a corrupted NCP version");
+		// TODO: Properly handle NCP Misbehavior
+		change_ncp_state(FAULT);
+	} else {
+		syslog(LOG_INFO, "[-NCP-]: Network name \"%s\"", value);
+		if (mCurrentNetworkInstance.name != value) {
+			mCurrentNetworkInstance.name = value;
+			signal_property_changed(kWPANTUNDProperty_NetworkName, mCurrentNetworkInstance.name);
 		}
+	}
 
-	} else if (key == SPINEL_PROP_NET_NETWORK_NAME) {
-		const char* value = NULL;
-		spinel_ssize_t len = spinel_datatype_unpack(value_data_ptr, value_data_len, "U", &value);
+	return true;
+}
 
-		if ((len <= 0) || (value == NULL)) {
-			syslog(LOG_CRIT, "[-NCP-]: Got a corrupted NCP version");
-			// TODO: Properly handle NCP Misbehavior
-			change_ncp_state(FAULT);
-		} else {
-			syslog(LOG_INFO, "[-NCP-]: Network name \"%s\"", value);
-			if (mCurrentNetworkInstance.name != value) {
-				mCurrentNetworkInstance.name = value;
-				signal_property_changed(kWPANTUNDProperty_NetworkName, mCurrentNetworkInstance.name);
+bool
+SpinelNCPInstance::handle_ncp_spinel_value_is_MCU_POWER_STATE(const uint8_t* value_data_ptr, spinel_size_t value_data_len)
+{
+	uint8_t power_state = 0;
+	spinel_ssize_t len = 0;
+
+	len  = spinel_datatype_unpack(value_data_ptr, value_data_len, SPINEL_DATATYPE_UINT8_S, &power_state);
+
+	if (len > 0) {
+		syslog(LOG_INFO, "[-NCP-]: MCU power state \"%s\" (%d)",
+			spinel_mcu_power_state_to_cstr(static_cast<spinel_mcu_power_state_t>(power_state)), power_state);
+
+		switch (get_ncp_state()) {
+		case OFFLINE:
+		case COMMISSIONED:
+			if (power_state == SPINEL_MCU_POWER_STATE_LOW_POWER) {
+				change_ncp_state(DEEP_SLEEP);
+			}
+			break;
+
+		case DEEP_SLEEP:
+			if (power_state == SPINEL_MCU_POWER_STATE_ON) {
+				change_ncp_state(mIsCommissioned ? COMMISSIONED : OFFLINE);
 			}
+			break;
+
+		default:
+			break;
 		}
+	}
 
-	} else if (key == SPINEL_PROP_MCU_POWER_STATE) {
-		uint8_t power_state = 0;
-		spinel_ssize_t len = 0;
+	return true;
+}
 
-		len  = spinel_datatype_unpack(value_data_ptr, value_data_len, SPINEL_DATATYPE_UINT8_S, &power_state);
+bool
+SpinelNCPInstance::handle_ncp_spinel_value_is_IPV6_ML_PREFIX(const uint8_t* value_data_ptr, spinel_size_t value_data_len)
+{
+	struct in6_addr *addr = NULL;
+	spinel_datatype_unpack(value_data_ptr, value_data_len, "6", &addr);
+	if (addr != NULL) {
+		syslog(LOG_INFO, "[-NCP-]: Mesh-local prefix \"%s\"", (in6_addr_to_string(*addr) + "/64").c_str());
+	}
+	update_mesh_local_prefix(addr);
 
-		if (len > 0) {
-			syslog(LOG_INFO, "[-NCP-]: MCU power state \"%s\" (%d)",
-				spinel_mcu_power_state_to_cstr(static_cast<spinel_mcu_power_state_t>(power_state)), power_state);
+	return true;
+}
 
-			switch (get_ncp_state()) {
-			case OFFLINE:
-			case COMMISSIONED:
-				if (power_state == SPINEL_MCU_POWER_STATE_LOW_POWER) {
-					change_ncp_state(DEEP_SLEEP);
-				}
-				break;
+bool
+SpinelNCPInstance::handle_ncp_spinel_value_is_IPV6_ADDRESS_TABLE(const uint8_t* value_data_ptr, spinel_size_t value_data_len)
+{
+	std::map<struct in6_addr, UnicastAddressEntry>::const_iterator iter;
+	std::map<struct in6_addr, UnicastAddressEntry> unicast_addresses(mUnicastAddresses);
+	const struct in6_addr *addr = NULL;
+	int num_address = 0;
 
-			case DEEP_SLEEP:
-				if (power_state == SPINEL_MCU_POWER_STATE_ON) {
-					change_ncp_state(mIsCommissioned ? COMMISSIONED : OFFLINE);
-				}
-				break;
+	while (value_data_len > 0) {
+		const uint8_t *entry_ptr = NULL;
+		spinel_size_t entry_len = 0;
+		spinel_ssize_t len = 0;
+		len = spinel_datatype_unpack(value_data_ptr, value_data_len, "D.", &entry_ptr, &entry_len);
+		if (len < 1) {
+			break;
+		}
 
-			default:
-				break;
-			}
+		addr = reinterpret_cast<const struct in6_addr*>(entry_ptr);
+		syslog(LOG_INFO, "[-NCP-]: IPv6 address [%d] \"%s\"", num_address, in6_addr_to_string(*addr).c_str());
+		num_address++;
+		unicast_addresses.erase(*addr);
+		handle_ncp_spinel_value_inserted(SPINEL_PROP_IPV6_ADDRESS_TABLE, entry_ptr, entry_len);
+
+		value_data_ptr += len;
+		value_data_len -= len;
+	}
+
+	syslog(LOG_INFO, "[-NCP-]: IPv6 address: Total %d address%s", num_address, (num_address > 1) ? "es" : "");
+
+	// Since this was the whole list, we need to remove the addresses
+	// which originated from NCP that that weren't in the list.
+	for (iter = unicast_addresses.begin(); iter != unicast_addresses.end(); ++iter) {
+		if (iter->second.is_from_ncp()) {
+			unicast_address_was_removed(kOriginThreadNCP, iter->first);
 		}
+	}
 
-	} else if (key == SPINEL_PROP_IPV6_LL_ADDR) {
-		struct in6_addr *addr = NULL;
+	return true;
+}
 
-		spinel_datatype_unpack(value_data_ptr, value_data_len, "6", &addr);
-		if (addr != NULL) {
-			syslog(LOG_INFO, "[-NCP-]: Link-local IPv6 address \"%s\"", in6_addr_to_string(*addr).c_str());
+bool
+SpinelNCPInstance::handle_ncp_spinel_value_is_IPV6_MULTICAST_ADDRESS_TABLE(const uint8_t* value_data_ptr, spinel_size_t value_data_len)
+{
+	std::map<struct in6_addr, MulticastAddressEntry>::const_iterator iter;
+	std::map<struct in6_addr, MulticastAddressEntry> multicast_addresses(mMulticastAddresses);
+	const struct in6_addr *addr = NULL;
+	int num_address = 0;
+
+	while (value_data_len > 0) {
+		const uint8_t *entry_ptr = NULL;
+		spinel_size_t entry_len = 0;
+		spinel_ssize_t len = 0;
+		len = spinel_datatype_unpack(value_data_ptr, value_data_len, "D.", &entry_ptr, &entry_len);
+		if (len < 1) {
+			break;
 		}
-		update_link_local_address(addr);
 
-	} else if (key == SPINEL_PROP_IPV6_ML_PREFIX) {
-		struct in6_addr *addr = NULL;
-		spinel_datatype_unpack(value_data_ptr, value_data_len, "6", &addr);
-		if (addr != NULL) {
-			syslog(LOG_INFO, "[-NCP-]: Mesh-local prefix \"%s\"", (in6_addr_to_string(*addr) + "/64").c_str());
+		addr = reinterpret_cast<const struct in6_addr*>(entry_ptr);
+		syslog(LOG_INFO, "[-NCP-]: Multicast IPv6 address [%d] \"%s\"", num_address, in6_addr_to_string(*addr).c_str());
+		num_address++;
+		multicast_addresses.erase(*addr);
+		handle_ncp_spinel_value_inserted(SPINEL_PROP_IPV6_MULTICAST_ADDRESS_TABLE, entry_ptr, entry_len);
+
+		value_data_ptr += len;
+		value_data_len -= len;
+	}
+
+	// Since this was the whole list, we need to remove the addresses
+	// which originated from NCP that that weren't in the list.
+	for (iter = multicast_addresses.begin(); iter != multicast_addresses.end(); ++iter) {
+		if (iter->second.is_from_ncp()) {
+			multicast_address_was_left(kOriginThreadNCP, iter->first);
 		}
-		update_mesh_local_prefix(addr);
+	}
 
-	} else if (key == SPINEL_PROP_IPV6_ADDRESS_TABLE) {
-		std::map<struct in6_addr, UnicastAddressEntry>::const_iterator iter;
-		std::map<struct in6_addr, UnicastAddressEntry> unicast_addresses(mUnicastAddresses);
-		const struct in6_addr *addr = NULL;
-		int num_address = 0;
+	return true;
+}
 
-		while (value_data_len > 0) {
-			const uint8_t *entry_ptr = NULL;
-			spinel_size_t entry_len = 0;
-			spinel_ssize_t len = 0;
-			len = spinel_datatype_unpack(value_data_ptr, value_data_len, "D.", &entry_ptr, &entry_len);
-			if (len < 1) {
-				break;
-			}
+bool
+SpinelNCPInstance::handle_ncp_spinel_value_is_HWADDR(const uint8_t* value_data_ptr, spinel_size_t value_data_len)
+{
+	nl::Data hwaddr(value_data_ptr, value_data_len);
+	if (value_data_len == sizeof(mMACHardwareAddress)) {
+		set_mac_hardware_address(value_data_ptr);
+	}
 
-			addr = reinterpret_cast<const struct in6_addr*>(entry_ptr);
-			syslog(LOG_INFO, "[-NCP-]: IPv6 address [%d] \"%s\"", num_address, in6_addr_to_string(*addr).c_str());
-			num_address++;
-			unicast_addresses.erase(*addr);
-			handle_ncp_spinel_value_inserted(key, entry_ptr, entry_len);
+	return true;
+}
 
-			value_data_ptr += len;
-			value_data_len -= len;
-		}
+bool
+SpinelNCPInstance::handle_ncp_spinel_value_is_MAC_15_4_LADDR(const uint8_t* value_data_ptr, spinel_size_t value_data_len)
+{
+	nl::Data hwaddr(value_data_ptr, value_data_len);
+	if (value_data_len == sizeof(mMACAddress)) {
+		set_mac_address(value_data_ptr);
+	}
 
-		syslog(LOG_INFO, "[-NCP-]: IPv6 address: Total %d address%s", num_address, (num_address > 1) ? "es" : "");
+	return true;
+}
 
-		// Since this was the whole list, we need to remove the addresses
-		// which originated from NCP that that weren't in the list.
-		for (iter = unicast_addresses.begin(); iter != unicast_addresses.end(); ++iter) {
-			if (iter->second.is_from_ncp()) {
-				unicast_address_was_removed(kOriginThreadNCP, iter->first);
-			}
-		}
+bool
+SpinelNCPInstance::handle_ncp_spinel_value_is_MAC_15_4_PANID(const uint8_t* value_data_ptr, spinel_size_t value_data_len)
+{
+	uint16_t panid;
+	spinel_datatype_unpack(value_data_ptr, value_data_len, SPINEL_DATATYPE_UINT16_S, &panid);
+	syslog(LOG_INFO, "[-NCP-]: PANID 0x%04X", panid);
+	if (panid != mCurrentNetworkInstance.panid) {
+		mCurrentNetworkInstance.panid = panid;
+		signal_property_changed(kWPANTUNDProperty_NetworkPANID, panid);
+	}
+
+	return true;
+}
+
+bool
+SpinelNCPInstance::handle_ncp_spinel_value_is_NET_XPANID(const uint8_t* value_data_ptr, spinel_size_t value_data_len)
+{
+	nl::Data xpanid(value_data_ptr, value_data_len);
+	char cstr_buf[200];
+	encode_data_into_string(value_data_ptr, value_data_len, cstr_buf, sizeof(cstr_buf), 0);
+	syslog(LOG_INFO, "[-NCP-] XPANID 0x%s", cstr_buf);
+
+	if ((value_data_len == 8) && 0 != memcmp(xpanid.data(), mCurrentNetworkInstance.xpanid, 8)) {
+		memcpy(mCurrentNetworkInstance.xpanid, xpanid.data(), 8);
+		signal_property_changed(kWPANTUNDProperty_NetworkXPANID, xpanid);
+	}
+
+	return true;
+}
+
+bool
+SpinelNCPInstance::handle_ncp_spinel_value_is_NET_PSKC(const uint8_t* value_data_ptr, spinel_size_t value_data_len)
+{
+	nl::Data network_pskc(value_data_ptr, value_data_len);
+	if (network_pskc != mNetworkPSKc) {
+		mNetworkPSKc = network_pskc;
+		signal_property_changed(kWPANTUNDProperty_NetworkPSKc, mNetworkPSKc);
+	}
 
-	} else if (key == SPINEL_PROP_IPV6_MULTICAST_ADDRESS_TABLE) {
-		std::map<struct in6_addr, MulticastAddressEntry>::const_iterator iter;
-		std::map<struct in6_addr, MulticastAddressEntry> multicast_addresses(mMulticastAddresses);
-		const struct in6_addr *addr = NULL;
-		int num_address = 0;
+	return true;
+}
 
-		while (value_data_len > 0) {
-			const uint8_t *entry_ptr = NULL;
-			spinel_size_t entry_len = 0;
-			spinel_ssize_t len = 0;
-			len = spinel_datatype_unpack(value_data_ptr, value_data_len, "D.", &entry_ptr, &entry_len);
-			if (len < 1) {
-				break;
-			}
+bool
+SpinelNCPInstance::handle_ncp_spinel_value_is_NET_MASTER_KEY(const uint8_t* value_data_ptr, spinel_size_t value_data_len)
+{
+	nl::Data network_key(value_data_ptr, value_data_len);
+	if (ncp_state_is_joining_or_joined(get_ncp_state())) {
+		if (network_key != mNetworkKey) {
+			mNetworkKey = network_key;
+			signal_property_changed(kWPANTUNDProperty_NetworkKey, mNetworkKey);
+		}
+	}
 
-			addr = reinterpret_cast<const struct in6_addr*>(entry_ptr);
-			syslog(LOG_INFO, "[-NCP-]: Multicast IPv6 address [%d] \"%s\"", num_address, in6_addr_to_string(*addr).c_str());
-			num_address++;
-			multicast_addresses.erase(*addr);
-			handle_ncp_spinel_value_inserted(key, entry_ptr, entry_len);
+	return true;
+}
 
-			value_data_ptr += len;
-			value_data_len -= len;
-		}
+bool
+SpinelNCPInstance::handle_ncp_spinel_value_is_NET_KEY_SEQUENCE_COUNTER(const uint8_t* value_data_ptr, spinel_size_t value_data_len)
+{
+	uint32_t network_key_index = 0;
+	spinel_ssize_t ret;
 
-		// Since this was the whole list, we need to remove the addresses
-		// which originated from NCP that that weren't in the list.
-		for (iter = multicast_addresses.begin(); iter != multicast_addresses.end(); ++iter) {
-			if (iter->second.is_from_ncp()) {
-				multicast_address_was_left(kOriginThreadNCP, iter->first);
-			}
-		}
-	} else if (key == SPINEL_PROP_HWADDR) {
-		nl::Data hwaddr(value_data_ptr, value_data_len);
-		if (value_data_len == sizeof(mMACHardwareAddress)) {
-			set_mac_hardware_address(value_data_ptr);
-		}
+	ret = spinel_datatype_unpack(value_data_ptr, value_data_len, SPINEL_DATATYPE_UINT32_S, &network_key_index);
+	//
+	__ASSERT_MACROS_check(ret > 0);
 
-	} else if (key == SPINEL_PROP_MAC_15_4_LADDR) {
-		nl::Data hwaddr(value_data_ptr, value_data_len);
-		if (value_data_len == sizeof(mMACAddress)) {
-			set_mac_address(value_data_ptr);
-		}
+	if ((ret > 0) && (network_key_index != mNetworkKeyIndex)) {
+		mNetworkKeyIndex = network_key_index;
+		signal_property_changed(kWPANTUNDProperty_NetworkKeyIndex, mNetworkKeyIndex);
+	}
 
-	} else if (key == SPINEL_PROP_MAC_15_4_PANID) {
-		uint16_t panid;
-		spinel_datatype_unpack(value_data_ptr, value_data_len, SPINEL_DATATYPE_UINT16_S, &panid);
-		syslog(LOG_INFO, "[-NCP-]: PANID 0x%04X", panid);
-		if (panid != mCurrentNetworkInstance.panid) {
-			mCurrentNetworkInstance.panid = panid;
-			signal_property_changed(kWPANTUNDProperty_NetworkPANID, panid);
-		}
+	return true;
+}
 
-	} else if (key == SPINEL_PROP_NET_XPANID) {
-		nl::Data xpanid(value_data_ptr, value_data_len);
-		char cstr_buf[200];
-		encode_data_into_string(value_data_ptr, value_data_len, cstr_buf, sizeof(cstr_buf), 0);
-		syslog(LOG_INFO, "[-NCP-] XPANID 0x%s", cstr_buf);
+bool
+SpinelNCPInstance::handle_ncp_spinel_value_is_PHY_CHAN(const uint8_t* value_data_ptr, spinel_size_t value_data_len)
+{
+	unsigned int value = 0;
+	spinel_ssize_t ret;
 
-		if ((value_data_len == 8) && 0 != memcmp(xpanid.data(), mCurrentNetworkInstance.xpanid, 8)) {
-			memcpy(mCurrentNetworkInstance.xpanid, xpanid.data(), 8);
-			signal_property_changed(kWPANTUNDProperty_NetworkXPANID, xpanid);
-		}
+	ret = spinel_datatype_unpack(value_data_ptr, value_data_len, SPINEL_DATATYPE_UINT_PACKED_S, &value);
 
-	} else if (key == SPINEL_PROP_NET_PSKC) {
-		nl::Data network_pskc(value_data_ptr, value_data_len);
-		if (network_pskc != mNetworkPSKc) {
-			mNetworkPSKc = network_pskc;
-			signal_property_changed(kWPANTUNDProperty_NetworkPSKc, mNetworkPSKc);
-		}
+	__ASSERT_MACROS_check(ret > 0);
 
-	} else if (key == SPINEL_PROP_NET_MASTER_KEY) {
-		nl::Data network_key(value_data_ptr, value_data_len);
-		if (ncp_state_is_joining_or_joined(get_ncp_state())) {
-			if (network_key != mNetworkKey) {
-				mNetworkKey = network_key;
-				signal_property_changed(kWPANTUNDProperty_NetworkKey, mNetworkKey);
-			}
+	if (ret > 0) {
+		syslog(LOG_INFO, "[-NCP-]: Channel %d", value);
+		if (value != mCurrentNetworkInstance.channel) {
+			mCurrentNetworkInstance.channel = value;
+			signal_property_changed(kWPANTUNDProperty_NCPChannel, mCurrentNetworkInstance.channel);
 		}
+	}
 
-	} else if (key == SPINEL_PROP_NET_KEY_SEQUENCE_COUNTER) {
-		uint32_t network_key_index = 0;
-		spinel_ssize_t ret;
+	return true;
+}
 
-		ret = spinel_datatype_unpack(value_data_ptr, value_data_len, SPINEL_DATATYPE_UINT32_S, &network_key_index);
-		//
-		__ASSERT_MACROS_check(ret > 0);
+bool
+SpinelNCPInstance::handle_ncp_spinel_value_is_PHY_CHAN_SUPPORTED(const uint8_t* value_data_ptr, spinel_size_t value_data_len)
+{
+	boost::any mask_value;
+	int ret = unpack_channel_mask(value_data_ptr, value_data_len, mask_value);
 
-		if ((ret > 0) && (network_key_index != mNetworkKeyIndex)) {
-			mNetworkKeyIndex = network_key_index;
-			signal_property_changed(kWPANTUNDProperty_NetworkKeyIndex, mNetworkKeyIndex);
-		}
+	if (ret == kWPANTUNDStatus_Ok) {
+		mSupportedChannelMask = any_to_int(mask_value);
+		syslog(LOG_INFO, "[-NCP-]: Supported Channel Mask 0x%x", mSupportedChannelMask);
+	}
 
-	} else if (key == SPINEL_PROP_PHY_CHAN) {
-		unsigned int value = 0;
-		spinel_ssize_t ret;
+	return true;
+}
 
-		ret = spinel_datatype_unpack(value_data_ptr, value_data_len, SPINEL_DATATYPE_UINT_PACKED_S, &value);
+bool
+SpinelNCPInstance::handle_ncp_spinel_value_is_PHY_CHAN_PREFERRED(const uint8_t* value_data_ptr, spinel_size_t value_data_len)
+{
+	boost::any mask_value;
+	int ret = unpack_channel_mask(value_data_ptr, value_data_len, mask_value);
 
-		__ASSERT_MACROS_check(ret > 0);
+	if (ret == kWPANTUNDStatus_Ok) {
+		mPreferredChannelMask = any_to_int(mask_value);
+		syslog(LOG_INFO, "[-NCP-]: Preferred Channel Mask 0x%x", mPreferredChannelMask);
+	}
 
-		if (ret > 0) {
-			syslog(LOG_INFO, "[-NCP-]: Channel %d", value);
-			if (value != mCurrentNetworkInstance.channel) {
-				mCurrentNetworkInstance.channel = value;
-				signal_property_changed(kWPANTUNDProperty_NCPChannel, mCurrentNetworkInstance.channel);
-			}
-		}
+	return true;
+}
 
-	} else if (key == SPINEL_PROP_PHY_CHAN_SUPPORTED) {
-		boost::any mask_value;
-		int ret = unpack_channel_mask(value_data_ptr, value_data_len, mask_value);
+bool
+SpinelNCPInstance::handle_ncp_spinel_value_is_PHY_TX_POWER(const uint8_t* value_data_ptr, spinel_size_t value_data_len)
+{
+	int8_t value = 0;
+	spinel_ssize_t ret;
 
-		if (ret == kWPANTUNDStatus_Ok) {
-			mSupportedChannelMask = any_to_int(mask_value);
-			syslog(LOG_INFO, "[-NCP-]: Supported Channel Mask 0x%x", mSupportedChannelMask);
-		}
+	ret = spinel_datatype_unpack(value_data_ptr, value_data_len, SPINEL_DATATYPE_INT8_S, &value);
 
-	} else if (key == SPINEL_PROP_PHY_CHAN_PREFERRED) {
-		boost::any mask_value;
-		int ret = unpack_channel_mask(value_data_ptr, value_data_len, mask_value);
+	__ASSERT_MACROS_check(ret > 0);
 
-		if (ret == kWPANTUNDStatus_Ok) {
-			mPreferredChannelMask = any_to_int(mask_value);
-			syslog(LOG_INFO, "[-NCP-]: Preferred Channel Mask 0x%x", mPreferredChannelMask);
+	if (ret > 0) {
+		syslog(LOG_INFO, "[-NCP-]: Tx power %d", value);
+		if (value != mTXPower) {
+			mTXPower = value;
+			signal_property_changed(kWPANTUNDProperty_NCPTXPower, mTXPower);
 		}
+	}
 
-	} else if (key == SPINEL_PROP_PHY_TX_POWER) {
-		int8_t value = 0;
-		spinel_ssize_t ret;
+	return true;
+}
 
-		ret = spinel_datatype_unpack(value_data_ptr, value_data_len, SPINEL_DATATYPE_INT8_S, &value);
+bool
+SpinelNCPInstance::handle_ncp_spinel_value_is_STREAM_DEBUG(const uint8_t* value_data_ptr, spinel_size_t value_data_len)
+{
+	handle_ncp_debug_stream(value_data_ptr, value_data_len);
 
-		__ASSERT_MACROS_check(ret > 0);
+	return true;
+}
 
-		if (ret > 0) {
-			syslog(LOG_INFO, "[-NCP-]: Tx power %d", value);
-			if (value != mTXPower) {
-				mTXPower = value;
-				signal_property_changed(kWPANTUNDProperty_NCPTXPower, mTXPower);
-			}
-		}
+bool
+SpinelNCPInstance::handle_ncp_spinel_value_is_STREAM_LOG(const uint8_t* value_data_ptr, spinel_size_t value_data_len)
+{
+	handle_ncp_log_stream(value_data_ptr, value_data_len);
 
-	} else if (key == SPINEL_PROP_STREAM_DEBUG) {
-		handle_ncp_debug_stream(value_data_ptr, value_data_len);
+	return true;
+}
 
-	} else if (key == SPINEL_PROP_STREAM_LOG) {
-		handle_ncp_log_stream(value_data_ptr, value_data_len);
+bool
+SpinelNCPInstance::handle_ncp_spinel_value_is_NET_ROLE(const uint8_t* value_data_ptr, spinel_size_t value_data_len)
+{
+	uint8_t value = 0;
+	spinel_ssize_t ret;
 
-	} else if (key == SPINEL_PROP_NET_ROLE) {
-		uint8_t value = 0;
-		spinel_ssize_t ret;
+	ret = spinel_datatype_unpack(value_data_ptr, value_data_len, SPINEL_DATATYPE_UINT8_S, &value);
 
-		ret = spinel_datatype_unpack(value_data_ptr, value_data_len, SPINEL_DATATYPE_UINT8_S, &value);
+	__ASSERT_MACROS_check(ret > 0);
 
-		__ASSERT_MACROS_check(ret > 0);
+	if (ret > 0) {
+		syslog(LOG_INFO, "[-NCP-]: Net Role \"%s\" (%d)", spinel_net_role_to_cstr(value), value);
 
-		if (ret > 0) {
-			syslog(LOG_INFO, "[-NCP-]: Net Role \"%s\" (%d)", spinel_net_role_to_cstr(value), value);
+		if (ncp_state_is_joining_or_joined(get_ncp_state())
+		  && (value != SPINEL_NET_ROLE_DETACHED)
+		) {
+			change_ncp_state(ASSOCIATED);
+		}
 
-			if (ncp_state_is_joining_or_joined(get_ncp_state())
-			  && (value != SPINEL_NET_ROLE_DETACHED)
-			) {
-				change_ncp_state(ASSOCIATED);
+		if (value == SPINEL_NET_ROLE_CHILD) {
+			if ((mThreadMode & SPINEL_THREAD_MODE_RX_ON_WHEN_IDLE) != 0) {
+				update_node_type(END_DEVICE);
+			} else {
+				update_node_type(SLEEPY_END_DEVICE);
 			}
 
-			if (value == SPINEL_NET_ROLE_CHILD) {
-				if ((mThreadMode & SPINEL_THREAD_MODE_RX_ON_WHEN_IDLE) != 0) {
-					update_node_type(END_DEVICE);
-				} else {
-					update_node_type(SLEEPY_END_DEVICE);
-				}
-
-			} else if (value == SPINEL_NET_ROLE_ROUTER) {
-				update_node_type(ROUTER);
+		} else if (value == SPINEL_NET_ROLE_ROUTER) {
+			update_node_type(ROUTER);
 
-			} else if (value == SPINEL_NET_ROLE_LEADER) {
-				update_node_type(LEADER);
+		} else if (value == SPINEL_NET_ROLE_LEADER) {
+			update_node_type(LEADER);
 
-			} else if (value == SPINEL_NET_ROLE_DETACHED) {
-				update_node_type(UNKNOWN);
-				if (ncp_state_is_associated(get_ncp_state())) {
-					change_ncp_state(ISOLATED);
-				}
+		} else if (value == SPINEL_NET_ROLE_DETACHED) {
+			update_node_type(UNKNOWN);
+			if (ncp_state_is_associated(get_ncp_state())) {
+				change_ncp_state(ISOLATED);
 			}
 		}
+	}
 
-	} else if (key == SPINEL_PROP_THREAD_MODE) {
-		uint8_t value = mThreadMode;
-		spinel_ssize_t ret;
+	return true;
+}
 
-		ret = spinel_datatype_unpack(value_data_ptr, value_data_len, SPINEL_DATATYPE_UINT8_S, &value);
+bool
+SpinelNCPInstance::handle_ncp_spinel_value_is_THREAD_MODE(const uint8_t* value_data_ptr, spinel_size_t value_data_len)
+{
+	uint8_t value = mThreadMode;
+	spinel_ssize_t ret;
 
-		__ASSERT_MACROS_check(ret > 0);
+	ret = spinel_datatype_unpack(value_data_ptr, value_data_len, SPINEL_DATATYPE_UINT8_S, &value);
 
-		if (ret > 0) {
-			syslog(LOG_INFO, "[-NCP-]: Thread Mode \"%s\" (0x%02x)", thread_mode_to_string(value).c_str(), value);
-			mThreadMode = value;
+	__ASSERT_MACROS_check(ret > 0);
 
-			switch (get_ncp_state())
-			{
-			case ISOLATED:
-				if ((mThreadMode & SPINEL_THREAD_MODE_RX_ON_WHEN_IDLE) != 0) {
-					change_ncp_state(ASSOCIATING);
-				}
-				break;
+	if (ret > 0) {
+		syslog(LOG_INFO, "[-NCP-]: Thread Mode \"%s\" (0x%02x)", thread_mode_to_string(value).c_str(), value);
+		mThreadMode = value;
 
-			case ASSOCIATING:
-				if (mIsCommissioned && ((mThreadMode & SPINEL_THREAD_MODE_RX_ON_WHEN_IDLE) == 0)) {
-					change_ncp_state(ISOLATED);
-				}
-				break;
+		switch (get_ncp_state())
+		{
+		case ISOLATED:
+			if ((mThreadMode & SPINEL_THREAD_MODE_RX_ON_WHEN_IDLE) != 0) {
+				change_ncp_state(ASSOCIATING);
+			}
+			break;
 
-			default:
-				break;
+		case ASSOCIATING:
+			if (mIsCommissioned && ((mThreadMode & SPINEL_THREAD_MODE_RX_ON_WHEN_IDLE) == 0)) {
+				change_ncp_state(ISOLATED);
 			}
+			break;
 
-			switch (mNodeType)
-			{
-			case END_DEVICE:
-			case SLEEPY_END_DEVICE:
-				if ((mThreadMode & SPINEL_THREAD_MODE_RX_ON_WHEN_IDLE) != 0) {
-					update_node_type(END_DEVICE);
-				} else {
-					update_node_type(SLEEPY_END_DEVICE);
-				}
-				break;
+		default:
+			break;
+		}
 
-			default:
-				break;
+		switch (mNodeType)
+		{
+		case END_DEVICE:
+		case SLEEPY_END_DEVICE:
+			if ((mThreadMode & SPINEL_THREAD_MODE_RX_ON_WHEN_IDLE) != 0) {
+				update_node_type(END_DEVICE);
+			} else {
+				update_node_type(SLEEPY_END_DEVICE);
 			}
-		}
+			break;
 
-	} else if (key == SPINEL_PROP_NET_SAVED) {
-		bool is_commissioned = false;
-		spinel_datatype_unpack(value_data_ptr, value_data_len, SPINEL_DATATYPE_BOOL_S, &is_commissioned);
-		syslog(LOG_INFO, "[-NCP-]: NetSaved (NCP is commissioned?) \"%s\" ", is_commissioned ? "yes" : "no");
-		mIsCommissioned = is_commissioned;
-		if (mIsCommissioned && (get_ncp_state() == OFFLINE)) {
-			// Just keep it offline
-			// change_ncp_state(COMMISSIONED);
-		} else if (!mIsCommissioned && (get_ncp_state() == COMMISSIONED)) {
-			change_ncp_state(OFFLINE);
-			printf("\nchanging states\n");
+		default:
+			break;
 		}
+	}
 
-	} else if (key == SPINEL_PROP_NET_STACK_UP) {
-		bool is_stack_up = false;
-		spinel_datatype_unpack(value_data_ptr, value_data_len, SPINEL_DATATYPE_BOOL_S, &is_stack_up);
-		syslog(LOG_NOTICE, "[-NCP-]: Stack is %sup", is_stack_up ? "" : "not ");
+	return true;
+}
 
-		set_stack_up(is_stack_up);
+bool
+SpinelNCPInstance::handle_ncp_spinel_value_is_NET_SAVED(const uint8_t* value_data_ptr, spinel_size_t value_data_len)
+{
+	bool is_commissioned = false;
+	spinel_datatype_unpack(value_data_ptr, value_data_len, SPINEL_DATATYPE_BOOL_S, &is_commissioned);
+	syslog(LOG_INFO, "[-NCP-]: NetSaved (NCP is commissioned?) \"%s\" ", is_commissioned ? "yes" : "no");
+	mIsCommissioned = is_commissioned;
+	if (mIsCommissioned && (get_ncp_state() == OFFLINE)) {
+		// Just keep it offline
+		// change_ncp_state(COMMISSIONED);
+	} else if (!mIsCommissioned && (get_ncp_state() == COMMISSIONED)) {
+		change_ncp_state(OFFLINE);
+		printf("\nchanging states\n");
+	}
 
-		if (is_stack_up) {
-			if (!ncp_state_is_joining_or_joined(get_ncp_state())) {
-				if (mIsCommissioned && ((mThreadMode & SPINEL_THREAD_MODE_RX_ON_WHEN_IDLE) == 0)) {
-					change_ncp_state(ISOLATED);
-				} else {
+	return true;
+}
+
+bool
+SpinelNCPInstance::handle_ncp_spinel_value_is_NET_STACK_UP(const uint8_t* value_data_ptr, spinel_size_t value_data_len)
+{
+	bool is_stack_up = false;
+	spinel_datatype_unpack(value_data_ptr, value_data_len, SPINEL_DATATYPE_BOOL_S, &is_stack_up);
+	syslog(LOG_NOTICE, "[-NCP-]: Stack is %sup", is_stack_up ? "" : "not ");
+
+	set_stack_up(is_stack_up);
+
+	if (is_stack_up) {
+		if (!ncp_state_is_joining_or_joined(get_ncp_state())) {
+			if (mIsCommissioned && ((mThreadMode & SPINEL_THREAD_MODE_RX_ON_WHEN_IDLE) == 0)) {
+				change_ncp_state(ISOLATED);
+			} else {
 
 #ifndef TI_WISUN_FAN
-					change_ncp_state(ASSOCIATING);
+				change_ncp_state(ASSOCIATING);
 #else
-					change_ncp_state(ASSOCIATED);
+				change_ncp_state(ASSOCIATED);
 #endif
-				}
-			}
-		} else {
-			if (!ncp_state_is_joining(get_ncp_state())) {
-				// change_ncp_state(mIsCommissioned ? COMMISSIONED : OFFLINE);
-				// Just set to OFFLINE and mIsCommissioned to false
-				change_ncp_state(OFFLINE);
-				mIsCommissioned = false;
 			}
 		}
-
-	} else if (key == SPINEL_PROP_NET_IF_UP) {
-		bool is_if_up = false;
-		spinel_datatype_unpack(value_data_ptr, value_data_len, SPINEL_DATATYPE_BOOL_S, &is_if_up);
-		syslog(LOG_NOTICE, "[-NCP-]: Interface is %sup", is_if_up ? "" : "not ");
-
-		set_if_up(is_if_up);
-
-		if (ncp_state_is_interface_up(get_ncp_state()) && !is_if_up) {
+	} else {
+		if (!ncp_state_is_joining(get_ncp_state())) {
 			// change_ncp_state(mIsCommissioned ? COMMISSIONED : OFFLINE);
 			// Just set to OFFLINE and mIsCommissioned to false
 			change_ncp_state(OFFLINE);
 			mIsCommissioned = false;
 		}
+	}
 
-	} else if (key == SPINEL_PROP_MESHCOP_COMMISSIONER_STATE) {
-		boost::any value;
-		int status;
-		status = unpack_commissioner_state(value_data_ptr, value_data_len, value);
-		if (status == kWPANTUNDStatus_Ok) {
-			syslog(LOG_INFO, "[-NCP-]: Thread Commissioner state is \"%s\"", any_to_string(value).c_str());
-		}
+	return true;
+}
 
-	} else if (key == SPINEL_PROP_THREAD_ON_MESH_NETS) {
-		handle_ncp_spinel_value_is_ON_MESH_NETS(value_data_ptr, value_data_len);
+bool
+SpinelNCPInstance::handle_ncp_spinel_value_is_NET_IF_UP(const uint8_t* value_data_ptr, spinel_size_t value_data_len)
+{
+	bool is_if_up = false;
+	spinel_datatype_unpack(value_data_ptr, value_data_len, SPINEL_DATATYPE_BOOL_S, &is_if_up);
+	syslog(LOG_NOTICE, "[-NCP-]: Interface is %sup", is_if_up ? "" : "not ");
 
-	} else if (key == SPINEL_PROP_THREAD_OFF_MESH_ROUTES) {
-		handle_ncp_spinel_value_is_OFF_MESH_ROUTES(value_data_ptr, value_data_len);
+	set_if_up(is_if_up);
 
-	} else if (key == SPINEL_PROP_SERVER_SERVICES) {
-		handle_ncp_spinel_value_is_SERVICES(value_data_ptr, value_data_len);
+	if (ncp_state_is_interface_up(get_ncp_state()) && !is_if_up) {
+		// change_ncp_state(mIsCommissioned ? COMMISSIONED : OFFLINE);
+		// Just set to OFFLINE and mIsCommissioned to false
+		change_ncp_state(OFFLINE);
+		mIsCommissioned = false;
+	}
 
-	} else if (key == SPINEL_PROP_THREAD_ASSISTING_PORTS) {
-		bool is_assisting = (value_data_len != 0);
-		uint16_t assisting_port(0);
+	return true;
+}
 
-		if (is_assisting != get_current_network_instance().joinable) {
-			mCurrentNetworkInstance.joinable = is_assisting;
-			signal_property_changed(kWPANTUNDProperty_NestLabs_NetworkAllowingJoin, is_assisting);
-		}
+bool
+SpinelNCPInstance::handle_ncp_spinel_value_is_MESHCOP_COMMISSIONER_STATE(const uint8_t* value_data_ptr, spinel_size_t value_data_len)
+{
+	boost::any value;
+	int status;
+	status = unpack_commissioner_state(value_data_ptr, value_data_len, value);
+	if (status == kWPANTUNDStatus_Ok) {
+		syslog(LOG_INFO, "[-NCP-]: Thread Commissioner state is \"%s\"", any_to_string(value).c_str());
+	}
 
-		if (is_assisting) {
-			int i;
-			syslog(LOG_NOTICE, "Network is joinable");
-			while (value_data_len > 0) {
-				i = spinel_datatype_unpack(value_data_ptr, value_data_len, SPINEL_DATATYPE_UINT16_S, &assisting_port);
-				if (i <= 0) {
-					break;
-				}
-				syslog(LOG_NOTICE, "Assisting on port %d", assisting_port);
-				value_data_ptr += i;
-				value_data_len -= i;
-			}
-		} else {
-			syslog(LOG_NOTICE, "Network is not joinable");
-		}
+	return true;
+}
 
-	} else if (key == SPINEL_PROP_JAM_DETECTED) {
-		bool jamDetected = false;
+bool
+SpinelNCPInstance::handle_ncp_spinel_value_is_THREAD_ASSISTING_PORTS(const uint8_t* value_data_ptr, spinel_size_t value_data_len)
+{
+	bool is_assisting = (value_data_len != 0);
+	uint16_t assisting_port(0);
 
-		spinel_datatype_unpack(value_data_ptr, value_data_len, SPINEL_DATATYPE_BOOL_S, &jamDetected);
-		signal_property_changed(kWPANTUNDProperty_JamDetectionStatus, jamDetected);
+	if (is_assisting != get_current_network_instance().joinable) {
+		mCurrentNetworkInstance.joinable = is_assisting;
+		signal_property_changed(kWPANTUNDProperty_NestLabs_NetworkAllowingJoin, is_assisting);
+	}
 
-		if (jamDetected) {
-			syslog(LOG_NOTICE, "Signal jamming is detected");
-		} else {
-			syslog(LOG_NOTICE, "Signal jamming cleared");
+	if (is_assisting) {
+		int i;
+		syslog(LOG_NOTICE, "Network is joinable");
+		while (value_data_len > 0) {
+			i = spinel_datatype_unpack(value_data_ptr, value_data_len, SPINEL_DATATYPE_UINT16_S, &assisting_port);
+			if (i <= 0) {
+				break;
+			}
+			syslog(LOG_NOTICE, "Assisting on port %d", assisting_port);
+			value_data_ptr += i;
+			value_data_len -= i;
 		}
+	} else {
+		syslog(LOG_NOTICE, "Network is not joinable");
+	}
 
-	} else if (key == SPINEL_PROP_CHANNEL_MANAGER_NEW_CHANNEL) {
-		uint8_t new_channel = 0;
-		spinel_ssize_t len;
+	return true;
+}
+
+bool
+SpinelNCPInstance::handle_ncp_spinel_value_is_JAM_DETECTED(const uint8_t* value_data_ptr, spinel_size_t value_data_len)
+{
+	bool jamDetected = false;
 
-		len = spinel_datatype_unpack(value_data_ptr, value_data_len, SPINEL_DATATYPE_UINT8_S, &new_channel);
+	spinel_datatype_unpack(value_data_ptr, value_data_len, SPINEL_DATATYPE_BOOL_S, &jamDetected);
+	signal_property_changed(kWPANTUNDProperty_JamDetectionStatus, jamDetected);
 
-		if ((len >= 0) && (new_channel != mChannelManagerNewChannel)) {
-			mChannelManagerNewChannel = new_channel;
-			signal_property_changed(kWPANTUNDProperty_ChannelManagerNewChannel, new_channel);
-			syslog(LOG_INFO, "[-NCP-]: ChannelManager about to switch to new channel %d", new_channel);
-		}
+	if (jamDetected) {
+		syslog(LOG_NOTICE, "Signal jamming is detected");
+	} else {
+		syslog(LOG_NOTICE, "Signal jamming cleared");
+	}
 
-	} else if (key == SPINEL_PROP_STREAM_RAW) {
-		if (mPcapManager.is_enabled()) {
-			const uint8_t* frame_ptr(NULL);
-			unsigned int frame_len(0);
-			const uint8_t* meta_ptr(NULL);
-			unsigned int meta_len(0);
-			spinel_ssize_t ret;
-			PcapPacket packet;
-			uint16_t flags = 0;
-
-			packet.set_timestamp().set_dlt(PCAP_DLT_IEEE802_15_4);
-
-			// Unpack the packet.
-			ret = spinel_datatype_unpack(
-				value_data_ptr,
-				value_data_len,
-				SPINEL_DATATYPE_DATA_WLEN_S SPINEL_DATATYPE_DATA_S,
-				&frame_ptr,
-				&frame_len,
-				&meta_ptr,
-				&meta_len
-			);
+	return true;
+}
 
-			require(ret > 0, bail);
-
-			// Unpack the metadata.
-			ret = spinel_datatype_unpack(
-				meta_ptr,
-				meta_len,
-				SPINEL_DATATYPE_INT8_S     // RSSI/TXPower
-				SPINEL_DATATYPE_INT8_S     // Noise Floor
-				SPINEL_DATATYPE_UINT16_S,  // Flags
-				NULL,   // Ignore RSSI/TXPower
-				NULL,	// Ignore Noise Floor
-				&flags
-			);
+bool
+SpinelNCPInstance::handle_ncp_spinel_value_is_CHANNEL_MANAGER_NEW_CHANNEL(const uint8_t* value_data_ptr, spinel_size_t value_data_len)
+{
+	uint8_t new_channel = 0;
+	spinel_ssize_t len;
 
-			__ASSERT_MACROS_check(ret > 0);
+	len = spinel_datatype_unpack(value_data_ptr, value_data_len, SPINEL_DATATYPE_UINT8_S, &new_channel);
 
-			if ((flags & SPINEL_MD_FLAG_TX) == SPINEL_MD_FLAG_TX)
-			{
-				// Ignore FCS for transmitted packets
-				frame_len -= 2;
-				packet.set_dlt(PCAP_DLT_IEEE802_15_4_NOFCS);
-			}
+	if ((len >= 0) && (new_channel != mChannelManagerNewChannel)) {
+		mChannelManagerNewChannel = new_channel;
+		signal_property_changed(kWPANTUNDProperty_ChannelManagerNewChannel, new_channel);
+		syslog(LOG_INFO, "[-NCP-]: ChannelManager about to switch to new channel %d", new_channel);
+	}
 
-			mPcapManager.push_packet(
-				packet
-					.append_ppi_field(PCAP_PPI_TYPE_SPINEL, meta_ptr, meta_len)
-					.append_payload(frame_ptr, frame_len)
-			);
-		}
+	return true;
+}
 
-	} else if (key == SPINEL_PROP_THREAD_TMF_PROXY_STREAM) {
+bool
+SpinelNCPInstance::handle_ncp_spinel_value_is_STREAM_RAW(const uint8_t* value_data_ptr, spinel_size_t value_data_len)
+{
+	if (mPcapManager.is_enabled()) {
 		const uint8_t* frame_ptr(NULL);
 		unsigned int frame_len(0);
-		uint16_t locator = 0;
-		uint16_t port = 0;
+		const uint8_t* meta_ptr(NULL);
+		unsigned int meta_len(0);
 		spinel_ssize_t ret;
-		Data data;
+		PcapPacket packet;
+		uint16_t flags = 0;
+
+		packet.set_timestamp().set_dlt(PCAP_DLT_IEEE802_15_4);
 
+		// Unpack the packet.
 		ret = spinel_datatype_unpack(
 			value_data_ptr,
 			value_data_len,
-			SPINEL_DATATYPE_DATA_S SPINEL_DATATYPE_UINT16_S SPINEL_DATATYPE_UINT16_S,
+			SPINEL_DATATYPE_DATA_WLEN_S SPINEL_DATATYPE_DATA_S,
 			&frame_ptr,
 			&frame_len,
-			&locator,
-			&port
+			&meta_ptr,
+			&meta_len
+		);
+
+		require(ret > 0, bail);
+
+		// Unpack the metadata.
+		ret = spinel_datatype_unpack(
+			meta_ptr,
+			meta_len,
+			SPINEL_DATATYPE_INT8_S     // RSSI/TXPower
+			SPINEL_DATATYPE_INT8_S     // Noise Floor
+			SPINEL_DATATYPE_UINT16_S,  // Flags
+			NULL,   // Ignore RSSI/TXPower
+			NULL,	// Ignore Noise Floor
+			&flags
 		);
 
 		__ASSERT_MACROS_check(ret > 0);
 
-		// Analyze the packet to determine if it should be dropped.
-		if ((ret > 0)) {
-			// append frame
-			data.append(frame_ptr, frame_len);
-			// pack the locator in big endian.
-			data.push_back(locator >> 8);
-			data.push_back(locator & 0xff);
-			// pack the port in big endian.
-			data.push_back(port >> 8);
-			data.push_back(port & 0xff);
-			signal_property_changed(kWPANTUNDProperty_TmfProxyStream, data);
+		if ((flags & SPINEL_MD_FLAG_TX) == SPINEL_MD_FLAG_TX)
+		{
+			// Ignore FCS for transmitted packets
+			frame_len -= 2;
+			packet.set_dlt(PCAP_DLT_IEEE802_15_4_NOFCS);
 		}
 
-	} else if (key == SPINEL_PROP_THREAD_UDP_FORWARD_STREAM) {
-		const uint8_t* frame_ptr(NULL);
-		unsigned int frame_len(0);
-		uint16_t peer_port = 0;
-		in6_addr *peer_addr;
-		uint16_t sock_port = 0;
-		spinel_ssize_t ret;
-		Data data;
-
-		ret = spinel_datatype_unpack(
-			value_data_ptr,
-			value_data_len,
-			SPINEL_DATATYPE_DATA_S
-			SPINEL_DATATYPE_UINT16_S    // Peer port
-			SPINEL_DATATYPE_IPv6ADDR_S  // Peer address
-			SPINEL_DATATYPE_UINT16_S,   // Sock port
-			&frame_ptr,
-			&frame_len,
-			&peer_port,
-			&peer_addr,
-			&sock_port
+		mPcapManager.push_packet(
+			packet
+				.append_ppi_field(PCAP_PPI_TYPE_SPINEL, meta_ptr, meta_len)
+				.append_payload(frame_ptr, frame_len)
 		);
+	}
+
+bail:
+	return true;
+}
+
+bool
+SpinelNCPInstance::handle_ncp_spinel_value_is_THREAD_TMF_PROXY_STREAM(const uint8_t* value_data_ptr, spinel_size_t value_data_len)
+{
+	const uint8_t* frame_ptr(NULL);
+	unsigned int frame_len(0);
+	uint16_t locator = 0;
+	uint16_t port = 0;
+	spinel_ssize_t ret;
+	Data data;
+
+	ret = spinel_datatype_unpack(
+		value_data_ptr,
+		value_data_len,
+		SPINEL_DATATYPE_DATA_S SPINEL_DATATYPE_UINT16_S SPINEL_DATATYPE_UINT16_S,
+		&frame_ptr,
+		&frame_len,
+		&locator,
+		&port
+	);
+
+	__ASSERT_MACROS_check(ret > 0);
+
+	// Analyze the packet to determine if it should be dropped.
+	if ((ret > 0)) {
+		// append frame
+		data.append(frame_ptr, frame_len);
+		// pack the locator in big endian.
+		data.push_back(locator >> 8);
+		data.push_back(locator & 0xff);
+		// pack the port in big endian.
+		data.push_back(port >> 8);
+		data.push_back(port & 0xff);
+		signal_property_changed(kWPANTUNDProperty_TmfProxyStream, data);
+	}
+
+	return true;
+}
+
+bool
+SpinelNCPInstance::handle_ncp_spinel_value_is_THREAD_UDP_FORWARD_STREAM(const uint8_t* value_data_ptr, spinel_size_t value_data_len)
+{
+	const uint8_t* frame_ptr(NULL);
+	unsigned int frame_len(0);
+	uint16_t peer_port = 0;
+	in6_addr *peer_addr;
+	uint16_t sock_port = 0;
+	spinel_ssize_t ret;
+	Data data;
+
+	ret = spinel_datatype_unpack(
+		value_data_ptr,
+		value_data_len,
+		SPINEL_DATATYPE_DATA_S
+		SPINEL_DATATYPE_UINT16_S    // Peer port
+		SPINEL_DATATYPE_IPv6ADDR_S  // Peer address
+		SPINEL_DATATYPE_UINT16_S,   // Sock port
+		&frame_ptr,
+		&frame_len,
+		&peer_port,
+		&peer_addr,
+		&sock_port
+	);
+
+	__ASSERT_MACROS_check(ret > 0);
+
+	// Analyze the packet to determine if it should be dropped.
+	if (ret > 0) {
+		// append frame
+		data.append(frame_ptr, frame_len);
+		// pack the locator in big endian.
+		data.push_back(peer_port >> 8);
+		data.push_back(peer_port & 0xff);
+		data.append(peer_addr->s6_addr, sizeof(*peer_addr));
+		// pack the port in big endian.
+		data.push_back(sock_port >> 8);
+		data.push_back(sock_port & 0xff);
+		signal_property_changed(kWPANTUNDProperty_UdpForwardStream, data);
+	}
+
+	return true;
+}
+
+bool
+SpinelNCPInstance::handle_ncp_spinel_value_is_STREAM_NET(const uint8_t* value_data_ptr, spinel_size_t value_data_len)
+{
+	handle_ncp_spinel_stream_net(FRAME_TYPE_DATA, value_data_ptr, value_data_len);
+
+	return true;
+}
+
+bool
+SpinelNCPInstance::handle_ncp_spinel_value_is_STREAM_NET_INSECURE(const uint8_t* value_data_ptr, spinel_size_t value_data_len)
+{
+	handle_ncp_spinel_stream_net(FRAME_TYPE_INSECURE_DATA, value_data_ptr, value_data_len);
+
+	return true;
+}
+
+void
+SpinelNCPInstance::handle_ncp_spinel_stream_net(uint8_t frame_data_type, const uint8_t* value_data_ptr, spinel_size_t value_data_len)
+{
+	spinel::Bytes frame;
+	spinel_ssize_t ret;
+
+	// The packet, then metadata this end has no use for.
+	ret = spinel::Frame<spinel::DataWlen, spinel::Data>::decode(value_data_ptr, value_data_len, &frame, NULL);
+
+	__ASSERT_MACROS_check(ret > 0);
+
+	// Analyze the packet to determine if it should be dropped.
+	if ((ret > 0) && should_forward_hostbound_frame(&frame_data_type, frame.ptr, frame.len)) {
+		if (static_cast<bool>(mLegacyInterface) && (frame_data_type == FRAME_TYPE_LEGACY_DATA)) {
+			handle_alt_ipv6_from_ncp(frame.ptr, frame.len);
+		} else {
+			handle_normal_ipv6_from_ncp(frame.ptr, frame.len);
+		}
+	}
+}
+
+bool
+SpinelNCPInstance::handle_ncp_spinel_value_is_THREAD_NEIGHBOR_TABLE(const uint8_t* value_data_ptr, spinel_size_t value_data_len)
+{
+	SpinelNCPTaskGetNetworkTopology::Table neigh_table;
+	SpinelNCPTaskGetNetworkTopology::Table::iterator it;
+	int num_neighbor = 0;
+
+	SpinelNCPTaskGetNetworkTopology::parse_neighbor_table(value_data_ptr, value_data_len, neigh_table);
+
+	for (it = neigh_table.begin(); it != neigh_table.end(); it++)
+	{
+		num_neighbor++;
+		syslog(LOG_INFO, "[-NCP-] Neighbor: %02d %s", num_neighbor, it->get_as_string().c_str());
+	}
+	syslog(LOG_INFO, "[-NCP-] Neighbor: Total %d neighbor%s", num_neighbor, (num_neighbor > 1) ? "s" : "");
+
+	return true;
+}
+
+bool
+SpinelNCPInstance::handle_ncp_spinel_value_is_THREAD_NEIGHBOR_TABLE_ERROR_RATES(const uint8_t* value_data_ptr, spinel_size_t value_data_len)
+{
+	SpinelNCPTaskGetNetworkTopology::Table neigh_table;
+	SpinelNCPTaskGetNetworkTopology::Table::iterator it;
+	int num_neighbor = 0;
+
+	SpinelNCPTaskGetNetworkTopology::prase_neighbor_error_rates_table(value_data_ptr, value_data_len, neigh_table);
+
+	for (it = neigh_table.begin(); it != neigh_table.end(); it++)
+	{
+		num_neighbor++;
+		syslog(LOG_INFO, "[-NCP-] Neighbor: %02d %s", num_neighbor, it->get_as_string().c_str());
+	}
+	syslog(LOG_INFO, "[-NCP-] Neighbor: Total %d neighbor%s", num_neighbor, (num_neighbor > 1) ? "s" : "");
 
-		__ASSERT_MACROS_check(ret > 0);
+	return true;
+}
 
-		// Analyze the packet to determine if it should be dropped.
-		if (ret > 0) {
-			// append frame
-			data.append(frame_ptr, frame_len);
-			// pack the locator in big endian.
-			data.push_back(peer_port >> 8);
-			data.push_back(peer_port & 0xff);
-			data.append(peer_addr->s6_addr, sizeof(*peer_addr));
-			// pack the port in big endian.
-			data.push_back(sock_port >> 8);
-			data.push_back(sock_port & 0xff);
-			signal_property_changed(kWPANTUNDProperty_UdpForwardStream, data);
-		}
+bool
+SpinelNCPInstance::handle_ncp_spinel_value_is_THREAD_ROUTER_TABLE(const uint8_t* value_data_ptr, spinel_size_t value_data_len)
+{
+	SpinelNCPTaskGetNetworkTopology::Table router_table;
+	SpinelNCPTaskGetNetworkTopology::Table::iterator it;
+	int num_router = 0;
 
-	} else if ((key == SPINEL_PROP_STREAM_NET) || (key == SPINEL_PROP_STREAM_NET_INSECURE)) {
-		const uint8_t* frame_ptr(NULL);
-		unsigned int frame_len(0);
-		spinel_ssize_t ret;
-		uint8_t frame_data_type = FRAME_TYPE_DATA;
+	SpinelNCPTaskGetNetworkTopology::parse_router_table(value_data_ptr, value_data_len, router_table);
 
-		if (SPINEL_PROP_STREAM_NET_INSECURE == key) {
-			frame_data_type = FRAME_TYPE_INSECURE_DATA;
-		}
+	for (it = router_table.begin(); it != router_table.end(); it++)
+	{
+		num_router++;
+		syslog(LOG_INFO, "[-NCP-] Router: %02d %s", num_router, it->get_as_string().c_str());
+	}
+	syslog(LOG_INFO, "[-NCP-] Router: Total %d router%s", num_router, (num_router > 1) ? "s" : "");
 
-		ret = spinel_datatype_unpack(
-			value_data_ptr,
-			value_data_len,
-			SPINEL_DATATYPE_DATA_S SPINEL_DATATYPE_DATA_S,
-			&frame_ptr,
-			&frame_len,
-			NULL,
-			NULL
-		);
+	return true;
+}
 
-		__ASSERT_MACROS_check(ret > 0);
+bool
+SpinelNCPInstance::handle_ncp_spinel_value_is_THREAD_ADDRESS_CACHE_TABLE(const uint8_t* value_data_ptr, spinel_size_t value_data_len)
+{
+	boost::any value;
+	if ((unpack_address_cache_table(value_data_ptr, value_data_len, value, false) == kWPANTUNDStatus_Ok)
+		&& (value.type() == typeid(std::list<std::string>))
+	) {
+		std::list<std::string> list = boost::any_cast<std::list<std::string> >(value);
+		int num_entries = 0;
 
-		// Analyze the packet to determine if it should be dropped.
-		if ((ret > 0) && should_forward_hostbound_frame(&frame_data_type, frame_ptr, frame_len)) {
-			if (static_cast<bool>(mLegacyInterface) && (frame_data_type == FRAME_TYPE_LEGACY_DATA)) {
-				handle_alt_ipv6_from_ncp(frame_ptr, frame_len);
-			} else {
-				handle_normal_ipv6_from_ncp(frame_ptr, frame_len);
-			}
+		for (std::list<std::string>::iterator it = list.begin(); it != list.end(); it++) {
+			num_entries++;
+			syslog(LOG_INFO, "[-NCP-] AddressCache: %02d %s", num_entries, it->c_str());
 		}
-	} else if (key == SPINEL_PROP_THREAD_NEIGHBOR_TABLE) {
-		SpinelNCPTaskGetNetworkTopology::Table neigh_table;
-		SpinelNCPTaskGetNetworkTopology::Table::iterator it;
-		int num_neighbor = 0;
+		syslog(LOG_INFO, "[-NCP-] AddressCache: Total %d entr%s", num_entries, (num_entries > 1) ? "ies" : "y");
+	}
 
-		SpinelNCPTaskGetNetworkTopology::parse_neighbor_table(value_data_ptr, value_data_len, neigh_table);
+	return true;
+}
 
-		for (it = neigh_table.begin(); it != neigh_table.end(); it++)
-		{
-			num_neighbor++;
-			syslog(LOG_INFO, "[-NCP-] Neighbor: %02d %s", num_neighbor, it->get_as_string().c_str());
-		}
-		syslog(LOG_INFO, "[-NCP-] Neighbor: Total %d neighbor%s", num_neighbor, (num_neighbor > 1) ? "s" : "");
+bool
+SpinelNCPInstance::handle_ncp_spinel_value_is_NET_PARTITION_ID(const uint8_t* value_data_ptr, spinel_size_t value_data_len)
+{
+	uint32_t paritition_id = 0;
+	spinel_datatype_unpack(value_data_ptr, value_data_len, SPINEL_DATATYPE_UINT32_S, &paritition_id);
+	syslog(LOG_INFO, "[-NCP-] Partition id: %u (0x%x)", paritition_id, paritition_id);
+
+	return true;
+}
 
-	} else if (key == SPINEL_PROP_THREAD_NEIGHBOR_TABLE_ERROR_RATES) {
-		SpinelNCPTaskGetNetworkTopology::Table neigh_table;
-		SpinelNCPTaskGetNetworkTopology::Table::iterator it;
-		int num_neighbor = 0;
+bool
+SpinelNCPInstance::handle_ncp_spinel_value_is_THREAD_LEADER_NETWORK_DATA(const uint8_t* value_data_ptr, spinel_size_t value_data_len)
+{
+	char net_data_cstr_buf[540];
+	encode_data_into_string(value_data_ptr, value_data_len, net_data_cstr_buf, sizeof(net_data_cstr_buf), 0);
+	syslog(LOG_INFO, "[-NCP-] Leader network data: [%s]", net_data_cstr_buf);
 
-		SpinelNCPTaskGetNetworkTopology::prase_neighbor_error_rates_table(value_data_ptr, value_data_len, neigh_table);
+	return true;
+}
 
-		for (it = neigh_table.begin(); it != neigh_table.end(); it++)
-		{
-			num_neighbor++;
-			syslog(LOG_INFO, "[-NCP-] Neighbor: %02d %s", num_neighbor, it->get_as_string().c_str());
-		}
-		syslog(LOG_INFO, "[-NCP-] Neighbor: Total %d neighbor%s", num_neighbor, (num_neighbor > 1) ? "s" : "");
+bool
+SpinelNCPInstance::handle_ncp_spinel_value_is_RCP_VERSION(const uint8_t* value_data_ptr, spinel_size_t value_data_len)
+{
+	const char *rcp_version = NULL;
+	spinel_ssize_t len;
 
-	} else if (key == SPINEL_PROP_THREAD_ROUTER_TABLE) {
-		SpinelNCPTaskGetNetworkTopology::Table router_table;
-		SpinelNCPTaskGetNetworkTopology::Table::iterator it;
-		int num_router = 0;
+	len = spinel_datatype_unpack(value_data_ptr, value_data_len, SPINEL_DATATYPE_UTF8_S, &rcp_version);
 
-		SpinelNCPTaskGetNetworkTopology::parse_router_table(value_data_ptr, value_data_len, router_table);
+	if (len > 0) {
+		mRcpVersion = std::string(rcp_version);
+		syslog(LOG_NOTICE, "[-NCP-]: RCP is running \"%s\"", rcp_version);
+	}
 
-		for (it = router_table.begin(); it != router_table.end(); it++)
-		{
-			num_router++;
-			syslog(LOG_INFO, "[-NCP-] Router: %02d %s", num_router, it->get_as_string().c_str());
-		}
-		syslog(LOG_INFO, "[-NCP-] Router: Total %d router%s", num_router, (num_router > 1) ? "s" : "");
+	return true;
+}
+
+bool
+SpinelNCPInstance::handle_ncp_spinel_value_is_SLAAC_ENABLED(const uint8_t* value_data_ptr, spinel_size_t value_data_len)
+{
+	bool enabled;
+	spinel_ssize_t len;
 
+	len = spinel_datatype_unpack(value_data_ptr, value_data_len, SPINEL_DATATYPE_BOOL_S, &enabled);
 
-	} else if (key == SPINEL_PROP_THREAD_ADDRESS_CACHE_TABLE) {
-		boost::any value;
-		if ((unpack_address_cache_table(value_data_ptr, value_data_len, value, false) == kWPANTUNDStatus_Ok)
-			&& (value.type() == typeid(std::list<std::string>))
-		) {
-			std::list<std::string> list = boost::any_cast<std::list<std::string> >(value);
-			int num_entries = 0;
+	if (len > 0) {
+		syslog(LOG_NOTICE, "[-NCP-]: SLAAC %sabled", enabled ? "en" : "dis");
+		mNCPHandlesSLAAC = enabled;
+	}
 
-			for (std::list<std::string>::iterator it = list.begin(); it != list.end(); it++) {
-				num_entries++;
-				syslog(LOG_INFO, "[-NCP-] AddressCache: %02d %s", num_entries, it->c_str());
-			}
-			syslog(LOG_INFO, "[-NCP-] AddressCache: Total %d entr%s", num_entries, (num_entries > 1) ? "ies" : "y");
-		}
+	return true;
+}
 
-	} else if (key == SPINEL_PROP_NET_PARTITION_ID) {
-		uint32_t paritition_id = 0;
-		spinel_datatype_unpack(value_data_ptr, value_data_len, SPINEL_DATATYPE_UINT32_S, &paritition_id);
-		syslog(LOG_INFO, "[-NCP-] Partition id: %u (0x%x)", paritition_id, paritition_id);
+bool
+SpinelNCPInstance::handle_ncp_spinel_value_is_MESHCOP_JOINER_STATE(const uint8_t* value_data_ptr, spinel_size_t value_data_len)
+{
+	boost::any value;
 
-	} else if (key == SPINEL_PROP_THREAD_LEADER_NETWORK_DATA) {
-		char net_data_cstr_buf[540];
-		encode_data_into_string(value_data_ptr, value_data_len, net_data_cstr_buf, sizeof(net_data_cstr_buf), 0);
-		syslog(LOG_INFO, "[-NCP-] Leader network data: [%s]", net_data_cstr_buf);
+	if (unpack_meshcop_joiner_state(value_data_ptr, value_data_len, value) == kWPANTUNDStatus_Ok) {
+		syslog(LOG_NOTICE, "[-NCP-]: Joiner state \"%s\"", any_to_string(value).c_str());
+	}
 
-	} else if (key == SPINEL_PROP_RCP_VERSION) {
-		const char *rcp_version = NULL;
-		spinel_ssize_t len;
+	return true;
+}
 
-		len = spinel_datatype_unpack(value_data_ptr, value_data_len, SPINEL_DATATYPE_UTF8_S, &rcp_version);
+bool
+SpinelNCPInstance::handle_ncp_spinel_value_is_THREAD_NETWORK_TIME(const uint8_t* value_data_ptr, spinel_size_t value_data_len)
+{
+	ValueMap result;
+	std::string result_as_string;
 
-		if (len > 0) {
-			mRcpVersion = std::string(rcp_version);
-			syslog(LOG_NOTICE, "[-NCP-]: RCP is running \"%s\"", rcp_version);
+	if (unpack_thread_network_time_as_valmap(value_data_ptr, value_data_len, result) == kWPANTUNDStatus_Ok) {
+		if (unpack_thread_network_time_as_string(value_data_ptr, value_data_len, result_as_string) == kWPANTUNDStatus_Ok) {
+			syslog(LOG_INFO, "[-NCP-]: Network time update: %s", result_as_string.c_str());
+		} else {
+			syslog(LOG_WARNING, "[-NCP-]: Failed to extract network time update for logging");
 		}
 
-	} else if (key == SPINEL_PROP_SLAAC_ENABLED) {
-		bool enabled;
-		spinel_ssize_t len;
+		handle_network_time_update(result);
+	} else {
+		syslog(LOG_WARNING, "[-NCP-]: Failed to unpack network time update");
+	}
 
-		len = spinel_datatype_unpack(value_data_ptr, value_data_len, SPINEL_DATATYPE_BOOL_S, &enabled);
+	return true;
+}
 
-		if (len > 0) {
-			syslog(LOG_NOTICE, "[-NCP-]: SLAAC %sabled", enabled ? "en" : "dis");
-			mNCPHandlesSLAAC = enabled;
-		}
+bool
+SpinelNCPInstance::handle_ncp_spinel_value_is_THREAD_LINK_METRICS_QUERY_RESULT(const uint8_t* value_data_ptr, spinel_size_t value_data_len)
+{
+	spinel_ssize_t len;
+	struct in6_addr *source = NULL;
+	std::string source_str;
+	uint8_t status;
+	std::string status_str;
+	const uint8_t *struct_in = NULL;
+	unsigned int struct_len = 0;
 
-	} else if (key == SPINEL_PROP_MESHCOP_JOINER_STATE) {
-		boost::any value;
+	mLinkMetricsQueryResult.clear();
 
-		if (unpack_meshcop_joiner_state(value_data_ptr, value_data_len, value) == kWPANTUNDStatus_Ok) {
-			syslog(LOG_NOTICE, "[-NCP-]: Joiner state \"%s\"", any_to_string(value).c_str());
-		}
+	// Decode source and status
+	len = spinel_datatype_unpack(
+		value_data_ptr,
+		value_data_len,
+		(
+			SPINEL_DATATYPE_IPv6ADDR_S
+			SPINEL_DATATYPE_UINT8_S
+			SPINEL_DATATYPE_DATA_WLEN_S
+		),
+		&source,
+		&status,
+		&struct_in,
+		&struct_len
+	);
 
-	} else if (key == SPINEL_PROP_THREAD_NETWORK_TIME) {
-		ValueMap result;
-		std::string result_as_string;
+	require(len >= 0, bail);
+	value_data_ptr += len;
+	value_data_len -= len;
 
-		if (unpack_thread_network_time_as_valmap(value_data_ptr, value_data_len, result) == kWPANTUNDStatus_Ok) {
-			if (unpack_thread_network_time_as_string(value_data_ptr, value_data_len, result_as_string) == kWPANTUNDStatus_Ok) {
-				syslog(LOG_INFO, "[-NCP-]: Network time update: %s", result_as_string.c_str());
-			} else {
-				syslog(LOG_WARNING, "[-NCP-]: Failed to extract network time update for logging");
-			}
+	source_str = in6_addr_to_string(*source);
+	status_str = spinel_link_metrics_status_to_cstr(status);
 
-			handle_network_time_update(result);
-		} else {
-			syslog(LOG_WARNING, "[-NCP-]: Failed to unpack network time update");
-		}
+	mLinkMetricsQueryResult[kWPANTUNDValueMapKey_LinkMetrics_Source] = source_str;
+	mLinkMetricsQueryResult[kWPANTUNDValueMapKey_LinkMetrics_Status] = status_str;
 
-	} else if (key == SPINEL_PROP_THREAD_LINK_METRICS_QUERY_RESULT) {
-		spinel_ssize_t len;
-		struct in6_addr *source = NULL;
-		std::string source_str;
-		uint8_t status;
-		std::string status_str;
-		const uint8_t *struct_in = NULL;
-		unsigned int struct_len = 0;
+	unpack_link_metrics_as_val_map(struct_in, struct_len, mLinkMetricsQueryResult);
 
-		mLinkMetricsQueryResult.clear();
+bail:
+	return true;
+}
 
-		// Decode source and status
-		len = spinel_datatype_unpack(
-			value_data_ptr,
-			value_data_len,
-			(
-				SPINEL_DATATYPE_IPv6ADDR_S
-				SPINEL_DATATYPE_UINT8_S
-				SPINEL_DATATYPE_DATA_WLEN_S
-			),
-			&source,
-			&status,
-			&struct_in,
-			&struct_len
-		);
+bool
+SpinelNCPInstance::handle_ncp_spinel_value_is_THREAD_LINK_METRICS_MGMT_RESPONSE(const uint8_t* value_data_ptr, spinel_size_t value_data_len)
+{
+	spinel_ssize_t len;
+	struct in6_addr *source = NULL;
+	std::string source_str;
+	uint8_t status;
+	std::string status_str;
 
-		require(len >= 0, bail);
-		value_data_ptr += len;
-		value_data_len -= len;
+	// Decode source and status
+	len = spinel_datatype_unpack(
+		value_data_ptr,
+		value_data_len,
+		(
+			SPINEL_DATATYPE_IPv6ADDR_S
+			SPINEL_DATATYPE_UINT8_S
+		),
+		&source,
+		&status
+	);
 
-		source_str = in6_addr_to_string(*source);
-		status_str = spinel_link_metrics_status_to_cstr(status);
+	require(len >= 0, bail);
+	value_data_ptr += len;
+	value_data_len -= len;
 
-		mLinkMetricsQueryResult[kWPANTUNDValueMapKey_LinkMetrics_Source] = source_str;
-		mLinkMetricsQueryResult[kWPANTUNDValueMapKey_LinkMetrics_Status] = status_str;
+	source_str = in6_addr_to_string(*source);
+	status_str = spinel_link_metrics_status_to_cstr(status);
 
-		unpack_link_metrics_as_val_map(struct_in, struct_len, mLinkMetricsQueryResult);
+	mLinkMetricsMgmtResponse[kWPANTUNDValueMapKey_LinkMetrics_Source] = source_str;
+	mLinkMetricsMgmtResponse[kWPANTUNDValueMapKey_LinkMetrics_Status] = status_str;
 
-	} else if (key == SPINEL_PROP_THREAD_LINK_METRICS_MGMT_RESPONSE) {
-		spinel_ssize_t len;
-		struct in6_addr *source = NULL;
-		std::string source_str;
-		uint8_t status;
-		std::string status_str;
+	syslog(LOG_INFO, "Link Metrics Mqmt Response: %s (src: %s)", status_str.c_str(), source_str.c_str());
 
-		// Decode source and status
-		len = spinel_datatype_unpack(
-			value_data_ptr,
-			value_data_len,
-			(
-				SPINEL_DATATYPE_IPv6ADDR_S
-				SPINEL_DATATYPE_UINT8_S
-			),
-			&source,
-			&status
-		);
+bail:
+	return true;
+}
 
-		require(len >= 0, bail);
-		value_data_ptr += len;
-		value_data_len -= len;
+bool
+SpinelNCPInstance::handle_ncp_spinel_value_is_THREAD_LINK_METRICS_MGMT_ENH_ACK_IE(const uint8_t* value_data_ptr, spinel_size_t value_data_len)
+{
+	spinel_ssize_t len;
+	uint16_t short_addr = 0;
+	const spinel_eui64_t *eui64 = NULL;
+	const uint8_t *struct_in = NULL;
+	unsigned int struct_len = 0;
 
-		source_str = in6_addr_to_string(*source);
-		status_str = spinel_link_metrics_status_to_cstr(status);
+	mLinkMetricsLastEnhAckIe.clear();
 
-		mLinkMetricsMgmtResponse[kWPANTUNDValueMapKey_LinkMetrics_Source] = source_str;
-		mLinkMetricsMgmtResponse[kWPANTUNDValueMapKey_LinkMetrics_Status] = status_str;
+	len = spinel_datatype_unpack(
+		value_data_ptr,
+		value_data_len,
+		(
+			SPINEL_DATATYPE_UINT16_S
+			SPINEL_DATATYPE_EUI64_S
+			SPINEL_DATATYPE_DATA_WLEN_S
+		),
+		&short_addr,
+		&eui64,
+		&struct_in,
+		&struct_len
+	);
 
-		syslog(LOG_INFO, "Link Metrics Mqmt Response: %s (src: %s)", status_str.c_str(), source_str.c_str());
+	require(len >= 0, bail);
+	value_data_ptr += len;
+	value_data_len -= len;
 
-	} else if (key == SPINEL_PROP_THREAD_LINK_METRICS_MGMT_ENH_ACK_IE) {
-		spinel_ssize_t len;
-		uint16_t short_addr = 0;
-		const spinel_eui64_t *eui64 = NULL;
-		const uint8_t *struct_in = NULL;
-		unsigned int struct_len = 0;
+	syslog(LOG_DEBUG, "Received Link Metrics Enh-ACK IE from 0x%02x", short_addr);
 
-		mLinkMetricsLastEnhAckIe.clear();
+	unpack_link_metrics_as_val_map(value_data_ptr, value_data_len, mLinkMetricsLastEnhAckIe);
 
-		len = spinel_datatype_unpack(
-			value_data_ptr,
-			value_data_len,
-			(
-				SPINEL_DATATYPE_UINT16_S
-				SPINEL_DATATYPE_EUI64_S
-				SPINEL_DATATYPE_DATA_WLEN_S
-			),
-			&short_addr,
-			&eui64,
-			&struct_in,
-			&struct_len
-		);
+bail:
+	return true;
+}
 
-		require(len >= 0, bail);
-		value_data_ptr += len;
-		value_data_len -= len;
+bool
+SpinelNCPInstance::handle_ncp_spinel_value_is_THREAD_MLR_RESPONSE(const uint8_t* value_data_ptr, spinel_size_t value_data_len)
+{
+	spinel_ssize_t len;
+	uint8_t status;
+	uint8_t mlr_status;
+	const uint8_t *struct_in = NULL;
+	unsigned int struct_len = 0;
+	std::list<std::string> addrList;
+
+	mMulticastListenerRegistrationResponse.clear();
+
+	len = spinel_datatype_unpack(
+		value_data_ptr,
+		value_data_len,
+		(
+			SPINEL_DATATYPE_UINT8_S
+			SPINEL_DATATYPE_UINT8_S
+		),
+		&status,
+		&mlr_status
+	);
 
-		syslog(LOG_DEBUG, "Received Link Metrics Enh-ACK IE from 0x%02x", short_addr);
+	require(len >= 0, bail);
+	value_data_ptr += len;
+	value_data_len -= len;
 
-		unpack_link_metrics_as_val_map(value_data_ptr, value_data_len, mLinkMetricsLastEnhAckIe);
+	mMulticastListenerRegistrationResponse[kWPANTUNDValueMapKey_ThreadMlrResponse_Status] = status;
+	mMulticastListenerRegistrationResponse[kWPANTUNDValueMapKey_ThreadMlrResponse_MlrStatus] = mlr_status;
 
-	} else if (key == SPINEL_PROP_THREAD_MLR_RESPONSE) {
+	len = spinel_datatype_unpack(
+		value_data_ptr,
+		value_data_len,
+		SPINEL_DATATYPE_DATA_WLEN_S,
+		&struct_in,
+		&struct_len
+	);
 
-		mMulticastListenerRegistrationResponse.clear();
+	require(len >= 0, bail);
+	value_data_ptr += len;
+	value_data_len -= len;
 
-		spinel_ssize_t len;
-		uint8_t status;
-		uint8_t mlr_status;
-		const uint8_t *struct_in = NULL;
-		unsigned int struct_len = 0;
+	while (struct_len != 0)
+	{
+		const in6_addr * failed_addr;
 
 		len = spinel_datatype_unpack(
-			value_data_ptr,
-			value_data_len,
-			(
-				SPINEL_DATATYPE_UINT8_S
-				SPINEL_DATATYPE_UINT8_S
-			),
-			&status,
-			&mlr_status
+			struct_in,
+			struct_len,
+			SPINEL_DATATYPE_IPv6ADDR_S,
+			&failed_addr
 		);
 
-		require(len >= 0, bail);
-		value_data_ptr += len;
-		value_data_len -= len;
+		require(len > 0, bail);
 
-		mMulticastListenerRegistrationResponse[kWPANTUNDValueMapKey_ThreadMlrResponse_Status] = status;
-		mMulticastListenerRegistrationResponse[kWPANTUNDValueMapKey_ThreadMlrResponse_MlrStatus] = mlr_status;
+		struct_in  += len;
+		struct_len -= len;
 
-		std::list<std::string> addrList;
+		addrList.push_back(in6_addr_to_string(*failed_addr));
+	}
 
-		len = spinel_datatype_unpack(
-			value_data_ptr,
-			value_data_len,
-			SPINEL_DATATYPE_DATA_WLEN_S,
-			&struct_in,
-			&struct_len
-		);
+	mMulticastListenerRegistrationResponse[kWPANTUNDValueMapKey_ThreadMlrResponse_Addresses] = addrList;
 
-		require(len >= 0, bail);
-		value_data_ptr += len;
-		value_data_len -= len;
+	syslog(LOG_DEBUG, "Received Multicast Listener Registration Response status=%u mlr_status=%u",
+		(unsigned)status, (unsigned)mlr_status);
 
-		while (struct_len != 0)
-		{
-			const in6_addr * failed_addr;
+bail:
+	return true;
+}
+
+void
+SpinelNCPInstance::register_value_is_handler(spinel_prop_key_t key, ValueIsHandler handler)
+{
+	if (!mValueIsHandlers.insert(key, handler)) {
+		syslog(LOG_ERR, "Handler for %s (%u) registered twice", spinel_prop_key_to_cstr(key), key);
+	}
+}
+
+void
+SpinelNCPInstance::register_all_value_is_handlers(void)
+{
+	// Note that SPINEL_PROP_IPV6_LL_ADDR has the same value as
+	// SPINEL_PROP_DODAG_ROUTE. Its handler takes both, telling them
+	// apart by length.
+	register_value_is_handler(SPINEL_PROP_LAST_STATUS, &SpinelNCPInstance::handle_ncp_spinel_value_is_LAST_STATUS);
+	register_value_is_handler(SPINEL_PROP_NCP_VERSION, &SpinelNCPInstance::handle_ncp_spinel_value_is_NCP_VERSION);
+	register_value_is_handler(SPINEL_PROP_INTERFACE_TYPE, &SpinelNCPInstance::handle_ncp_spinel_value_is_INTERFACE_TYPE);
+	register_value_is_handler(SPINEL_PROP_DODAG_ROUTE_DEST, &SpinelNCPInstance::handle_ncp_spinel_value_is_DODAG_ROUTE_DEST);
+	register_value_is_handler(SPINEL_PROP_PHY_CCA_THRESHOLD, &SpinelNCPInstance::handle_ncp_spinel_value_is_PHY_CCA_THRESHOLD);
+	register_value_is_handler(SPINEL_PROP_NUM_CONNECTED_DEVICES, &SpinelNCPInstance::handle_ncp_spinel_value_is_NUM_CONNECTED_DEVICES);
+	register_value_is_handler(SPINEL_PROP_CONNECTED_DEVICES, &SpinelNCPInstance::handle_ncp_spinel_value_is_CONNECTED_DEVICES);
+	register_value_is_handler(SPINEL_PROP_DODAG_ROUTE, &SpinelNCPInstance::handle_ncp_spinel_value_is_DODAG_ROUTE);
+	register_value_is_handler(SPINEL_PROP_PHY_CH_SPACING, &SpinelNCPInstance::handle_ncp_spinel_value_is_PHY_CH_SPACING);
+	register_value_is_handler(SPINEL_PROP_MAC_BC_INTERVAL, &SpinelNCPInstance::handle_ncp_spinel_value_is_MAC_BC_INTERVAL);
+	register_value_is_handler(SPINEL_PROP_MAC_UC_DWELL_INTERVAL, &SpinelNCPInstance::handle_ncp_spinel_value_is_MAC_UC_DWELL_INTERVAL);
+	register_value_is_handler(SPINEL_PROP_MAC_BC_DWELL_INTERVAL, &SpinelNCPInstance::handle_ncp_spinel_value_is_MAC_BC_DWELL_INTERVAL);
+	register_value_is_handler(SPINEL_PROP_MAC_UC_CHANNEL_FUNCTION, &SpinelNCPInstance::handle_ncp_spinel_value_is_MAC_UC_CHANNEL_FUNCTION);
+	register_value_is_handler(SPINEL_PROP_MAC_BC_CHANNEL_FUNCTION, &SpinelNCPInstance::handle_ncp_spinel_value_is_MAC_BC_CHANNEL_FUNCTION);
+	register_value_is_handler(SPINEL_PROP_MAC_FILTER_MODE, &SpinelNCPInstance::handle_ncp_spinel_value_is_MAC_FILTER_MODE);
+	register_value_is_handler(SPINEL_PROP_PHY_CHO_CENTER_FREQ, &SpinelNCPInstance::handle_ncp_spinel_value_is_PHY_CHO_CENTER_FREQ);
+	register_value_is_handler(SPINEL_PROP_MAC_MAC_FILTER_LIST, &SpinelNCPInstance::handle_ncp_spinel_value_is_MAC_MAC_FILTER_LIST);
+	register_value_is_handler(SPINEL_PROP_PHY_UNICAST_CHANNEL_LIST, &SpinelNCPInstance::handle_ncp_spinel_value_is_PHY_UNICAST_CHANNEL_LIST);
+	register_value_is_handler(SPINEL_PROP_PHY_BROADCAST_CHANNEL_LIST, &SpinelNCPInstance::handle_ncp_spinel_value_is_PHY_BROADCAST_CHANNEL_LIST);
+	register_value_is_handler(SPINEL_PROP_PHY_ASYNC_CHANNEL_LIST, &SpinelNCPInstance::handle_ncp_spinel_value_is_PHY_ASYNC_CHANNEL_LIST);
+	register_value_is_handler(SPINEL_PROP_PROTOCOL_VERSION, &SpinelNCPInstance::handle_ncp_spinel_value_is_PROTOCOL_VERSION);
+	register_value_is_handler(SPINEL_PROP_PHY_REGION, &SpinelNCPInstance::handle_ncp_spinel_value_is_PHY_REGION);
+	register_value_is_handler(SPINEL_PROP_PHY_MODE_ID, &SpinelNCPInstance::handle_ncp_spinel_value_is_PHY_MODE_ID);
+	register_value_is_handler(SPINEL_PROP_CAPS, &SpinelNCPInstance::handle_ncp_spinel_value_is_CAPS);
+	register_value_is_handler(SPINEL_PROP_NET_NETWORK_NAME, &SpinelNCPInstance::handle_ncp_spinel_value_is_NET_NETWORK_NAME);
+	register_value_is_handler(SPINEL_PROP_MCU_POWER_STATE, &SpinelNCPInstance::handle_ncp_spinel_value_is_MCU_POWER_STATE);
+	register_value_is_handler(SPINEL_PROP_IPV6_ML_PREFIX, &SpinelNCPInstance::handle_ncp_spinel_value_is_IPV6_ML_PREFIX);
+	register_value_is_handler(SPINEL_PROP_IPV6_ADDRESS_TABLE, &SpinelNCPInstance::handle_ncp_spinel_value_is_IPV6_ADDRESS_TABLE);
+	register_value_is_handler(SPINEL_PROP_IPV6_MULTICAST_ADDRESS_TABLE, &SpinelNCPInstance::handle_ncp_spinel_value_is_IPV6_MULTICAST_ADDRESS_TABLE);
+	register_value_is_handler(SPINEL_PROP_HWADDR, &SpinelNCPInstance::handle_ncp_spinel_value_is_HWADDR);
+	register_value_is_handler(SPINEL_PROP_MAC_15_4_LADDR, &SpinelNCPInstance::handle_ncp_spinel_value_is_MAC_15_4_LADDR);
+	register_value_is_handler(SPINEL_PROP_MAC_15_4_PANID, &SpinelNCPInstance::handle_ncp_spinel_value_is_MAC_15_4_PANID);
+	register_value_is_handler(SPINEL_PROP_NET_XPANID, &SpinelNCPInstance::handle_ncp_spinel_value_is_NET_XPANID);
+	register_value_is_handler(SPINEL_PROP_NET_PSKC, &SpinelNCPInstance::handle_ncp_spinel_value_is_NET_PSKC);
+	register_value_is_handler(SPINEL_PROP_NET_MASTER_KEY, &SpinelNCPInstance::handle_ncp_spinel_value_is_NET_MASTER_KEY);
+	register_value_is_handler(SPINEL_PROP_NET_KEY_SEQUENCE_COUNTER, &SpinelNCPInstance::handle_ncp_spinel_value_is_NET_KEY_SEQUENCE_COUNTER);
+	register_value_is_handler(SPINEL_PROP_PHY_CHAN, &SpinelNCPInstance::handle_ncp_spinel_value_is_PHY_CHAN);
+	register_value_is_handler(SPINEL_PROP_PHY_CHAN_SUPPORTED, &SpinelNCPInstance::handle_ncp_spinel_value_is_PHY_CHAN_SUPPORTED);
+	register_value_is_handler(SPINEL_PROP_PHY_CHAN_PREFERRED, &SpinelNCPInstance::handle_ncp_spinel_value_is_PHY_CHAN_PREFERRED);
+	register_value_is_handler(SPINEL_PROP_PHY_TX_POWER, &SpinelNCPInstance::handle_ncp_spinel_value_is_PHY_TX_POWER);
+	register_value_is_handler(SPINEL_PROP_STREAM_DEBUG, &SpinelNCPInstance::handle_ncp_spinel_value_is_STREAM_DEBUG);
+	register_value_is_handler(SPINEL_PROP_STREAM_LOG, &SpinelNCPInstance::handle_ncp_spinel_value_is_STREAM_LOG);
+	register_value_is_handler(SPINEL_PROP_NET_ROLE, &SpinelNCPInstance::handle_ncp_spinel_value_is_NET_ROLE);
+	register_value_is_handler(SPINEL_PROP_THREAD_MODE, &SpinelNCPInstance::handle_ncp_spinel_value_is_THREAD_MODE);
+	register_value_is_handler(SPINEL_PROP_NET_SAVED, &SpinelNCPInstance::handle_ncp_spinel_value_is_NET_SAVED);
+	register_value_is_handler(SPINEL_PROP_NET_STACK_UP, &SpinelNCPInstance::handle_ncp_spinel_value_is_NET_STACK_UP);
+	register_value_is_handler(SPINEL_PROP_NET_IF_UP, &SpinelNCPInstance::handle_ncp_spinel_value_is_NET_IF_UP);
+	register_value_is_handler(SPINEL_PROP_MESHCOP_COMMISSIONER_STATE, &SpinelNCPInstance::handle_ncp_spinel_value_is_MESHCOP_COMMISSIONER_STATE);
+	register_value_is_handler(SPINEL_PROP_THREAD_ON_MESH_NETS, &SpinelNCPInstance::handle_ncp_spinel_value_is_ON_MESH_NETS);
+	register_value_is_handler(SPINEL_PROP_THREAD_OFF_MESH_ROUTES, &SpinelNCPInstance::handle_ncp_spinel_value_is_OFF_MESH_ROUTES);
+	register_value_is_handler(SPINEL_PROP_SERVER_SERVICES, &SpinelNCPInstance::handle_ncp_spinel_value_is_SERVICES);
+	register_value_is_handler(SPINEL_PROP_THREAD_ASSISTING_PORTS, &SpinelNCPInstance::handle_ncp_spinel_value_is_THREAD_ASSISTING_PORTS);
+	register_value_is_handler(SPINEL_PROP_JAM_DETECTED, &SpinelNCPInstance::handle_ncp_spinel_value_is_JAM_DETECTED);
+	register_value_is_handler(SPINEL_PROP_CHANNEL_MANAGER_NEW_CHANNEL, &SpinelNCPInstance::handle_ncp_spinel_value_is_CHANNEL_MANAGER_NEW_CHANNEL);
+	register_value_is_handler(SPINEL_PROP_STREAM_RAW, &SpinelNCPInstance::handle_ncp_spinel_value_is_STREAM_RAW);
+	register_value_is_handler(SPINEL_PROP_THREAD_TMF_PROXY_STREAM, &SpinelNCPInstance::handle_ncp_spinel_value_is_THREAD_TMF_PROXY_STREAM);
+	register_value_is_handler(SPINEL_PROP_THREAD_UDP_FORWARD_STREAM, &SpinelNCPInstance::handle_ncp_spinel_value_is_THREAD_UDP_FORWARD_STREAM);
+	register_value_is_handler(SPINEL_PROP_STREAM_NET, &SpinelNCPInstance::handle_ncp_spinel_value_is_STREAM_NET);
+	register_value_is_handler(SPINEL_PROP_STREAM_NET_INSECURE, &SpinelNCPInstance::handle_ncp_spinel_value_is_STREAM_NET_INSECURE);
+	register_value_is_handler(SPINEL_PROP_THREAD_NEIGHBOR_TABLE, &SpinelNCPInstance::handle_ncp_spinel_value_is_THREAD_NEIGHBOR_TABLE);
+	register_value_is_handler(SPINEL_PROP_THREAD_NEIGHBOR_TABLE_ERROR_RATES, &SpinelNCPInstance::handle_ncp_spinel_value_is_THREAD_NEIGHBOR_TABLE_ERROR_RATES);
+	register_value_is_handler(SPINEL_PROP_THREAD_ROUTER_TABLE, &SpinelNCPInstance::handle_ncp_spinel_value_is_THREAD_ROUTER_TABLE);
+	register_value_is_handler(SPINEL_PROP_THREAD_ADDRESS_CACHE_TABLE, &SpinelNCPInstance::handle_ncp_spinel_value_is_THREAD_ADDRESS_CACHE_TABLE);
+	register_value_is_handler(SPINEL_PROP_NET_PARTITION_ID, &SpinelNCPInstance::handle_ncp_spinel_value_is_NET_PARTITION_ID);
+	register_value_is_handler(SPINEL_PROP_THREAD_LEADER_NETWORK_DATA, &SpinelNCPInstance::handle_ncp_spinel_value_is_THREAD_LEADER_NETWORK_DATA);
+	register_value_is_handler(SPINEL_PROP_RCP_VERSION, &SpinelNCPInstance::handle_ncp_spinel_value_is_RCP_VERSION);
+	register_value_is_handler(SPINEL_PROP_SLAAC_ENABLED, &SpinelNCPInstance::handle_ncp_spinel_value_is_SLAAC_ENABLED);
+	register_value_is_handler(SPINEL_PROP_MESHCOP_JOINER_STATE, &SpinelNCPInstance::handle_ncp_spinel_value_is_MESHCOP_JOINER_STATE);
+	register_value_is_handler(SPINEL_PROP_THREAD_NETWORK_TIME, &SpinelNCPInstance::handle_ncp_spinel_value_is_THREAD_NETWORK_TIME);
+	register_value_is_handler(SPINEL_PROP_THREAD_LINK_METRICS_QUERY_RESULT, &SpinelNCPInstance::handle_ncp_spinel_value_is_THREAD_LINK_METRICS_QUERY_RESULT);
+	register_value_is_handler(SPINEL_PROP_THREAD_LINK_METRICS_MGMT_RESPONSE, &SpinelNCPInstance::handle_ncp_spinel_value_is_THREAD_LINK_METRICS_MGMT_RESPONSE);
+	register_value_is_handler(SPINEL_PROP_THREAD_LINK_METRICS_MGMT_ENH_ACK_IE, &SpinelNCPInstance::handle_ncp_spinel_value_is_THREAD_LINK_METRICS_MGMT_ENH_ACK_IE);
+	register_value_is_handler(SPINEL_PROP_THREAD_MLR_RESPONSE, &SpinelNCPInstance::handle_ncp_spinel_value_is_THREAD_MLR_RESPONSE);
+}
 
-			len = spinel_datatype_unpack(
-				struct_in,
-				struct_len,
-				SPINEL_DATATYPE_IPv6ADDR_S,
-				&failed_addr
-			);
+void
+SpinelNCPInstance::handle_ncp_spinel_value_is(spinel_prop_key_t key, const uint8_t* value_data_ptr, spinel_size_t value_data_len)
+{
+	ValueIsHandlerTable::Entry* entry;
+
+	if (setlogmask(0) & LOG_MASK(LOG_DEBUG)) {
+		syslog(LOG_DEBUG, "[-NCP-]: Value is %s (%u)", spinel_prop_key_to_cstr(key), key);
+	}
 
-			require(len > 0, bail);
+	// Values which change after initialization are saved right away,
+	// those fetched during initialization once it is over.
+	if (!mPropertyCacheIsReplaying
+	 && mPropertyCache.update(key, value_data_ptr, value_data_len)
+	 && !is_initializing_ncp()
+	 && (mPropertyCache.get_state() == PropertyCache::kStateFresh)
+	) {
+		mPropertyCache.save();
+	}
 
-			struct_in  += len;
-			struct_len -= len;
+	entry = mValueIsHandlers.find(key);
 
-			addrList.push_back(in6_addr_to_string(*failed_addr));
-		}
+	if (entry != NULL) {
+		uint64_t started_at = time_get_monotonic_us();
+		bool should_pass_on = (this->*entry->mHandler)(value_data_ptr, value_data_len);
 
-		mMulticastListenerRegistrationResponse[kWPANTUNDValueMapKey_ThreadMlrResponse_Addresses] = addrList;
+		mValueIsHandlers.record(entry, static_cast<uint32_t>(time_get_monotonic_us() - started_at));
 
-		syslog(LOG_DEBUG, "Received Multicast Listener Registration Response status=%u mlr_status=%u",
-			(unsigned)status, (unsigned)mlr_status);
+		if (!should_pass_on) {
+			return;
+		}
+	} else {
+		mValueIsHandlers.record_unhandled();
 	}
 
-bail:
-	process_event(EVENT_NCP_PROP_VALUE_IS, key, original_value_data_ptr, original_value_data_len);
+	process_event(EVENT_NCP_PROP_VALUE_IS, key, value_data_ptr, value_data_len);
 }
 
 void
@@ -6996,6 +8414,13 @@ SpinelNCPInstance::handle_ncp_state_change(NCPState new_ncp_state, NCPState old_
 {
 	NCPInstanceBase::handle_ncp_state_change(new_ncp_state, old_ncp_state);
 
+	// Whatever the network looked like before no longer applies.
+	if (ncp_state_is_associated(old_ncp_state) && !ncp_state_is_associated(new_ncp_state)) {
+		reset_topology();
+	} else {
+		mTopologySnapshotValid = false;
+	}
+
 	if ( ncp_state_is_joining_or_joined(old_ncp_state)
 	  && (new_ncp_state == OFFLINE)
 	) {
@@ -7039,12 +8464,12 @@ SpinelNCPInstance::handle_ncp_spinel_callback(unsigned int command, const uint8_
 	case SPINEL_CMD_PROP_VALUE_INSERTED:
 	case SPINEL_CMD_PROP_VALUE_REMOVED:
 		{
-			spinel_prop_key_t key = SPINEL_PROP_LAST_STATUS;
-			uint8_t* value_data_ptr = NULL;
-			spinel_size_t value_data_len = 0;
+			unsigned int prop_key = SPINEL_PROP_LAST_STATUS;
+			spinel::Bytes value;
 			spinel_ssize_t ret;
 
-			ret = spinel_datatype_unpack(cmd_data_ptr, cmd_data_len, "CiiD", NULL, NULL, &key, &value_data_ptr, &value_data_len);
+			ret = spinel::Frame<uint8_t, spinel::PackedUint, spinel::PackedUint, spinel::Data>::decode(
+				cmd_data_ptr, cmd_data_len, NULL, NULL, &prop_key, &value);
 
 			__ASSERT_MACROS_check(ret != -1);
 
@@ -7052,9 +8477,17 @@ SpinelNCPInstance::handle_ncp_spinel_callback(unsigned int command, const uint8_
 				break;
 			}
 
+			const spinel_prop_key_t key = static_cast<spinel_prop_key_t>(prop_key);
+			const uint8_t* value_data_ptr = value.ptr;
+			spinel_size_t value_data_len = value.len;
+
 			switch (command) {
 			case SPINEL_CMD_PROP_VALUE_IS:
 				handle_ncp_spinel_value_is(key, value_data_ptr, value_data_len);
+
+				if (SPINEL_HEADER_GET_TID(mInboundHeader) != 0) {
+					complete_spinel_transaction(SPINEL_HEADER_GET_TID(mInboundHeader), key, value_data_ptr, value_data_len);
+				}
 				break;
 			case SPINEL_CMD_PROP_VALUE_INSERTED:
 				handle_ncp_spinel_value_inserted(key, value_data_ptr, value_data_len);
@@ -7454,12 +8887,86 @@ SpinelNCPInstance::convert_route_preference_to_flags(RoutePreference preference)
 	return flags;
 }
 
+static bool
+spinel_prop_holds_key_material(spinel_prop_key_t prop_key)
+{
+	switch (prop_key) {
+	case SPINEL_PROP_NET_MASTER_KEY:
+	case SPINEL_PROP_THREAD_ACTIVE_DATASET:
+	case SPINEL_PROP_THREAD_PENDING_DATASET:
+	case SPINEL_PROP_MESHCOP_JOINER_COMMISSIONING:
+	case SPINEL_PROP_NET_PSKC:
+	case SPINEL_PROP_MESHCOP_COMMISSIONER_JOINERS:
+		return true;
+
+	default:
+		return false;
+	}
+}
+
+// Adds the frame to the frame trace. Only the header, command and
+// property key are decoded here, the rest is left for `wfanctl trace`.
+static void
+trace_spinel_frame(uint8_t direction, const uint8_t *frame_ptr, spinel_size_t frame_len)
+{
+	uint8_t header = 0;
+	unsigned int command = 0;
+	unsigned int prop_key = 0;
+	uint8_t flags = 0;
+	const uint8_t *payload_ptr = NULL;
+	spinel_size_t payload_len = 0;
+	spinel_ssize_t read_len;
+
+	read_len = spinel::Frame<uint8_t, spinel::PackedUint>::decode(frame_ptr, frame_len, &header, &command);
+
+	if (read_len <= 0) {
+		// Not a valid spinel frame, keep its first bytes as they are.
+		payload_ptr = frame_ptr;
+		payload_len = frame_len;
+		command = 0;
+
+	} else {
+		payload_ptr = frame_ptr + read_len;
+		payload_len = frame_len - read_len;
+
+		if ((command >= SPINEL_CMD_PROP_VALUE_GET) && (command <= SPINEL_CMD_PROP_VALUE_REMOVED)) {
+			read_len = spinel_packed_uint_decode(payload_ptr, payload_len, &prop_key);
+
+			if (read_len > 0) {
+				flags |= FRAME_TRACE_FLAG_HAS_KEY;
+				payload_ptr += read_len;
+				payload_len -= read_len;
+
+				if (spinel_prop_holds_key_material(static_cast<spinel_prop_key_t>(prop_key))) {
+					flags |= FRAME_TRACE_FLAG_REDACTED;
+					payload_len = 0;
+				}
+			}
+		}
+	}
+
+	FrameTrace::shared().record(
+		direction,
+		SPINEL_HEADER_GET_TID(header),
+		command,
+		prop_key,
+		flags,
+		static_cast<uint16_t>(frame_len),
+		payload_ptr,
+		payload_len
+	);
+}
+
 void
 SpinelNCPInstance::log_spinel_frame(SpinelFrameOrigin origin, const uint8_t *frame_ptr, spinel_size_t frame_len)
 {
 	int logmask = setlogmask(0);
 
-	setlogmask(logmask);
+	trace_spinel_frame(
+		(origin == kDriverToNCP) ? FRAME_TRACE_DIRECTION_TO_NCP : FRAME_TRACE_DIRECTION_FROM_NCP,
+		frame_ptr,
+		frame_len
+	);
 
 	if (logmask & LOG_MASK(LOG_INFO)) {
 		std::string log;
@@ -7515,19 +9022,12 @@ SpinelNCPInstance::log_spinel_frame(SpinelFrameOrigin origin, const uint8_t *fra
 					// Skip logging any of above properties
 					goto bail;
 
-				case SPINEL_PROP_NET_MASTER_KEY:
-				case SPINEL_PROP_THREAD_ACTIVE_DATASET:
-				case SPINEL_PROP_THREAD_PENDING_DATASET:
-				case SPINEL_PROP_MESHCOP_JOINER_COMMISSIONING:
-				case SPINEL_PROP_NET_PSKC:
-				case SPINEL_PROP_MESHCOP_COMMISSIONER_JOINERS:
-					// Hide the value by skipping value dump
-					skip_value_dump = true;
-					break;
-
 				default:
-					skip_value_dump = false;
-					encode_data_into_string(value_ptr, value_len, value_dump_str, sizeof(value_dump_str), 0);
+					// Hide the value of keys and credentials by skipping value dump
+					skip_value_dump = spinel_prop_holds_key_material(prop_key);
+					if (!skip_value_dump) {
+						encode_data_into_string(value_ptr, value_len, value_dump_str, sizeof(value_dump_str), 0);
+					}
 					break;
 				}
 
@@ -7567,7 +9067,8 @@ bool
 SpinelNCPInstance::is_busy(void)
 {
 	return NCPInstanceBase::is_busy()
-		|| !mTaskQueue.empty();
+		|| !mTaskQueue.empty()
+		|| !outbound_queues_empty();
 }
 
 void
@@ -7575,8 +9076,19 @@ SpinelNCPInstance::process(void)
 {
 	NCPInstanceBase::process();
 
+	if (mTransactionCount != 0) {
+		expire_spinel_transactions();
+	}
+
 	mVendorCustom.process();
 
+	if (mTopologyRefreshAgain
+	 && !mTopologyRefreshPending
+	 && (CMS_SINCE(mTopologyRefreshTime) >= SPINEL_TOPOLOGY_REFRESH_MIN_INTERVAL)
+	) {
+		refresh_topology();
+	}
+
 	if (!is_initializing_ncp() && mTaskQueue.empty()) {
 		bool x = mPcapManager.is_enabled();
 
@@ -25,11 +25,16 @@
 #include "NCPInstanceBase.h"
 #include "SpinelNCPControlInterface.h"
 #include "SpinelNCPThreadDataset.h"
+#include "SpinelNCPTopologyGraph.h"
+#include "SpinelNCPPropertyCache.h"
+#include "SpinelNCPDispatchTable.h"
 #include "SpinelNCPTaskSendCommand.h"
+#include "SpinelNCPReaderThread.h"
 #include "nlpt.h"
 #include "SocketWrapper.h"
 #include "SocketAsyncOp.h"
 #include "ValueMap.h"
+#include "RingBuffer.h"
 
 #include <queue>
 #include <set>
@@ -55,6 +60,41 @@ WPANTUND_DECLARE_NCPINSTANCE_PLUGIN(spinel, SpinelNCPInstance);
 
 #define NCP_FRAMING_OVERHEAD 3
 
+// Size, in bytes, of each of the queues holding framed outbound frames.
+#define SPINEL_OUTBOUND_QUEUE_SIZE         (SPINEL_FRAME_BUFFER_SIZE * 8)
+#define SPINEL_OUTBOUND_QUEUE_MAX_FRAMES   32
+
+// Maximum number of frames coalesced into a single write to the NCP.
+#define SPINEL_OUTBOUND_BATCH_MAX_FRAMES   16
+
+// Maximum number of pipelined property gets waiting on a reply. One of
+// the fifteen TIDs is always left for the command being sent by a task.
+#define SPINEL_MAX_TRANSACTIONS            14
+#define SPINEL_TRANSACTION_TABLE_SIZE      ((SPINEL_HEADER_TID_MASK >> SPINEL_HEADER_TID_SHIFT) + 1)
+
+// Maximum number of property fetches and settings restores kept in flight
+// while initializing the NCP, and how many times one which fails is retried.
+#ifndef SPINEL_INIT_MAX_COMMANDS_IN_FLIGHT
+#define SPINEL_INIT_MAX_COMMANDS_IN_FLIGHT 4
+#endif
+#define SPINEL_INIT_MAX_RETRIES            1
+
+// How long, in milliseconds, a topology snapshot is served from the cache.
+#define SPINEL_TOPOLOGY_SNAPSHOT_MAX_AGE   (5 * MSEC_PER_SEC)
+
+// How long, in milliseconds, a value the NCP reported is used to answer
+// gets of the properties registered with register_get_handler_spinel_cached().
+#ifndef SPINEL_CACHED_GET_MAX_AGE
+#define SPINEL_CACHED_GET_MAX_AGE          (30 * MSEC_PER_SEC)
+#endif
+
+// Shortest time, in milliseconds, from the end of one background walk of
+// the topology to the start of the next. Changes to the number of
+// connected devices seen in between are folded into a single walk.
+#ifndef SPINEL_TOPOLOGY_REFRESH_MIN_INTERVAL
+#define SPINEL_TOPOLOGY_REFRESH_MIN_INTERVAL (15 * MSEC_PER_SEC)
+#endif
+
 #define CHANNEL_LIST_SIZE             17
 
 #define CONTROL_REQUIRE_EMPTY_OUTBOUND_BUFFER_WITHIN(seconds, error_label) do { \
@@ -79,7 +119,7 @@ WPANTUND_DECLARE_NCPINSTANCE_PLUGIN(spinel, SpinelNCPInstance);
 
 #define CONTROL_REQUIRE_PREP_TO_SEND_COMMAND_WITHIN(timeout, error_label) do { \
 		CONTROL_REQUIRE_EMPTY_OUTBOUND_BUFFER_WITHIN(timeout, error_label); \
-		GetInstance(this)->mLastTID = SPINEL_GET_NEXT_TID(GetInstance(this)->mLastTID); \
+		GetInstance(this)->mLastTID = GetInstance(this)->get_next_free_tid(GetInstance(this)->mLastTID); \
 		mLastHeader = (SPINEL_HEADER_FLAG | SPINEL_HEADER_IID_0 | (GetInstance(this)->mLastTID << SPINEL_HEADER_TID_SHIFT)); \
 	} while (false)
 
@@ -110,6 +150,8 @@ class SpinelNCPInstance : public NCPInstanceBase {
 	friend class SpinelNCPTaskHostDidWake;
 	friend class SpinelNCPTaskSendCommand;
 	friend class SpinelNCPTaskGetNetworkTopology;
+	friend class SpinelNCPTaskGetTopologySnapshot;
+	friend class SpinelNCPTaskGetConnectedDevices;
 	friend class SpinelNCPTaskGetMsgBufferCounters;
 	friend class SpinelNCPTaskJoinerCommissioning;
 	friend class SpinelNCPTaskJoinerAttach;
@@ -132,6 +174,12 @@ public:
 
 	virtual int vprocess_event(int event, va_list args);
 
+	// Handlers for the values reported by the NCP, one per property.
+	// They return false if the value must not be passed on to the
+	// running tasks as `EVENT_NCP_PROP_VALUE_IS`.
+	typedef bool (SpinelNCPInstance::*ValueIsHandler)(const uint8_t* value_data_ptr, spinel_size_t value_data_len);
+	typedef SpinelDispatchTable<ValueIsHandler> ValueIsHandlerTable;
+
 
 protected:
 	virtual char ncp_to_driver_pump();
@@ -144,6 +192,7 @@ protected:
 protected:
 
 	int vprocess_init(int event, va_list args);
+	int vprocess_init_commands(int event, va_list args);
 	int vprocess_disabled(int event, va_list args);
 	int vprocess_associated(int event, va_list args);
 	int vprocess_resume(int event, va_list args);
@@ -156,9 +205,84 @@ protected:
 	void handle_ncp_state_change(NCPState new_ncp_state, NCPState old_ncp_state);
 
 	void handle_ncp_log_stream(const uint8_t* data_ptr, int data_len);
-	void handle_ncp_spinel_value_is_ON_MESH_NETS(const uint8_t* value_data_ptr, spinel_size_t value_data_len);
-	void handle_ncp_spinel_value_is_OFF_MESH_ROUTES(const uint8_t* value_data_ptr, spinel_size_t value_data_len);
-	void handle_ncp_spinel_value_is_SERVICES(const uint8_t* data_ptr, spinel_size_t value_data_len);
+	void handle_ncp_spinel_stream_net(uint8_t frame_data_type, const uint8_t* value_data_ptr, spinel_size_t value_data_len);
+
+	void register_value_is_handler(spinel_prop_key_t key, ValueIsHandler handler);
+	void register_all_value_is_handlers(void);
+
+	bool handle_ncp_spinel_value_is_ON_MESH_NETS(const uint8_t* value_data_ptr, spinel_size_t value_data_len);
+	bool handle_ncp_spinel_value_is_OFF_MESH_ROUTES(const uint8_t* value_data_ptr, spinel_size_t value_data_len);
+	bool handle_ncp_spinel_value_is_SERVICES(const uint8_t* data_ptr, spinel_size_t value_data_len);
+	bool handle_ncp_spinel_value_is_LAST_STATUS(const uint8_t* value_data_ptr, spinel_size_t value_data_len);
+	bool handle_ncp_spinel_value_is_NCP_VERSION(const uint8_t* value_data_ptr, spinel_size_t value_data_len);
+	bool handle_ncp_spinel_value_is_INTERFACE_TYPE(const uint8_t* value_data_ptr, spinel_size_t value_data_len);
+	bool handle_ncp_spinel_value_is_DODAG_ROUTE_DEST(const uint8_t* value_data_ptr, spinel_size_t value_data_len);
+	bool handle_ncp_spinel_value_is_PHY_CCA_THRESHOLD(const uint8_t* value_data_ptr, spinel_size_t value_data_len);
+	bool handle_ncp_spinel_value_is_NUM_CONNECTED_DEVICES(const uint8_t* value_data_ptr, spinel_size_t value_data_len);
+	bool handle_ncp_spinel_value_is_CONNECTED_DEVICES(const uint8_t* value_data_ptr, spinel_size_t value_data_len);
+	bool handle_ncp_spinel_value_is_DODAG_ROUTE(const uint8_t* value_data_ptr, spinel_size_t value_data_len);
+	bool handle_ncp_spinel_value_is_PHY_CH_SPACING(const uint8_t* value_data_ptr, spinel_size_t value_data_len);
+	bool handle_ncp_spinel_value_is_MAC_BC_INTERVAL(const uint8_t* value_data_ptr, spinel_size_t value_data_len);
+	bool handle_ncp_spinel_value_is_MAC_UC_DWELL_INTERVAL(const uint8_t* value_data_ptr, spinel_size_t value_data_len);
+	bool handle_ncp_spinel_value_is_MAC_BC_DWELL_INTERVAL(const uint8_t* value_data_ptr, spinel_size_t value_data_len);
+	bool handle_ncp_spinel_value_is_MAC_UC_CHANNEL_FUNCTION(const uint8_t* value_data_ptr, spinel_size_t value_data_len);
+	bool handle_ncp_spinel_value_is_MAC_BC_CHANNEL_FUNCTION(const uint8_t* value_data_ptr, spinel_size_t value_data_len);
+	bool handle_ncp_spinel_value_is_MAC_FILTER_MODE(const uint8_t* value_data_ptr, spinel_size_t value_data_len);
+	bool handle_ncp_spinel_value_is_PHY_CHO_CENTER_FREQ(const uint8_t* value_data_ptr, spinel_size_t value_data_len);
+	bool handle_ncp_spinel_value_is_MAC_MAC_FILTER_LIST(const uint8_t* value_data_ptr, spinel_size_t value_data_len);
+	bool handle_ncp_spinel_value_is_PHY_UNICAST_CHANNEL_LIST(const uint8_t* value_data_ptr, spinel_size_t value_data_len);
+	bool handle_ncp_spinel_value_is_PHY_BROADCAST_CHANNEL_LIST(const uint8_t* value_data_ptr, spinel_size_t value_data_len);
+	bool handle_ncp_spinel_value_is_PHY_ASYNC_CHANNEL_LIST(const uint8_t* value_data_ptr, spinel_size_t value_data_len);
+	bool handle_ncp_spinel_value_is_PROTOCOL_VERSION(const uint8_t* value_data_ptr, spinel_size_t value_data_len);
+	bool handle_ncp_spinel_value_is_PHY_REGION(const uint8_t* value_data_ptr, spinel_size_t value_data_len);
+	bool handle_ncp_spinel_value_is_PHY_MODE_ID(const uint8_t* value_data_ptr, spinel_size_t value_data_len);
+	bool handle_ncp_spinel_value_is_CAPS(const uint8_t* value_data_ptr, spinel_size_t value_data_len);
+	bool handle_ncp_spinel_value_is_NET_NETWORK_NAME(const uint8_t* value_data_ptr, spinel_size_t value_data_len);
+	bool handle_ncp_spinel_value_is_MCU_POWER_STATE(const uint8_t* value_data_ptr, spinel_size_t value_data_len);
+	bool handle_ncp_spinel_value_is_IPV6_ML_PREFIX(const uint8_t* value_data_ptr, spinel_size_t value_data_len);
+	bool handle_ncp_spinel_value_is_IPV6_ADDRESS_TABLE(const uint8_t* value_data_ptr, spinel_size_t value_data_len);
+	bool handle_ncp_spinel_value_is_IPV6_MULTICAST_ADDRESS_TABLE(const uint8_t* value_data_ptr, spinel_size_t value_data_len);
+	bool handle_ncp_spinel_value_is_HWADDR(const uint8_t* value_data_ptr, spinel_size_t value_data_len);
+	bool handle_ncp_spinel_value_is_MAC_15_4_LADDR(const uint8_t* value_data_ptr, spinel_size_t value_data_len);
+	bool handle_ncp_spinel_value_is_MAC_15_4_PANID(const uint8_t* value_data_ptr, spinel_size_t value_data_len);
+	bool handle_ncp_spinel_value_is_NET_XPANID(const uint8_t* value_data_ptr, spinel_size_t value_data_len);
+	bool handle_ncp_spinel_value_is_NET_PSKC(const uint8_t* value_data_ptr, spinel_size_t value_data_len);
+	bool handle_ncp_spinel_value_is_NET_MASTER_KEY(const uint8_t* value_data_ptr, spinel_size_t value_data_len);
+	bool handle_ncp_spinel_value_is_NET_KEY_SEQUENCE_COUNTER(const uint8_t* value_data_ptr, spinel_size_t value_data_len);
+	bool handle_ncp_spinel_value_is_PHY_CHAN(const uint8_t* value_data_ptr, spinel_size_t value_data_len);
+	bool handle_ncp_spinel_value_is_PHY_CHAN_SUPPORTED(const uint8_t* value_data_ptr, spinel_size_t value_data_len);
+	bool handle_ncp_spinel_value_is_PHY_CHAN_PREFERRED(const uint8_t* value_data_ptr, spinel_size_t value_data_len);
+	bool handle_ncp_spinel_value_is_PHY_TX_POWER(const uint8_t* value_data_ptr, spinel_size_t value_data_len);
+	bool handle_ncp_spinel_value_is_STREAM_DEBUG(const uint8_t* value_data_ptr, spinel_size_t value_data_len);
+	bool handle_ncp_spinel_value_is_STREAM_LOG(const uint8_t* value_data_ptr, spinel_size_t value_data_len);
+	bool handle_ncp_spinel_value_is_NET_ROLE(const uint8_t* value_data_ptr, spinel_size_t value_data_len);
+	bool handle_ncp_spinel_value_is_THREAD_MODE(const uint8_t* value_data_ptr, spinel_size_t value_data_len);
+	bool handle_ncp_spinel_value_is_NET_SAVED(const uint8_t* value_data_ptr, spinel_size_t value_data_len);
+	bool handle_ncp_spinel_value_is_NET_STACK_UP(const uint8_t* value_data_ptr, spinel_size_t value_data_len);
+	bool handle_ncp_spinel_value_is_NET_IF_UP(const uint8_t* value_data_ptr, spinel_size_t value_data_len);
+	bool handle_ncp_spinel_value_is_MESHCOP_COMMISSIONER_STATE(const uint8_t* value_data_ptr, spinel_size_t value_data_len);
+	bool handle_ncp_spinel_value_is_THREAD_ASSISTING_PORTS(const uint8_t* value_data_ptr, spinel_size_t value_data_len);
+	bool handle_ncp_spinel_value_is_JAM_DETECTED(const uint8_t* value_data_ptr, spinel_size_t value_data_len);
+	bool handle_ncp_spinel_value_is_CHANNEL_MANAGER_NEW_CHANNEL(const uint8_t* value_data_ptr, spinel_size_t value_data_len);
+	bool handle_ncp_spinel_value_is_STREAM_RAW(const uint8_t* value_data_ptr, spinel_size_t value_data_len);
+	bool handle_ncp_spinel_value_is_THREAD_TMF_PROXY_STREAM(const uint8_t* value_data_ptr, spinel_size_t value_data_len);
+	bool handle_ncp_spinel_value_is_THREAD_UDP_FORWARD_STREAM(const uint8_t* value_data_ptr, spinel_size_t value_data_len);
+	bool handle_ncp_spinel_value_is_STREAM_NET(const uint8_t* value_data_ptr, spinel_size_t value_data_len);
+	bool handle_ncp_spinel_value_is_STREAM_NET_INSECURE(const uint8_t* value_data_ptr, spinel_size_t value_data_len);
+	bool handle_ncp_spinel_value_is_THREAD_NEIGHBOR_TABLE(const uint8_t* value_data_ptr, spinel_size_t value_data_len);
+	bool handle_ncp_spinel_value_is_THREAD_NEIGHBOR_TABLE_ERROR_RATES(const uint8_t* value_data_ptr, spinel_size_t value_data_len);
+	bool handle_ncp_spinel_value_is_THREAD_ROUTER_TABLE(const uint8_t* value_data_ptr, spinel_size_t value_data_len);
+	bool handle_ncp_spinel_value_is_THREAD_ADDRESS_CACHE_TABLE(const uint8_t* value_data_ptr, spinel_size_t value_data_len);
+	bool handle_ncp_spinel_value_is_NET_PARTITION_ID(const uint8_t* value_data_ptr, spinel_size_t value_data_len);
+	bool handle_ncp_spinel_value_is_THREAD_LEADER_NETWORK_DATA(const uint8_t* value_data_ptr, spinel_size_t value_data_len);
+	bool handle_ncp_spinel_value_is_RCP_VERSION(const uint8_t* value_data_ptr, spinel_size_t value_data_len);
+	bool handle_ncp_spinel_value_is_SLAAC_ENABLED(const uint8_t* value_data_ptr, spinel_size_t value_data_len);
+	bool handle_ncp_spinel_value_is_MESHCOP_JOINER_STATE(const uint8_t* value_data_ptr, spinel_size_t value_data_len);
+	bool handle_ncp_spinel_value_is_THREAD_NETWORK_TIME(const uint8_t* value_data_ptr, spinel_size_t value_data_len);
+	bool handle_ncp_spinel_value_is_THREAD_LINK_METRICS_QUERY_RESULT(const uint8_t* value_data_ptr, spinel_size_t value_data_len);
+	bool handle_ncp_spinel_value_is_THREAD_LINK_METRICS_MGMT_RESPONSE(const uint8_t* value_data_ptr, spinel_size_t value_data_len);
+	bool handle_ncp_spinel_value_is_THREAD_LINK_METRICS_MGMT_ENH_ACK_IE(const uint8_t* value_data_ptr, spinel_size_t value_data_len);
+	bool handle_ncp_spinel_value_is_THREAD_MLR_RESPONSE(const uint8_t* value_data_ptr, spinel_size_t value_data_len);
 
 	bool should_filter_address(const struct in6_addr &address, uint8_t prefix_len);
 	void filter_addresses(void);
@@ -197,6 +321,41 @@ private:
 
 	void log_spinel_frame(SpinelFrameOrigin origin, const uint8_t *frame_ptr, spinel_size_t frame_len);
 
+	bool hdlc_deframe_staged_bytes(void);
+
+	enum OutboundFrameClass {
+		kOutboundFrameClassControl,
+		kOutboundFrameClassData,
+
+		kOutboundFrameClassCount
+	};
+
+	struct OutboundFrameInfo {
+		spinel_ssize_t mLength;
+		cms_t mEnqueueTime;
+		uint8_t mClass;
+		bool mHasCallback;
+		bool mIsReset;
+	};
+
+	struct OutboundQueue {
+		RingBuffer<uint8_t, SPINEL_OUTBOUND_QUEUE_SIZE> mFrameBytes;
+		RingBuffer<OutboundFrameInfo, SPINEL_OUTBOUND_QUEUE_MAX_FRAMES> mFrames;
+		uint32_t mDropCount;
+		uint32_t mSentCount;
+		uint64_t mLatencySum;
+		cms_t mLatencyMax;
+	};
+
+	bool outbound_queue_has_room(OutboundFrameClass frame_class) const;
+	bool outbound_queues_empty(void) const;
+	bool enqueue_outbound_frame(OutboundFrameClass frame_class, uint8_t *frame_ptr, spinel_ssize_t frame_len,
+			size_t frame_buffer_size, bool has_callback);
+	int read_outbound_data_frame(void);
+	void prepare_outbound_batch(void);
+	bool complete_outbound_batch(void);
+	void flush_outbound_queues(int status);
+
 private:
 	void update_node_type(NodeType node_type);
 	void update_link_local_address(struct in6_addr *addr);
@@ -217,7 +376,43 @@ private:
 	typedef SpinelNCPTaskSendCommand::ReplyUnpacker ReplyUnpacker;
 
 	void get_spinel_prop(CallbackWithStatusArg1 cb, spinel_prop_key_t prop_key, const std::string &reply_format);
+	void get_spinel_prop_cached(CallbackWithStatusArg1 cb, spinel_prop_key_t prop_key, const std::string &reply_format);
 	void get_spinel_prop_with_unpacker(CallbackWithStatusArg1 cb, spinel_prop_key_t prop_key, ReplyUnpacker unpacker);
+	void send_spinel_prop_get(CallbackWithStatusArg1 cb, spinel_prop_key_t prop_key, ReplyUnpacker unpacker);
+
+	// A get held back while a property batch is open.
+	struct BatchedGet {
+		CallbackWithStatusArg1 mCallback;
+		ReplyUnpacker mUnpacker;
+	};
+
+	void begin_property_batch(void);
+	void end_property_batch(void);
+	void batched_get_did_finish(int status, const boost::any& value, const std::list<BatchedGet>& gets);
+
+	struct SpinelTransaction {
+		bool mInUse;
+		cms_t mDeadline;
+		CallbackWithStatusArg1 mCallback;
+		ReplyUnpacker mUnpacker;
+	};
+
+	spinel_tid_t get_next_free_tid(spinel_tid_t tid) const;
+	bool start_spinel_transaction(const Data& command, ReplyUnpacker unpacker, CallbackWithStatusArg1 cb);
+	bool send_spinel_transaction(const Data& command, ReplyUnpacker unpacker, CallbackWithStatusArg1 cb);
+	void complete_spinel_transaction(spinel_tid_t tid, spinel_prop_key_t key, const uint8_t* value_data_ptr,
+			spinel_size_t value_data_len);
+	void expire_spinel_transactions(void);
+	void cancel_spinel_transactions(int status);
+	cms_t get_ms_to_next_transaction_timeout(void) const;
+
+	bool topology_snapshot_is_fresh(void) const;
+	void get_topology_snapshot(CallbackWithStatusArg1 cb, int result_format);
+	void refresh_topology(void);
+	void handle_topology_refresh(int status, const boost::any& value);
+	void topology_did_change(TopologyGraph::ChangeType type, const struct in6_addr &address,
+			const TopologyGraph::Node &node, const TopologyGraph::Node *old_node);
+	void reset_topology(void);
 
 	void check_capability_prop_get(CallbackWithStatusArg1 cb, const std::string &prop_name, unsigned int capability,
 			PropGetHandler handler);
@@ -227,6 +422,8 @@ private:
 
 	void register_get_handler_spinel_simple(const char *prop_name, spinel_prop_key_t prop_key,
 			const char *reply_format);
+	void register_get_handler_spinel_cached(const char *prop_name, spinel_prop_key_t prop_key,
+			const char *reply_format);
 	void register_get_handler_spinel_unpacker(const char *prop_name, spinel_prop_key_t prop_key,
 			ReplyUnpacker unpacker);
 	void register_get_handler_capability_spinel_simple(const char *prop_name, unsigned int capability,
@@ -282,6 +479,15 @@ private:
 	void get_prop_DatasetAllFiledsAsValMap(CallbackWithStatusArg1 cb);
 	void get_prop_DatasetCommand(CallbackWithStatusArg1 cb);
 	void get_prop_DaemonTickleOnHostDidWake(CallbackWithStatusArg1 cb);
+	void get_prop_DaemonOutboundQueueDepth(CallbackWithStatusArg1 cb);
+	void get_prop_DaemonOutboundQueueDrops(CallbackWithStatusArg1 cb);
+	void get_prop_DaemonOutboundQueueLatency(CallbackWithStatusArg1 cb);
+	void get_prop_NetworkTopology(CallbackWithStatusArg1 cb);
+	void get_prop_NetworkTopologyAsValMap(CallbackWithStatusArg1 cb);
+	void get_prop_NetworkTopologyBinary(CallbackWithStatusArg1 cb);
+	void get_prop_ConnectedDevicesAll(CallbackWithStatusArg1 cb);
+	void get_prop_ConnectedDevicesAllBinary(CallbackWithStatusArg1 cb);
+	void get_prop_NetworkTopologyGeneration(CallbackWithStatusArg1 cb);
 	void get_prop_POSIXAppRCPVersionCached(CallbackWithStatusArg1 cb);
 	void get_prop_MACFilterFixedRssi(CallbackWithStatusArg1 cb);
 
@@ -377,6 +583,8 @@ public:
 
 	virtual void property_get_value(const std::string& key, CallbackWithStatusArg1 cb);
 
+	virtual PropertyHandle get_property_handle(const std::string& key) const;
+
 	virtual void property_set_value(const std::string& key, const boost::any& value, CallbackWithStatus cb);
 
 	virtual void property_insert_value(const std::string& key, const boost::any& value, CallbackWithStatus cb);
@@ -424,6 +632,38 @@ private:
 	 */
 	typedef std::map<std::string, SettingsEntry> SettingsMap;
 
+	// A property fetch or settings restore sent while initializing the NCP.
+	struct InitCommand
+	{
+		InitCommand(const Data &command = Data(), const std::string &name = std::string(), bool is_restore = false) :
+			mSpinelCommand(command),
+			mName(name),
+			mIsRestore(is_restore)
+		{
+		}
+
+		Data mSpinelCommand;
+		std::string mName;
+		bool mIsRestore;
+	};
+
+	bool can_send_init_command(void) const;
+	void init_command_did_finish(int status, const boost::any& value, unsigned int generation, const InitCommand& command);
+	void get_prop_DaemonNCPInitTime(CallbackWithStatusArg1 cb);
+
+	void replay_property_cache(void);
+	void property_cache_did_revalidate(void);
+	void get_prop_DaemonPropertyCache(CallbackWithStatusArg1 cb);
+	void get_prop_ConfigDaemonPropertyCachePath(CallbackWithStatusArg1 cb);
+	void set_prop_ConfigDaemonPropertyCachePath(const boost::any &value, CallbackWithStatus cb);
+
+	void get_prop_DaemonInboundPropertyStats(CallbackWithStatusArg1 cb);
+
+	bool set_reader_thread_enabled(bool enabled);
+	void get_prop_ConfigDaemonSerialReaderThread(CallbackWithStatusArg1 cb);
+	void set_prop_ConfigDaemonSerialReaderThread(const boost::any &value, CallbackWithStatus cb);
+	void get_prop_DaemonSerialStats(CallbackWithStatusArg1 cb);
+
 private:
 	enum {
 		kMaxCommissionerEnergyScanResultEntries = 64,
@@ -443,16 +683,42 @@ private:
 	const uint8_t* mInboundFrameDataPtr;
 	spinel_size_t mInboundFrameDataLen;
 	uint16_t mInboundFrameHDLCCRC;
+	struct hdlc_deframer mInboundDeframer;
+	uint32_t mInboundOverrunCount;
+
+	// Raw bytes read from the serial adapter which have not been deframed yet.
+	uint8_t mInboundStagingBuffer[SPINEL_FRAME_BUFFER_SIZE*2];
+	size_t mInboundStagingLen;
+	size_t mInboundStagingOffset;
+
+	// Reads the serial port on its own thread, if
+	// Config:Daemon:SerialReaderThread is set.
+	boost::shared_ptr<SpinelNCPReaderThread> mReaderThread;
 
-	uint8_t mOutboundBufferHeader[3];
 	uint8_t mOutboundBuffer[SPINEL_FRAME_BUFFER_SIZE];
-	uint8_t mOutboundBufferType;
 	spinel_ssize_t mOutboundBufferLen;
 	spinel_ssize_t mOutboundBufferSent;
-	uint8_t mOutboundBufferEscaped[SPINEL_FRAME_BUFFER_SIZE*2];
-	spinel_ssize_t mOutboundBufferEscapedLen;
 	boost::function<void(int)> mOutboundCallback;
 
+	// IPv6 packet read from the tunnel interface, prefixed by its spinel header.
+	uint8_t mOutboundDataBuffer[SPINEL_FRAME_BUFFER_SIZE];
+	uint8_t mOutboundDataBufferType;
+
+	// Scratch space for framing a single frame. Every byte of the frame
+	// and of its FCS may need escaping, plus the two flag bytes.
+	uint8_t mOutboundBufferEscaped[SPINEL_FRAME_BUFFER_SIZE*2 + 6];
+	spinel_ssize_t mOutboundBufferEscapedLen;
+
+	// Framed frames waiting to be written, one queue per OutboundFrameClass.
+	OutboundQueue mOutboundQueue[kOutboundFrameClassCount];
+
+	// Frames taken off the queues for the write currently in progress.
+	uint8_t mOutboundBatchBuffer[SPINEL_FRAME_BUFFER_SIZE*4];
+	spinel_ssize_t mOutboundBatchLen;
+	OutboundFrameInfo mOutboundBatch[SPINEL_OUTBOUND_BATCH_MAX_FRAMES];
+	int mOutboundBatchCount;
+	bool mOutboundPumpIsIdle;
+
 	int mTXPower;
 	uint8_t mThreadMode;
 	bool mIsCommissioned;
@@ -469,15 +735,29 @@ private:
 	ThreadDataset mLocalDataset;
 
 	SettingsMap mSettings;
-	SettingsMap::iterator mSettingsIter;
+
+	// NCP initialization
+	std::list<InitCommand> mInitCommands;
+	std::list<InitCommand> mInitFailedCommands;
+	int mInitCommandsInFlight;
+	int mInitRound;
+	int mInitRetryCount;
+	unsigned int mInitGeneration;
+	cms_t mInitStartTime;
+	cms_t mInitDuration;
+
+	// Last known property values, kept across restarts of the daemon.
+	PropertyCache mPropertyCache;
+	bool mPropertyCacheIsReplaying;
+
+	ValueIsHandlerTable mValueIsHandlers;
 
 	DriverState mDriverState;
 
 	// Protothreads and related state
 	PT mSleepPT;
 	PT mSubPT;
-
-	int mSubPTIndex;
+	PT mInitCommandsPT;
 
 	Data mNetworkPSKc;
 	Data mNetworkKey;
@@ -505,6 +785,28 @@ private:
 	// Task management
 	std::list<boost::shared_ptr<SpinelNCPTask> > mTaskQueue;
 
+	// Property gets which have been sent and are waiting on a reply,
+	// indexed by the TID they were sent with.
+	SpinelTransaction mTransactions[SPINEL_TRANSACTION_TABLE_SIZE];
+	int mTransactionCount;
+	spinel_tid_t mLastTransactionTID;
+
+	// Gets held back by begin_property_batch(), by spinel property.
+	int mPropertyBatchDepth;
+	std::map<spinel_prop_key_t, std::list<BatchedGet> > mBatchedGets;
+
+	// Parent/child graph of the network, as last read from the NCP.
+	TopologyGraph mTopology;
+	cms_t mTopologySnapshotTime;
+	bool mTopologySnapshotValid;
+	bool mTopologyRefreshPending;
+	bool mTopologyRefreshAgain;
+	cms_t mTopologyRefreshTime;
+
+	// Bumped for every change reported to clients. A client seeing a
+	// gap in it has missed changes and needs to read the whole graph.
+	uint32_t mTopologyGeneration;
+
 	// The vendor custom class needs to
 	// remain as the last thing in this class.
 	SpinelNCPVendorCustom mVendorCustom;
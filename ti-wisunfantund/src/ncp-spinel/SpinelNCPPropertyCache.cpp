@@ -0,0 +1,394 @@
+/*
+ *
+ * Copyright (c) 2026 Texas Instruments
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#if HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include "assert-macros.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <syslog.h>
+#include <unistd.h>
+#include "SpinelNCPPropertyCache.h"
+#include "FileExporter.h"
+
+using namespace nl;
+using namespace nl::wpantund;
+
+static const uint8_t kFileMagic[4] = { 'W', 'F', 'P', 'C' };
+
+PropertyCache::PropertyCache()
+	: mState(kStateDisabled)
+	, mIdentityDidChange(false)
+	, mConfirmedAt(0)
+{
+}
+
+bool
+PropertyCache::is_cached_property(unsigned int key)
+{
+	switch (key) {
+	case SPINEL_PROP_NCP_VERSION:
+	case SPINEL_PROP_HWADDR:
+	case SPINEL_PROP_PHY_CCA_THRESHOLD:
+	case SPINEL_PROP_PHY_TX_POWER:
+	case SPINEL_PROP_PHY_REGION:
+	case SPINEL_PROP_PHY_MODE_ID:
+	case SPINEL_PROP_PHY_UNICAST_CHANNEL_LIST:
+	case SPINEL_PROP_PHY_BROADCAST_CHANNEL_LIST:
+	case SPINEL_PROP_PHY_ASYNC_CHANNEL_LIST:
+	case SPINEL_PROP_PHY_CH_SPACING:
+	case SPINEL_PROP_PHY_CHO_CENTER_FREQ:
+	case SPINEL_PROP_MAC_15_4_PANID:
+	case SPINEL_PROP_MAC_UC_DWELL_INTERVAL:
+	case SPINEL_PROP_MAC_BC_DWELL_INTERVAL:
+	case SPINEL_PROP_MAC_BC_INTERVAL:
+	case SPINEL_PROP_MAC_UC_CHANNEL_FUNCTION:
+	case SPINEL_PROP_MAC_BC_CHANNEL_FUNCTION:
+	case SPINEL_PROP_MAC_MAC_FILTER_LIST:
+	case SPINEL_PROP_NET_NETWORK_NAME:
+		return true;
+
+	default:
+		return false;
+	}
+}
+
+void
+PropertyCache::set_path(const std::string& path)
+{
+	mPath = path;
+
+	if (mPath.empty()) {
+		mState = kStateDisabled;
+	} else if (mState == kStateDisabled) {
+		mState = mValues.empty() ? kStateEmpty : kStateFresh;
+	}
+}
+
+const char*
+PropertyCache::get_state_cstr(void) const
+{
+	switch (mState) {
+	case kStateDisabled: return "disabled";
+	case kStateEmpty:    return "empty";
+	case kStateStale:    return "stale";
+	case kStateFresh:    return "fresh";
+	}
+	return "unknown";
+}
+
+uint32_t
+PropertyCache::get_age(void) const
+{
+	time_t now = time(NULL);
+
+	if ((mConfirmedAt == 0) || (now < mConfirmedAt)) {
+		return 0;
+	}
+
+	return static_cast<uint32_t>(now - mConfirmedAt);
+}
+
+void
+PropertyCache::update_identity(unsigned int key, const Data& value)
+{
+	if (key == SPINEL_PROP_NCP_VERSION) {
+		const char* version = NULL;
+
+		if ((spinel_datatype_unpack(value.data(), value.size(), SPINEL_DATATYPE_UTF8_S, &version) > 0) && (version != NULL)) {
+			if ((mState == kStateStale) && !mNCPVersion.empty() && (mNCPVersion != version)) {
+				mIdentityDidChange = true;
+			}
+			mNCPVersion = version;
+		}
+
+	} else if (key == SPINEL_PROP_HWADDR) {
+		if ((mState == kStateStale) && !mHardwareAddress.empty() && (mHardwareAddress != value)) {
+			mIdentityDidChange = true;
+		}
+		mHardwareAddress = value;
+	}
+}
+
+bool
+PropertyCache::update(unsigned int key, const uint8_t* value_ptr, spinel_size_t value_len)
+{
+	std::map<unsigned int, Entry>::iterator iter;
+	bool changed = true;
+
+	// Called for every inbound value, stream packets included, so
+	// nothing is copied until the key is known to be cached.
+	if (!is_cached_property(key) || (value_len > kMaxValueLength)) {
+		return false;
+	}
+
+	Data value(value_ptr, value_len);
+
+	update_identity(key, value);
+
+	iter = mValues.find(key);
+
+	if (iter == mValues.end()) {
+		iter = mValues.insert(std::make_pair(key, Entry())).first;
+	} else {
+		changed = (iter->second.mValue != value);
+	}
+
+	iter->second.mValue = value;
+	iter->second.mConfirmed = true;
+	iter->second.mConfirmedTime = time_ms();
+
+	if (mState == kStateEmpty) {
+		mState = kStateFresh;
+	}
+
+	if (mState == kStateFresh) {
+		mConfirmedAt = time(NULL);
+	}
+
+	return changed;
+}
+
+const Data*
+PropertyCache::get_confirmed_value(unsigned int key, cms_t max_age) const
+{
+	std::map<unsigned int, Entry>::const_iterator iter = mValues.find(key);
+
+	if ((iter == mValues.end())
+	 || !iter->second.mConfirmed
+	 || (CMS_SINCE(iter->second.mConfirmedTime) > max_age)
+	) {
+		return NULL;
+	}
+
+	return &iter->second.mValue;
+}
+
+void
+PropertyCache::begin_revalidation(void)
+{
+	std::map<unsigned int, Entry>::iterator iter;
+
+	for (iter = mValues.begin(); iter != mValues.end(); ++iter) {
+		iter->second.mConfirmed = false;
+	}
+
+	if (mState == kStateFresh) {
+		mState = kStateStale;
+	}
+}
+
+int
+PropertyCache::finish_revalidation(void)
+{
+	std::map<unsigned int, Entry>::iterator iter = mValues.begin();
+	int dropped = 0;
+
+	while (iter != mValues.end()) {
+		if (iter->second.mConfirmed) {
+			++iter;
+		} else {
+			mValues.erase(iter++);
+			dropped++;
+		}
+	}
+
+	if (mState != kStateDisabled) {
+		mState = mValues.empty() ? kStateEmpty : kStateFresh;
+	}
+
+	mIdentityDidChange = false;
+	mConfirmedAt = time(NULL);
+
+	return dropped;
+}
+
+static void
+append_uint16(std::string& out, uint16_t value)
+{
+	out.push_back(static_cast<char>(value & 0xFF));
+	out.push_back(static_cast<char>(value >> 8));
+}
+
+static void
+append_uint32(std::string& out, uint32_t value)
+{
+	append_uint16(out, static_cast<uint16_t>(value & 0xFFFF));
+	append_uint16(out, static_cast<uint16_t>(value >> 16));
+}
+
+std::string
+PropertyCache::serialize(void) const
+{
+	std::map<unsigned int, Entry>::const_iterator iter;
+	std::string out;
+	std::string version = mNCPVersion.substr(0, 255);
+
+	out.append(reinterpret_cast<const char*>(kFileMagic), sizeof(kFileMagic));
+	out.push_back(static_cast<char>(kFileFormatVersion));
+	append_uint32(out, static_cast<uint32_t>(mConfirmedAt));
+
+	out.push_back(static_cast<char>(version.size()));
+	out.append(version);
+
+	out.push_back(static_cast<char>(mHardwareAddress.size()));
+	out.append(mHardwareAddress.begin(), mHardwareAddress.end());
+
+	append_uint16(out, static_cast<uint16_t>(mValues.size()));
+
+	for (iter = mValues.begin(); iter != mValues.end(); ++iter) {
+		append_uint32(out, static_cast<uint32_t>(iter->first));
+		append_uint16(out, static_cast<uint16_t>(iter->second.mValue.size()));
+		out.append(iter->second.mValue.begin(), iter->second.mValue.end());
+	}
+
+	return out;
+}
+
+// Reads a snapshot written by `serialize()`. Leaves the cache untouched
+// unless the whole snapshot is valid.
+bool
+PropertyCache::parse(const uint8_t* ptr, size_t len)
+{
+	const uint8_t* end = ptr + len;
+	std::map<unsigned int, Entry> values;
+	std::string version;
+	Data hwaddr;
+	uint32_t confirmed_at;
+	int count;
+	bool ret = false;
+
+	require(len >= sizeof(kFileMagic) + 6, bail);
+	require(memcmp(ptr, kFileMagic, sizeof(kFileMagic)) == 0, bail);
+	ptr += sizeof(kFileMagic);
+
+	require(*ptr == kFileFormatVersion, bail);
+	ptr++;
+
+	confirmed_at = ptr[0] | (ptr[1] << 8) | (ptr[2] << 16) | (static_cast<uint32_t>(ptr[3]) << 24);
+	ptr += 4;
+
+	require(ptr + 1 + *ptr <= end, bail);
+	version.assign(reinterpret_cast<const char*>(ptr + 1), *ptr);
+	ptr += 1 + *ptr;
+
+	require(ptr + 1 + *ptr <= end, bail);
+	hwaddr.append(ptr + 1, *ptr);
+	ptr += 1 + *ptr;
+
+	require(ptr + 2 <= end, bail);
+	count = ptr[0] | (ptr[1] << 8);
+	ptr += 2;
+
+	for (; count > 0; count--) {
+		unsigned int key;
+		size_t value_len;
+
+		require(ptr + 6 <= end, bail);
+		key = ptr[0] | (ptr[1] << 8) | (ptr[2] << 16) | (static_cast<uint32_t>(ptr[3]) << 24);
+		value_len = ptr[4] | (ptr[5] << 8);
+		ptr += 6;
+
+		require(ptr + value_len <= end, bail);
+
+		// Skip properties which are no longer cached.
+		if (is_cached_property(key) && (value_len <= kMaxValueLength)) {
+			Entry& entry = values[key];
+			entry.mValue = Data(ptr, value_len);
+			entry.mConfirmed = false;
+			entry.mConfirmedTime = 0;
+		}
+
+		ptr += value_len;
+	}
+
+	require(ptr == end, bail);
+
+	mValues.swap(values);
+	mNCPVersion = version;
+	mHardwareAddress = hwaddr;
+	mConfirmedAt = static_cast<time_t>(confirmed_at);
+	ret = true;
+
+bail:
+	return ret;
+}
+
+int
+PropertyCache::load(void)
+{
+	Data contents;
+	int fd = -1;
+	int ret = 0;
+
+	require(!mPath.empty(), bail);
+
+	fd = open(mPath.c_str(), O_RDONLY | O_CLOEXEC);
+
+	if (fd < 0) {
+		if (errno != ENOENT) {
+			syslog(LOG_WARNING, "PropertyCache: Unable to open \"%s\": %s", mPath.c_str(), strerror(errno));
+		}
+		goto bail;
+	}
+
+	for (;;) {
+		uint8_t buffer[512];
+		ssize_t len = read(fd, buffer, sizeof(buffer));
+
+		if ((len < 0) && (errno == EINTR)) {
+			continue;
+		}
+
+		require_string(len >= 0, bail, strerror(errno));
+
+		if (len == 0) {
+			break;
+		}
+
+		contents.append(buffer, len);
+	}
+
+	if (!parse(contents.data(), contents.size())) {
+		syslog(LOG_WARNING, "PropertyCache: Ignoring unreadable snapshot \"%s\"", mPath.c_str());
+		goto bail;
+	}
+
+	mIdentityDidChange = false;
+	mState = mValues.empty() ? kStateEmpty : kStateStale;
+	ret = static_cast<int>(mValues.size());
+
+bail:
+	if (fd >= 0) {
+		close(fd);
+	}
+
+	return ret;
+}
+
+void
+PropertyCache::save(void)
+{
+	if (!mPath.empty()) {
+		FileExporter::shared().write(mPath, serialize());
+	}
+}
@@ -0,0 +1,149 @@
+/*
+ *
+ * Copyright (c) 2026 Texas Instruments
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef __wpantund__SpinelNCPPropertyCache__
+#define __wpantund__SpinelNCPPropertyCache__
+
+#include <map>
+#include <string>
+#include <stdint.h>
+#include <time.h>
+#include "spinel.h"
+#include "Data.h"
+#include "time-utils.h"
+
+namespace nl {
+namespace wpantund {
+
+// Last known values of the NCP properties fetched during initialization,
+// kept on disk so that a restarted daemon can answer for them before the
+// NCP has been heard from. Values are kept exactly as the NCP sent them
+// (the payload of a VALUE_IS), so they can be replayed through the normal
+// spinel value handler.
+//
+// Values read back from disk are "stale" until the NCP has reported every
+// one of them again ("fresh"). The snapshot is keyed by the version
+// string and hardware address of the NCP which produced it; values from
+// another NCP are all replaced, or dropped, by the time the cache is fresh.
+class PropertyCache
+{
+public:
+	enum State
+	{
+		kStateDisabled,     // No path has been set
+		kStateEmpty,        // Nothing cached yet
+		kStateStale,        // Values read from disk, not yet confirmed by the NCP
+		kStateFresh,        // Every value has been confirmed by the NCP
+	};
+
+	enum
+	{
+		// File format: the magic, a version byte, the little-endian 32-bit
+		// time the values were last confirmed, the NCP version string and
+		// the hardware address (each preceded by its length byte), then a
+		// little-endian 16-bit count of records, each holding the 32-bit
+		// property key, the 16-bit length of the value and the value itself.
+		kFileFormatVersion  = 1,
+		kMaxValueLength     = 1024,
+	};
+
+public:
+	PropertyCache();
+
+	// Properties worth caching: those fetched during initialization whose
+	// handling only updates a value, with no effect on the NCP state.
+	static bool is_cached_property(unsigned int key);
+
+	void set_path(const std::string& path);
+	const std::string& get_path(void) const { return mPath; }
+
+	// Replaces the cached values with the snapshot on disk, if any.
+	// Returns the number of values read back.
+	int load(void);
+
+	// Queues the snapshot to be written to disk in the background.
+	void save(void);
+
+	// Records a value reported by the NCP. Returns true if it differs
+	// from the cached one.
+	bool update(unsigned int key, const uint8_t* value_ptr, spinel_size_t value_len);
+
+	// Returns the value of `key` if the NCP has reported it since the
+	// last `begin_revalidation()`, at most `max_age` milliseconds ago.
+	// Returns NULL otherwise, and the caller has to ask the NCP.
+	const Data* get_confirmed_value(unsigned int key, cms_t max_age) const;
+
+	// Forgets which values have been confirmed by the NCP.
+	void begin_revalidation(void);
+
+	// Drops the values the NCP did not report again since
+	// `begin_revalidation()` and marks the cache as fresh. Returns the
+	// number of values dropped.
+	int finish_revalidation(void);
+
+	State get_state(void) const { return mState; }
+	const char* get_state_cstr(void) const;
+
+	size_t size(void) const { return mValues.size(); }
+
+	// Seconds since the cached values were last confirmed by the NCP.
+	uint32_t get_age(void) const;
+
+	// True if the NCP reported an identity different from the one
+	// the snapshot on disk was taken from.
+	bool identity_did_change(void) const { return mIdentityDidChange; }
+
+	const std::string& get_ncp_version(void) const { return mNCPVersion; }
+
+	// Calls `handler(key, value_ptr, value_len)` for every cached value.
+	template <typename Handler>
+	void for_each(Handler handler) const
+	{
+		std::map<unsigned int, Entry>::const_iterator iter;
+
+		for (iter = mValues.begin(); iter != mValues.end(); ++iter) {
+			handler(static_cast<spinel_prop_key_t>(iter->first), iter->second.mValue.data(), static_cast<spinel_size_t>(iter->second.mValue.size()));
+		}
+	}
+
+private:
+	struct Entry
+	{
+		Data mValue;
+		bool mConfirmed;
+		cms_t mConfirmedTime;
+	};
+
+	std::string serialize(void) const;
+	bool parse(const uint8_t* ptr, size_t len);
+	void update_identity(unsigned int key, const Data& value);
+
+	std::string mPath;
+	State mState;
+	std::map<unsigned int, Entry> mValues;
+	std::string mNCPVersion;
+	Data mHardwareAddress;
+	bool mIdentityDidChange;
+	time_t mConfirmedAt;
+};
+
+}; // namespace wpantund
+}; // namespace nl
+
+#endif /* defined(__wpantund__SpinelNCPPropertyCache__) */
@@ -0,0 +1,361 @@
+/*
+ *
+ * Copyright (c) 2026 Texas Instruments
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *    Description:
+ *      Implementation of the threaded serial reader.
+ *
+ */
+
+#if HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include "assert-macros.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <string.h>
+#include <syslog.h>
+#include <unistd.h>
+#include "SpinelNCPReaderThread.h"
+
+using namespace nl;
+using namespace nl::wpantund;
+
+static int
+open_nonblocking_pipe(int fds[2])
+{
+	int ret = pipe(fds);
+
+	require_string(ret == 0, bail, strerror(errno));
+
+	for (int i = 0; i < 2; i++) {
+		IGNORE_RETURN_VALUE( fcntl(fds[i], F_SETFL, fcntl(fds[i], F_GETFL) | O_NONBLOCK) );
+		IGNORE_RETURN_VALUE( fcntl(fds[i], F_SETFD, FD_CLOEXEC) );
+	}
+
+bail:
+	if (ret != 0) {
+		fds[0] = fds[1] = -1;
+	}
+	return ret;
+}
+
+static void
+drain_pipe(int fd)
+{
+	uint8_t buffer[64];
+
+	while (::read(fd, buffer, sizeof(buffer)) > 0) {
+	}
+}
+
+SpinelNCPReaderThread::SpinelNCPReaderThread(boost::shared_ptr<SocketWrapper> parent)
+	: SocketAdapter(parent)
+	, mThreadStarted(false)
+	, mReadFD(-1)
+	, mWakePending(false)
+	, mReadError(0)
+	, mReads(0)
+	, mFrames(0)
+	, mRingDrops(0)
+	, mOversize(0)
+	, mRingHighWater(0)
+{
+	IGNORE_RETURN_VALUE( open_nonblocking_pipe(mStopPipe) );
+	IGNORE_RETURN_VALUE( open_nonblocking_pipe(mWakePipe) );
+
+	hdlc_deframer_init(&mDeframer, mFrame + sizeof(FrameHeader), sizeof(mFrame) - sizeof(FrameHeader));
+}
+
+SpinelNCPReaderThread::~SpinelNCPReaderThread()
+{
+	stop();
+
+	for (int i = 0; i < 2; i++) {
+		if (mStopPipe[i] >= 0) {
+			close(mStopPipe[i]);
+		}
+		if (mWakePipe[i] >= 0) {
+			close(mWakePipe[i]);
+		}
+	}
+}
+
+bool
+SpinelNCPReaderThread::start(void)
+{
+	sigset_t all_signals;
+	sigset_t old_signals;
+	int ret;
+
+	if (mThreadStarted) {
+		return true;
+	}
+
+	require(mParent && (mStopPipe[0] >= 0) && (mWakePipe[0] >= 0), bail);
+
+	mReadFD = mParent->get_read_fd();
+
+	// Signals are for the main loop. The thread inherits this mask.
+	sigfillset(&all_signals);
+	pthread_sigmask(SIG_SETMASK, &all_signals, &old_signals);
+
+	ret = pthread_create(&mThread, NULL, &SpinelNCPReaderThread::thread_main, this);
+
+	pthread_sigmask(SIG_SETMASK, &old_signals, NULL);
+
+	require_string(ret == 0, bail, strerror(ret));
+
+	mThreadStarted = true;
+
+bail:
+	if (!mThreadStarted) {
+		syslog(LOG_ERR, "SpinelNCPReaderThread: Unable to start reader thread");
+	}
+	return mThreadStarted;
+}
+
+void
+SpinelNCPReaderThread::stop(void)
+{
+	if (!mThreadStarted) {
+		return;
+	}
+
+	IGNORE_RETURN_VALUE( ::write(mStopPipe[1], "", 1) );
+	pthread_join(mThread, NULL);
+	drain_pipe(mStopPipe[0]);
+
+	mThreadStarted = false;
+}
+
+// Only called with the thread stopped.
+void
+SpinelNCPReaderThread::flush(void)
+{
+	mRing.clear();
+	hdlc_deframer_reset(&mDeframer);
+	mReadError = 0;
+	mWakePending = false;
+	drain_pipe(mWakePipe[0]);
+}
+
+void
+SpinelNCPReaderThread::reset()
+{
+	stop();
+	SocketAdapter::reset();
+	flush();
+	start();
+}
+
+int
+SpinelNCPReaderThread::hibernate(void)
+{
+	int ret;
+
+	stop();
+	ret = SocketAdapter::hibernate();
+	flush();
+
+	return ret;
+}
+
+ssize_t
+SpinelNCPReaderThread::read(void* data, size_t len)
+{
+	return -ENOTSUP;
+}
+
+bool
+SpinelNCPReaderThread::can_read(void)const
+{
+	return !mRing.empty() || (mReadError != 0);
+}
+
+int
+SpinelNCPReaderThread::get_read_fd(void)const
+{
+	return mWakePipe[0];
+}
+
+ssize_t
+SpinelNCPReaderThread::pull_frame(uint8_t* frame, size_t frame_size, uint16_t* crc)
+{
+	FrameHeader header;
+
+	if (mRing.peek(reinterpret_cast<uint8_t*>(&header), sizeof(header)) < static_cast<int>(sizeof(header))) {
+		// Out of frames. Rearm the wakeup before looking once more,
+		// so that a frame queued in between can't go unnoticed.
+		mWakePending = false;
+		drain_pipe(mWakePipe[0]);
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+
+		if (mRing.peek(reinterpret_cast<uint8_t*>(&header), sizeof(header)) < static_cast<int>(sizeof(header))) {
+			return mReadError;
+		}
+	}
+
+	mRing.pull(NULL, sizeof(header));
+
+	if (header.mLength > frame_size) {
+		// Can't happen, the thread deframes into a buffer no bigger.
+		mRing.pull(NULL, header.mLength);
+		return 0;
+	}
+
+	mRing.pull(frame, header.mLength);
+	*crc = header.mCRC;
+
+	return header.mLength;
+}
+
+SpinelNCPReaderThread::Stats
+SpinelNCPReaderThread::get_stats(void) const
+{
+	Stats stats;
+
+	stats.mReads = mReads.load(std::memory_order_relaxed);
+	stats.mFrames = mFrames.load(std::memory_order_relaxed);
+	stats.mRingDrops = mRingDrops.load(std::memory_order_relaxed);
+	stats.mOversize = mOversize.load(std::memory_order_relaxed);
+	stats.mRingHighWater = mRingHighWater.load(std::memory_order_relaxed);
+
+	return stats;
+}
+
+void*
+SpinelNCPReaderThread::thread_main(void* context)
+{
+	static_cast<SpinelNCPReaderThread*>(context)->run();
+	return NULL;
+}
+
+void
+SpinelNCPReaderThread::wake_main_loop(void)
+{
+	// Pairs with the fence in `pull_frame()`: either the main loop sees
+	// what was just queued, or it has cleared `mWakePending` and gets
+	// written to.
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+
+	if (!mWakePending.exchange(true)) {
+		IGNORE_RETURN_VALUE( ::write(mWakePipe[1], "", 1) );
+	}
+}
+
+void
+SpinelNCPReaderThread::queue_frame(size_t frame_len)
+{
+	FrameHeader header;
+	uint32_t queued;
+
+	header.mLength = static_cast<uint16_t>(frame_len);
+	header.mCRC = mDeframer.crc;
+	memcpy(mFrame, &header, sizeof(header));
+
+	if (!mRing.push(mFrame, static_cast<int>(sizeof(header) + frame_len))) {
+		mRingDrops.fetch_add(1, std::memory_order_relaxed);
+		return;
+	}
+
+	mFrames.fetch_add(1, std::memory_order_relaxed);
+
+	queued = static_cast<uint32_t>(mRing.size());
+
+	if (queued > mRingHighWater.load(std::memory_order_relaxed)) {
+		mRingHighWater.store(queued, std::memory_order_relaxed);
+	}
+}
+
+void
+SpinelNCPReaderThread::run(void)
+{
+	struct pollfd fds[2];
+
+	fds[0].fd = mStopPipe[0];
+	fds[0].events = POLLIN;
+	fds[1].fd = mReadFD;
+	fds[1].events = POLLIN;
+
+	while (true) {
+		ssize_t read_len;
+		ssize_t offset = 0;
+		bool queued = false;
+
+		fds[0].revents = fds[1].revents = 0;
+
+		if (poll(fds, 2, -1) < 0) {
+			if (errno == EINTR) {
+				continue;
+			}
+			read_len = -errno;
+			goto on_error;
+		}
+
+		if (fds[0].revents != 0) {
+			break;
+		}
+
+		if (fds[1].revents == 0) {
+			continue;
+		}
+
+		read_len = mParent->read(mReadBuffer, sizeof(mReadBuffer));
+
+		if ((read_len == 0) && ((fds[1].revents & (POLLHUP | POLLERR | POLLNVAL)) != 0)) {
+			// Nothing left to read and never will be.
+			read_len = -EPIPE;
+		}
+
+		if (read_len < 0) {
+			goto on_error;
+		}
+
+		mReads.fetch_add(1, std::memory_order_relaxed);
+
+		// A single read can carry any number of frames. The main loop
+		// is woken once for all of them.
+		while (offset < read_len) {
+			ssize_t frame_len;
+
+			offset += hdlc_deframe(&mDeframer, mReadBuffer + offset, read_len - offset, &frame_len);
+
+			// Empty frames are just back to back flags.
+			if (frame_len > 2) {
+				queue_frame(frame_len);
+				queued = true;
+			}
+		}
+
+		mOversize.store(mDeframer.overrun_count, std::memory_order_relaxed);
+
+		if (queued) {
+			wake_main_loop();
+		}
+		continue;
+
+on_error:
+		// Handed to the main loop once it has taken the frames
+		// queued before the error. Reading resumes after a reset.
+		mReadError = static_cast<int>(read_len);
+		wake_main_loop();
+		break;
+	}
+}
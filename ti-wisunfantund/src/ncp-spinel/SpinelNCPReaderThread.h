@@ -0,0 +1,133 @@
+/*
+ *
+ * Copyright (c) 2026 Texas Instruments
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *    Description:
+ *      This file declares a socket adapter which reads and deframes
+ *      the NCP's HDLC stream on a dedicated thread.
+ *
+ */
+
+#ifndef __wpantund__SpinelNCPReaderThread__
+#define __wpantund__SpinelNCPReaderThread__
+
+#include <atomic>
+#include <stdint.h>
+#include <pthread.h>
+#include "SocketAdapter.h"
+#include "RingBuffer.h"
+#include "hdlc.h"
+#include "spinel.h"
+
+namespace nl {
+namespace wpantund {
+
+// Keeps the serial port drained while the main loop is busy elsewhere
+// (a D-Bus client reading a large property, a slow task, ...). A thread
+// reads everything the NCP sends as soon as it arrives, deframes it, and
+// queues the frames for the main loop in a lock-free ring. The main loop
+// waits on `get_read_fd()` as before and takes whole frames out with
+// `pull_frame()`.
+//
+// Only reading moves to the thread; writes go straight to the parent
+// socket from the main loop, as they always have.
+class SpinelNCPReaderThread : public SocketAdapter {
+public:
+	struct Stats {
+		uint32_t mReads;         // Reads from the serial port
+		uint32_t mFrames;        // Frames queued for the main loop
+		uint32_t mRingDrops;     // Frames dropped because the ring was full
+		uint32_t mOversize;      // Frames dropped for being too big
+		uint32_t mRingHighWater; // Most bytes ever waiting in the ring
+	};
+
+	SpinelNCPReaderThread(boost::shared_ptr<SocketWrapper> parent);
+
+	// Stops the thread, if it is running.
+	virtual ~SpinelNCPReaderThread();
+
+	// Starts reading from the parent socket. Returns false if the
+	// thread could not be started.
+	bool start(void);
+
+	// Stops reading and waits for the thread to exit. Anything still
+	// queued stays queued.
+	void stop(void);
+
+	// Takes the next frame off the ring. Copies it (FCS included) to
+	// `frame` and its CRC residue to `*crc`, and returns its length.
+	// Returns zero if no frame is waiting, and a negative errno if
+	// reading from the serial port failed.
+	ssize_t pull_frame(uint8_t* frame, size_t frame_size, uint16_t* crc);
+
+	Stats get_stats(void) const;
+
+	// The main loop must not read the parent socket behind our back.
+	virtual ssize_t read(void* data, size_t len);
+	virtual bool can_read(void)const;
+	virtual int get_read_fd(void)const;
+
+	// The parent's file descriptor goes away over these, so the thread
+	// is stopped around them.
+	virtual void reset();
+	virtual int hibernate(void);
+
+private:
+	// Each frame is queued behind this header.
+	struct FrameHeader {
+		uint16_t mLength;
+		uint16_t mCRC;
+	};
+
+	enum {
+		kRingSize = 65536,
+	};
+
+	static void* thread_main(void* context);
+	void run(void);
+	void queue_frame(size_t frame_len);
+	void flush(void);
+	void wake_main_loop(void);
+
+	pthread_t mThread;
+	bool mThreadStarted;
+	int mReadFD;
+
+	// Written to stop the thread, and by the thread to wake the main
+	// loop.
+	int mStopPipe[2];
+	int mWakePipe[2];
+	std::atomic<bool> mWakePending;
+	std::atomic<int> mReadError;
+
+	SpscRingBuffer<uint8_t, kRingSize> mRing;
+
+	// Only touched by the thread while it runs.
+	struct hdlc_deframer mDeframer;
+	uint8_t mReadBuffer[SPINEL_FRAME_BUFFER_SIZE * 2];
+	uint8_t mFrame[sizeof(FrameHeader) + SPINEL_FRAME_BUFFER_SIZE];
+
+	std::atomic<uint32_t> mReads;
+	std::atomic<uint32_t> mFrames;
+	std::atomic<uint32_t> mRingDrops;
+	std::atomic<uint32_t> mOversize;
+	std::atomic<uint32_t> mRingHighWater;
+};
+
+}; // namespace wpantund
+}; // namespace nl
+
+#endif // defined(__wpantund__SpinelNCPReaderThread__)
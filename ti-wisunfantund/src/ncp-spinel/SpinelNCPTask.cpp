@@ -102,26 +102,29 @@ on_error:
 nl::Data
 nl::wpantund::SpinelPackData(const char* pack_format, ...)
 {
-	Data ret(64);
+	uint8_t buffer[SPINEL_FRAME_BUFFER_SIZE];
+	spinel_ssize_t packed_size;
+	Data ret;
 
 	va_list args;
 	va_start(args, pack_format);
+	packed_size = spinel_datatype_vpack(buffer, sizeof(buffer), pack_format, args);
+	va_end(args);
 
-	do {
-		spinel_ssize_t packed_size = spinel_datatype_vpack(ret.data(), (spinel_size_t)ret.size(), pack_format, args);
+	if (packed_size < 0) {
+		// Leave `ret` empty.
 
-		if (packed_size < 0) {
-			ret.clear();
-		} else if (packed_size > ret.size()) {
-			ret.resize(packed_size);
-			continue;
-		} else {
-			ret.resize(packed_size);
-		}
-		break;
-	} while(true);
+	} else if (packed_size <= static_cast<spinel_ssize_t>(sizeof(buffer))) {
+		ret = Data(buffer, packed_size);
+
+	} else {
+		// Too big to ever be sent, which is for the caller to find out.
+		ret.resize(packed_size);
+		va_start(args, pack_format);
+		spinel_datatype_vpack(ret.data(), (spinel_size_t)ret.size(), pack_format, args);
+		va_end(args);
+	}
 
-	va_end(args);
 	return ret;
 }
 
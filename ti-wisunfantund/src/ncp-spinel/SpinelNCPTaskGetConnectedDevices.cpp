@@ -0,0 +1,194 @@
+/*
+ *
+ * Copyright (c) 2026 Texas Instruments
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#if HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include "assert-macros.h"
+#include <syslog.h>
+#include <errno.h>
+#include "SpinelNCPTaskGetConnectedDevices.h"
+#include "SpinelNCPInstance.h"
+#include "SpinelNCPTopologyGraph.h"
+#include "spinel-extra.h"
+
+using namespace nl;
+using namespace nl::wpantund;
+
+nl::wpantund::SpinelNCPTaskGetConnectedDevices::SpinelNCPTaskGetConnectedDevices(
+	SpinelNCPInstance* instance,
+	CallbackWithStatusArg1 cb,
+	ResultFormat result_format
+) : SpinelNCPTask(instance, cb), mResultFormat(result_format), mBlockCount(0), mFirstBlockId(-1),
+	mSeenLastBlock(false), mDone(false)
+{
+}
+
+boost::any
+nl::wpantund::SpinelNCPTaskGetConnectedDevices::format_devices(void) const
+{
+	boost::any ret;
+
+	if (mResultFormat == kResultFormat_Binary) {
+		Data result(mDevices.size() * sizeof(struct in6_addr));
+
+		for (size_t i = 0; i < mDevices.size(); i++) {
+			memcpy(result.data() + i * sizeof(struct in6_addr), mDevices[i].s6_addr, sizeof(struct in6_addr));
+		}
+
+		ret = result;
+
+	} else {
+		std::list<std::string> result;
+
+		for (std::vector<struct in6_addr>::const_iterator it = mDevices.begin(); it != mDevices.end(); ++it) {
+			result.push_back(in6_addr_to_string(*it));
+		}
+
+		ret = result;
+	}
+
+	return ret;
+}
+
+int
+nl::wpantund::SpinelNCPTaskGetConnectedDevices::vprocess_event(int event, va_list args)
+{
+	int ret = kWPANTUNDStatus_Failure;
+	unsigned int prop_key;
+	const uint8_t *data_in;
+	spinel_size_t data_len;
+
+	EH_BEGIN();
+
+	if (!mInstance->mEnabled) {
+		ret = kWPANTUNDStatus_InvalidWhenDisabled;
+		finish(ret);
+		EH_EXIT();
+	}
+
+	if (mInstance->get_ncp_state() == UPGRADING) {
+		ret = kWPANTUNDStatus_InvalidForCurrentState;
+		finish(ret);
+		EH_EXIT();
+	}
+
+	// Wait for a bit to see if the NCP will enter the right state.
+	EH_REQUIRE_WITHIN(
+		NCP_DEFAULT_COMMAND_RESPONSE_TIMEOUT,
+		!ncp_state_is_initializing(mInstance->get_ncp_state()) && !mInstance->is_initializing_ncp(),
+		on_error
+	);
+
+	EH_WAIT_UNTIL(EVENT_STARTING_TASK != event);
+
+	mDevices.clear();
+	mSeen.clear();
+	mBlockCount = 0;
+	mFirstBlockId = -1;
+	mSeenLastBlock = false;
+	mDone = false;
+
+	// Each read returns the block after the one returned by the previous
+	// read, whoever made it, and wraps around after the last block. So
+	// the walk may start part way through the list: keep going past the
+	// last block until the block we started at comes round again.
+	do {
+		mNextCommand = SpinelPackData(
+			SPINEL_FRAME_PACK_CMD_PROP_VALUE_GET,
+			SPINEL_PROP_CONNECTED_DEVICES
+		);
+
+		EH_SPAWN(&mSubPT, vprocess_send_command(event, args));
+
+		ret = mNextCommandRet;
+
+		require_noerr(ret, on_error);
+
+		require(EVENT_NCP_PROP_VALUE_IS == static_cast<unsigned int>(event), on_error);
+
+		prop_key = va_arg(args, unsigned int);
+		data_in = va_arg(args, const uint8_t*);
+		data_len = va_arg_small(args, spinel_size_t);
+
+		require(prop_key == SPINEL_PROP_CONNECTED_DEVICES, on_error);
+
+		{
+			std::vector<struct in6_addr> block;
+			bool is_last_block = false;
+			uint8_t block_id = 0;
+
+			ret = TopologyGraph::parse_connected_devices_block(data_in, data_len, block, is_last_block, &block_id);
+			require_noerr(ret, on_error);
+
+			if (mFirstBlockId < 0) {
+				mFirstBlockId = block_id;
+
+			} else if (block_id == mFirstBlockId) {
+				// Back where we started, this block has been read already.
+				mDone = true;
+			}
+
+			if (!mDone) {
+				for (std::vector<struct in6_addr>::iterator it = block.begin(); it != block.end(); ++it) {
+					if (mSeen.insert(*it).second) {
+						mDevices.push_back(*it);
+					}
+				}
+
+				if (is_last_block) {
+					mSeenLastBlock = true;
+					mDone = (mFirstBlockId == 0);
+				}
+			}
+		}
+
+		mBlockCount++;
+
+	} while (!mDone && (mBlockCount < kMaxConnectedDeviceBlocks));
+
+	if (!mSeenLastBlock) {
+		syslog(LOG_WARNING, "Connected devices: No last block after %d blocks, list may be incomplete", mBlockCount);
+	}
+
+	ret = kWPANTUNDStatus_Ok;
+
+	finish(ret, format_devices());
+
+	mDevices.clear();
+	mSeen.clear();
+
+	EH_EXIT();
+
+on_error:
+
+	if (ret == kWPANTUNDStatus_Ok) {
+		ret = kWPANTUNDStatus_Failure;
+	}
+
+	syslog(LOG_ERR, "Getting connected devices failed: %d", ret);
+
+	finish(ret);
+
+	mDevices.clear();
+	mSeen.clear();
+
+	EH_END();
+}
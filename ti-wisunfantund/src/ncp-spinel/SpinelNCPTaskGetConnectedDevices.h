@@ -0,0 +1,79 @@
+/*
+ *
+ * Copyright (c) 2026 Texas Instruments
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef __wpantund__SpinelNCPTaskGetConnectedDevices__
+#define __wpantund__SpinelNCPTaskGetConnectedDevices__
+
+#include <set>
+#include <vector>
+#include "IPv6Helpers.h"
+#include "SpinelNCPTask.h"
+#include "SpinelNCPInstance.h"
+
+using namespace nl;
+using namespace nl::wpantund;
+
+namespace nl {
+namespace wpantund {
+
+// Reads SPINEL_PROP_CONNECTED_DEVICES block after block until the NCP
+// has given out the whole list, and returns it in one go, each address
+// once.
+class SpinelNCPTaskGetConnectedDevices : public SpinelNCPTask
+{
+public:
+
+	enum ResultFormat
+	{
+		kResultFormat_StringArray,     // Returns the addresses as an array of std::string(s).
+		kResultFormat_Binary,          // Returns the addresses back to back, 16 bytes each.
+	};
+
+	enum
+	{
+		// Guards against an NCP which never flags its last block.
+		kMaxConnectedDeviceBlocks = 128,
+	};
+
+public:
+	SpinelNCPTaskGetConnectedDevices(
+		SpinelNCPInstance *instance,
+		CallbackWithStatusArg1 cb,
+		ResultFormat result_format = kResultFormat_StringArray
+	);
+	virtual int vprocess_event(int event, va_list args);
+
+private:
+	boost::any format_devices(void) const;
+
+	ResultFormat mResultFormat;
+	std::vector<struct in6_addr> mDevices;
+	std::set<struct in6_addr> mSeen;
+	int mBlockCount;
+	int mFirstBlockId;
+	bool mSeenLastBlock;
+	bool mDone;
+};
+
+
+}; // namespace wpantund
+}; // namespace nl
+
+
+#endif /* defined(__wpantund__SpinelNCPTaskGetConnectedDevices__) */
@@ -0,0 +1,234 @@
+/*
+ *
+ * Copyright (c) 2026 Texas Instruments
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#if HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include "assert-macros.h"
+#include <syslog.h>
+#include <errno.h>
+#include "SpinelNCPTaskGetTopologySnapshot.h"
+#include "SpinelNCPInstance.h"
+#include "spinel-extra.h"
+
+using namespace nl;
+using namespace nl::wpantund;
+
+nl::wpantund::SpinelNCPTaskGetTopologySnapshot::SpinelNCPTaskGetTopologySnapshot(
+	SpinelNCPInstance* instance,
+	CallbackWithStatusArg1 cb,
+	ResultFormat result_format,
+	bool use_cache
+) : SpinelNCPTask(instance, cb), mResultFormat(result_format), mUseCache(use_cache), mDeviceIndex(0), mBlockCount(0),
+	mIsLastBlock(false), mDevicesBeforeBlock(0)
+{
+}
+
+boost::any
+nl::wpantund::SpinelNCPTaskGetTopologySnapshot::format_snapshot(const TopologyGraph& graph, ResultFormat result_format)
+{
+	boost::any ret;
+
+	if (result_format == kResultFormat_Binary) {
+		Data result;
+		graph.convert_to_binary(result);
+		ret = result;
+
+	} else if (result_format == kResultFormat_ValueMapArray) {
+		std::list<ValueMap> result;
+		graph.convert_to_valuemap_list(result);
+		ret = result;
+
+	} else {
+		std::list<std::string> result;
+		graph.convert_to_string_list(result);
+		ret = result;
+	}
+
+	return ret;
+}
+
+int
+nl::wpantund::SpinelNCPTaskGetTopologySnapshot::vprocess_event(int event, va_list args)
+{
+	int ret = kWPANTUNDStatus_Failure;
+	unsigned int prop_key;
+	const uint8_t *data_in;
+	spinel_size_t data_len;
+
+	EH_BEGIN();
+
+	if (!mInstance->mEnabled) {
+		ret = kWPANTUNDStatus_InvalidWhenDisabled;
+		finish(ret);
+		EH_EXIT();
+	}
+
+	if (mInstance->get_ncp_state() == UPGRADING) {
+		ret = kWPANTUNDStatus_InvalidForCurrentState;
+		finish(ret);
+		EH_EXIT();
+	}
+
+	// Wait for a bit to see if the NCP will enter the right state.
+	EH_REQUIRE_WITHIN(
+		NCP_DEFAULT_COMMAND_RESPONSE_TIMEOUT,
+		!ncp_state_is_initializing(mInstance->get_ncp_state()) && !mInstance->is_initializing_ncp(),
+		on_error
+	);
+
+	EH_WAIT_UNTIL(EVENT_STARTING_TASK != event);
+
+	// Another snapshot task queued ahead of us may have just done all
+	// the work.
+	if (mUseCache && mInstance->topology_snapshot_is_fresh()) {
+		finish(kWPANTUNDStatus_Ok, format_snapshot(mInstance->mTopology, mResultFormat));
+		EH_EXIT();
+	}
+
+	mGraph.clear();
+	mDevices.clear();
+	mBlockCount = 0;
+
+	// Each read of the connected devices property returns the next
+	// block. Stop at the block flagged as the last one, or once the
+	// NCP starts handing out addresses we have already seen.
+	do {
+		mNextCommand = SpinelPackData(
+			SPINEL_FRAME_PACK_CMD_PROP_VALUE_GET,
+			SPINEL_PROP_CONNECTED_DEVICES
+		);
+
+		EH_SPAWN(&mSubPT, vprocess_send_command(event, args));
+
+		ret = mNextCommandRet;
+
+		require_noerr(ret, on_error);
+
+		require(EVENT_NCP_PROP_VALUE_IS == static_cast<unsigned int>(event), on_error);
+
+		prop_key = va_arg(args, unsigned int);
+		data_in = va_arg(args, const uint8_t*);
+		data_len = va_arg_small(args, spinel_size_t);
+
+		require(prop_key == SPINEL_PROP_CONNECTED_DEVICES, on_error);
+
+		{
+			std::vector<struct in6_addr> block;
+
+			ret = TopologyGraph::parse_connected_devices_block(data_in, data_len, block, mIsLastBlock);
+			require_noerr(ret, on_error);
+
+			mDevicesBeforeBlock = mDevices.size();
+
+			for (std::vector<struct in6_addr>::iterator it = block.begin(); it != block.end(); it++) {
+				if (!mGraph.contains(*it)) {
+					mGraph.add_node(*it);
+					mDevices.push_back(*it);
+				}
+			}
+		}
+
+		mBlockCount++;
+
+	} while (!mIsLastBlock
+		&& (mDevices.size() != mDevicesBeforeBlock)
+		&& (mBlockCount < kMaxConnectedDeviceBlocks)
+	);
+
+	for (mDeviceIndex = 0; mDeviceIndex < mDevices.size(); mDeviceIndex++) {
+		mNextCommand = SpinelPackData(
+			SPINEL_FRAME_PACK_CMD_PROP_VALUE_SET(SPINEL_DATATYPE_DATA_S),
+			SPINEL_PROP_DODAG_ROUTE_DEST,
+			mDevices[mDeviceIndex].s6_addr,
+			sizeof(mDevices[mDeviceIndex].s6_addr)
+		);
+
+		EH_SPAWN(&mSubPT, vprocess_send_command(event, args));
+
+		ret = mNextCommandRet;
+
+		require(ret != kWPANTUNDStatus_Timeout, on_error);
+
+		if (ret != kWPANTUNDStatus_Ok) {
+			// The node may have dropped out since the list was read.
+			// Keep it in the snapshot, without a parent.
+			continue;
+		}
+
+		mNextCommand = SpinelPackData(
+			SPINEL_FRAME_PACK_CMD_PROP_VALUE_GET,
+			SPINEL_PROP_DODAG_ROUTE
+		);
+
+		EH_SPAWN(&mSubPT, vprocess_send_command(event, args));
+
+		ret = mNextCommandRet;
+
+		require(ret != kWPANTUNDStatus_Timeout, on_error);
+
+		if ((ret == kWPANTUNDStatus_Ok) && (EVENT_NCP_PROP_VALUE_IS == static_cast<unsigned int>(event))) {
+			std::vector<struct in6_addr> route;
+
+			prop_key = va_arg(args, unsigned int);
+			data_in = va_arg(args, const uint8_t*);
+			data_len = va_arg_small(args, spinel_size_t);
+
+			if ((prop_key == SPINEL_PROP_DODAG_ROUTE)
+			 && (TopologyGraph::parse_dodag_route(data_in, data_len, route) == kWPANTUNDStatus_Ok)
+			 && (route.back() == mDevices[mDeviceIndex])
+			) {
+				mGraph.add_route(route);
+			} else {
+				syslog(LOG_WARNING, "Ignoring unexpected DODAG route for %s",
+					in6_addr_to_string(mDevices[mDeviceIndex]).c_str());
+			}
+		}
+	}
+
+	// Nodes missing from the walk are reported as gone from here.
+	mInstance->mTopology.replace(mGraph);
+	mInstance->mTopologySnapshotTime = time_ms();
+	mInstance->mTopologySnapshotValid = true;
+
+	ret = kWPANTUNDStatus_Ok;
+
+	finish(ret, format_snapshot(mInstance->mTopology, mResultFormat));
+
+	mGraph.clear();
+	mDevices.clear();
+
+	EH_EXIT();
+
+on_error:
+
+	if (ret == kWPANTUNDStatus_Ok) {
+		ret = kWPANTUNDStatus_Failure;
+	}
+
+	syslog(LOG_ERR, "Getting topology snapshot failed: %d", ret);
+
+	finish(ret);
+
+	mGraph.clear();
+	mDevices.clear();
+
+	EH_END();
+}
@@ -0,0 +1,84 @@
+/*
+ *
+ * Copyright (c) 2026 Texas Instruments
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef __wpantund__SpinelNCPTaskGetTopologySnapshot__
+#define __wpantund__SpinelNCPTaskGetTopologySnapshot__
+
+#include <vector>
+#include <string>
+#include "ValueMap.h"
+#include "IPv6Helpers.h"
+#include "SpinelNCPTask.h"
+#include "SpinelNCPInstance.h"
+#include "SpinelNCPTopologyGraph.h"
+
+using namespace nl;
+using namespace nl::wpantund;
+
+namespace nl {
+namespace wpantund {
+
+// Walks every connected device and its DODAG route on the NCP and
+// assembles them into a single parent/child graph, which then replaces
+// the one kept by the instance.
+class SpinelNCPTaskGetTopologySnapshot : public SpinelNCPTask
+{
+public:
+
+	enum ResultFormat
+	{
+		kResultFormat_StringArray,     // Returns the topology as an array of std::string(s) (one per node).
+		kResultFormat_ValueMapArray,   // Returns the topology as an array of ValueMap dictionary.
+		kResultFormat_Binary,          // Returns the topology in the compact binary form of TopologyGraph.
+	};
+
+	enum
+	{
+		// Guards against an NCP which never flags its last block.
+		kMaxConnectedDeviceBlocks = 128,
+	};
+
+public:
+	SpinelNCPTaskGetTopologySnapshot(
+		SpinelNCPInstance *instance,
+		CallbackWithStatusArg1 cb,
+		ResultFormat result_format = kResultFormat_ValueMapArray,
+		bool use_cache = true
+	);
+	virtual int vprocess_event(int event, va_list args);
+
+	static boost::any format_snapshot(const TopologyGraph& graph, ResultFormat result_format);
+
+private:
+	ResultFormat mResultFormat;
+	bool mUseCache;
+	TopologyGraph mGraph;
+	std::vector<struct in6_addr> mDevices;
+	size_t mDeviceIndex;
+	int mBlockCount;
+	bool mIsLastBlock;
+	size_t mDevicesBeforeBlock;
+};
+
+
+}; // namespace wpantund
+}; // namespace nl
+
+
+#endif /* defined(__wpantund__SpinelNCPTaskGetTopologySnapshot__) */
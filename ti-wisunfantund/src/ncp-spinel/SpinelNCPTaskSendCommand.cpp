@@ -74,7 +74,7 @@ SpinelNCPTaskSendCommand::Factory::set_timeout(int timeout)
 SpinelNCPTaskSendCommand::Factory&
 SpinelNCPTaskSendCommand::Factory::set_reply_format(const std::string& packed_format)
 {
-	mReplyUnpacker = boost::bind(simple_unpacker, _1, _2, packed_format, _3);
+	mReplyUnpacker = SpinelNCPTaskSendCommand::simple_reply_unpacker(packed_format);
 	return *this;
 }
 
@@ -302,6 +302,12 @@ simple_unpacker(const uint8_t* data_in, spinel_size_t data_len, const std::strin
 	return retval;
 }
 
+SpinelNCPTaskSendCommand::ReplyUnpacker
+nl::wpantund::SpinelNCPTaskSendCommand::simple_reply_unpacker(const std::string& packed_format)
+{
+	return boost::bind(simple_unpacker, _1, _2, packed_format, _3);
+}
+
 int
 nl::wpantund::SpinelNCPTaskSendCommand::vprocess_event(int event, va_list args)
 {
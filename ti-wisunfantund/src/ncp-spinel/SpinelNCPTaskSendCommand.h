@@ -82,6 +82,9 @@ public:
 
 	SpinelNCPTaskSendCommand(const Factory& factory);
 
+	//! Returns an unpacker for a simple (single type) reply format.
+	static ReplyUnpacker simple_reply_unpacker(const std::string& packed_format);
+
 	virtual int vprocess_event(int event, va_list args);
 
 private:
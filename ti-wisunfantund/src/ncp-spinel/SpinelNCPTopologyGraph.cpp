@@ -0,0 +1,303 @@
+/*
+ *
+ * Copyright (c) 2026 Texas Instruments
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#if HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include "assert-macros.h"
+#include <stdio.h>
+#include <string.h>
+#include "SpinelNCPTopologyGraph.h"
+#include "wpan-error.h"
+#include "wpan-properties.h"
+
+using namespace nl;
+using namespace nl::wpantund;
+
+static bool
+node_parent_differs(const TopologyGraph::Node &lhs, const TopologyGraph::Node &rhs)
+{
+	if (lhs.mHasParent != rhs.mHasParent) {
+		return true;
+	}
+
+	return lhs.mHasParent && (lhs.mParent != rhs.mParent);
+}
+
+void
+TopologyGraph::set_node(const struct in6_addr &address, const Node &node)
+{
+	NodeMap::iterator iter = mNodes.find(address);
+
+	if (iter == mNodes.end()) {
+		mNodes[address] = node;
+
+		if (!mChangeHandler.empty()) {
+			mChangeHandler(kNodeJoined, address, node, NULL);
+		}
+
+	} else if (node_parent_differs(iter->second, node)) {
+		Node old_node = iter->second;
+
+		iter->second = node;
+
+		if (!mChangeHandler.empty()) {
+			mChangeHandler(kParentChanged, address, node, &old_node);
+		}
+
+	} else {
+		iter->second.mPathCost = node.mPathCost;
+	}
+}
+
+void
+TopologyGraph::add_node(const struct in6_addr &address)
+{
+	if (!contains(address)) {
+		Node node;
+
+		memset(&node.mParent, 0, sizeof(node.mParent));
+		node.mHasParent = false;
+		node.mPathCost = kUnknownPathCost;
+
+		set_node(address, node);
+	}
+}
+
+void
+TopologyGraph::add_route(const std::vector<struct in6_addr> &route)
+{
+	for (size_t hop = 0; hop < route.size(); hop++) {
+		Node node;
+
+		memset(&node.mParent, 0, sizeof(node.mParent));
+		node.mHasParent = (hop != 0);
+		node.mPathCost = static_cast<uint8_t>(hop);
+
+		if (node.mHasParent) {
+			node.mParent = route[hop - 1];
+		}
+
+		set_node(route[hop], node);
+	}
+}
+
+void
+TopologyGraph::replace(const TopologyGraph &other)
+{
+	NodeMap::iterator iter = mNodes.begin();
+	NodeMap::const_iterator other_iter;
+
+	while (iter != mNodes.end()) {
+		if (other.contains(iter->first)) {
+			++iter;
+			continue;
+		}
+
+		Node old_node = iter->second;
+		struct in6_addr address = iter->first;
+
+		mNodes.erase(iter++);
+
+		if (!mChangeHandler.empty()) {
+			mChangeHandler(kNodeLeft, address, old_node, NULL);
+		}
+	}
+
+	for (other_iter = other.mNodes.begin(); other_iter != other.mNodes.end(); ++other_iter) {
+		if (!other_iter->second.mHasParent && (other_iter->second.mPathCost == kUnknownPathCost)) {
+			add_node(other_iter->first);
+		} else {
+			set_node(other_iter->first, other_iter->second);
+		}
+	}
+}
+
+void
+TopologyGraph::convert_to_valuemap_list(std::list<ValueMap> &list) const
+{
+	NodeMap::const_iterator iter;
+	std::map<struct in6_addr, std::list<std::string> > children;
+
+	for (iter = mNodes.begin(); iter != mNodes.end(); ++iter) {
+		if (iter->second.mHasParent) {
+			children[iter->second.mParent].push_back(in6_addr_to_string(iter->first));
+		}
+	}
+
+	for (iter = mNodes.begin(); iter != mNodes.end(); ++iter) {
+		ValueMap entry;
+
+		entry[kWPANTUNDValueMapKey_Topology_Address] = in6_addr_to_string(iter->first);
+
+		if (iter->second.mHasParent) {
+			entry[kWPANTUNDValueMapKey_Topology_Parent] = in6_addr_to_string(iter->second.mParent);
+		}
+
+		if (iter->second.mPathCost != kUnknownPathCost) {
+			entry[kWPANTUNDValueMapKey_Topology_PathCost] = iter->second.mPathCost;
+		}
+
+		entry[kWPANTUNDValueMapKey_Topology_Children] = children[iter->first];
+
+		list.push_back(entry);
+	}
+}
+
+void
+TopologyGraph::convert_to_string_list(std::list<std::string> &list) const
+{
+	NodeMap::const_iterator iter;
+	std::map<struct in6_addr, int> child_count;
+
+	for (iter = mNodes.begin(); iter != mNodes.end(); ++iter) {
+		if (iter->second.mHasParent) {
+			child_count[iter->second.mParent]++;
+		}
+	}
+
+	for (iter = mNodes.begin(); iter != mNodes.end(); ++iter) {
+		char c_string[200];
+
+		snprintf(c_string, sizeof(c_string),
+			"%s, Parent:%s, PathCost:%d, Children:%d",
+			in6_addr_to_string(iter->first).c_str(),
+			iter->second.mHasParent ? in6_addr_to_string(iter->second.mParent).c_str() : "none",
+			(iter->second.mPathCost != kUnknownPathCost) ? iter->second.mPathCost : -1,
+			child_count[iter->first]
+		);
+
+		list.push_back(std::string(c_string));
+	}
+}
+
+void
+TopologyGraph::convert_to_binary(Data &data) const
+{
+	NodeMap::const_iterator iter;
+	std::map<struct in6_addr, uint16_t> index;
+	uint8_t *ptr;
+
+	for (iter = mNodes.begin(); iter != mNodes.end(); ++iter) {
+		uint16_t next_index = static_cast<uint16_t>(index.size());
+		index[iter->first] = next_index;
+	}
+
+	data.resize(kBinaryHeaderSize + kBinaryNodeSize * mNodes.size());
+	ptr = data.data();
+
+	*ptr++ = kBinaryFormatVersion;
+	*ptr++ = static_cast<uint8_t>(mNodes.size() & 0xFF);
+	*ptr++ = static_cast<uint8_t>(mNodes.size() >> 8);
+
+	for (iter = mNodes.begin(); iter != mNodes.end(); ++iter) {
+		uint16_t parent = kNoParentIndex;
+
+		if (iter->second.mHasParent && (index.count(iter->second.mParent) != 0)) {
+			parent = index[iter->second.mParent];
+		}
+
+		memcpy(ptr, iter->first.s6_addr, sizeof(iter->first.s6_addr));
+		ptr += sizeof(iter->first.s6_addr);
+		*ptr++ = static_cast<uint8_t>(parent & 0xFF);
+		*ptr++ = static_cast<uint8_t>(parent >> 8);
+		*ptr++ = iter->second.mPathCost;
+	}
+}
+
+int
+TopologyGraph::parse_connected_devices_block(
+	const uint8_t *data_in,
+	spinel_size_t data_len,
+	std::vector<struct in6_addr> &devices,
+	bool &is_last_block,
+	uint8_t *block_id
+) {
+	int ret = kWPANTUNDStatus_Failure;
+	const uint8_t *entry_ptr = NULL;
+	spinel_size_t entry_len = 0;
+	spinel_ssize_t len;
+
+	len = spinel_datatype_unpack(data_in, data_len, SPINEL_DATATYPE_DATA_S, &entry_ptr, &entry_len);
+	require(len > 0 && entry_len >= 1, bail);
+
+	// The first byte is the block ID, with the MSB set on the last block.
+	is_last_block = ((entry_ptr[0] & 0x80) != 0);
+	if (block_id != NULL) {
+		*block_id = (entry_ptr[0] & 0x7F);
+	}
+	entry_ptr++;
+	entry_len--;
+
+	while (entry_len >= sizeof(struct in6_addr)) {
+		struct in6_addr address;
+
+		memcpy(address.s6_addr, entry_ptr, sizeof(address.s6_addr));
+		devices.push_back(address);
+
+		entry_ptr += sizeof(struct in6_addr);
+		entry_len -= sizeof(struct in6_addr);
+	}
+
+	ret = kWPANTUNDStatus_Ok;
+
+bail:
+	return ret;
+}
+
+int
+TopologyGraph::parse_dodag_route(
+	const uint8_t *data_in,
+	spinel_size_t data_len,
+	std::vector<struct in6_addr> &route
+) {
+	int ret = kWPANTUNDStatus_Failure;
+	const uint8_t *entry_ptr = NULL;
+	spinel_size_t entry_len = 0;
+	spinel_ssize_t len;
+	unsigned int path_cost;
+
+	len = spinel_datatype_unpack(data_in, data_len, SPINEL_DATATYPE_DATA_S, &entry_ptr, &entry_len);
+	require(len > 0 && entry_len >= 1, bail);
+
+	// The path cost is followed by `path_cost + 1` addresses, starting
+	// at the root and ending at the destination.
+	path_cost = entry_ptr[0];
+	entry_ptr++;
+	entry_len--;
+
+	require(entry_len >= (path_cost + 1) * sizeof(struct in6_addr), bail);
+
+	route.clear();
+
+	for (unsigned int i = 0; i <= path_cost; i++) {
+		struct in6_addr address;
+
+		memcpy(address.s6_addr, entry_ptr, sizeof(address.s6_addr));
+		route.push_back(address);
+
+		entry_ptr += sizeof(struct in6_addr);
+	}
+
+	ret = kWPANTUNDStatus_Ok;
+
+bail:
+	return ret;
+}
@@ -0,0 +1,119 @@
+/*
+ *
+ * Copyright (c) 2026 Texas Instruments
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef __wpantund__SpinelNCPTopologyGraph__
+#define __wpantund__SpinelNCPTopologyGraph__
+
+#include <map>
+#include <list>
+#include <vector>
+#include <string>
+#include <boost/function.hpp>
+#include "spinel.h"
+#include "Data.h"
+#include "ValueMap.h"
+#include "IPv6Helpers.h"
+
+namespace nl {
+namespace wpantund {
+
+// Parent/child graph of the Wi-SUN network, keyed by node address. It
+// is fed from SPINEL_PROP_CONNECTED_DEVICES blocks and
+// SPINEL_PROP_DODAG_ROUTE values, and reports every node which joins,
+// leaves or moves to another parent through the change handler.
+class TopologyGraph
+{
+public:
+	enum
+	{
+		kUnknownPathCost         = 0xFF,
+
+		// Binary form: a version byte and a little-endian node count,
+		// followed by one record per node holding the 16 byte address,
+		// the little-endian index of the parent record (kNoParentIndex
+		// for the root or for nodes whose route is unknown) and the path cost.
+		kBinaryFormatVersion     = 1,
+		kBinaryHeaderSize        = 3,
+		kBinaryNodeSize          = sizeof(struct in6_addr) + 3,
+		kNoParentIndex           = 0xFFFF,
+	};
+
+	enum ChangeType
+	{
+		kNodeJoined,
+		kNodeLeft,
+		kParentChanged,
+	};
+
+	struct Node
+	{
+		struct in6_addr mParent;
+		bool            mHasParent;
+		uint8_t         mPathCost;
+	};
+
+	typedef std::map<struct in6_addr, Node> NodeMap;
+
+	// `old_node` is only set for kParentChanged.
+	typedef boost::function<void(ChangeType type, const struct in6_addr &address, const Node &node,
+			const Node *old_node)> ChangeHandler;
+
+	TopologyGraph(void) { }
+
+	void set_change_handler(const ChangeHandler &handler) { mChangeHandler = handler; }
+
+	// Drops every node without reporting them as gone.
+	void clear(void) { mNodes.clear(); }
+	bool empty(void) const { return mNodes.empty(); }
+	size_t size(void) const { return mNodes.size(); }
+	bool contains(const struct in6_addr &address) const { return mNodes.count(address) != 0; }
+	const NodeMap &get_nodes(void) const { return mNodes; }
+
+	// Adds a node whose route is not known yet.
+	void add_node(const struct in6_addr &address);
+
+	// Adds every hop of a route, root first, as the child of the hop before it.
+	void add_route(const std::vector<struct in6_addr> &route);
+
+	// Makes this graph a copy of `other`, reporting the differences. A
+	// node whose route is unknown in `other` keeps the parent it has here.
+	void replace(const TopologyGraph &other);
+
+	void convert_to_valuemap_list(std::list<ValueMap> &list) const;
+	void convert_to_string_list(std::list<std::string> &list) const;
+	void convert_to_binary(Data &data) const;
+
+	// Parse one block of SPINEL_PROP_CONNECTED_DEVICES, appending the addresses to `devices`.
+	static int parse_connected_devices_block(const uint8_t *data_in, spinel_size_t data_len,
+			std::vector<struct in6_addr> &devices, bool &is_last_block, uint8_t *block_id = NULL);
+
+	// Parse SPINEL_PROP_DODAG_ROUTE into the list of hops, root first and destination last.
+	static int parse_dodag_route(const uint8_t *data_in, spinel_size_t data_len, std::vector<struct in6_addr> &route);
+
+private:
+	void set_node(const struct in6_addr &address, const Node &node);
+
+	NodeMap mNodes;
+	ChangeHandler mChangeHandler;
+};
+
+}; // namespace wpantund
+}; // namespace nl
+
+#endif /* defined(__wpantund__SpinelNCPTopologyGraph__) */
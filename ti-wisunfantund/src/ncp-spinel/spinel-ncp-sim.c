@@ -0,0 +1,1625 @@
+/*
+ *
+ * Copyright (c) 2026 Texas Instruments
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *    Description:
+ *      Host-side stand-in for a Wi-SUN border router NCP. Speaks
+ *      HDLC-lite framed spinel on stdin/stdout, so that wfantund can
+ *      drive it through a `system:` socket path, for example:
+ *
+ *          wfantund -s 'system:spinel-ncp-sim --nodes 200 --baud 460800'
+ *
+ *      It simulates a network of nodes (with join churn and a DODAG of
+ *      bounded depth) behind the border router, pages the connected
+ *      devices list like the real NCP, sends ICMPv6 echo requests from
+ *      the nodes to the border router's address at a given rate and
+ *      paces everything to a UART baud rate. The echo replies coming
+ *      back from the host give the end-to-end latency through wfantund
+ *      and the kernel. With `--lossy`, bytes the host is not ready for
+ *      are thrown away, like a UART without flow control would. Statistics
+ *      are written out on exit.
+ *
+ */
+
+#define _GNU_SOURCE 1
+
+#if HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <errno.h>
+#include <fcntl.h>
+#include <getopt.h>
+#include <poll.h>
+#include <signal.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/resource.h>
+
+#include "hdlc.h"
+#include "spinel.h"
+
+/* ------------------------------------------------------------------------- */
+/* MARK: Macros and Constants */
+
+#define SIM_NCP_VERSION_STRING          "TIWISUNFAN/spinel-ncp-sim"
+
+#define SIM_MAX_FRAME_LEN               SPINEL_FRAME_MAX_SIZE
+#define SIM_MAX_NODES                   8192
+#define SIM_MAX_BLOCKS                  128     // Block IDs are seven bits
+#define SIM_MAX_BLOCK_SIZE              64      // 16 * 64 + 1 fits in a spinel frame
+#define SIM_MAX_PROPS                   64
+#define SIM_MAX_PROP_LEN                256
+#define SIM_MAX_RTT_SAMPLES             65536
+
+// Encoded bytes waiting for the UART. Generated traffic is dropped,
+// like on the NCP, once the backlog passes SIM_TX_DATA_LIMIT.
+#define SIM_TX_QUEUE_LEN                (256 * 1024)
+#define SIM_TX_DATA_LIMIT               (16 * 1024)
+
+#define SIM_IPV6_HEADER_LEN             40
+#define SIM_ICMPV6_HEADER_LEN           8
+#define SIM_ECHO_STAMP_LEN              16
+#define SIM_ECHO_MIN_PACKET_LEN         (SIM_IPV6_HEADER_LEN + SIM_ICMPV6_HEADER_LEN + SIM_ECHO_STAMP_LEN)
+#define SIM_ECHO_MAX_PACKET_LEN         1280
+#define SIM_ECHO_IDENTIFIER             0x5753
+#define SIM_ECHO_MAGIC                  0x57465346  // "WFSF"
+
+#define SIM_NO_PARENT                   0xFFFF
+
+#define USEC_PER_SEC                    1000000ULL
+
+/* ------------------------------------------------------------------------- */
+/* MARK: Types */
+
+struct sim_node {
+	struct in6_addr addr;
+	uint16_t parent;        // SIM_NO_PARENT if attached to the border router
+	uint8_t depth;          // Hops to the border router
+	bool joined;
+	uint64_t rejoin_at;     // Only while not joined
+};
+
+struct sim_prop {
+	spinel_prop_key_t key;
+	uint16_t len;
+	uint8_t value[SIM_MAX_PROP_LEN];
+};
+
+// Token bucket standing in for one direction of the UART.
+struct sim_uart_budget {
+	double bytes_per_us;    // Zero if unlimited
+	double credit;
+	double burst;
+	uint64_t last_refill;
+};
+
+struct sim_stats {
+	uint64_t rx_frames;
+	uint64_t rx_bytes;
+	uint64_t rx_bad_crc;
+	uint64_t rx_bad_frames;
+	uint64_t tx_frames;
+	uint64_t tx_bytes;
+	uint64_t tx_overflow;
+	uint64_t host_overruns;
+	uint64_t host_overrun_bytes;
+	uint64_t resets;
+	uint64_t prop_gets;
+	uint64_t prop_sets;
+	uint64_t prop_not_found;
+	uint64_t blocks_served;
+	uint64_t block_passes;
+	uint64_t routes_served;
+	uint64_t node_leaves;
+	uint64_t node_joins;
+	uint64_t net_to_host;
+	uint64_t net_to_host_bytes;
+	uint64_t net_to_host_dropped;
+	uint64_t net_from_host;
+	uint64_t net_from_host_bytes;
+	uint64_t echo_replies;
+	uint64_t rtt_sum;
+	uint32_t rtt_min;
+	uint32_t rtt_max;
+	uint32_t rtt_count;
+	uint32_t rtt_samples[SIM_MAX_RTT_SAMPLES];
+};
+
+/* ------------------------------------------------------------------------- */
+/* MARK: Global State */
+
+static int sNodeCount = 50;
+static int sMaxDepth = 4;
+static int sBlockSize = 20;
+static double sChurnRate = 0;           // Nodes leaving per second
+static double sRejoinDelay = 10;        // Seconds before a node which left joins again
+static double sPacketRate = 0;          // Echo requests sent to the host per second
+static int sPacketLen = 128;
+static int sBaudRate = 115200;
+static bool sLossy;
+static uint32_t sRandomState = 1;
+static const char* sStatsPath = NULL;
+static struct in6_addr sPrefix;
+static struct in6_addr sHostAddress;
+
+static struct sim_node sNodes[SIM_MAX_NODES];
+static int sJoinedCount;
+static int sBlockCursor;
+static struct in6_addr sRouteDest;
+
+// Nodes which left, in the order they will join again.
+static uint16_t sRejoinQueue[SIM_MAX_NODES];
+static int sRejoinHead;
+static int sRejoinCount;
+
+static struct sim_prop sProps[SIM_MAX_PROPS];
+static int sPropCount;
+
+static uint8_t sRxFrame[SIM_MAX_FRAME_LEN + 2];
+static size_t sRxFrameLen;
+static bool sRxEscaped;
+static bool sRxOverflow;
+static uint16_t sRxCrc = HDLC_CRC_RESET_VALUE;
+
+static uint8_t sTxQueue[SIM_TX_QUEUE_LEN];
+static size_t sTxHead;
+static size_t sTxTail;
+
+static struct sim_uart_budget sRxBudget;
+static struct sim_uart_budget sTxBudget;
+
+static uint16_t sEchoSequence;
+static uint64_t sNextPacketAt;
+static uint64_t sNextChurnAt;
+static uint64_t sStartTime;
+
+static struct sim_stats sStats;
+
+static volatile sig_atomic_t sQuit;
+static volatile sig_atomic_t sDumpStats;
+static volatile sig_atomic_t sClearStats;
+
+/* ------------------------------------------------------------------------- */
+/* MARK: Utilities */
+
+static uint64_t
+time_us(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return (uint64_t)ts.tv_sec * USEC_PER_SEC + (uint64_t)ts.tv_nsec / 1000;
+}
+
+static uint32_t
+next_random(void)
+{
+	sRandomState ^= sRandomState << 13;
+	sRandomState ^= sRandomState >> 17;
+	sRandomState ^= sRandomState << 5;
+	return sRandomState;
+}
+
+// Interval to the next of a series of events happening `rate` times a
+// second, jittered by up to half of it either way so that churn and
+// traffic don't line up with each other.
+static uint64_t
+next_interval_us(double rate)
+{
+	double mean = (double)USEC_PER_SEC / rate;
+
+	return (uint64_t)(mean / 2 + mean * (double)(next_random() % 1024) / 1024.0);
+}
+
+static void
+signal_quit(int sig)
+{
+	(void)sig;
+	sQuit = 1;
+}
+
+/* ------------------------------------------------------------------------- */
+/* MARK: UART Pacing */
+
+static void
+uart_budget_init(struct sim_uart_budget* budget, int baud, uint64_t now)
+{
+	// Eight data bits plus a start and a stop bit per byte.
+	budget->bytes_per_us = (double)baud / 10.0 / (double)USEC_PER_SEC;
+	// Up to 10ms worth of bytes in one go, like a small FIFO.
+	budget->burst = budget->bytes_per_us * 10000.0;
+	if (budget->burst < 64) {
+		budget->burst = 64;
+	}
+	budget->credit = budget->burst;
+	budget->last_refill = now;
+}
+
+static void
+uart_budget_refill(struct sim_uart_budget* budget, uint64_t now)
+{
+	if (budget->bytes_per_us > 0) {
+		budget->credit += (double)(now - budget->last_refill) * budget->bytes_per_us;
+		if (budget->credit > budget->burst) {
+			budget->credit = budget->burst;
+		}
+	}
+	budget->last_refill = now;
+}
+
+static size_t
+uart_budget_available(const struct sim_uart_budget* budget, size_t want)
+{
+	if ((budget->bytes_per_us > 0) && ((double)want > budget->credit)) {
+		want = (size_t)budget->credit;
+	}
+
+	return want;
+}
+
+static void
+uart_budget_spend(struct sim_uart_budget* budget, size_t len)
+{
+	if (budget->bytes_per_us > 0) {
+		budget->credit -= (double)len;
+	}
+}
+
+// Microseconds until `want` bytes (capped at the burst size) can go.
+static uint64_t
+uart_budget_wait_us(const struct sim_uart_budget* budget, size_t want)
+{
+	double needed;
+
+	if (budget->bytes_per_us <= 0) {
+		return 0;
+	}
+
+	needed = ((double)want < budget->burst) ? (double)want : budget->burst;
+
+	if (needed <= budget->credit) {
+		return 0;
+	}
+
+	return (uint64_t)((needed - budget->credit) / budget->bytes_per_us) + 1;
+}
+
+/* ------------------------------------------------------------------------- */
+/* MARK: Outbound Frames */
+
+static size_t
+tx_queue_backlog(void)
+{
+	return sTxTail - sTxHead;
+}
+
+// In lossy mode: sends whatever the UART would have sent by now, and
+// throws away the part of it the host had no room for.
+static void
+tx_lossy(void)
+{
+	size_t want = uart_budget_available(&sTxBudget, tx_queue_backlog());
+	ssize_t len;
+
+	if (want == 0) {
+		return;
+	}
+
+	len = write(STDOUT_FILENO, sTxQueue + sTxHead, want);
+
+	if (len < 0) {
+		len = 0;
+	}
+
+	if ((size_t)len < want) {
+		sStats.host_overruns++;
+		sStats.host_overrun_bytes += want - (size_t)len;
+	}
+
+	uart_budget_spend(&sTxBudget, want);
+	sStats.tx_bytes += (uint64_t)len;
+	sTxHead += want;
+
+	if (sTxHead == sTxTail) {
+		sTxHead = sTxTail = 0;
+	}
+}
+
+// Frames and queues a spinel frame for the host. Returns false if it
+// was dropped.
+static bool
+send_frame(const uint8_t* frame_ptr, size_t frame_len, bool is_data)
+{
+	size_t needed = HDLC_ENCODED_MAX_LEN(frame_len) + 2;
+
+	if (is_data && (tx_queue_backlog() > SIM_TX_DATA_LIMIT)) {
+		sStats.net_to_host_dropped++;
+		return false;
+	}
+
+	if (sTxTail + needed > sizeof(sTxQueue)) {
+		memmove(sTxQueue, sTxQueue + sTxHead, tx_queue_backlog());
+		sTxTail -= sTxHead;
+		sTxHead = 0;
+	}
+
+	if (sTxTail + needed > sizeof(sTxQueue)) {
+		sStats.tx_overflow++;
+		return false;
+	}
+
+	sTxQueue[sTxTail++] = HDLC_BYTE_FLAG;
+	sTxTail += hdlc_encode(sTxQueue + sTxTail, frame_ptr, frame_len);
+	sTxQueue[sTxTail++] = HDLC_BYTE_FLAG;
+
+	sStats.tx_frames++;
+
+	return true;
+}
+
+static void
+send_prop_value(uint8_t header, unsigned int command, spinel_prop_key_t key, const uint8_t* value_ptr, size_t value_len)
+{
+	uint8_t frame[SIM_MAX_FRAME_LEN];
+	spinel_ssize_t len;
+
+	len = spinel_datatype_pack(
+		frame,
+		sizeof(frame),
+		SPINEL_DATATYPE_COMMAND_PROP_S SPINEL_DATATYPE_DATA_S,
+		header,
+		command,
+		key,
+		value_ptr,
+		value_len
+	);
+
+	if ((len > 0) && ((size_t)len <= sizeof(frame))) {
+		send_frame(frame, (size_t)len, false);
+	}
+}
+
+static void
+send_last_status(uint8_t header, spinel_status_t status)
+{
+	uint8_t value[8];
+	spinel_ssize_t len = spinel_datatype_pack(value, sizeof(value), SPINEL_DATATYPE_UINT_PACKED_S, status);
+
+	send_prop_value(header, SPINEL_CMD_PROP_VALUE_IS, SPINEL_PROP_LAST_STATUS, value, (size_t)len);
+}
+
+/* ------------------------------------------------------------------------- */
+/* MARK: Property Store */
+
+// Properties without any behavior of their own hold whatever the host
+// last set them to.
+static struct sim_prop*
+prop_find(spinel_prop_key_t key)
+{
+	int i;
+
+	for (i = 0; i < sPropCount; i++) {
+		if (sProps[i].key == key) {
+			return &sProps[i];
+		}
+	}
+
+	return NULL;
+}
+
+static bool
+prop_store(spinel_prop_key_t key, const uint8_t* value_ptr, size_t value_len)
+{
+	struct sim_prop* prop = prop_find(key);
+
+	if (value_len > SIM_MAX_PROP_LEN) {
+		return false;
+	}
+
+	if (prop == NULL) {
+		if (sPropCount == SIM_MAX_PROPS) {
+			return false;
+		}
+		prop = &sProps[sPropCount++];
+		prop->key = key;
+	}
+
+	memcpy(prop->value, value_ptr, value_len);
+	prop->len = (uint16_t)value_len;
+
+	return true;
+}
+
+static bool
+prop_get_bool(spinel_prop_key_t key)
+{
+	struct sim_prop* prop = prop_find(key);
+
+	return (prop != NULL) && (prop->len >= 1) && (prop->value[0] != 0);
+}
+
+static void
+prop_store_defaults(void)
+{
+	static const char network_name[] = "wisunsim";
+	uint8_t value[2];
+
+	sPropCount = 0;
+
+	value[0] = 1;
+	prop_store(SPINEL_PROP_NET_IF_UP, value, 1);
+	prop_store(SPINEL_PROP_NET_STACK_UP, value, 1);
+
+	value[0] = SPINEL_NET_ROLE_ROUTER;
+	prop_store(SPINEL_PROP_NET_ROLE, value, 1);
+
+	value[0] = 0xCD;
+	value[1] = 0xAB;
+	prop_store(SPINEL_PROP_MAC_15_4_PANID, value, 2);
+
+	prop_store(SPINEL_PROP_NET_NETWORK_NAME, (const uint8_t*)network_name, sizeof(network_name));
+}
+
+/* ------------------------------------------------------------------------- */
+/* MARK: Network Model */
+
+static void
+node_address(struct in6_addr* addr, int index)
+{
+	*addr = sPrefix;
+	// Interface IDs look like the ones TI parts derive from their EUI-64.
+	addr->s6_addr[8] = 0x02;
+	addr->s6_addr[9] = 0x12;
+	addr->s6_addr[10] = 0x4b;
+	addr->s6_addr[11] = 0x00;
+	addr->s6_addr[12] = 0x00;
+	addr->s6_addr[13] = 0x51;
+	addr->s6_addr[14] = (uint8_t)(index >> 8);
+	addr->s6_addr[15] = (uint8_t)index;
+}
+
+static int
+node_index(const struct in6_addr* addr)
+{
+	int index;
+
+	if (memcmp(addr->s6_addr, sPrefix.s6_addr, 8) != 0) {
+		return -1;
+	}
+
+	index = (addr->s6_addr[14] << 8) | addr->s6_addr[15];
+
+	if ((index >= sNodeCount) || (memcmp(addr, &sNodes[index].addr, sizeof(*addr)) != 0)) {
+		return -1;
+	}
+
+	return index;
+}
+
+// Picks a parent for `index` among the joined nodes which can take
+// a child without going over the maximum depth, or the border router.
+static void
+node_attach(int index)
+{
+	int tries;
+
+	sNodes[index].parent = SIM_NO_PARENT;
+	sNodes[index].depth = 1;
+
+	for (tries = 0; tries < 8; tries++) {
+		int candidate = (int)(next_random() % (uint32_t)(sNodeCount + 1));
+
+		if (candidate == sNodeCount) {
+			break;
+		}
+
+		if ((candidate != index)
+		 && sNodes[candidate].joined
+		 && (sNodes[candidate].depth < sMaxDepth)
+		) {
+			sNodes[index].parent = (uint16_t)candidate;
+			sNodes[index].depth = (uint8_t)(sNodes[candidate].depth + 1);
+			break;
+		}
+	}
+}
+
+static void
+update_depths(void)
+{
+	bool changed;
+	int i;
+
+	// Parents can come after their children, so go until it settles.
+	do {
+		changed = false;
+
+		for (i = 0; i < sNodeCount; i++) {
+			uint8_t depth = 1;
+
+			if (sNodes[i].parent != SIM_NO_PARENT) {
+				depth = (uint8_t)(sNodes[sNodes[i].parent].depth + 1);
+			}
+
+			if (sNodes[i].depth != depth) {
+				sNodes[i].depth = depth;
+				changed = true;
+			}
+		}
+	} while (changed);
+}
+
+static void
+send_num_connected_devices(void)
+{
+	uint8_t value[2];
+
+	value[0] = (uint8_t)(sJoinedCount & 0xFF);
+	value[1] = (uint8_t)(sJoinedCount >> 8);
+
+	send_prop_value(SPINEL_HEADER_FLAG | SPINEL_HEADER_IID_0, SPINEL_CMD_PROP_VALUE_IS, SPINEL_PROP_NUM_CONNECTED_DEVICES, value, sizeof(value));
+}
+
+static void
+network_init(void)
+{
+	int i;
+
+	for (i = 0; i < sNodeCount; i++) {
+		node_address(&sNodes[i].addr, i);
+		node_attach(i);
+		sNodes[i].joined = true;
+		sNodes[i].rejoin_at = 0;
+	}
+
+	sJoinedCount = sNodeCount;
+	sBlockCursor = 0;
+	sRejoinHead = 0;
+	sRejoinCount = 0;
+	memset(&sRouteDest, 0, sizeof(sRouteDest));
+}
+
+// A random joined node leaves, taking nothing with it: its children
+// move up to its parent, the way RPL repairs around a lost router.
+static void
+node_leave(uint64_t now)
+{
+	int start = (int)(next_random() % (uint32_t)sNodeCount);
+	int index = -1;
+	int i;
+
+	for (i = 0; i < sNodeCount; i++) {
+		int candidate = (start + i) % sNodeCount;
+
+		if (sNodes[candidate].joined) {
+			index = candidate;
+			break;
+		}
+	}
+
+	if (index < 0) {
+		return;
+	}
+
+	for (i = 0; i < sNodeCount; i++) {
+		if (sNodes[i].parent == index) {
+			sNodes[i].parent = sNodes[index].parent;
+		}
+	}
+
+	sNodes[index].joined = false;
+	sNodes[index].parent = SIM_NO_PARENT;
+	sNodes[index].rejoin_at = now + (uint64_t)(sRejoinDelay * (double)USEC_PER_SEC);
+	sJoinedCount--;
+
+	sRejoinQueue[(sRejoinHead + sRejoinCount) % SIM_MAX_NODES] = (uint16_t)index;
+	sRejoinCount++;
+
+	update_depths();
+
+	sStats.node_leaves++;
+	send_num_connected_devices();
+}
+
+static void
+process_rejoins(uint64_t now)
+{
+	bool changed = false;
+
+	while (sRejoinCount > 0) {
+		int index = sRejoinQueue[sRejoinHead];
+
+		if (sNodes[index].rejoin_at > now) {
+			break;
+		}
+
+		sRejoinHead = (sRejoinHead + 1) % SIM_MAX_NODES;
+		sRejoinCount--;
+
+		node_attach(index);
+		sNodes[index].joined = true;
+		sNodes[index].rejoin_at = 0;
+		sJoinedCount++;
+
+		sStats.node_joins++;
+		changed = true;
+	}
+
+	if (changed) {
+		send_num_connected_devices();
+	}
+}
+
+// Builds the next block of the connected devices list, with the block
+// ID in the first byte and its MSB set on the last block. Like the
+// NCP, every read moves on to the next block, wrapping after the last.
+static size_t
+build_connected_devices_block(uint8_t* out)
+{
+	int block_count = (sJoinedCount + sBlockSize - 1) / sBlockSize;
+	int first;
+	int seen = 0;
+	int count = 0;
+	size_t len = 1;
+	int i;
+
+	if (block_count == 0) {
+		block_count = 1;
+	}
+
+	if (block_count > SIM_MAX_BLOCKS) {
+		block_count = SIM_MAX_BLOCKS;
+	}
+
+	if (sBlockCursor >= block_count) {
+		sBlockCursor = 0;
+	}
+
+	first = sBlockCursor * sBlockSize;
+
+	for (i = 0; (i < sNodeCount) && (count < sBlockSize); i++) {
+		if (!sNodes[i].joined) {
+			continue;
+		}
+
+		if (seen++ < first) {
+			continue;
+		}
+
+		memcpy(out + len, sNodes[i].addr.s6_addr, sizeof(struct in6_addr));
+		len += sizeof(struct in6_addr);
+		count++;
+	}
+
+	out[0] = (uint8_t)sBlockCursor;
+
+	if (sBlockCursor == block_count - 1) {
+		out[0] |= 0x80;
+		sStats.block_passes++;
+	}
+
+	sBlockCursor = (sBlockCursor + 1) % block_count;
+	sStats.blocks_served++;
+
+	return len;
+}
+
+// Path cost followed by the addresses from the border router down to
+// `sRouteDest`. Returns zero if there is no such node.
+static size_t
+build_dodag_route(uint8_t* out)
+{
+	int index = node_index(&sRouteDest);
+	int path_cost;
+	int hop;
+
+	if ((index < 0) || !sNodes[index].joined) {
+		return 0;
+	}
+
+	path_cost = sNodes[index].depth;
+	out[0] = (uint8_t)path_cost;
+	memcpy(out + 1, sHostAddress.s6_addr, sizeof(struct in6_addr));
+
+	for (hop = path_cost; hop >= 1; hop--) {
+		memcpy(out + 1 + hop * sizeof(struct in6_addr), sNodes[index].addr.s6_addr, sizeof(struct in6_addr));
+		index = sNodes[index].parent;
+	}
+
+	sStats.routes_served++;
+
+	return 1 + (size_t)(path_cost + 1) * sizeof(struct in6_addr);
+}
+
+/* ------------------------------------------------------------------------- */
+/* MARK: IPv6 Traffic */
+
+static uint16_t
+icmpv6_checksum(const uint8_t* packet, size_t len)
+{
+	uint32_t sum = 0;
+	size_t icmp_len = len - SIM_IPV6_HEADER_LEN;
+	size_t i;
+
+	// Pseudo-header: source, destination, length and next header.
+	for (i = 8; i < SIM_IPV6_HEADER_LEN; i += 2) {
+		sum += (uint32_t)((packet[i] << 8) | packet[i + 1]);
+	}
+	sum += (uint32_t)(icmp_len >> 16) + (uint32_t)(icmp_len & 0xFFFF);
+	sum += IPPROTO_ICMPV6;
+
+	for (i = SIM_IPV6_HEADER_LEN; i + 1 < len; i += 2) {
+		sum += (uint32_t)((packet[i] << 8) | packet[i + 1]);
+	}
+	if (i < len) {
+		sum += (uint32_t)(packet[i] << 8);
+	}
+
+	while (sum >> 16) {
+		sum = (sum & 0xFFFF) + (sum >> 16);
+	}
+
+	return (uint16_t)~sum;
+}
+
+static void
+put_be32(uint8_t* ptr, uint32_t value)
+{
+	ptr[0] = (uint8_t)(value >> 24);
+	ptr[1] = (uint8_t)(value >> 16);
+	ptr[2] = (uint8_t)(value >> 8);
+	ptr[3] = (uint8_t)value;
+}
+
+static uint32_t
+get_be32(const uint8_t* ptr)
+{
+	return ((uint32_t)ptr[0] << 24) | ((uint32_t)ptr[1] << 16) | ((uint32_t)ptr[2] << 8) | ptr[3];
+}
+
+// Sends an ICMPv6 echo request from a random joined node to the
+// border router's address, stamped with the time it was queued.
+static void
+send_echo_request(uint64_t now)
+{
+	uint8_t packet[SIM_ECHO_MAX_PACKET_LEN];
+	uint8_t frame[SIM_MAX_FRAME_LEN];
+	size_t payload_len = (size_t)sPacketLen - SIM_IPV6_HEADER_LEN;
+	spinel_ssize_t frame_len;
+	uint16_t checksum;
+	int index;
+	size_t i;
+
+	if ((sJoinedCount == 0) || !prop_get_bool(SPINEL_PROP_NET_STACK_UP)) {
+		return;
+	}
+
+	do {
+		index = (int)(next_random() % (uint32_t)sNodeCount);
+	} while (!sNodes[index].joined);
+
+	memset(packet, 0, SIM_IPV6_HEADER_LEN + SIM_ICMPV6_HEADER_LEN);
+	packet[0] = 0x60;
+	packet[4] = (uint8_t)(payload_len >> 8);
+	packet[5] = (uint8_t)payload_len;
+	packet[6] = IPPROTO_ICMPV6;
+	packet[7] = 64;
+	memcpy(packet + 8, sNodes[index].addr.s6_addr, 16);
+	memcpy(packet + 24, sHostAddress.s6_addr, 16);
+
+	packet[40] = 128; // Echo request
+	packet[44] = (uint8_t)(SIM_ECHO_IDENTIFIER >> 8);
+	packet[45] = (uint8_t)SIM_ECHO_IDENTIFIER;
+	packet[46] = (uint8_t)(sEchoSequence >> 8);
+	packet[47] = (uint8_t)sEchoSequence;
+	sEchoSequence++;
+
+	put_be32(packet + 48, SIM_ECHO_MAGIC);
+	put_be32(packet + 52, 0);
+	put_be32(packet + 56, (uint32_t)(now >> 32));
+	put_be32(packet + 60, (uint32_t)now);
+
+	for (i = SIM_ECHO_MIN_PACKET_LEN; i < (size_t)sPacketLen; i++) {
+		packet[i] = (uint8_t)i;
+	}
+
+	checksum = icmpv6_checksum(packet, (size_t)sPacketLen);
+	packet[42] = (uint8_t)(checksum >> 8);
+	packet[43] = (uint8_t)checksum;
+
+	frame_len = spinel_datatype_pack(
+		frame,
+		sizeof(frame),
+		SPINEL_DATATYPE_COMMAND_PROP_S SPINEL_DATATYPE_DATA_WLEN_S SPINEL_DATATYPE_DATA_S,
+		SPINEL_HEADER_FLAG | SPINEL_HEADER_IID_0,
+		SPINEL_CMD_PROP_VALUE_IS,
+		SPINEL_PROP_STREAM_NET,
+		packet,
+		(size_t)sPacketLen,
+		packet,
+		(size_t)0
+	);
+
+	if ((frame_len > 0) && ((size_t)frame_len <= sizeof(frame)) && send_frame(frame, (size_t)frame_len, true)) {
+		sStats.net_to_host++;
+		sStats.net_to_host_bytes += (uint64_t)sPacketLen;
+	}
+}
+
+static void
+record_rtt(uint32_t rtt)
+{
+	if ((sStats.rtt_count == 0) || (rtt < sStats.rtt_min)) {
+		sStats.rtt_min = rtt;
+	}
+	if (rtt > sStats.rtt_max) {
+		sStats.rtt_max = rtt;
+	}
+	sStats.rtt_sum += rtt;
+
+	if (sStats.rtt_count < SIM_MAX_RTT_SAMPLES) {
+		sStats.rtt_samples[sStats.rtt_count] = rtt;
+	}
+	sStats.rtt_count++;
+}
+
+// Counts an IPv6 packet the host sent into the mesh, and takes the
+// round trip time from it if it answers one of our echo requests.
+static void
+handle_ipv6_from_host(const uint8_t* packet, size_t len)
+{
+	sStats.net_from_host++;
+	sStats.net_from_host_bytes += len;
+
+	if ((len >= SIM_ECHO_MIN_PACKET_LEN)
+	 && (packet[6] == IPPROTO_ICMPV6)
+	 && (packet[40] == 129) // Echo reply
+	 && (((packet[44] << 8) | packet[45]) == SIM_ECHO_IDENTIFIER)
+	 && (get_be32(packet + 48) == SIM_ECHO_MAGIC)
+	) {
+		uint64_t sent = ((uint64_t)get_be32(packet + 56) << 32) | get_be32(packet + 60);
+		uint64_t now = time_us();
+
+		sStats.echo_replies++;
+
+		if ((sent <= now) && (sent >= sStartTime)) {
+			record_rtt((uint32_t)(now - sent));
+		}
+	}
+}
+
+/* ------------------------------------------------------------------------- */
+/* MARK: Spinel Commands */
+
+static void
+handle_prop_value_get(uint8_t header, spinel_prop_key_t key)
+{
+	uint8_t value[SIM_MAX_FRAME_LEN];
+	spinel_ssize_t len = -1;
+	struct sim_prop* prop;
+
+	sStats.prop_gets++;
+
+	switch (key) {
+	case SPINEL_PROP_PROTOCOL_VERSION:
+		len = spinel_datatype_pack(value, sizeof(value), "ii", SPINEL_PROTOCOL_VERSION_THREAD_MAJOR, SPINEL_PROTOCOL_VERSION_THREAD_MINOR);
+		break;
+
+	case SPINEL_PROP_NCP_VERSION:
+		len = spinel_datatype_pack(value, sizeof(value), SPINEL_DATATYPE_UTF8_S, SIM_NCP_VERSION_STRING);
+		break;
+
+	case SPINEL_PROP_INTERFACE_TYPE:
+		len = spinel_datatype_pack(value, sizeof(value), SPINEL_DATATYPE_UINT_PACKED_S, SPINEL_PROTOCOL_TYPE_THREAD);
+		break;
+
+	case SPINEL_PROP_CAPS:
+		len = spinel_datatype_pack(value, sizeof(value), "ii", SPINEL_CAP_NET_THREAD_1_1, SPINEL_CAP_ROLE_ROUTER);
+		break;
+
+	case SPINEL_PROP_HWADDR:
+		{
+			static const uint8_t eui64[8] = { 0x00, 0x12, 0x4b, 0x00, 0x00, 0x51, 0xff, 0xfe };
+			len = spinel_datatype_pack(value, sizeof(value), SPINEL_DATATYPE_EUI64_S, eui64);
+		}
+		break;
+
+	case SPINEL_PROP_IPV6_ADDRESS_TABLE:
+		len = spinel_datatype_pack(
+			value,
+			sizeof(value),
+			SPINEL_DATATYPE_STRUCT_S(
+				SPINEL_DATATYPE_IPv6ADDR_S
+				SPINEL_DATATYPE_UINT8_S
+				SPINEL_DATATYPE_UINT32_S
+				SPINEL_DATATYPE_UINT32_S
+			),
+			&sHostAddress,
+			64,
+			0xFFFFFFFF,
+			0xFFFFFFFF
+		);
+		break;
+
+	case SPINEL_PROP_NUM_CONNECTED_DEVICES:
+		len = spinel_datatype_pack(value, sizeof(value), SPINEL_DATATYPE_UINT16_S, (uint16_t)sJoinedCount);
+		break;
+
+	case SPINEL_PROP_CONNECTED_DEVICES:
+		{
+			uint8_t block[1 + SIM_MAX_BLOCK_SIZE * sizeof(struct in6_addr)];
+			size_t block_len = build_connected_devices_block(block);
+			len = spinel_datatype_pack(value, sizeof(value), SPINEL_DATATYPE_DATA_S, block, block_len);
+		}
+		break;
+
+	case SPINEL_PROP_DODAG_ROUTE:
+		{
+			uint8_t route[1 + (UINT8_MAX + 1) * sizeof(struct in6_addr)];
+			size_t route_len = build_dodag_route(route);
+
+			if (route_len == 0) {
+				send_last_status(header, SPINEL_STATUS_ITEM_NOT_FOUND);
+				return;
+			}
+
+			len = spinel_datatype_pack(value, sizeof(value), SPINEL_DATATYPE_DATA_S, route, route_len);
+		}
+		break;
+
+	default:
+		prop = prop_find(key);
+		if (prop != NULL) {
+			memcpy(value, prop->value, prop->len);
+			len = prop->len;
+		}
+		break;
+	}
+
+	if ((len < 0) || ((size_t)len > sizeof(value))) {
+		sStats.prop_not_found++;
+		send_last_status(header, SPINEL_STATUS_PROP_NOT_FOUND);
+		return;
+	}
+
+	send_prop_value(header, SPINEL_CMD_PROP_VALUE_IS, key, value, (size_t)len);
+}
+
+static void
+handle_prop_value_set(uint8_t header, spinel_prop_key_t key, const uint8_t* value_ptr, spinel_size_t value_len)
+{
+	sStats.prop_sets++;
+
+	switch (key) {
+	case SPINEL_PROP_STREAM_NET:
+	case SPINEL_PROP_STREAM_NET_INSECURE:
+		{
+			const uint8_t* packet = NULL;
+			spinel_size_t packet_len = 0;
+
+			if (spinel_datatype_unpack(value_ptr, value_len, SPINEL_DATATYPE_DATA_WLEN_S, &packet, &packet_len) > 0) {
+				handle_ipv6_from_host(packet, packet_len);
+			}
+
+			// Data frames are sent without a transaction ID and get no reply.
+			if (SPINEL_HEADER_GET_TID(header) != 0) {
+				send_last_status(header, SPINEL_STATUS_OK);
+			}
+		}
+		return;
+
+	case SPINEL_PROP_DODAG_ROUTE_DEST:
+		// The destination is the last 16 bytes, whether or not they
+		// come with a length.
+		if (value_len >= sizeof(struct in6_addr)) {
+			memcpy(sRouteDest.s6_addr, value_ptr + value_len - sizeof(struct in6_addr), sizeof(struct in6_addr));
+		}
+		break;
+
+	default:
+		break;
+	}
+
+	if (!prop_store(key, value_ptr, value_len)) {
+		send_last_status(header, SPINEL_STATUS_NOMEM);
+		return;
+	}
+
+	send_prop_value(header, SPINEL_CMD_PROP_VALUE_IS, key, value_ptr, value_len);
+}
+
+static void
+handle_reset(void)
+{
+	sStats.resets++;
+
+	prop_store_defaults();
+	network_init();
+
+	sTxHead = sTxTail = 0;
+
+	send_last_status(SPINEL_HEADER_FLAG | SPINEL_HEADER_IID_0, SPINEL_STATUS_RESET_SOFTWARE);
+}
+
+static void
+handle_frame(const uint8_t* frame_ptr, size_t frame_len)
+{
+	uint8_t header = 0;
+	unsigned int command = 0;
+	spinel_prop_key_t key = 0;
+	const uint8_t* value_ptr = NULL;
+	spinel_size_t value_len = 0;
+	spinel_ssize_t len;
+
+	len = spinel_datatype_unpack(frame_ptr, (spinel_size_t)frame_len, SPINEL_DATATYPE_COMMAND_S, &header, &command);
+
+	if ((len <= 0) || ((header & SPINEL_HEADER_FLAG) != SPINEL_HEADER_FLAG)) {
+		sStats.rx_bad_frames++;
+		return;
+	}
+
+	switch (command) {
+	case SPINEL_CMD_NOOP:
+		send_last_status(header, SPINEL_STATUS_OK);
+		break;
+
+	case SPINEL_CMD_RESET:
+		handle_reset();
+		break;
+
+	case SPINEL_CMD_PROP_VALUE_GET:
+	case SPINEL_CMD_PROP_VALUE_SET:
+	case SPINEL_CMD_PROP_VALUE_INSERT:
+	case SPINEL_CMD_PROP_VALUE_REMOVE:
+		len = spinel_datatype_unpack(
+			frame_ptr,
+			(spinel_size_t)frame_len,
+			SPINEL_DATATYPE_COMMAND_PROP_S SPINEL_DATATYPE_DATA_S,
+			NULL,
+			NULL,
+			&key,
+			&value_ptr,
+			&value_len
+		);
+
+		if (len <= 0) {
+			sStats.rx_bad_frames++;
+			send_last_status(header, SPINEL_STATUS_PARSE_ERROR);
+
+		} else if (command == SPINEL_CMD_PROP_VALUE_GET) {
+			handle_prop_value_get(header, key);
+
+		} else if (command == SPINEL_CMD_PROP_VALUE_SET) {
+			handle_prop_value_set(header, key, value_ptr, value_len);
+
+		} else {
+			// Lists aren't modelled; just acknowledge the change.
+			send_prop_value(
+				header,
+				(command == SPINEL_CMD_PROP_VALUE_INSERT) ? SPINEL_CMD_PROP_VALUE_INSERTED : SPINEL_CMD_PROP_VALUE_REMOVED,
+				key,
+				value_ptr,
+				value_len
+			);
+		}
+		break;
+
+	default:
+		send_last_status(header, SPINEL_STATUS_INVALID_COMMAND);
+		break;
+	}
+}
+
+/* ------------------------------------------------------------------------- */
+/* MARK: Inbound Frames */
+
+static void
+hdlc_decode(const uint8_t* data, size_t len)
+{
+	size_t i;
+
+	for (i = 0; i < len; i++) {
+		uint8_t byte = data[i];
+
+		if (byte == HDLC_BYTE_FLAG) {
+			if (sRxOverflow) {
+				sStats.rx_bad_frames++;
+
+			} else if (sRxFrameLen > 2) {
+				if (sRxCrc == HDLC_GOOD_FCS) {
+					sStats.rx_frames++;
+					handle_frame(sRxFrame, sRxFrameLen - 2);
+				} else {
+					sStats.rx_bad_crc++;
+				}
+			}
+
+			sRxFrameLen = 0;
+			sRxEscaped = false;
+			sRxOverflow = false;
+			sRxCrc = HDLC_CRC_RESET_VALUE;
+			continue;
+		}
+
+		if (byte == HDLC_BYTE_ESC) {
+			sRxEscaped = true;
+			continue;
+		}
+
+		if (sRxEscaped) {
+			byte ^= HDLC_ESCAPE_XFORM;
+			sRxEscaped = false;
+		}
+
+		if (sRxFrameLen < sizeof(sRxFrame)) {
+			sRxFrame[sRxFrameLen++] = byte;
+			sRxCrc = hdlc_crc16(sRxCrc, byte);
+		} else {
+			sRxOverflow = true;
+		}
+	}
+}
+
+/* ------------------------------------------------------------------------- */
+/* MARK: Statistics */
+
+static int
+compare_uint32(const void* a, const void* b)
+{
+	uint32_t x = *(const uint32_t*)a;
+	uint32_t y = *(const uint32_t*)b;
+
+	return (x > y) - (x < y);
+}
+
+static double
+rtt_percentile_ms(int percent)
+{
+	uint32_t count = sStats.rtt_count;
+
+	if (count > SIM_MAX_RTT_SAMPLES) {
+		count = SIM_MAX_RTT_SAMPLES;
+	}
+
+	if (count == 0) {
+		return 0;
+	}
+
+	return (double)sStats.rtt_samples[(count - 1) * (uint32_t)percent / 100] / 1000.0;
+}
+
+// One `key=value` per line, so that scripts can pick out what they need.
+static void
+dump_stats(FILE* out)
+{
+	double elapsed = (double)(time_us() - sStartTime) / (double)USEC_PER_SEC;
+	uint32_t samples = (sStats.rtt_count < SIM_MAX_RTT_SAMPLES) ? sStats.rtt_count : SIM_MAX_RTT_SAMPLES;
+	struct rusage usage;
+
+	getrusage(RUSAGE_SELF, &usage);
+
+	qsort(sStats.rtt_samples, samples, sizeof(sStats.rtt_samples[0]), compare_uint32);
+
+	fprintf(out, "elapsed_s=%.3f\n", elapsed);
+	fprintf(out, "nodes=%d\n", sNodeCount);
+	fprintf(out, "nodes_joined=%d\n", sJoinedCount);
+	fprintf(out, "baud=%d\n", sBaudRate);
+	fprintf(out, "rx_frames=%llu\n", (unsigned long long)sStats.rx_frames);
+	fprintf(out, "rx_bytes=%llu\n", (unsigned long long)sStats.rx_bytes);
+	fprintf(out, "rx_bad_crc=%llu\n", (unsigned long long)sStats.rx_bad_crc);
+	fprintf(out, "rx_bad_frames=%llu\n", (unsigned long long)sStats.rx_bad_frames);
+	fprintf(out, "tx_frames=%llu\n", (unsigned long long)sStats.tx_frames);
+	fprintf(out, "tx_bytes=%llu\n", (unsigned long long)sStats.tx_bytes);
+	fprintf(out, "tx_overflow=%llu\n", (unsigned long long)sStats.tx_overflow);
+	fprintf(out, "host_overruns=%llu\n", (unsigned long long)sStats.host_overruns);
+	fprintf(out, "host_overrun_bytes=%llu\n", (unsigned long long)sStats.host_overrun_bytes);
+	fprintf(out, "resets=%llu\n", (unsigned long long)sStats.resets);
+	fprintf(out, "prop_gets=%llu\n", (unsigned long long)sStats.prop_gets);
+	fprintf(out, "prop_sets=%llu\n", (unsigned long long)sStats.prop_sets);
+	fprintf(out, "prop_not_found=%llu\n", (unsigned long long)sStats.prop_not_found);
+	fprintf(out, "connected_devices_blocks=%llu\n", (unsigned long long)sStats.blocks_served);
+	fprintf(out, "connected_devices_passes=%llu\n", (unsigned long long)sStats.block_passes);
+	fprintf(out, "dodag_routes=%llu\n", (unsigned long long)sStats.routes_served);
+	fprintf(out, "node_leaves=%llu\n", (unsigned long long)sStats.node_leaves);
+	fprintf(out, "node_joins=%llu\n", (unsigned long long)sStats.node_joins);
+	fprintf(out, "net_to_host=%llu\n", (unsigned long long)sStats.net_to_host);
+	fprintf(out, "net_to_host_bytes=%llu\n", (unsigned long long)sStats.net_to_host_bytes);
+	fprintf(out, "net_to_host_dropped=%llu\n", (unsigned long long)sStats.net_to_host_dropped);
+	fprintf(out, "net_from_host=%llu\n", (unsigned long long)sStats.net_from_host);
+	fprintf(out, "net_from_host_bytes=%llu\n", (unsigned long long)sStats.net_from_host_bytes);
+	fprintf(out, "echo_replies=%llu\n", (unsigned long long)sStats.echo_replies);
+	fprintf(out, "rtt_min_ms=%.3f\n", (double)sStats.rtt_min / 1000.0);
+	fprintf(out, "rtt_avg_ms=%.3f\n", sStats.rtt_count ? (double)sStats.rtt_sum / sStats.rtt_count / 1000.0 : 0.0);
+	fprintf(out, "rtt_p50_ms=%.3f\n", rtt_percentile_ms(50));
+	fprintf(out, "rtt_p99_ms=%.3f\n", rtt_percentile_ms(99));
+	fprintf(out, "rtt_max_ms=%.3f\n", (double)sStats.rtt_max / 1000.0);
+	fprintf(out, "cpu_user_s=%ld.%06ld\n", (long)usage.ru_utime.tv_sec, (long)usage.ru_utime.tv_usec);
+	fprintf(out, "cpu_sys_s=%ld.%06ld\n", (long)usage.ru_stime.tv_sec, (long)usage.ru_stime.tv_usec);
+}
+
+/* ------------------------------------------------------------------------- */
+/* MARK: Main Loop */
+
+static void
+print_help(void)
+{
+	static const char* help =
+	"Syntax: spinel-ncp-sim [options]\n"
+	"\n"
+	"Simulates a Wi-SUN border router NCP on stdin/stdout. Run it from\n"
+	"wfantund with `-s 'system:spinel-ncp-sim [options]'`.\n"
+	"\n"
+	"Options:\n"
+	"    -n, --nodes=<count>       Nodes in the network (default 50)\n"
+	"    -d, --depth=<hops>        Maximum DODAG depth (default 4)\n"
+	"    -k, --block-size=<count>  Addresses per connected devices block (default 20)\n"
+	"    -c, --churn=<rate>        Nodes leaving per second (default 0)\n"
+	"    -j, --rejoin=<seconds>    Time for a node to join again (default 10)\n"
+	"    -r, --rate=<rate>         Echo requests sent to the host per second (default 0)\n"
+	"    -s, --size=<bytes>        IPv6 packet size of the echo requests (default 128)\n"
+	"    -b, --baud=<rate>         UART baud rate, 0 for unlimited (default 115200)\n"
+	"    -L, --lossy               Drop bytes the host is not ready for, instead\n"
+	"                              of waiting (needs a baud rate)\n"
+	"    -p, --prefix=<prefix>     /64 prefix of the network (default 2020:abcd::)\n"
+	"    -S, --seed=<seed>         Random seed (default 1)\n"
+	"    -o, --stats=<file>        Write statistics here on exit (default stderr)\n"
+	"    -h, --help                Print this help\n"
+	"\n"
+	"SIGUSR1 writes out the statistics without exiting, SIGUSR2 clears them.\n";
+
+	fputs(help, stdout);
+}
+
+static bool
+parse_options(int argc, char* argv[])
+{
+	static const struct option options[] = {
+		{ "nodes",      required_argument, NULL, 'n' },
+		{ "depth",      required_argument, NULL, 'd' },
+		{ "block-size", required_argument, NULL, 'k' },
+		{ "churn",      required_argument, NULL, 'c' },
+		{ "rejoin",     required_argument, NULL, 'j' },
+		{ "rate",       required_argument, NULL, 'r' },
+		{ "size",       required_argument, NULL, 's' },
+		{ "baud",       required_argument, NULL, 'b' },
+		{ "lossy",      no_argument,       NULL, 'L' },
+		{ "prefix",     required_argument, NULL, 'p' },
+		{ "seed",       required_argument, NULL, 'S' },
+		{ "stats",      required_argument, NULL, 'o' },
+		{ "help",       no_argument,       NULL, 'h' },
+		{ NULL,         0,                 NULL, 0   },
+	};
+	int c;
+
+	inet_pton(AF_INET6, "2020:abcd::", &sPrefix);
+
+	while ((c = getopt_long(argc, argv, "n:d:k:c:j:r:s:b:Lp:S:o:h", options, NULL)) != -1) {
+		switch (c) {
+		case 'n':
+			sNodeCount = atoi(optarg);
+			break;
+
+		case 'd':
+			sMaxDepth = atoi(optarg);
+			break;
+
+		case 'k':
+			sBlockSize = atoi(optarg);
+			break;
+
+		case 'c':
+			sChurnRate = strtod(optarg, NULL);
+			break;
+
+		case 'j':
+			sRejoinDelay = strtod(optarg, NULL);
+			break;
+
+		case 'r':
+			sPacketRate = strtod(optarg, NULL);
+			break;
+
+		case 's':
+			sPacketLen = atoi(optarg);
+			break;
+
+		case 'b':
+			sBaudRate = atoi(optarg);
+			break;
+
+		case 'L':
+			sLossy = true;
+			break;
+
+		case 'p':
+			if (inet_pton(AF_INET6, optarg, &sPrefix) != 1) {
+				fprintf(stderr, "spinel-ncp-sim: Bad prefix \"%s\"\n", optarg);
+				return false;
+			}
+			break;
+
+		case 'S':
+			sRandomState = (uint32_t)strtoul(optarg, NULL, 0);
+			break;
+
+		case 'o':
+			sStatsPath = optarg;
+			break;
+
+		case 'h':
+		default:
+			print_help();
+			exit((c == 'h') ? EXIT_SUCCESS : EXIT_FAILURE);
+		}
+	}
+
+	if ((sBlockSize < 1) || (sBlockSize > SIM_MAX_BLOCK_SIZE)) {
+		fprintf(stderr, "spinel-ncp-sim: Block size must be between 1 and %d\n", SIM_MAX_BLOCK_SIZE);
+		return false;
+	}
+
+	if ((sNodeCount < 0) || (sNodeCount > SIM_MAX_NODES) || (sNodeCount > SIM_MAX_BLOCKS * sBlockSize)) {
+		fprintf(stderr, "spinel-ncp-sim: Node count must be between 0 and %d with blocks of %d\n",
+		        (SIM_MAX_NODES < SIM_MAX_BLOCKS * sBlockSize) ? SIM_MAX_NODES : SIM_MAX_BLOCKS * sBlockSize, sBlockSize);
+		return false;
+	}
+
+	if ((sMaxDepth < 1) || (sMaxDepth > UINT8_MAX)) {
+		fprintf(stderr, "spinel-ncp-sim: Depth must be between 1 and %d\n", UINT8_MAX);
+		return false;
+	}
+
+	if ((sPacketLen < SIM_ECHO_MIN_PACKET_LEN) || (sPacketLen > SIM_ECHO_MAX_PACKET_LEN)) {
+		fprintf(stderr, "spinel-ncp-sim: Packet size must be between %d and %d\n", SIM_ECHO_MIN_PACKET_LEN, SIM_ECHO_MAX_PACKET_LEN);
+		return false;
+	}
+
+	if (sLossy && (sBaudRate == 0)) {
+		fprintf(stderr, "spinel-ncp-sim: Lossy mode needs a baud rate\n");
+		return false;
+	}
+
+	if ((sBaudRate < 0) || (sChurnRate < 0) || (sPacketRate < 0) || (sRejoinDelay < 0) || (sRandomState == 0)) {
+		fprintf(stderr, "spinel-ncp-sim: Rates, delays and the seed must be positive\n");
+		return false;
+	}
+
+	sHostAddress = sPrefix;
+	memset(sHostAddress.s6_addr + 8, 0, 8);
+	sHostAddress.s6_addr[15] = 1;
+	memcpy(sPrefix.s6_addr + 8, sHostAddress.s6_addr + 8, 8);
+
+	return true;
+}
+
+static void
+write_stats(void)
+{
+	FILE* out = stderr;
+
+	if (sStatsPath != NULL) {
+		out = fopen(sStatsPath, "w");
+		if (out == NULL) {
+			fprintf(stderr, "spinel-ncp-sim: Unable to open \"%s\": %s\n", sStatsPath, strerror(errno));
+			out = stderr;
+		}
+	}
+
+	dump_stats(out);
+
+	if (out != stderr) {
+		fclose(out);
+	} else {
+		fflush(out);
+	}
+}
+
+static void
+signal_dump_stats(int sig)
+{
+	(void)sig;
+	sDumpStats = 1;
+}
+
+static void
+signal_clear_stats(int sig)
+{
+	(void)sig;
+	sClearStats = 1;
+}
+
+int
+main(int argc, char* argv[])
+{
+	uint64_t now;
+
+	if (!parse_options(argc, argv)) {
+		return EXIT_FAILURE;
+	}
+
+	signal(SIGINT, &signal_quit);
+	signal(SIGTERM, &signal_quit);
+	signal(SIGHUP, &signal_quit);
+	signal(SIGUSR1, &signal_dump_stats);
+	signal(SIGUSR2, &signal_clear_stats);
+	signal(SIGPIPE, SIG_IGN);
+
+	if (isatty(STDIN_FILENO)) {
+		struct termios tios;
+
+		if (tcgetattr(STDIN_FILENO, &tios) == 0) {
+			cfmakeraw(&tios);
+			tcsetattr(STDIN_FILENO, TCSANOW, &tios);
+		}
+	}
+
+	fcntl(STDIN_FILENO, F_SETFL, fcntl(STDIN_FILENO, F_GETFL) | O_NONBLOCK);
+	fcntl(STDOUT_FILENO, F_SETFL, fcntl(STDOUT_FILENO, F_GETFL) | O_NONBLOCK);
+
+	now = sStartTime = time_us();
+	uart_budget_init(&sRxBudget, sBaudRate, now);
+	uart_budget_init(&sTxBudget, sBaudRate, now);
+
+	prop_store_defaults();
+	network_init();
+
+	sNextPacketAt = (sPacketRate > 0) ? now + next_interval_us(sPacketRate) : UINT64_MAX;
+	sNextChurnAt = (sChurnRate > 0) ? now + next_interval_us(sChurnRate) : UINT64_MAX;
+
+	// A real NCP announces itself when it comes out of reset.
+	send_last_status(SPINEL_HEADER_FLAG | SPINEL_HEADER_IID_0, SPINEL_STATUS_RESET_POWER_ON);
+
+	while (!sQuit) {
+		struct pollfd fds[2];
+		uint64_t wait_us = USEC_PER_SEC;
+		uint64_t next_event;
+		struct timespec timeout;
+		int nfds = 0;
+		int rx_index = -1;
+		int tx_index = -1;
+
+		now = time_us();
+
+		if (sDumpStats) {
+			sDumpStats = 0;
+			write_stats();
+		}
+
+		if (sClearStats) {
+			sClearStats = 0;
+			memset(&sStats, 0, sizeof(sStats));
+			sStartTime = now;
+		}
+
+		uart_budget_refill(&sRxBudget, now);
+		uart_budget_refill(&sTxBudget, now);
+
+		process_rejoins(now);
+
+		while (now >= sNextChurnAt) {
+			node_leave(now);
+			sNextChurnAt += next_interval_us(sChurnRate);
+		}
+
+		while (now >= sNextPacketAt) {
+			send_echo_request(now);
+			sNextPacketAt += next_interval_us(sPacketRate);
+
+			// Don't try to catch up after falling far behind.
+			if (now > sNextPacketAt + USEC_PER_SEC) {
+				sNextPacketAt = now;
+			}
+		}
+
+		next_event = (sNextPacketAt < sNextChurnAt) ? sNextPacketAt : sNextChurnAt;
+		if (sRejoinCount > 0) {
+			uint64_t rejoin_at = sNodes[sRejoinQueue[sRejoinHead]].rejoin_at;
+			if (rejoin_at < next_event) {
+				next_event = rejoin_at;
+			}
+		}
+		if (next_event - now < wait_us) {
+			wait_us = next_event - now;
+		}
+
+		if (uart_budget_available(&sRxBudget, 1) > 0) {
+			fds[nfds].fd = STDIN_FILENO;
+			fds[nfds].events = POLLIN;
+			rx_index = nfds++;
+		} else if (uart_budget_wait_us(&sRxBudget, 16) < wait_us) {
+			wait_us = uart_budget_wait_us(&sRxBudget, 16);
+		}
+
+		if (sLossy) {
+			tx_lossy();
+
+			if ((tx_queue_backlog() > 0) && (uart_budget_wait_us(&sTxBudget, 256) < wait_us)) {
+				wait_us = uart_budget_wait_us(&sTxBudget, 256);
+			}
+
+		} else if (tx_queue_backlog() > 0) {
+			uint64_t tx_wait = uart_budget_wait_us(&sTxBudget, tx_queue_backlog());
+
+			if (tx_wait == 0) {
+				fds[nfds].fd = STDOUT_FILENO;
+				fds[nfds].events = POLLOUT;
+				tx_index = nfds++;
+			} else if (tx_wait < wait_us) {
+				wait_us = tx_wait;
+			}
+		}
+
+		timeout.tv_sec = (time_t)(wait_us / USEC_PER_SEC);
+		timeout.tv_nsec = (long)(wait_us % USEC_PER_SEC) * 1000;
+
+		if (ppoll(fds, (nfds_t)nfds, &timeout, NULL) < 0) {
+			if (errno == EINTR) {
+				continue;
+			}
+			perror("spinel-ncp-sim: ppoll");
+			break;
+		}
+
+		if ((rx_index >= 0) && (fds[rx_index].revents != 0)) {
+			uint8_t buffer[4096];
+			size_t want = uart_budget_available(&sRxBudget, sizeof(buffer));
+			ssize_t len = read(STDIN_FILENO, buffer, want);
+
+			if (len > 0) {
+				uart_budget_spend(&sRxBudget, (size_t)len);
+				sStats.rx_bytes += (uint64_t)len;
+				hdlc_decode(buffer, (size_t)len);
+
+			} else if ((len == 0) || ((errno != EAGAIN) && (errno != EINTR))) {
+				// The host went away.
+				break;
+			}
+		}
+
+		if ((tx_index >= 0) && (fds[tx_index].revents != 0)) {
+			size_t want = uart_budget_available(&sTxBudget, tx_queue_backlog());
+			ssize_t len = write(STDOUT_FILENO, sTxQueue + sTxHead, want);
+
+			if (len > 0) {
+				uart_budget_spend(&sTxBudget, (size_t)len);
+				sStats.tx_bytes += (uint64_t)len;
+				sTxHead += (size_t)len;
+
+				if (sTxHead == sTxTail) {
+					sTxHead = sTxTail = 0;
+				}
+
+			} else if ((len < 0) && (errno != EAGAIN) && (errno != EINTR)) {
+				break;
+			}
+		}
+	}
+
+	write_stats();
+
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,285 @@
+/*
+ *
+ * Copyright (c) 2026 Texas Instruments
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *    Description:
+ *      Times `spinel::Frame` against `spinel_datatype_pack()` and
+ *      `spinel_datatype_unpack()` on the frame layouts of the per-frame
+ *      paths, and `Frame::pack()` against packing with varargs into a
+ *      `Data` the way `SpinelPackData()` does.
+ *
+ *      Usage: spinel_frame_bench [iterations]
+ *
+ */
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "SpinelFrame.h"
+
+using namespace nl::wpantund;
+
+#define FRAME_COUNT     64
+
+typedef spinel::Frame<uint8_t, spinel::PackedUint> HeaderFrame;
+typedef spinel::Frame<uint8_t, spinel::PackedUint, spinel::PackedUint, spinel::Data> PropFrame;
+typedef spinel::Frame<spinel::DataWlen, spinel::Data> StreamNetFrame;
+typedef spinel::Frame<uint8_t, spinel::PackedUint, spinel::PackedUint, uint16_t> SetFrame;
+
+struct Frames {
+	uint8_t buffer[FRAME_COUNT][256];
+	spinel_size_t len[FRAME_COUNT];
+};
+
+// Frames and values vary from one iteration to the next, so the
+// compiler can't fold any of the work away.
+static Frames sPropFrames;
+static Frames sStreamNetFrames;
+static unsigned int sValues[FRAME_COUNT];
+
+static uint32_t sRandomState = 0x2545F491;
+
+static uint32_t
+next_random(void)
+{
+	sRandomState ^= sRandomState << 13;
+	sRandomState ^= sRandomState >> 17;
+	sRandomState ^= sRandomState << 5;
+	return sRandomState;
+}
+
+static double
+now_ns(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static void
+build_frames(void)
+{
+	static uint8_t payload[200];
+
+	for (size_t i = 0; i < sizeof(payload); i++) {
+		payload[i] = (uint8_t)next_random();
+	}
+
+	for (int i = 0; i < FRAME_COUNT; i++) {
+		sValues[i] = next_random() % 0x4000;
+
+		sPropFrames.len[i] = spinel_datatype_pack(
+			sPropFrames.buffer[i], sizeof(sPropFrames.buffer[i]), "CiiD",
+			0x80 | (i & 0xF), SPINEL_CMD_PROP_VALUE_IS, sValues[i], payload, 16 + i
+		);
+
+		sStreamNetFrames.len[i] = spinel_datatype_pack(
+			sStreamNetFrames.buffer[i], sizeof(sStreamNetFrames.buffer[i]), "dD",
+			payload, 40 + i, payload + 40, 8
+		);
+	}
+}
+
+static uint32_t
+unpack_header_varargs(int i)
+{
+	uint8_t header = 0;
+	unsigned int command = 0;
+
+	spinel_datatype_unpack(sPropFrames.buffer[i], sPropFrames.len[i], "Ci", &header, &command);
+
+	return header + command;
+}
+
+static uint32_t
+unpack_header_typed(int i)
+{
+	uint8_t header = 0;
+	unsigned int command = 0;
+
+	HeaderFrame::decode(sPropFrames.buffer[i], sPropFrames.len[i], &header, &command);
+
+	return header + command;
+}
+
+static uint32_t
+unpack_prop_varargs(int i)
+{
+	uint8_t header = 0;
+	unsigned int command = 0;
+	unsigned int key = 0;
+	const uint8_t* value = NULL;
+	unsigned int value_len = 0;
+
+	spinel_datatype_unpack(sPropFrames.buffer[i], sPropFrames.len[i], "CiiD",
+		&header, &command, &key, &value, &value_len);
+
+	return header + command + key + value_len;
+}
+
+static uint32_t
+unpack_prop_typed(int i)
+{
+	uint8_t header = 0;
+	unsigned int command = 0;
+	unsigned int key = 0;
+	spinel::Bytes value;
+
+	PropFrame::decode(sPropFrames.buffer[i], sPropFrames.len[i], &header, &command, &key, &value);
+
+	return header + command + key + value.len;
+}
+
+static uint32_t
+unpack_stream_net_varargs(int i)
+{
+	const uint8_t* packet = NULL;
+	unsigned int packet_len = 0;
+	const uint8_t* meta = NULL;
+	unsigned int meta_len = 0;
+
+	spinel_datatype_unpack(sStreamNetFrames.buffer[i], sStreamNetFrames.len[i], "dD",
+		&packet, &packet_len, &meta, &meta_len);
+
+	return packet_len + meta_len;
+}
+
+static uint32_t
+unpack_stream_net_typed(int i)
+{
+	spinel::Bytes packet;
+	spinel::Bytes meta;
+
+	StreamNetFrame::decode(sStreamNetFrames.buffer[i], sStreamNetFrames.len[i], &packet, &meta);
+
+	return packet.len + meta.len;
+}
+
+static uint32_t
+pack_set_varargs(int i)
+{
+	uint8_t buffer[SetFrame::kMaxSize];
+
+	return spinel_datatype_pack(buffer, sizeof(buffer), "CiiS",
+		SPINEL_HEADER_FLAG, SPINEL_CMD_PROP_VALUE_SET, sValues[i], (uint16_t)i) + buffer[2];
+}
+
+static uint32_t
+pack_set_typed(int i)
+{
+	uint8_t buffer[SetFrame::kMaxSize];
+
+	return SetFrame::encode(buffer, sizeof(buffer),
+		SPINEL_HEADER_FLAG, SPINEL_CMD_PROP_VALUE_SET, sValues[i], (uint16_t)i) + buffer[2];
+}
+
+// Same as SpinelPackData(), without the fallback for frames too big
+// to send.
+static nl::Data
+pack_data(const char* pack_format, ...)
+{
+	uint8_t buffer[SPINEL_FRAME_BUFFER_SIZE];
+	spinel_ssize_t packed_size;
+	nl::Data ret;
+	va_list args;
+
+	va_start(args, pack_format);
+	packed_size = spinel_datatype_vpack(buffer, sizeof(buffer), pack_format, args);
+	va_end(args);
+
+	if ((packed_size >= 0) && (packed_size <= static_cast<spinel_ssize_t>(sizeof(buffer)))) {
+		ret = nl::Data(buffer, packed_size);
+	}
+
+	return ret;
+}
+
+static uint32_t
+pack_data_varargs(int i)
+{
+	nl::Data data = pack_data("Cii", SPINEL_HEADER_FLAG, SPINEL_CMD_PROP_VALUE_GET, sValues[i]);
+
+	return static_cast<uint32_t>(data.size()) + data[2];
+}
+
+static uint32_t
+pack_data_typed(int i)
+{
+	nl::Data data = spinel::Frame<uint8_t, spinel::PackedUint, spinel::PackedUint>::pack(
+		SPINEL_HEADER_FLAG, SPINEL_CMD_PROP_VALUE_GET, sValues[i]);
+
+	return static_cast<uint32_t>(data.size()) + data[2];
+}
+
+static double
+time_ns(uint32_t (*run)(int), int iterations, uint32_t& checksum)
+{
+	double begin = now_ns();
+
+	checksum = 0;
+
+	for (int i = 0; i < iterations; i++) {
+		checksum += run(i % FRAME_COUNT);
+	}
+
+	return (now_ns() - begin) / iterations;
+}
+
+static int
+compare(const char* name, uint32_t (*varargs)(int), uint32_t (*typed)(int), int iterations)
+{
+	uint32_t varargs_checksum;
+	uint32_t typed_checksum;
+	double varargs_ns = time_ns(varargs, iterations, varargs_checksum);
+	double typed_ns = time_ns(typed, iterations, typed_checksum);
+
+	printf("%-12s %12.1f %12.1f %8.1fx\n", name, varargs_ns, typed_ns, varargs_ns / typed_ns);
+
+	if (varargs_checksum != typed_checksum) {
+		fprintf(stderr, "%s: the two codecs disagree\n", name);
+		return -1;
+	}
+
+	return 0;
+}
+
+int
+main(int argc, char* argv[])
+{
+	int iterations = (argc > 1) ? atoi(argv[1]) : 20000000;
+	int ret = 0;
+
+	if (iterations <= 0) {
+		fprintf(stderr, "usage: %s [iterations]\n", argv[0]);
+		return EXIT_FAILURE;
+	}
+
+	build_frames();
+
+	printf("%d iterations\n\n", iterations);
+	printf("%-12s %12s %12s %9s\n", "frame", "varargs ns", "typed ns", "speedup");
+
+	ret |= compare("Ci unpack", &unpack_header_varargs, &unpack_header_typed, iterations);
+	ret |= compare("CiiD unpack", &unpack_prop_varargs, &unpack_prop_typed, iterations);
+	ret |= compare("dD unpack", &unpack_stream_net_varargs, &unpack_stream_net_typed, iterations);
+	ret |= compare("CiiS pack", &pack_set_varargs, &pack_set_typed, iterations);
+	ret |= compare("Cii to Data", &pack_data_varargs, &pack_data_typed, iterations);
+
+	return (ret == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
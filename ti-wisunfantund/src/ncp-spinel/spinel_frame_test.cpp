@@ -0,0 +1,317 @@
+/*
+ *
+ * Copyright (c) 2026 Texas Instruments
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *    Description:
+ *      Checks `spinel::Frame` against `spinel_datatype_pack()` and
+ *      `spinel_datatype_unpack()`, on random values and on truncated
+ *      and corrupted frames.
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "SpinelFrame.h"
+
+using namespace nl::wpantund;
+
+#define ITERATIONS      20000
+
+// Every field type, in the order of `kFormat`.
+typedef spinel::Frame<
+	uint8_t,
+	spinel::PackedUint,
+	spinel::PackedUint,
+	int8_t,
+	bool,
+	uint16_t,
+	int16_t,
+	uint32_t,
+	int32_t,
+	uint64_t,
+	int64_t,
+	spinel_ipv6addr_t,
+	spinel_eui64_t,
+	spinel_eui48_t,
+	spinel::DataWlen,
+	spinel::Data
+> AllFields;
+
+static const char kFormat[] = "CiicbSsLlXx6EedD";
+
+struct Values {
+	uint8_t u8;
+	unsigned int packed1;
+	unsigned int packed2;
+	int8_t i8;
+	bool b;
+	uint16_t u16;
+	int16_t i16;
+	uint32_t u32;
+	int32_t i32;
+	uint64_t u64;
+	int64_t i64;
+	spinel_ipv6addr_t ipv6;
+	spinel_eui64_t eui64;
+	spinel_eui48_t eui48;
+	const uint8_t* data1_ptr;
+	unsigned int data1_len;
+	const uint8_t* data2_ptr;
+	unsigned int data2_len;
+};
+
+static uint32_t sRandomState = 0x2545F491;
+
+static uint32_t
+next_random(void)
+{
+	sRandomState ^= sRandomState << 13;
+	sRandomState ^= sRandomState >> 17;
+	sRandomState ^= sRandomState << 5;
+	return sRandomState;
+}
+
+static unsigned int
+random_packed_uint(void)
+{
+	// Weighted towards the one, two and three byte encodings and the
+	// edges between them.
+	switch (next_random() % 5) {
+	case 0: return next_random() % 0x80;
+	case 1: return next_random() % 0x4000;
+	case 2: return next_random() % SPINEL_MAX_UINT_PACKED;
+	case 3: return 0x7F + next_random() % 2;
+	default: return 0x3FFF + next_random() % 2;
+	}
+}
+
+static void
+random_values(Values& values, const uint8_t* data, size_t data_len)
+{
+	uint8_t* bytes;
+
+	values.u8 = (uint8_t)next_random();
+	values.packed1 = random_packed_uint();
+	values.packed2 = random_packed_uint();
+	values.i8 = (int8_t)next_random();
+	values.b = (next_random() & 1) != 0;
+	values.u16 = (uint16_t)next_random();
+	values.i16 = (int16_t)next_random();
+	values.u32 = next_random();
+	values.i32 = (int32_t)next_random();
+	values.u64 = ((uint64_t)next_random() << 32) | next_random();
+	values.i64 = (int64_t)(((uint64_t)next_random() << 32) | next_random());
+
+	bytes = (uint8_t*)&values.ipv6;
+	for (size_t i = 0; i < sizeof(values.ipv6); i++) {
+		bytes[i] = (uint8_t)next_random();
+	}
+	for (size_t i = 0; i < sizeof(values.eui64); i++) {
+		values.eui64.bytes[i] = (uint8_t)next_random();
+	}
+	for (size_t i = 0; i < sizeof(values.eui48); i++) {
+		values.eui48.bytes[i] = (uint8_t)next_random();
+	}
+
+	values.data1_ptr = data + next_random() % (data_len / 2);
+	values.data1_len = next_random() % (data_len / 2);
+	values.data2_ptr = data + next_random() % (data_len / 2);
+	values.data2_len = next_random() % (data_len / 2);
+}
+
+static spinel_ssize_t
+reference_pack(uint8_t* buffer, spinel_size_t buffer_len, const Values& v)
+{
+	return spinel_datatype_pack(buffer, buffer_len, kFormat,
+		v.u8, v.packed1, v.packed2, v.i8, v.b, v.u16, v.i16, v.u32, v.i32, v.u64, v.i64,
+		&v.ipv6, &v.eui64, &v.eui48, v.data1_ptr, v.data1_len, v.data2_ptr, v.data2_len);
+}
+
+static spinel_ssize_t
+typed_pack(uint8_t* buffer, spinel_size_t buffer_len, const Values& v)
+{
+	return AllFields::encode(buffer, buffer_len,
+		v.u8, v.packed1, v.packed2, v.i8, v.b, v.u16, v.i16, v.u32, v.i32, v.u64, v.i64,
+		v.ipv6, v.eui64, v.eui48,
+		spinel::Bytes(v.data1_ptr, v.data1_len), spinel::Bytes(v.data2_ptr, v.data2_len));
+}
+
+static spinel_ssize_t
+reference_unpack(const uint8_t* buffer, spinel_size_t buffer_len, Values& v)
+{
+	const spinel_ipv6addr_t* ipv6 = NULL;
+	const spinel_eui64_t* eui64 = NULL;
+	const spinel_eui48_t* eui48 = NULL;
+	spinel_ssize_t ret;
+
+	v.data2_ptr = NULL;
+
+	ret = spinel_datatype_unpack(buffer, buffer_len, kFormat,
+		&v.u8, &v.packed1, &v.packed2, &v.i8, &v.b, &v.u16, &v.i16, &v.u32, &v.i32, &v.u64, &v.i64,
+		&ipv6, &eui64, &eui48, &v.data1_ptr, &v.data1_len, &v.data2_ptr, &v.data2_len);
+
+	// On some bad lengths `spinel_datatype_unpack()` gives up but
+	// returns how far it got rather than -1. The frame was only read
+	// properly if the last field was reached.
+	if ((ret < 0) || (v.data2_ptr == NULL)) {
+		return -1;
+	}
+
+	v.ipv6 = *ipv6;
+	v.eui64 = *eui64;
+	v.eui48 = *eui48;
+
+	return ret;
+}
+
+static spinel_ssize_t
+typed_unpack(const uint8_t* buffer, spinel_size_t buffer_len, Values& v)
+{
+	spinel::Bytes data1;
+	spinel::Bytes data2;
+	spinel_ssize_t ret;
+
+	ret = AllFields::decode(buffer, buffer_len,
+		&v.u8, &v.packed1, &v.packed2, &v.i8, &v.b, &v.u16, &v.i16, &v.u32, &v.i32, &v.u64, &v.i64,
+		&v.ipv6, &v.eui64, &v.eui48, &data1, &data2);
+
+	v.data1_ptr = data1.ptr;
+	v.data1_len = data1.len;
+	v.data2_ptr = data2.ptr;
+	v.data2_len = data2.len;
+
+	return ret;
+}
+
+static bool
+values_equal(const Values& a, const Values& b)
+{
+	return (a.u8 == b.u8)
+	    && (a.packed1 == b.packed1)
+	    && (a.packed2 == b.packed2)
+	    && (a.i8 == b.i8)
+	    && (a.b == b.b)
+	    && (a.u16 == b.u16)
+	    && (a.i16 == b.i16)
+	    && (a.u32 == b.u32)
+	    && (a.i32 == b.i32)
+	    && (a.u64 == b.u64)
+	    && (a.i64 == b.i64)
+	    && (memcmp(&a.ipv6, &b.ipv6, sizeof(a.ipv6)) == 0)
+	    && (memcmp(&a.eui64, &b.eui64, sizeof(a.eui64)) == 0)
+	    && (memcmp(&a.eui48, &b.eui48, sizeof(a.eui48)) == 0)
+	    && (a.data1_ptr == b.data1_ptr)
+	    && (a.data1_len == b.data1_len)
+	    && (a.data2_ptr == b.data2_ptr)
+	    && (a.data2_len == b.data2_len);
+}
+
+int main(void)
+{
+	static uint8_t data[SPINEL_FRAME_MAX_SIZE];
+	static uint8_t expected[AllFields::kMaxSize];
+	static uint8_t actual[AllFields::kMaxSize];
+	int errors = 0;
+	int i;
+
+	for (size_t j = 0; j < sizeof(data); j++) {
+		data[j] = (uint8_t)next_random();
+	}
+
+	for (i = 0; (i < ITERATIONS) && (errors == 0); i++) {
+		Values values;
+		Values reference_values;
+		Values typed_values;
+		spinel_ssize_t expected_len;
+		spinel_ssize_t actual_len;
+		spinel_size_t buffer_len;
+
+		random_values(values, data, 512);
+
+		memset(expected, 0, sizeof(expected));
+		memset(actual, 0, sizeof(actual));
+
+		expected_len = reference_pack(expected, sizeof(expected), values);
+		actual_len = typed_pack(actual, sizeof(actual), values);
+
+		if ((actual_len != expected_len) || (memcmp(actual, expected, sizeof(actual)) != 0)) {
+			printf("encode mismatch (len %d, expected %d)\n", (int)actual_len, (int)expected_len);
+			errors++;
+			break;
+		}
+
+		if (AllFields::size(values.u8, values.packed1, values.packed2, values.i8, values.b, values.u16,
+			values.i16, values.u32, values.i32, values.u64, values.i64, values.ipv6, values.eui64,
+			values.eui48, spinel::Bytes(values.data1_ptr, values.data1_len),
+			spinel::Bytes(values.data2_ptr, values.data2_len)) != expected_len) {
+			printf("size mismatch\n");
+			errors++;
+		}
+
+		// A buffer one byte short must be left alone.
+		memset(actual, 0xA5, sizeof(actual));
+		if ((typed_pack(actual, expected_len - 1, values) != expected_len) || (actual[0] != 0xA5)) {
+			printf("encode into short buffer wrote to it\n");
+			errors++;
+		}
+
+		// Decode the frame as packed, then truncated, then corrupted.
+		memcpy(actual, expected, expected_len);
+		buffer_len = expected_len;
+
+		switch (next_random() % 3) {
+		case 1:
+			buffer_len = next_random() % (expected_len + 1);
+			break;
+		case 2:
+			for (int k = next_random() % 4; k >= 0; k--) {
+				actual[next_random() % expected_len] = (uint8_t)next_random();
+			}
+			break;
+		}
+
+		memset(&reference_values, 0, sizeof(reference_values));
+		memset(&typed_values, 0, sizeof(typed_values));
+
+		expected_len = reference_unpack(actual, buffer_len, reference_values);
+		actual_len = typed_unpack(actual, buffer_len, typed_values);
+
+		if (actual_len != expected_len) {
+			printf("decode mismatch (len %d, expected %d)\n", (int)actual_len, (int)expected_len);
+			errors++;
+
+		} else if ((actual_len > 0) && !values_equal(reference_values, typed_values)) {
+			printf("decoded values mismatch\n");
+			errors++;
+		}
+	}
+
+	// Packed unsigned integers out of range.
+	if ((spinel::Frame<spinel::PackedUint>::encode(actual, sizeof(actual), SPINEL_MAX_UINT_PACKED) != -1)
+		|| (spinel_datatype_pack(actual, sizeof(actual), "i", SPINEL_MAX_UINT_PACKED) != -1)) {
+		printf("out of range packed uint was encoded\n");
+		errors++;
+	}
+
+	if (errors != 0) {
+		printf("FAIL\n");
+		return EXIT_FAILURE;
+	}
+
+	printf("OK\n");
+	return EXIT_SUCCESS;
+}
@@ -97,6 +97,14 @@ DBUSHelpers::any_from_dbus_iter(DBusMessageIter *iter)
 			ret = nl::Data(value, nelements);
 		} else if (dbus_message_iter_get_arg_type(&sub_iter) == DBUS_TYPE_DICT_ENTRY) {
 			ret = value_map_from_dbus_iter(iter);
+		} else if ((dbus_message_iter_get_arg_type(&sub_iter) == DBUS_TYPE_ARRAY)
+		        && (dbus_message_iter_get_element_type(&sub_iter) == DBUS_TYPE_BYTE)
+		) {
+			std::list<nl::Data> list_of_data;
+			do {
+				list_of_data.push_back(boost::any_cast<nl::Data>(any_from_dbus_iter(&sub_iter)));
+			} while (dbus_message_iter_next(&sub_iter));
+			ret = list_of_data;
 		} else {
 			syslog(LOG_NOTICE,
 			       "Unsupported DBUS array type for any: %d",
@@ -271,6 +279,27 @@ DBUSHelpers::append_any_to_dbus_iter(
 			                               &*vector_iter);
 		}
 
+		dbus_message_iter_close_container(iter, &array_iter);
+	} else if (value.type() == typeid(std::list<nl::Data>)) {
+		DBusMessageIter array_iter;
+		const std::list<nl::Data>& list_of_data =
+		    boost::any_cast< std::list<nl::Data> >(value);
+		std::list<nl::Data>::const_iterator list_iter;
+
+		// Open a container as "Array of Byte Arrays" (dbus type "aay")
+		dbus_message_iter_open_container(
+		    iter,
+		    DBUS_TYPE_ARRAY,
+		    DBUS_TYPE_ARRAY_AS_STRING DBUS_TYPE_BYTE_AS_STRING,
+		    &array_iter
+		    );
+
+		for (list_iter = list_of_data.begin();
+		     list_iter != list_of_data.end();
+		     list_iter++) {
+			append_any_to_dbus_iter(&array_iter, *list_iter);
+		}
+
 		dbus_message_iter_close_container(iter, &array_iter);
 	} else if (value.type() == typeid(std::vector<uint8_t>)) {
 		DBusMessageIter array_iter;
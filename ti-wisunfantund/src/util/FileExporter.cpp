@@ -0,0 +1,269 @@
+/*
+ *
+ * Copyright (c) 2026 Texas Instruments
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *    Description:
+ *      Implementation of the background file writer.
+ *
+ */
+
+#if HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include "assert-macros.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <syslog.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <vector>
+#include "FileExporter.h"
+
+using namespace nl;
+
+FileExporter&
+FileExporter::shared(void)
+{
+	static FileExporter exporter;
+	return exporter;
+}
+
+FileExporter::FileExporter()
+	: mThreadStarted(false)
+	, mStopping(false)
+	, mLatencySum(0)
+{
+	pthread_mutex_init(&mMutex, NULL);
+	pthread_cond_init(&mCondition, NULL);
+	memset(&mStats, 0, sizeof(mStats));
+}
+
+FileExporter::~FileExporter()
+{
+	pthread_mutex_lock(&mMutex);
+	mStopping = true;
+	pthread_cond_signal(&mCondition);
+	pthread_mutex_unlock(&mMutex);
+
+	if (mThreadStarted) {
+		pthread_join(mThread, NULL);
+	}
+
+	pthread_cond_destroy(&mCondition);
+	pthread_mutex_destroy(&mMutex);
+}
+
+void
+FileExporter::write(const std::string& path, const std::string& contents)
+{
+	Entry entry;
+
+	entry.mRemove = false;
+	entry.mContents = contents;
+	entry.mQueuedAt = time_ms();
+
+	enqueue(path, entry);
+}
+
+void
+FileExporter::remove(const std::string& path)
+{
+	Entry entry;
+
+	entry.mRemove = true;
+	entry.mQueuedAt = time_ms();
+
+	enqueue(path, entry);
+}
+
+void
+FileExporter::enqueue(const std::string& path, const Entry& entry)
+{
+	std::map<std::string, Entry>::iterator iter;
+
+	pthread_mutex_lock(&mMutex);
+
+	if (!mThreadStarted && !mStopping) {
+		if (pthread_create(&mThread, NULL, &FileExporter::thread_main, this) == 0) {
+			mThreadStarted = true;
+		} else {
+			syslog(LOG_ERR, "FileExporter: Unable to start writer thread: %s", strerror(errno));
+		}
+	}
+
+	iter = mPending.find(path);
+
+	if (iter == mPending.end()) {
+		mPending[path] = entry;
+	} else {
+		// Keep the original time, so the latency reflects how stale
+		// the file on disk has been rather than how old the last update is.
+		cms_t queued_at = iter->second.mQueuedAt;
+		iter->second = entry;
+		iter->second.mQueuedAt = queued_at;
+		mStats.mCoalesced++;
+	}
+
+	mStats.mBacklog = static_cast<uint32_t>(mPending.size());
+
+	pthread_cond_signal(&mCondition);
+	pthread_mutex_unlock(&mMutex);
+}
+
+FileExporter::Stats
+FileExporter::get_stats(void)
+{
+	Stats stats;
+
+	pthread_mutex_lock(&mMutex);
+	stats = mStats;
+	stats.mLatencyAvg = (mStats.mWritten == 0) ? 0 : static_cast<uint32_t>(mLatencySum / mStats.mWritten);
+	pthread_mutex_unlock(&mMutex);
+
+	return stats;
+}
+
+static void
+create_parent_directories(const std::string& path)
+{
+	std::string::size_type pos = path.find('/', 1);
+
+	while (pos != std::string::npos) {
+		IGNORE_RETURN_VALUE( mkdir(path.substr(0, pos).c_str(), 0777) );
+		pos = path.find('/', pos + 1);
+	}
+}
+
+static const char kTempSuffix[] = ".XXXXXX";
+
+// Runs on the writer thread, without the lock held.
+bool
+FileExporter::export_entry(const std::string& path, const Entry& entry)
+{
+	std::vector<char> temp_path(path.begin(), path.end());
+	const char* ptr = entry.mContents.data();
+	size_t len = entry.mContents.size();
+	bool ret = false;
+	bool temp_created = false;
+	int fd = -1;
+
+	if (entry.mRemove) {
+		ret = (unlink(path.c_str()) == 0) || (errno == ENOENT);
+		goto bail;
+	}
+
+	create_parent_directories(path);
+
+	// mkstemp() picks a fresh name next to the target and creates it
+	// with O_EXCL, so it never follows a symlink planted there.
+	temp_path.insert(temp_path.end(), kTempSuffix, kTempSuffix + sizeof(kTempSuffix));
+
+	fd = mkstemp(&temp_path[0]);
+	require_string(fd >= 0, bail, strerror(errno));
+	temp_created = true;
+
+	IGNORE_RETURN_VALUE( fcntl(fd, F_SETFD, FD_CLOEXEC) );
+	require_string(fchmod(fd, 0644) == 0, bail, strerror(errno));
+
+	while (len > 0) {
+		ssize_t written = ::write(fd, ptr, len);
+
+		if ((written < 0) && (errno == EINTR)) {
+			continue;
+		}
+
+		require_string(written > 0, bail, strerror(errno));
+
+		ptr += written;
+		len -= written;
+	}
+
+	require_string(fsync(fd) == 0, bail, strerror(errno));
+	require_string(close(fd) == 0, bail, strerror(errno));
+	fd = -1;
+
+	require_string(rename(&temp_path[0], path.c_str()) == 0, bail, strerror(errno));
+
+	ret = true;
+
+bail:
+	if (fd >= 0) {
+		close(fd);
+	}
+
+	if (!ret && temp_created) {
+		IGNORE_RETURN_VALUE( unlink(&temp_path[0]) );
+	}
+
+	return ret;
+}
+
+void*
+FileExporter::thread_main(void* context)
+{
+	static_cast<FileExporter*>(context)->run();
+	return NULL;
+}
+
+void
+FileExporter::run(void)
+{
+	pthread_mutex_lock(&mMutex);
+
+	while (!mStopping || !mPending.empty()) {
+		std::map<std::string, Entry>::iterator iter;
+		std::string path;
+		Entry entry;
+		bool ok;
+		cms_t latency;
+
+		if (mPending.empty()) {
+			pthread_cond_wait(&mCondition, &mMutex);
+			continue;
+		}
+
+		iter = mPending.begin();
+		path = iter->first;
+		entry = iter->second;
+		mPending.erase(iter);
+
+		pthread_mutex_unlock(&mMutex);
+
+		ok = export_entry(path, entry);
+
+		pthread_mutex_lock(&mMutex);
+
+		latency = CMS_SINCE(entry.mQueuedAt);
+
+		if (ok) {
+			mStats.mWritten++;
+			mLatencySum += static_cast<uint64_t>(latency);
+			if (static_cast<uint32_t>(latency) > mStats.mLatencyMax) {
+				mStats.mLatencyMax = static_cast<uint32_t>(latency);
+			}
+		} else {
+			mStats.mFailed++;
+			syslog(LOG_WARNING, "FileExporter: Unable to update \"%s\"", path.c_str());
+		}
+
+		mStats.mBacklog = static_cast<uint32_t>(mPending.size());
+	}
+
+	pthread_mutex_unlock(&mMutex);
+}
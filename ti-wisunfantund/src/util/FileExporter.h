@@ -0,0 +1,97 @@
+/*
+ *
+ * Copyright (c) 2026 Texas Instruments
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *    Description:
+ *      This file declares a module which writes files from a background
+ *      thread, so that slow storage never holds up the main loop.
+ *
+ */
+
+#ifndef __wpantund__FileExporter__
+#define __wpantund__FileExporter__
+
+#include <map>
+#include <string>
+#include <stdint.h>
+#include <pthread.h>
+
+#include "time-utils.h"
+
+namespace nl {
+
+// Writes files on a dedicated thread. Every file is written under a
+// temporary name and then renamed into place, so readers never see a
+// partial file. An update to a file which has not been written yet
+// simply replaces the pending one.
+class FileExporter {
+public:
+	struct Stats {
+		uint32_t mBacklog;      // Files waiting to be written
+		uint32_t mWritten;      // Files written (or removed) so far
+		uint32_t mCoalesced;    // Updates replaced by a newer one before being written
+		uint32_t mFailed;       // Files which could not be written
+		uint32_t mLatencyAvg;   // Average time, in ms, from the first pending update to the write
+		uint32_t mLatencyMax;   // Worst such time, in ms
+	};
+
+public:
+	// The exporter shared by the whole daemon. Its thread is only
+	// started once something is queued.
+	static FileExporter& shared(void);
+
+	FileExporter();
+
+	// Writes out whatever is still pending before returning.
+	~FileExporter();
+
+	// Queues `contents` to be written to `path`, creating the
+	// directories leading to it as needed.
+	void write(const std::string& path, const std::string& contents);
+
+	// Queues the removal of `path`. Cancels any pending write to it.
+	void remove(const std::string& path);
+
+	Stats get_stats(void);
+
+private:
+	struct Entry {
+		bool mRemove;
+		std::string mContents;
+		cms_t mQueuedAt;
+	};
+
+	void enqueue(const std::string& path, const Entry& entry);
+	bool export_entry(const std::string& path, const Entry& entry);
+
+	static void* thread_main(void* context);
+	void run(void);
+
+	pthread_mutex_t mMutex;
+	pthread_cond_t mCondition;
+	pthread_t mThread;
+	bool mThreadStarted;
+	bool mStopping;
+
+	std::map<std::string, Entry> mPending;
+
+	Stats mStats;
+	uint64_t mLatencySum;
+};
+
+}; // namespace nl
+
+#endif // defined(__wpantund__FileExporter__)
@@ -0,0 +1,183 @@
+/*
+ *
+ * Copyright (c) 2026 Texas Instruments
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *    Description:
+ *      Implementation of the frame trace.
+ *
+ */
+
+#if HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <string.h>
+#include <syslog.h>
+#include <sys/time.h>
+#include "FrameTrace.h"
+#include "FileExporter.h"
+#include "time-utils.h"
+
+using namespace nl;
+
+FrameTrace&
+FrameTrace::shared(void)
+{
+	static FrameTrace trace;
+	return trace;
+}
+
+FrameTrace::FrameTrace()
+	: mNextSequence(0)
+	, mDumpRequested(0)
+	, mDumpPath(FRAME_TRACE_DEFAULT_DUMP_PATH)
+	, mDumps(0)
+{
+	for (int i = 0; i < kCapacity; i++) {
+		mSlots[i].mSequence.store(0, std::memory_order_relaxed);
+	}
+}
+
+void
+FrameTrace::record(
+	uint8_t direction,
+	uint8_t tid,
+	uint32_t command,
+	uint32_t key,
+	uint8_t flags,
+	uint16_t frame_len,
+	const uint8_t* payload_ptr,
+	size_t payload_len
+) {
+	uint32_t sequence = mNextSequence.fetch_add(1, std::memory_order_relaxed);
+	Slot& slot = mSlots[sequence & (kCapacity - 1)];
+	Record& record = slot.mRecord;
+
+	if (payload_len > FRAME_TRACE_PAYLOAD_MAX) {
+		payload_len = FRAME_TRACE_PAYLOAD_MAX;
+	}
+
+	slot.mSequence.store(0, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_release);
+
+	record.mTimestamp = time_get_monotonic_us();
+	record.mCommand = command;
+	record.mKey = key;
+	record.mFrameLen = frame_len;
+	record.mDirection = direction;
+	record.mTID = tid;
+	record.mFlags = flags;
+	record.mPayloadLen = static_cast<uint8_t>(payload_len);
+	memcpy(record.mPayload, payload_ptr, payload_len);
+
+	slot.mSequence.store(sequence + 1, std::memory_order_release);
+}
+
+static void
+append_le(std::string& out, uint64_t value, int len)
+{
+	for (; len > 0; len--) {
+		out.push_back(static_cast<char>(value & 0xFF));
+		value >>= 8;
+	}
+}
+
+std::string
+FrameTrace::dump(void) const
+{
+	uint32_t end = mNextSequence.load(std::memory_order_acquire);
+	uint32_t begin = (end > kCapacity) ? (end - kCapacity) : 0;
+	uint32_t count = 0;
+	struct timeval now;
+	std::string records;
+	std::string out;
+
+	records.reserve((end - begin) * FRAME_TRACE_RECORD_LEN);
+
+	for (uint32_t sequence = begin; sequence != end; sequence++) {
+		const Slot& slot = mSlots[sequence & (kCapacity - 1)];
+		Record record;
+
+		if (slot.mSequence.load(std::memory_order_acquire) != sequence + 1) {
+			continue;
+		}
+
+		record = slot.mRecord;
+
+		// Drop the record if it was overwritten while being copied.
+		std::atomic_thread_fence(std::memory_order_acquire);
+		if (slot.mSequence.load(std::memory_order_relaxed) != sequence + 1) {
+			continue;
+		}
+
+		append_le(records, record.mTimestamp, 8);
+		append_le(records, record.mCommand, 4);
+		append_le(records, record.mKey, 4);
+		append_le(records, record.mFrameLen, 2);
+		records.push_back(static_cast<char>(record.mDirection));
+		records.push_back(static_cast<char>(record.mTID));
+		records.push_back(static_cast<char>(record.mFlags));
+		records.push_back(static_cast<char>(record.mPayloadLen));
+		records.append(reinterpret_cast<const char*>(record.mPayload), record.mPayloadLen);
+		records.append(FRAME_TRACE_PAYLOAD_MAX - record.mPayloadLen, '\0');
+		count++;
+	}
+
+	gettimeofday(&now, NULL);
+
+	out.reserve(FRAME_TRACE_HEADER_LEN + records.size());
+	out.append(FRAME_TRACE_MAGIC, 4);
+	out.push_back(static_cast<char>(FRAME_TRACE_VERSION));
+	out.push_back(static_cast<char>(FRAME_TRACE_RECORD_LEN));
+	append_le(out, 0, 2);
+	append_le(out, count, 4);
+	append_le(out, time_get_monotonic_us(), 8);
+	append_le(out, static_cast<uint64_t>(now.tv_sec) * 1000000 + now.tv_usec, 8);
+	out.append(records);
+
+	return out;
+}
+
+void
+FrameTrace::process(void)
+{
+	if (!mDumpRequested) {
+		return;
+	}
+
+	mDumpRequested = 0;
+
+	if (mDumpPath.empty()) {
+		syslog(LOG_WARNING, "FrameTrace: No dump path set, ignoring dump request");
+		return;
+	}
+
+	FileExporter::shared().write(mDumpPath, dump());
+	mDumps++;
+
+	syslog(LOG_NOTICE, "FrameTrace: Writing the last frames to \"%s\"", mDumpPath.c_str());
+}
+
+FrameTrace::Stats
+FrameTrace::get_stats(void) const
+{
+	Stats stats;
+
+	stats.mRecorded = mNextSequence.load(std::memory_order_relaxed);
+	stats.mDumps = mDumps;
+
+	return stats;
+}
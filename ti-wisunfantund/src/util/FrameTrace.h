@@ -0,0 +1,114 @@
+/*
+ *
+ * Copyright (c) 2026 Texas Instruments
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *    Description:
+ *      This file declares a fixed size trace of the most recent frames
+ *      exchanged with the NCP, cheap enough to be always on.
+ *
+ */
+
+#ifndef __wpantund__FrameTrace__
+#define __wpantund__FrameTrace__
+
+#include <atomic>
+#include <string>
+#include <signal.h>
+#include <stdint.h>
+
+#include "frame-trace.h"
+
+namespace nl {
+
+// Keeps the last `kCapacity` frames in a ring, as fixed size binary
+// records: nothing is formatted or written out until a dump is asked for.
+// Recording never blocks. A record being overwritten while a dump is
+// taken is left out of the dump rather than copied half written.
+class FrameTrace {
+public:
+	enum {
+		kCapacity = 1024,   // Must be a power of two
+	};
+
+	struct Stats {
+		uint32_t mRecorded;     // Frames recorded so far
+		uint32_t mDumps;        // Dumps written to disk
+	};
+
+public:
+	// The trace shared by the whole daemon.
+	static FrameTrace& shared(void);
+
+	FrameTrace();
+
+	void record(
+		uint8_t direction,
+		uint8_t tid,
+		uint32_t command,
+		uint32_t key,
+		uint8_t flags,
+		uint16_t frame_len,
+		const uint8_t* payload_ptr,
+		size_t payload_len
+	);
+
+	// Returns the frames still in the ring, oldest first, in the
+	// format described in "frame-trace.h".
+	std::string dump(void) const;
+
+	// Where `process()` writes the dump. Empty disables it.
+	void set_dump_path(const std::string& path) { mDumpPath = path; }
+	const std::string& get_dump_path(void) const { return mDumpPath; }
+
+	// Async-signal-safe. Asks for the trace to be written out by the
+	// next `process()`.
+	void request_dump(void) { mDumpRequested = 1; }
+
+	// Called from the main loop.
+	void process(void);
+
+	Stats get_stats(void) const;
+
+private:
+	struct Record {
+		uint64_t mTimestamp;
+		uint32_t mCommand;
+		uint32_t mKey;
+		uint16_t mFrameLen;
+		uint8_t mDirection;
+		uint8_t mTID;
+		uint8_t mFlags;
+		uint8_t mPayloadLen;
+		uint8_t mPayload[FRAME_TRACE_PAYLOAD_MAX];
+	};
+
+	struct Slot {
+		// Sequence number of the record plus one, zero while it is
+		// being written.
+		std::atomic<uint32_t> mSequence;
+		Record mRecord;
+	};
+
+	Slot mSlots[kCapacity];
+	std::atomic<uint32_t> mNextSequence;
+	volatile sig_atomic_t mDumpRequested;
+	std::string mDumpPath;
+	uint32_t mDumps;
+};
+
+}; // namespace nl
+
+#endif // defined(__wpantund__FrameTrace__)
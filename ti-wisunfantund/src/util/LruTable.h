@@ -0,0 +1,276 @@
+/*
+ *
+ * Copyright (c) 2026 Texas Instruments
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *    Description:
+ *      A fixed capacity key/value table which evicts the least recently
+ *      used entry when full.
+ *
+ */
+
+#ifndef wpantund_LruTable_h
+#define wpantund_LruTable_h
+
+#include <stdint.h>
+#include <stddef.h>
+#include <vector>
+
+namespace nl {
+
+// Entries live in a flat array sized once by `set_capacity()`. Lookups go
+// through an open addressing (linear probing) hash index, and the entries
+// are threaded on an intrusive list ordered from most to least recently
+// used, so finding, inserting, touching and evicting are all O(1).
+//
+// `K` must provide `uint32_t hash(void) const` and `operator==`.
+template <typename K, typename V>
+class LruTable
+{
+public:
+	typedef K key_type;
+	typedef V value_type;
+	typedef int size_type;
+	typedef int index_type;
+
+	static const index_type kInvalidIndex = -1;
+
+public:
+	LruTable(size_type capacity = 64)
+	{
+		set_capacity(capacity);
+	}
+
+	// Changes the capacity of the table. Drops every entry.
+	void set_capacity(size_type capacity)
+	{
+		size_type bucket_count = 1;
+
+		if (capacity < 1) {
+			capacity = 1;
+		}
+
+		// Keep the load factor at or below one half.
+		while (bucket_count < 2 * capacity) {
+			bucket_count <<= 1;
+		}
+
+		mEntries.clear();
+		mEntries.resize(capacity);
+		mBuckets.resize(bucket_count);
+		mFreeList.reserve(capacity);
+
+		clear();
+	}
+
+	size_type capacity(void) const { return static_cast<size_type>(mEntries.size()); }
+	size_type size(void) const { return mSize; }
+	bool empty(void) const { return mSize == 0; }
+
+	// Drops every entry.
+	void clear(void)
+	{
+		mFreeList.clear();
+
+		for (index_type i = capacity() - 1; i >= 0; i--) {
+			mFreeList.push_back(i);
+		}
+
+		for (size_t i = 0; i < mBuckets.size(); i++) {
+			mBuckets[i] = kInvalidIndex;
+		}
+
+		mHead = mTail = kInvalidIndex;
+		mSize = 0;
+	}
+
+	// Returns the value for `key`, or NULL. Does not change the LRU order.
+	value_type *find(const key_type& key)
+	{
+		index_type index = mBuckets[find_bucket(key)];
+		return (index == kInvalidIndex) ? NULL : &mEntries[index].mValue;
+	}
+
+	const value_type *find(const key_type& key) const
+	{
+		index_type index = mBuckets[find_bucket(key)];
+		return (index == kInvalidIndex) ? NULL : &mEntries[index].mValue;
+	}
+
+	// Returns the value for `key` and marks it as the most recently used
+	// one. If `key` is not in the table it is added, evicting the least
+	// recently used entry if the table is full; `inserted` tells the
+	// caller it has to initialize the (stale) value.
+	value_type *touch(const key_type& key, bool& inserted, bool& evicted)
+	{
+		size_t bucket = find_bucket(key);
+		index_type index = mBuckets[bucket];
+
+		inserted = false;
+		evicted = false;
+
+		if (index != kInvalidIndex) {
+			unlink(index);
+			link_at_head(index);
+			return &mEntries[index].mValue;
+		}
+
+		if (mFreeList.empty()) {
+			remove_at(mTail);
+			evicted = true;
+
+			// Removing may have moved entries around in the index.
+			bucket = find_bucket(key);
+		}
+
+		index = mFreeList.back();
+		mFreeList.pop_back();
+
+		mEntries[index].mKey = key;
+		mBuckets[bucket] = index;
+		link_at_head(index);
+		mSize++;
+
+		inserted = true;
+
+		return &mEntries[index].mValue;
+	}
+
+	// Removes `key` from the table. Returns false if it was not there.
+	bool remove(const key_type& key)
+	{
+		index_type index = mBuckets[find_bucket(key)];
+
+		if (index == kInvalidIndex) {
+			return false;
+		}
+
+		remove_at(index);
+		return true;
+	}
+
+	// Walks the entries from the most to the least recently used:
+	//
+	//     for (index_type i = table.first(); i != kInvalidIndex; i = table.next(i)) { ... }
+	index_type first(void) const { return mHead; }
+	index_type next(index_type index) const { return mEntries[index].mNext; }
+	const key_type& key_at(index_type index) const { return mEntries[index].mKey; }
+	const value_type& value_at(index_type index) const { return mEntries[index].mValue; }
+
+private:
+	struct Entry
+	{
+		key_type mKey;
+		value_type mValue;
+		index_type mPrev;
+		index_type mNext;
+	};
+
+	size_t mask(void) const
+	{
+		return mBuckets.size() - 1;
+	}
+
+	// Returns the bucket holding `key`, or the empty bucket where it
+	// would go. The index is never full, so this always terminates.
+	size_t find_bucket(const key_type& key) const
+	{
+		size_t bucket = key.hash() & mask();
+
+		while (mBuckets[bucket] != kInvalidIndex) {
+			if (mEntries[mBuckets[bucket]].mKey == key) {
+				break;
+			}
+			bucket = (bucket + 1) & mask();
+		}
+
+		return bucket;
+	}
+
+	void unlink(index_type index)
+	{
+		Entry& entry = mEntries[index];
+
+		if (entry.mPrev != kInvalidIndex) {
+			mEntries[entry.mPrev].mNext = entry.mNext;
+		} else {
+			mHead = entry.mNext;
+		}
+
+		if (entry.mNext != kInvalidIndex) {
+			mEntries[entry.mNext].mPrev = entry.mPrev;
+		} else {
+			mTail = entry.mPrev;
+		}
+	}
+
+	void link_at_head(index_type index)
+	{
+		Entry& entry = mEntries[index];
+
+		entry.mPrev = kInvalidIndex;
+		entry.mNext = mHead;
+
+		if (mHead != kInvalidIndex) {
+			mEntries[mHead].mPrev = index;
+		} else {
+			mTail = index;
+		}
+
+		mHead = index;
+	}
+
+	void remove_at(index_type index)
+	{
+		size_t hole = find_bucket(mEntries[index].mKey);
+		size_t bucket = hole;
+
+		// Backward shift deletion: pull up any later entry of the probe
+		// sequence which would no longer be reachable past the hole.
+		for (;;) {
+			size_t home;
+
+			bucket = (bucket + 1) & mask();
+
+			if (mBuckets[bucket] == kInvalidIndex) {
+				break;
+			}
+
+			home = mEntries[mBuckets[bucket]].mKey.hash() & mask();
+
+			if (((bucket - home) & mask()) >= ((bucket - hole) & mask())) {
+				mBuckets[hole] = mBuckets[bucket];
+				hole = bucket;
+			}
+		}
+
+		mBuckets[hole] = kInvalidIndex;
+
+		unlink(index);
+		mFreeList.push_back(index);
+		mSize--;
+	}
+
+	std::vector<Entry> mEntries;
+	std::vector<index_type> mBuckets;
+	std::vector<index_type> mFreeList;
+	index_type mHead;
+	index_type mTail;
+	size_type mSize;
+};
+
+}; // namespace nl
+
+#endif // wpantund_LruTable_h
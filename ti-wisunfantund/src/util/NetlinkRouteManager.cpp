@@ -0,0 +1,762 @@
+/*
+ *
+ * Copyright (c) 2026 Texas Instruments
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *    Description:
+ *      Implementation of the batched rtnetlink address/route helper.
+ *
+ */
+
+#if HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include "assert-macros.h"
+#include "NetlinkRouteManager.h"
+#include "IPv6Helpers.h"
+#include <errno.h>
+#include <stdio.h>
+#include <syslog.h>
+#include <unistd.h>
+
+#if __linux__
+#include <asm/types.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <linux/netlink.h>
+#include <linux/rtnetlink.h>
+#endif
+
+// What the kernel uses for a route added with a metric of zero.
+#define DEFAULT_ROUTE_METRIC        1024
+
+NetlinkRouteManager::Route::Route(const struct in6_addr& prefix, uint8_t prefix_len, uint32_t metric)
+	: mPrefix(prefix)
+	, mPrefixLen(prefix_len)
+	, mMetric((metric != 0) ? metric : DEFAULT_ROUTE_METRIC)
+{
+	for (int i = 0; i < 16; i++) {
+		int bits = prefix_len - i * 8;
+
+		if (bits <= 0) {
+			mPrefix.s6_addr[i] = 0;
+		} else if (bits < 8) {
+			mPrefix.s6_addr[i] &= static_cast<uint8_t>(0xFF << (8 - bits));
+		}
+	}
+}
+
+NetlinkRouteManager::NetlinkRouteManager()
+	: mFD(-1)
+	, mNextSeq(1)
+{
+	memset(&mStats, 0, sizeof(mStats));
+}
+
+NetlinkRouteManager::~NetlinkRouteManager()
+{
+	if (mFD >= 0) {
+		close(mFD);
+	}
+}
+
+bool
+NetlinkRouteManager::is_open(void) const
+{
+	return mFD >= 0;
+}
+
+int
+NetlinkRouteManager::get_pending_count(void) const
+{
+	return static_cast<int>(mRequests.size());
+}
+
+NetlinkRouteManager::Stats
+NetlinkRouteManager::get_stats(void) const
+{
+	return mStats;
+}
+
+#if __linux__ // --------------------------------------------------------------
+
+std::string
+NetlinkRouteManager::Request::get_description(void) const
+{
+	char c_string[200];
+	const char* verb = "?";
+
+	switch (mType) {
+	case RTM_NEWADDR:  verb = "add address";    break;
+	case RTM_DELADDR:  verb = "remove address"; break;
+	case RTM_NEWROUTE: verb = "add route";      break;
+	case RTM_DELROUTE: verb = "remove route";   break;
+	}
+
+	if ((mType == RTM_NEWROUTE) || (mType == RTM_DELROUTE)) {
+		snprintf(c_string, sizeof(c_string), "%s \"%s/%d\" metric %d", verb,
+			in6_addr_to_string(mPrefix).c_str(), mPrefixLen, mMetric);
+	} else {
+		snprintf(c_string, sizeof(c_string), "%s \"%s/%d\"", verb,
+			in6_addr_to_string(mPrefix).c_str(), mPrefixLen);
+	}
+
+	return std::string(c_string);
+}
+
+// Adding what is already there or removing what is already gone.
+static bool
+is_benign_error(uint16_t type, int error)
+{
+	switch (type) {
+	case RTM_NEWADDR:
+	case RTM_NEWROUTE:
+		return error == EEXIST;
+
+	case RTM_DELADDR:
+		return error == EADDRNOTAVAIL;
+
+	case RTM_DELROUTE:
+		return error == ESRCH;
+	}
+
+	return false;
+}
+
+static void
+append_bytes(std::vector<uint8_t>& buffer, const void* data, size_t len, size_t space)
+{
+	const size_t offset = buffer.size();
+
+	buffer.resize(offset + space, 0);
+	memcpy(&buffer[offset], data, len);
+}
+
+static void
+append_attribute(std::vector<uint8_t>& buffer, uint16_t type, const void* data, size_t len)
+{
+	const size_t offset = buffer.size();
+	struct rtattr rta;
+
+	rta.rta_len = RTA_LENGTH(len);
+	rta.rta_type = type;
+
+	buffer.resize(offset + RTA_SPACE(len), 0);
+	memcpy(&buffer[offset], &rta, sizeof(rta));
+	memcpy(&buffer[offset + RTA_LENGTH(0)], data, len);
+}
+
+int
+NetlinkRouteManager::open(void)
+{
+	int fd = -1;
+	int value;
+
+	if (mFD >= 0) {
+		return 0;
+	}
+
+	fd = socket(AF_NETLINK, SOCK_DGRAM | SOCK_CLOEXEC, NETLINK_ROUTE);
+
+	require(fd >= 0, bail);
+
+	// A full batch of ACKs has to fit in the receive buffer.
+	value = 256 * 1024;
+	IGNORE_RETURN_VALUE(setsockopt(fd, SOL_SOCKET, SO_RCVBUF, &value, sizeof(value)));
+
+#ifdef NETLINK_CAP_ACK
+	// Don't send the requests back to us with their ACKs.
+	value = 1;
+	IGNORE_RETURN_VALUE(setsockopt(fd, SOL_NETLINK, NETLINK_CAP_ACK, &value, sizeof(value)));
+#endif
+
+	mFD = fd;
+	fd = -1;
+
+bail:
+	if (fd >= 0) {
+		close(fd);
+	}
+
+	return (mFD >= 0) ? 0 : -1;
+}
+
+int
+NetlinkRouteManager::open(int fd)
+{
+	if (mFD >= 0) {
+		close(mFD);
+	}
+
+	mFD = fd;
+
+	return 0;
+}
+
+void
+NetlinkRouteManager::queue_request(uint16_t type, int ifindex, const struct in6_addr& prefix, uint8_t prefix_len, uint32_t metric)
+{
+	const size_t offset = mQueue.size();
+	struct nlmsghdr header;
+	uint32_t u32;
+	Request request;
+
+	memset(&header, 0, sizeof(header));
+	header.nlmsg_type = type;
+	header.nlmsg_flags = NLM_F_REQUEST | NLM_F_ACK;
+	header.nlmsg_seq = mNextSeq++;
+
+	if ((type == RTM_NEWADDR) || (type == RTM_NEWROUTE)) {
+		header.nlmsg_flags |= NLM_F_CREATE;
+	}
+
+	append_bytes(mQueue, &header, sizeof(header), NLMSG_HDRLEN);
+
+	if ((type == RTM_NEWADDR) || (type == RTM_DELADDR)) {
+		struct ifaddrmsg ifa;
+
+		memset(&ifa, 0, sizeof(ifa));
+		ifa.ifa_family = AF_INET6;
+		ifa.ifa_prefixlen = prefix_len;
+		ifa.ifa_scope = RT_SCOPE_UNIVERSE;
+		ifa.ifa_index = ifindex;
+
+		append_bytes(mQueue, &ifa, sizeof(ifa), NLMSG_ALIGN(sizeof(ifa)));
+		append_attribute(mQueue, IFA_LOCAL, &prefix, sizeof(prefix));
+		append_attribute(mQueue, IFA_ADDRESS, &prefix, sizeof(prefix));
+
+	} else {
+		struct rtmsg rtm;
+
+		memset(&rtm, 0, sizeof(rtm));
+		rtm.rtm_family = AF_INET6;
+		rtm.rtm_dst_len = prefix_len;
+		rtm.rtm_table = RT_TABLE_MAIN;
+		rtm.rtm_type = RTN_UNICAST;
+
+		if (type == RTM_NEWROUTE) {
+			rtm.rtm_protocol = kRouteProtocol;
+			rtm.rtm_scope = RT_SCOPE_UNIVERSE;
+		} else {
+			// Matches the route whoever added it.
+			rtm.rtm_protocol = RTPROT_UNSPEC;
+			rtm.rtm_scope = RT_SCOPE_NOWHERE;
+		}
+
+		append_bytes(mQueue, &rtm, sizeof(rtm), NLMSG_ALIGN(sizeof(rtm)));
+		append_attribute(mQueue, RTA_DST, &prefix, sizeof(prefix));
+
+		u32 = ifindex;
+		append_attribute(mQueue, RTA_OIF, &u32, sizeof(u32));
+
+		if (metric != 0) {
+			u32 = metric;
+			append_attribute(mQueue, RTA_PRIORITY, &u32, sizeof(u32));
+		}
+	}
+
+	// The header is filled in last, once the length is known.
+	header.nlmsg_len = static_cast<uint32_t>(mQueue.size() - offset);
+	memcpy(&mQueue[offset], &header, sizeof(header));
+
+	request.mSeq = header.nlmsg_seq;
+	request.mType = type;
+	request.mIfIndex = ifindex;
+	request.mPrefix = prefix;
+	request.mPrefixLen = prefix_len;
+	request.mMetric = metric;
+
+	mQueueOffsets.push_back(offset);
+	mRequests.push_back(request);
+}
+
+void
+NetlinkRouteManager::add_address(int ifindex, const struct in6_addr& address, uint8_t prefix_len)
+{
+	queue_request(RTM_NEWADDR, ifindex, address, prefix_len, 0);
+}
+
+void
+NetlinkRouteManager::remove_address(int ifindex, const struct in6_addr& address, uint8_t prefix_len)
+{
+	queue_request(RTM_DELADDR, ifindex, address, prefix_len, 0);
+}
+
+void
+NetlinkRouteManager::add_route(int ifindex, const struct in6_addr& prefix, uint8_t prefix_len, uint32_t metric)
+{
+	queue_request(RTM_NEWROUTE, ifindex, prefix, prefix_len, metric);
+}
+
+void
+NetlinkRouteManager::remove_route(int ifindex, const struct in6_addr& prefix, uint8_t prefix_len, uint32_t metric)
+{
+	queue_request(RTM_DELROUTE, ifindex, prefix, prefix_len, metric);
+}
+
+// Waits for the socket to become readable, but not past `deadline`.
+bool
+NetlinkRouteManager::wait_readable(cms_t deadline)
+{
+	struct pollfd pfd;
+	cms_t timeout = deadline - time_ms();
+
+	if (timeout <= 0) {
+		return false;
+	}
+
+	pfd.fd = mFD;
+	pfd.events = POLLIN;
+	pfd.revents = 0;
+
+	return poll(&pfd, 1, timeout) > 0;
+}
+
+// Sends requests `begin` to `end` (bytes `byte_begin` to `byte_end` of the
+// queue) in one datagram and collects their ACKs. Returns the number of
+// requests which failed, leaving `errno` set to the last failure.
+int
+NetlinkRouteManager::send_batch(size_t begin, size_t end, size_t byte_begin, size_t byte_end, cms_t deadline)
+{
+	const uint32_t first_seq = mRequests[begin].mSeq;
+	const size_t count = end - begin;
+	std::vector<bool> acked(count, false);
+	size_t outstanding = count;
+	int failures = 0;
+	int last_error = 0;
+
+	uint8_t buffers[kRecvBatch][kAckBufferSize];
+	struct iovec iovecs[kRecvBatch];
+	struct mmsghdr messages[kRecvBatch];
+
+	mStats.mSends++;
+	mStats.mRequests += static_cast<uint32_t>(count);
+
+	// An unconnected netlink socket sends to the kernel by default.
+	if (send(mFD, &mQueue[byte_begin], byte_end - byte_begin, 0) < 0) {
+		last_error = errno;
+		syslog(LOG_ERR, "NetlinkRouteManager: Unable to send %d requests: %s",
+		       static_cast<int>(count), strerror(last_error));
+		failures = static_cast<int>(count);
+		goto bail;
+	}
+
+	for (int i = 0; i < kRecvBatch; i++) {
+		iovecs[i].iov_base = buffers[i];
+		iovecs[i].iov_len = sizeof(buffers[i]);
+		memset(&messages[i], 0, sizeof(messages[i]));
+		messages[i].msg_hdr.msg_iov = &iovecs[i];
+		messages[i].msg_hdr.msg_iovlen = 1;
+	}
+
+	// The kernel handles the requests inside `send()`, so the ACKs are
+	// normally waiting already and there is no need to poll first.
+	while (outstanding > 0) {
+		int received = recvmmsg(mFD, messages, kRecvBatch, MSG_DONTWAIT, NULL);
+
+		if (received < 0) {
+			if (errno == EAGAIN) {
+				if (!wait_readable(deadline)) {
+					last_error = ETIMEDOUT;
+					break;
+				}
+				continue;
+			}
+			if (errno == EINTR) {
+				continue;
+			}
+			// ENOBUFS means ACKs were dropped, and won't come.
+			last_error = errno;
+			break;
+		}
+
+		for (int i = 0; i < received; i++) {
+			const struct nlmsghdr* nlh = reinterpret_cast<const struct nlmsghdr*>(buffers[i]);
+			int len = static_cast<int>(messages[i].msg_len);
+
+			for (; NLMSG_OK(nlh, len); nlh = NLMSG_NEXT(nlh, len)) {
+				const struct nlmsgerr* err;
+				size_t index = nlh->nlmsg_seq - first_seq;
+				int error;
+
+				if ((nlh->nlmsg_type != NLMSG_ERROR) || (index >= count) || acked[index]
+					|| (nlh->nlmsg_len < NLMSG_LENGTH(sizeof(struct nlmsgerr)))
+				) {
+					// Not one of ours, or the ACK for an earlier
+					// batch which timed out.
+					continue;
+				}
+
+				err = reinterpret_cast<const struct nlmsgerr*>(NLMSG_DATA(nlh));
+				error = -err->error;
+
+				acked[index] = true;
+				outstanding--;
+
+				if ((error != 0) && !is_benign_error(mRequests[begin + index].mType, error)) {
+					syslog(LOG_ERR, "NetlinkRouteManager: Unable to %s on interface %d: %s",
+					       mRequests[begin + index].get_description().c_str(),
+					       mRequests[begin + index].mIfIndex, strerror(error));
+					last_error = error;
+					failures++;
+				}
+			}
+		}
+	}
+
+	if (outstanding > 0) {
+		syslog(LOG_ERR, "NetlinkRouteManager: No ACK for %d of %d requests: %s",
+		       static_cast<int>(outstanding), static_cast<int>(count), strerror(last_error));
+		failures += static_cast<int>(outstanding);
+	}
+
+bail:
+	mStats.mFailures += failures;
+
+	if (failures != 0) {
+		errno = last_error;
+	}
+
+	return failures;
+}
+
+int
+NetlinkRouteManager::flush(void)
+{
+	return flush_until(time_ms() + kTimeoutMs);
+}
+
+int
+NetlinkRouteManager::flush_until(cms_t deadline)
+{
+	const size_t count = mRequests.size();
+	size_t begin = 0;
+	int failures = 0;
+	int last_error = 0;
+
+	if (mFD < 0) {
+		failures = static_cast<int>(count);
+		last_error = EBADF;
+		goto bail;
+	}
+
+	while (begin < count) {
+		size_t end = begin + 1;
+
+		// As many whole requests as fit in one datagram.
+		while ((end < count)
+			&& (end - begin < kMaxBatchRequests)
+			&& (((end + 1 < count) ? mQueueOffsets[end + 1] : mQueue.size()) - mQueueOffsets[begin] <= kMaxBatchSize)
+		) {
+			end++;
+		}
+
+		if (send_batch(begin, end, mQueueOffsets[begin], (end < count) ? mQueueOffsets[end] : mQueue.size(), deadline) != 0) {
+			last_error = errno;
+			failures++;
+		}
+
+		begin = end;
+	}
+
+bail:
+	mQueue.clear();
+	mQueueOffsets.clear();
+	mRequests.clear();
+
+	if (failures != 0) {
+		errno = last_error;
+		return -1;
+	}
+
+	return 0;
+}
+
+// Reads a whole dump of `type` into `messages`, back to back.
+int
+NetlinkRouteManager::dump(uint16_t type, std::vector<uint8_t>& messages, cms_t deadline)
+{
+	std::vector<uint8_t> request;
+	std::vector<uint8_t> buffer(kDumpBufferSize);
+	struct nlmsghdr header;
+	const uint32_t seq = mNextSeq++;
+	bool done = false;
+	int ret = -1;
+
+	messages.clear();
+
+	memset(&header, 0, sizeof(header));
+	header.nlmsg_type = type;
+	header.nlmsg_flags = NLM_F_REQUEST | NLM_F_DUMP;
+	header.nlmsg_seq = seq;
+
+	append_bytes(request, &header, sizeof(header), NLMSG_HDRLEN);
+
+	if (type == RTM_GETADDR) {
+		struct ifaddrmsg ifa;
+
+		memset(&ifa, 0, sizeof(ifa));
+		ifa.ifa_family = AF_INET6;
+		append_bytes(request, &ifa, sizeof(ifa), NLMSG_ALIGN(sizeof(ifa)));
+	} else {
+		struct rtmsg rtm;
+
+		memset(&rtm, 0, sizeof(rtm));
+		rtm.rtm_family = AF_INET6;
+		append_bytes(request, &rtm, sizeof(rtm), NLMSG_ALIGN(sizeof(rtm)));
+	}
+
+	header.nlmsg_len = static_cast<uint32_t>(request.size());
+	memcpy(&request[0], &header, sizeof(header));
+
+	require_string(mFD >= 0, bail, "NetlinkRouteManager: not open");
+
+	require_string(send(mFD, &request[0], request.size(), 0) >= 0, bail, strerror(errno));
+
+	mStats.mDumps++;
+
+	while (!done) {
+		ssize_t len = recv(mFD, &buffer[0], buffer.size(), MSG_DONTWAIT);
+		const struct nlmsghdr* nlh;
+
+		if (len < 0) {
+			if (errno == EAGAIN) {
+				if (!wait_readable(deadline)) {
+					errno = ETIMEDOUT;
+					goto bail;
+				}
+				continue;
+			}
+			if (errno == EINTR) {
+				continue;
+			}
+			goto bail;
+		}
+
+		nlh = reinterpret_cast<const struct nlmsghdr*>(&buffer[0]);
+
+		for (int remaining = static_cast<int>(len); NLMSG_OK(nlh, remaining); nlh = NLMSG_NEXT(nlh, remaining)) {
+			if (nlh->nlmsg_seq != seq) {
+				continue;
+			}
+
+			if (nlh->nlmsg_type == NLMSG_DONE) {
+				done = true;
+				break;
+			}
+
+			if (nlh->nlmsg_type == NLMSG_ERROR) {
+				const struct nlmsgerr* err = reinterpret_cast<const struct nlmsgerr*>(NLMSG_DATA(nlh));
+
+				errno = -err->error;
+				goto bail;
+			}
+
+			if ((nlh->nlmsg_flags & NLM_F_DUMP_INTR) != 0) {
+				// Changed while being dumped; the caller can try again.
+				errno = EAGAIN;
+				goto bail;
+			}
+
+			messages.insert(messages.end(),
+				reinterpret_cast<const uint8_t*>(nlh),
+				reinterpret_cast<const uint8_t*>(nlh) + NLMSG_ALIGN(nlh->nlmsg_len));
+		}
+	}
+
+	ret = 0;
+
+bail:
+	return ret;
+}
+
+int
+NetlinkRouteManager::reconcile(int ifindex, const std::set<Address>& addresses, const std::set<Route>& routes)
+{
+	std::set<Address> missing_addresses(addresses);
+	std::set<Route> missing_routes(routes);
+	std::vector<Route> extra_routes;
+	std::vector<uint8_t> messages;
+	const struct nlmsghdr* nlh;
+	const cms_t deadline = time_ms() + kTimeoutMs;
+	int len;
+	int changes = -1;
+
+	// Addresses
+
+	require_noerr(dump(RTM_GETADDR, messages, deadline), bail);
+
+	nlh = reinterpret_cast<const struct nlmsghdr*>(messages.data());
+	for (len = static_cast<int>(messages.size()); NLMSG_OK(nlh, len); nlh = NLMSG_NEXT(nlh, len)) {
+		const struct ifaddrmsg* ifa = reinterpret_cast<const struct ifaddrmsg*>(NLMSG_DATA(nlh));
+		const struct rtattr* rta = IFA_RTA(ifa);
+		int rta_len = IFA_PAYLOAD(nlh);
+
+		if ((nlh->nlmsg_type != RTM_NEWADDR) || (ifa->ifa_family != AF_INET6)
+			|| (static_cast<int>(ifa->ifa_index) != ifindex)
+		) {
+			continue;
+		}
+
+		for (; RTA_OK(rta, rta_len); rta = RTA_NEXT(rta, rta_len)) {
+			if ((rta->rta_type == IFA_ADDRESS) && (RTA_PAYLOAD(rta) >= sizeof(struct in6_addr))) {
+				struct in6_addr address;
+
+				memcpy(&address, RTA_DATA(rta), sizeof(address));
+				missing_addresses.erase(Address(address, ifa->ifa_prefixlen));
+			}
+		}
+	}
+
+	// Routes
+
+	require_noerr(dump(RTM_GETROUTE, messages, deadline), bail);
+
+	nlh = reinterpret_cast<const struct nlmsghdr*>(messages.data());
+	for (len = static_cast<int>(messages.size()); NLMSG_OK(nlh, len); nlh = NLMSG_NEXT(nlh, len)) {
+		const struct rtmsg* rtm = reinterpret_cast<const struct rtmsg*>(NLMSG_DATA(nlh));
+		const struct rtattr* rta = RTM_RTA(rtm);
+		int rta_len = RTM_PAYLOAD(nlh);
+		struct in6_addr prefix;
+		uint32_t table = rtm->rtm_table;
+		uint32_t oif = 0;
+		uint32_t metric = 0;
+
+		if ((nlh->nlmsg_type != RTM_NEWROUTE) || (rtm->rtm_family != AF_INET6)
+			|| (rtm->rtm_type != RTN_UNICAST)
+		) {
+			continue;
+		}
+
+		memset(&prefix, 0, sizeof(prefix));
+
+		for (; RTA_OK(rta, rta_len); rta = RTA_NEXT(rta, rta_len)) {
+			switch (rta->rta_type) {
+			case RTA_DST:
+				if (RTA_PAYLOAD(rta) >= sizeof(prefix)) {
+					memcpy(&prefix, RTA_DATA(rta), sizeof(prefix));
+				}
+				break;
+			case RTA_OIF:
+				memcpy(&oif, RTA_DATA(rta), sizeof(oif));
+				break;
+			case RTA_PRIORITY:
+				memcpy(&metric, RTA_DATA(rta), sizeof(metric));
+				break;
+			case RTA_TABLE:
+				memcpy(&table, RTA_DATA(rta), sizeof(table));
+				break;
+			default:
+				break;
+			}
+		}
+
+		if ((table != RT_TABLE_MAIN) || (static_cast<int>(oif) != ifindex)) {
+			continue;
+		}
+
+		// Any route that is wanted will do, whoever added it. Only
+		// ours are taken away.
+		Route route(prefix, rtm->rtm_dst_len, metric);
+
+		if ((missing_routes.erase(route) == 0) && (rtm->rtm_protocol == kRouteProtocol)) {
+			extra_routes.push_back(route);
+		}
+	}
+
+	for (std::vector<Route>::iterator iter = extra_routes.begin(); iter != extra_routes.end(); ++iter) {
+		remove_route(ifindex, iter->mPrefix, iter->mPrefixLen, iter->mMetric);
+	}
+
+	for (std::set<Route>::iterator iter = missing_routes.begin(); iter != missing_routes.end(); ++iter) {
+		add_route(ifindex, iter->mPrefix, iter->mPrefixLen, iter->mMetric);
+	}
+
+	for (std::set<Address>::iterator iter = missing_addresses.begin(); iter != missing_addresses.end(); ++iter) {
+		add_address(ifindex, iter->mAddress, iter->mPrefixLen);
+	}
+
+	changes = get_pending_count();
+
+	if (changes != 0) {
+		syslog(LOG_INFO, "NetlinkRouteManager: Interface %d: adding %d addresses and %d routes, removing %d routes",
+		       ifindex, static_cast<int>(missing_addresses.size()), static_cast<int>(missing_routes.size()),
+		       static_cast<int>(extra_routes.size()));
+	}
+
+	require_noerr_action(flush_until(deadline), bail, changes = -1);
+
+bail:
+	return changes;
+}
+
+#else // ----------------------------------------------------------------------
+
+std::string
+NetlinkRouteManager::Request::get_description(void) const
+{
+	return std::string();
+}
+
+int
+NetlinkRouteManager::open(void)
+{
+	errno = ENOTSUP;
+	return -1;
+}
+
+int
+NetlinkRouteManager::open(int fd)
+{
+	close(fd);
+	errno = ENOTSUP;
+	return -1;
+}
+
+void
+NetlinkRouteManager::add_address(int ifindex, const struct in6_addr& address, uint8_t prefix_len)
+{
+}
+
+void
+NetlinkRouteManager::remove_address(int ifindex, const struct in6_addr& address, uint8_t prefix_len)
+{
+}
+
+void
+NetlinkRouteManager::add_route(int ifindex, const struct in6_addr& prefix, uint8_t prefix_len, uint32_t metric)
+{
+}
+
+void
+NetlinkRouteManager::remove_route(int ifindex, const struct in6_addr& prefix, uint8_t prefix_len, uint32_t metric)
+{
+}
+
+int
+NetlinkRouteManager::flush(void)
+{
+	return 0;
+}
+
+int
+NetlinkRouteManager::reconcile(int ifindex, const std::set<Address>& addresses, const std::set<Route>& routes)
+{
+	errno = ENOTSUP;
+	return -1;
+}
+
+#endif // ---------------------------------------------------------------------
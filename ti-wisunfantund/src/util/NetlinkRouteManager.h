@@ -0,0 +1,190 @@
+/*
+ *
+ * Copyright (c) 2026 Texas Instruments
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *    Description:
+ *      This file declares a helper which programs IPv6 addresses and
+ *      routes through rtnetlink, many requests to a send.
+ *
+ */
+
+#ifndef __wpantund__NetlinkRouteManager__
+#define __wpantund__NetlinkRouteManager__
+
+#include <stdint.h>
+#include <string.h>
+#include <netinet/in.h>
+#include <set>
+#include <string>
+#include <vector>
+#include "time-utils.h"
+
+// Queues address and route requests and hands them to the kernel in as
+// few `send()`s as they fit in. Every request asks for an ACK, and the
+// ACKs are matched back to their requests by sequence number, so a
+// failure is still reported against the entry that caused it.
+//
+// Routes are added with their own protocol number (`kRouteProtocol`),
+// which is how `reconcile()` tells the routes it is responsible for
+// apart from everyone else's.
+//
+// The kernel handles rtnetlink requests inside `send()`, so their ACKs
+// (and the parts of a dump) are normally queued before we look for
+// them. A wait only happens when something went wrong, and everything a
+// call to `flush()` or `reconcile()` waits for is bounded by
+// `kTimeoutMs` overall. Those calls are made from the main loop.
+//
+// Only available on Linux; elsewhere `open()` fails and callers are
+// expected to fall back to `netif-mgmt`.
+class NetlinkRouteManager
+{
+public:
+	struct Address {
+		struct in6_addr mAddress;
+		uint8_t mPrefixLen;
+
+		Address(const struct in6_addr& address, uint8_t prefix_len)
+			: mAddress(address), mPrefixLen(prefix_len) { }
+
+		bool operator<(const Address& other) const {
+			int ret = memcmp(&mAddress, &other.mAddress, sizeof(mAddress));
+			return (ret != 0) ? (ret < 0) : (mPrefixLen < other.mPrefixLen);
+		}
+	};
+
+	// The prefix is stored with the bits past `mPrefixLen` cleared, as
+	// the kernel reports it.
+	struct Route {
+		struct in6_addr mPrefix;
+		uint8_t mPrefixLen;
+		uint32_t mMetric;
+
+		Route(const struct in6_addr& prefix, uint8_t prefix_len, uint32_t metric);
+
+		bool operator<(const Route& other) const {
+			int ret = memcmp(&mPrefix, &other.mPrefix, sizeof(mPrefix));
+			if (ret != 0) {
+				return ret < 0;
+			}
+			if (mPrefixLen != other.mPrefixLen) {
+				return mPrefixLen < other.mPrefixLen;
+			}
+			return mMetric < other.mMetric;
+		}
+	};
+
+	struct Stats {
+		uint32_t mRequests;       // Requests sent
+		uint32_t mSends;          // Datagrams they were sent in
+		uint32_t mFailures;       // Requests the kernel refused
+		uint32_t mDumps;          // Dumps read by `reconcile()`
+	};
+
+	enum {
+		// Our own `rtm_protocol`, from the range left for routing daemons.
+		kRouteProtocol = 0x57,
+
+		// The longest `flush()` or `reconcile()` waits for the kernel.
+		kTimeoutMs = 250,
+	};
+
+	NetlinkRouteManager();
+	~NetlinkRouteManager();
+
+	// Opens the rtnetlink socket. Returns 0, or -1 with `errno` set.
+	int open(void);
+
+	// Uses `fd`, a datagram socket standing in for the rtnetlink one,
+	// which is then closed along with the manager. Lets tests play
+	// the kernel on the other end of a socket pair.
+	int open(int fd);
+	bool is_open(void) const;
+
+	// Queue a request. Nothing is sent until `flush()`. Adding what is
+	// already there and removing what is already gone are not failures.
+	void add_address(int ifindex, const struct in6_addr& address, uint8_t prefix_len);
+	void remove_address(int ifindex, const struct in6_addr& address, uint8_t prefix_len);
+	void add_route(int ifindex, const struct in6_addr& prefix, uint8_t prefix_len, uint32_t metric);
+	void remove_route(int ifindex, const struct in6_addr& prefix, uint8_t prefix_len, uint32_t metric);
+
+	// Number of requests queued and not flushed yet.
+	int get_pending_count(void) const;
+
+	// Sends everything queued and waits for each request to be
+	// acknowledged. Returns 0 if all of them succeeded, otherwise -1
+	// with `errno` set to the last failure. Requests not acknowledged
+	// within `kTimeoutMs` fail with ETIMEDOUT.
+	int flush(void);
+
+	// Dumps the kernel's IPv6 addresses and routes on `ifindex` and
+	// makes it match:
+	//
+	//  - Addresses in `addresses` which are missing are added. Addresses
+	//    are never removed: the kernel, the user and wfantund all add
+	//    them, and the kernel's view is adopted by wfantund anyway.
+	//  - Routes in `routes` which are missing, or there with another
+	//    metric, are added, and routes of ours not in `routes` are
+	//    removed. Other routes are left alone.
+	//
+	// Returns the number of changes made, or -1 with `errno` set. Waits
+	// no more than `kTimeoutMs` in all.
+	int reconcile(int ifindex, const std::set<Address>& addresses, const std::set<Route>& routes);
+
+	Stats get_stats(void) const;
+
+private:
+	struct Request {
+		uint32_t mSeq;
+		uint16_t mType;
+		int mIfIndex;
+		struct in6_addr mPrefix;
+		uint8_t mPrefixLen;
+		uint32_t mMetric;
+
+		std::string get_description(void) const;
+	};
+
+	enum {
+		// A datagram is kept well under the default socket send buffer,
+		// which is the most the kernel takes at once, and to as many
+		// requests as there is room for ACKs in our receive buffer.
+		kMaxBatchSize = 32 * 1024,
+		kMaxBatchRequests = 128,
+
+		kRecvBatch = 32,
+		kAckBufferSize = 512,
+		kDumpBufferSize = 32 * 1024,
+	};
+
+	void queue_request(uint16_t type, int ifindex, const struct in6_addr& prefix, uint8_t prefix_len, uint32_t metric);
+	bool wait_readable(cms_t deadline);
+	int send_batch(size_t begin, size_t end, size_t byte_begin, size_t byte_end, cms_t deadline);
+	int flush_until(cms_t deadline);
+	int dump(uint16_t type, std::vector<uint8_t>& messages, cms_t deadline);
+
+	int mFD;
+	uint32_t mNextSeq;
+
+	// Requests waiting for `flush()`, back to back, as they are sent,
+	// and what each one was (in the same order).
+	std::vector<uint8_t> mQueue;
+	std::vector<size_t> mQueueOffsets;
+	std::vector<Request> mRequests;
+
+	Stats mStats;
+};
+
+#endif // defined(__wpantund__NetlinkRouteManager__)
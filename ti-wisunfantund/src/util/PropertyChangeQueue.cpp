@@ -0,0 +1,108 @@
+/*
+ *
+ * Copyright (c) 2026 Texas Instruments
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *    Description:
+ *      Implementation of the property change queue.
+ *
+ */
+
+#if HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include "PropertyChangeQueue.h"
+
+using namespace nl;
+
+PropertyChangeQueue::Stats PropertyChangeQueue::sTotals;
+
+PropertyChangeQueue::PropertyChangeQueue(cms_t interval, int batch_size)
+	: mLastFlush(0)
+	, mHasFlushed(false)
+{
+	set_interval(interval);
+	set_batch_size(batch_size);
+}
+
+PropertyChangeQueue::~PropertyChangeQueue()
+{
+	drop();
+}
+
+bool
+PropertyChangeQueue::queue(const std::string& key, const boost::any& value)
+{
+	ValueMap::iterator iter = mPending.find(key);
+
+	sTotals.mQueued++;
+
+	if (iter == mPending.end()) {
+		mPending[key] = value;
+	} else {
+		iter->second = value;
+		sTotals.mMerged++;
+	}
+
+	return is_due();
+}
+
+cms_t
+PropertyChangeQueue::get_ms_to_flush(void) const
+{
+	cms_t ret = 0;
+
+	if (mPending.empty()) {
+		ret = CMS_DISTANT_FUTURE;
+
+	} else if ((mBatchSize != 0) && (mPending.size() >= static_cast<size_t>(mBatchSize))) {
+		ret = 0;
+
+	} else if (mHasFlushed) {
+		ret = mInterval - CMS_SINCE(mLastFlush);
+
+		if (ret < 0) {
+			ret = 0;
+		}
+	}
+
+	return ret;
+}
+
+void
+PropertyChangeQueue::flush(ValueMap& values)
+{
+	values.clear();
+	values.swap(mPending);
+
+	mLastFlush = time_ms();
+	mHasFlushed = true;
+	sTotals.mSignals++;
+}
+
+void
+PropertyChangeQueue::drop(void)
+{
+	sTotals.mDropped += static_cast<uint32_t>(mPending.size());
+	mPending.clear();
+}
+
+void
+PropertyChangeQueue::did_fail_to_send(int count)
+{
+	sTotals.mDropped += static_cast<uint32_t>(count);
+	sTotals.mSignals--;
+}
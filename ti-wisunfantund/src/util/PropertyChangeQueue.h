@@ -0,0 +1,97 @@
+/*
+ *
+ * Copyright (c) 2026 Texas Instruments
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *    Description:
+ *      This file declares a queue which coalesces property changes
+ *      so they can be signaled in batches.
+ *
+ */
+
+#ifndef __wpantund__PropertyChangeQueue__
+#define __wpantund__PropertyChangeQueue__
+
+#include <stdint.h>
+#include <string>
+#include <boost/any.hpp>
+
+#include "ValueMap.h"
+#include "time-utils.h"
+
+namespace nl {
+
+// Holds the latest value of every property changed since the last flush.
+// A change to a property which is still pending replaces the pending
+// value. The queue is due once `interval` ms have passed since the last
+// flush (the first change after a quiet period is due right away), or
+// as soon as `batch_size` distinct properties are pending.
+class PropertyChangeQueue {
+public:
+	struct Stats {
+		uint32_t mQueued;       // Changes queued
+		uint32_t mMerged;       // Changes which replaced a pending value
+		uint32_t mSignals;      // Batches flushed
+		uint32_t mDropped;      // Changes thrown away without being sent
+	};
+
+public:
+	// `batch_size` of zero means no limit.
+	PropertyChangeQueue(cms_t interval = 0, int batch_size = 0);
+
+	// Drops whatever is still pending.
+	~PropertyChangeQueue();
+
+	void set_interval(cms_t interval) { mInterval = (interval > 0) ? interval : 0; }
+	cms_t get_interval(void) const { return mInterval; }
+
+	void set_batch_size(int batch_size) { mBatchSize = (batch_size > 0) ? batch_size : 0; }
+	int get_batch_size(void) const { return mBatchSize; }
+
+	// Queues a change. Returns true if the queue is now due.
+	bool queue(const std::string& key, const boost::any& value);
+
+	bool empty(void) const { return mPending.empty(); }
+	bool is_due(void) const { return get_ms_to_flush() == 0; }
+
+	// Time until the queue is due, or `CMS_DISTANT_FUTURE` if empty.
+	cms_t get_ms_to_flush(void) const;
+
+	// Moves the pending values into `values` and restarts the interval.
+	void flush(ValueMap& values);
+
+	// Throws away the pending values, counting them as dropped.
+	void drop(void);
+
+	// Counts `count` flushed changes as lost (the signal carrying them
+	// could not be sent).
+	void did_fail_to_send(int count);
+
+	// Totals across every queue of the daemon.
+	static Stats get_totals(void) { return sTotals; }
+
+private:
+	ValueMap mPending;
+	cms_t mInterval;
+	int mBatchSize;
+	cms_t mLastFlush;
+	bool mHasFlushed;
+
+	static Stats sTotals;
+};
+
+}; // namespace nl
+
+#endif // defined(__wpantund__PropertyChangeQueue__)
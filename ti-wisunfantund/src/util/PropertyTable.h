@@ -0,0 +1,215 @@
+/*
+ *
+ * Copyright (c) 2026 Texas Instruments
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *    Description:
+ *      A table keyed by case-insensitive property names.
+ *
+ */
+
+#ifndef wpantund_PropertyTable_h
+#define wpantund_PropertyTable_h
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+namespace nl {
+
+// Maps property names, compared without regard to ASCII case, to values.
+// Meant to be filled once at startup and then only looked up: lookups go
+// through an open addressing (linear probing) hash index and never
+// allocate, whatever the case of the key. Keys are hashed and compared
+// eight bytes at a time, folding the case of the whole word at once.
+//
+// Every key is given a handle, its index in the table, when inserted.
+// Handles stay valid for the life of the table, so a caller which reads
+// the same property over and over can resolve it once with `find()` and
+// then go straight to the value with `at()`.
+template <typename V>
+class PropertyTable
+{
+public:
+	typedef V value_type;
+	typedef int size_type;
+	typedef int handle_type;
+
+	static const handle_type kInvalidHandle = -1;
+
+public:
+	PropertyTable()
+		: mBuckets(16, kInvalidHandle)
+	{
+	}
+
+	size_type size(void) const { return static_cast<size_type>(mEntries.size()); }
+	bool empty(void) const { return mEntries.empty(); }
+
+	// Adds `key`, or replaces its value if it is already there. Returns
+	// its handle. May move the values around, so references obtained
+	// from `at()` do not survive it.
+	handle_type insert(const std::string& key, const value_type& value)
+	{
+		uint32_t hash = hash_key(key.data(), key.size());
+		size_t bucket = find_bucket(key.data(), key.size(), hash);
+		handle_type handle = mBuckets[bucket];
+
+		if (handle != kInvalidHandle) {
+			mEntries[handle].mValue = value;
+			return handle;
+		}
+
+		handle = static_cast<handle_type>(mEntries.size());
+		mEntries.push_back(Entry(key, hash, value));
+		mBuckets[bucket] = handle;
+
+		// Keep the load factor at or below one half.
+		if (mEntries.size() * 2 > mBuckets.size()) {
+			rehash(mBuckets.size() * 2);
+		}
+
+		return handle;
+	}
+
+	// Returns the handle of `key`, or `kInvalidHandle`.
+	handle_type find(const char* key, size_t len) const
+	{
+		return mBuckets[find_bucket(key, len, hash_key(key, len))];
+	}
+
+	handle_type find(const std::string& key) const
+	{
+		return find(key.data(), key.size());
+	}
+
+	value_type& at(handle_type handle) { return mEntries[handle].mValue; }
+	const value_type& at(handle_type handle) const { return mEntries[handle].mValue; }
+
+	// The key as it was first inserted.
+	const std::string& key_at(handle_type handle) const { return mEntries[handle].mKey; }
+
+private:
+	struct Entry
+	{
+		Entry(const std::string& key, uint32_t hash, const value_type& value)
+			: mKey(key), mHash(hash), mValue(value) {}
+
+		std::string mKey;
+		uint32_t mHash;
+		value_type mValue;
+	};
+
+	// Loads up to eight bytes of `key` (zero padded) with ASCII lower
+	// case letters turned to upper case, all eight bytes at once.
+	static uint64_t load_folded(const char* key, size_t len)
+	{
+		static const uint64_t kOnes = 0x0101010101010101ull;
+		uint64_t word = 0;
+		uint64_t heptets, at_least_a, above_z, is_lower;
+
+		if (len >= 8) {
+			memcpy(&word, key, 8);
+		} else {
+			// A fixed size copy is inlined, a variable one is not.
+			for (size_t i = 0; i < len; i++) {
+				word |= static_cast<uint64_t>(static_cast<uint8_t>(key[i])) << (8 * i);
+			}
+		}
+
+		heptets = word & (0x7F * kOnes);
+		at_least_a = heptets + ((0x80 - 'a') * kOnes);
+		above_z = heptets + ((0x80 - 'z' - 1) * kOnes);
+		is_lower = at_least_a & ~above_z & ~word & (0x80 * kOnes);
+
+		return word - (is_lower >> 2);
+	}
+
+	static uint32_t hash_key(const char* key, size_t len)
+	{
+		uint64_t hash = len * 0x9E3779B97F4A7C15ull;
+
+		for (size_t i = 0; i < len; i += 8) {
+			hash = (hash ^ load_folded(key + i, len - i)) * 0x9E3779B97F4A7C15ull;
+		}
+
+		return static_cast<uint32_t>(hash ^ (hash >> 32));
+	}
+
+	static bool keys_match(const std::string& a, const char* b, size_t len)
+	{
+		if (a.size() != len) {
+			return false;
+		}
+
+		for (size_t i = 0; i < len; i += 8) {
+			if (load_folded(a.data() + i, len - i) != load_folded(b + i, len - i)) {
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	size_t mask(void) const
+	{
+		return mBuckets.size() - 1;
+	}
+
+	// Returns the bucket holding `key`, or the empty bucket where it
+	// would go. The index is never full, so this always terminates.
+	size_t find_bucket(const char* key, size_t len, uint32_t hash) const
+	{
+		size_t bucket = hash & mask();
+
+		while (mBuckets[bucket] != kInvalidHandle) {
+			const Entry& entry = mEntries[mBuckets[bucket]];
+
+			if ((entry.mHash == hash) && keys_match(entry.mKey, key, len)) {
+				break;
+			}
+			bucket = (bucket + 1) & mask();
+		}
+
+		return bucket;
+	}
+
+	void rehash(size_t bucket_count)
+	{
+		mBuckets.assign(bucket_count, kInvalidHandle);
+
+		for (size_t i = 0; i < mEntries.size(); i++) {
+			size_t bucket = mEntries[i].mHash & mask();
+
+			while (mBuckets[bucket] != kInvalidHandle) {
+				bucket = (bucket + 1) & mask();
+			}
+
+			mBuckets[bucket] = static_cast<handle_type>(i);
+		}
+	}
+
+	std::vector<Entry> mEntries;
+	std::vector<handle_type> mBuckets;
+};
+
+template <typename V>
+const typename PropertyTable<V>::handle_type PropertyTable<V>::kInvalidHandle;
+
+}; // namespace nl
+
+#endif // wpantund_PropertyTable_h
@@ -16,7 +16,8 @@
  * limitations under the License.
  *
  *    Description:
- *      Ring-buffer implementation (not thread-safe)
+ *      Ring-buffer implementations: a general one (not thread-safe)
+ *      and a byte-oriented one shared by exactly two threads.
  *
  */
 
@@ -24,11 +25,19 @@
 #define wpantund_RingBuffer_h
 
 #include <stdint.h>
+#include <string.h>
+#include <atomic>
 #include <stdexcept>
+#include <type_traits>
 
 namespace nl {
 
 // NOTE: The below implementation of RingBuffer<> is NOT thread-safe.
+//
+// Any capacity `I` works. When it is a power of two the indices wrap with
+// a mask, otherwise with a compare and subtract; either way there is no
+// division. Bulk `push()`/`pull()` copy at most two contiguous runs, with
+// memcpy when `T` is trivially copyable.
 
 template <typename T = uint8_t, int I = 512>
 class RingBuffer
@@ -40,6 +49,8 @@ public:
 
 	static const size_type buffer_size = I;
 
+	static_assert(I > 0, "RingBuffer size must be positive");
+
 public:
 
 	RingBuffer()
@@ -72,20 +83,45 @@ public:
 		return buffer_size;
 	}
 
+	// The first contiguous run of elements at the front, for handing
+	// straight to `write()` and friends. Follow with `pop()` for however
+	// many were used. If the data wraps, the rest is only reachable after
+	// that pop.
 	const value_type* data_ptr()const {
 		return &mBuffer[mReadIdx];
 	}
 
 	size_type size_of_data_ptr()const {
-		size_type ret;
+		size_type ret = buffer_size - mReadIdx;
 
-		if (mWriteIdx >= mReadIdx) {
-			ret = mWriteIdx - mReadIdx;
-		} else {
-			ret = buffer_size - mReadIdx;
+		return (mCount < ret) ? mCount : ret;
+	}
+
+	// The first contiguous run of free space at the back, for reading
+	// straight into. Follow with `commit()` for however many elements were
+	// filled in.
+	value_type* write_ptr() {
+		return &mBuffer[mWriteIdx];
+	}
+
+	size_type size_of_write_ptr()const {
+		size_type ret = buffer_size - mWriteIdx;
+
+		return (space_available() < ret) ? space_available() : ret;
+	}
+
+	// Appends `value_count` elements already placed at `write_ptr()`.
+	template <typename S> void
+	commit(S value_count)
+	{
+		const size_type count = static_cast<size_type>(value_count);
+
+		if (size_of_write_ptr() < count) {
+			throw std::overflow_error("commit past end of ring buffer write span");
 		}
 
-		return ret;
+		mWriteIdx = wrap(mWriteIdx + count);
+		mCount += count;
 	}
 
 	template <typename S> void
@@ -95,12 +131,31 @@ public:
 			throw std::overflow_error("not enough room in ring buffer");
 		}
 
-		while(value_count--) {
-			mBuffer[mWriteIdx] = *values++;
-			mWriteIdx++;
-			mWriteIdx %= buffer_size; // Should be optimized by compiler as a mask
-			mCount++;
+		copy_in(values, static_cast<size_type>(value_count));
+	}
+
+	// Like `push()`, but when there isn't room, makes it by dropping the
+	// oldest elements. If more than `buffer_size` elements are given, only
+	// the last `buffer_size` of them are kept. Returns how many elements
+	// were dropped from the buffer.
+	template <typename S> size_type
+	force_push(const value_type* values, S value_count)
+	{
+		size_type count = static_cast<size_type>(value_count);
+		size_type dropped = 0;
+
+		if (count > buffer_size) {
+			values += count - buffer_size;
+			count = buffer_size;
+		}
+
+		if (space_available() < count) {
+			dropped = pop(count - space_available());
 		}
+
+		copy_in(values, count);
+
+		return dropped;
 	}
 
 	template <typename S> size_type
@@ -108,21 +163,11 @@ public:
 	{
 		size_type bytes_read = size();
 
-		if (bytes_read < value_count) {
-			value_count = bytes_read;
-		} else {
+		if (bytes_read > value_count) {
 			bytes_read = static_cast<size_type>(value_count);
 		}
 
-		while (value_count--) {
-			mReadIdx++;
-			mReadIdx %= buffer_size; // Should be optimized by compiler as a mask
-			mCount--;
-		}
-
-		if (mReadIdx == mWriteIdx) {
-			mReadIdx = mWriteIdx = 0;
-		}
+		consume(bytes_read);
 
 		return bytes_read;
 	}
@@ -132,18 +177,12 @@ public:
 	{
 		size_type bytes_read = size();
 
-		if (bytes_read < value_count) {
-			value_count = bytes_read;
-		} else {
+		if (bytes_read > value_count) {
 			bytes_read = static_cast<size_type>(value_count);
 		}
 
-		while (value_count--) {
-			*values++ = mBuffer[mReadIdx];
-			mReadIdx++;
-			mReadIdx %= buffer_size; // Should be optimized by compiler as a mask
-			mCount--;
-		}
+		copy_out(values, bytes_read);
+		consume(bytes_read);
 
 		return bytes_read;
 	}
@@ -179,8 +218,7 @@ public:
 		}
 
 		mBuffer[mWriteIdx] = value;
-		mWriteIdx++;
-		mWriteIdx %= buffer_size;
+		mWriteIdx = wrap(mWriteIdx + 1);
 		mCount++;
 
 		return true;
@@ -191,8 +229,7 @@ public:
 	void force_write(const value_type& value)
 	{
 		mBuffer[mWriteIdx] = value;
-		mWriteIdx++;
-		mWriteIdx %= buffer_size;
+		mWriteIdx = wrap(mWriteIdx + 1);
 
 		if (mCount == buffer_size) {
 			mReadIdx = mWriteIdx;
@@ -205,7 +242,7 @@ public:
 	// is empty returns false, otherwise returns true.
 	bool read(value_type& value)
 	{
-		value_type *f = front();
+		const value_type *f = front();
 
 		if (f) {
 			value = *f;
@@ -222,8 +259,7 @@ public:
 			return false;
 		}
 
-		mReadIdx++;
-		mReadIdx %= buffer_size;
+		mReadIdx = wrap(mReadIdx + 1);
 		mCount--;
 
 		return true;
@@ -237,6 +273,66 @@ public:
 	}
 
 private:
+	// `idx` is never more than `2 * buffer_size - 1`, so a single
+	// subtraction is enough when the mask can't be used.
+	static size_type wrap(size_type idx)
+	{
+		if ((buffer_size & (buffer_size - 1)) == 0) {
+			return idx & (buffer_size - 1);
+		}
+
+		return (idx >= buffer_size) ? (idx - buffer_size) : idx;
+	}
+
+	static void copy_elements(value_type* dest, const value_type* src, size_type count, std::true_type)
+	{
+		memcpy(dest, src, count * sizeof(value_type));
+	}
+
+	static void copy_elements(value_type* dest, const value_type* src, size_type count, std::false_type)
+	{
+		while (count--) {
+			*dest++ = *src++;
+		}
+	}
+
+	static void copy_elements(value_type* dest, const value_type* src, size_type count)
+	{
+		copy_elements(dest, src, count, typename std::is_trivially_copyable<value_type>::type());
+	}
+
+	// The copies are split in two where they wrap around the end.
+	void copy_in(const value_type* values, size_type count)
+	{
+		const size_type first = (count < buffer_size - mWriteIdx) ? count : buffer_size - mWriteIdx;
+
+		copy_elements(&mBuffer[mWriteIdx], values, first);
+		copy_elements(&mBuffer[0], values + first, count - first);
+
+		mWriteIdx = wrap(mWriteIdx + count);
+		mCount += count;
+	}
+
+	void copy_out(value_type* values, size_type count) const
+	{
+		const size_type first = (count < buffer_size - mReadIdx) ? count : buffer_size - mReadIdx;
+
+		copy_elements(values, &mBuffer[mReadIdx], first);
+		copy_elements(values + first, &mBuffer[0], count - first);
+	}
+
+	void consume(size_type count)
+	{
+		mReadIdx = wrap(mReadIdx + count);
+		mCount -= count;
+
+		// Start over at the beginning when emptied, so that the spans
+		// are as long as they can be.
+		if (mCount == 0) {
+			mReadIdx = mWriteIdx = 0;
+		}
+	}
+
 	class IteratorBase
 	{
 	protected:
@@ -391,6 +487,140 @@ private:
 	value_type mBuffer[buffer_size];
 };
 
+// A ring buffer for handing data from one thread (the producer, which
+// only pushes) to one other thread (the consumer, which only pulls)
+// without locking. Elements are copied in and out in bulk, so `T` must
+// be trivially copyable. `I` must be a power of two.
+//
+// The read and write positions run freely and are masked on use. Each
+// side only ever stores its own position, with release ordering, after
+// copying, and loads the other side's with acquire ordering, so whatever
+// the producer pushed is visible to the consumer once it shows up in
+// `size()`.
+template <typename T = uint8_t, int I = 4096>
+class SpscRingBuffer
+{
+public:
+
+	typedef T value_type;
+	typedef int size_type;
+
+	static const size_type buffer_size = I;
+
+	static_assert((I > 0) && ((I & (I - 1)) == 0), "SpscRingBuffer size must be a power of two");
+	static_assert(std::is_trivially_copyable<T>::value, "SpscRingBuffer elements are copied with memcpy");
+
+public:
+
+	SpscRingBuffer() : mReadPos(0), mWritePos(0) { }
+
+	// Either side: elements waiting to be pulled. Only a lower bound
+	// for the producer and an upper bound for the consumer when the
+	// other side is busy.
+	size_type size() const
+	{
+		return static_cast<size_type>(mWritePos.load(std::memory_order_acquire) - mReadPos.load(std::memory_order_acquire));
+	}
+
+	bool empty() const
+	{
+		return size() == 0;
+	}
+
+	// Producer: room left for pushing.
+	size_type space_available() const
+	{
+		return buffer_size - static_cast<size_type>(mWritePos.load(std::memory_order_relaxed) - mReadPos.load(std::memory_order_acquire));
+	}
+
+	// Producer: appends all `count` elements and returns true, or
+	// nothing at all and returns false if they do not fit.
+	bool push(const value_type* values, size_type count)
+	{
+		const uint32_t write_pos = mWritePos.load(std::memory_order_relaxed);
+
+		if (space_available() < count) {
+			return false;
+		}
+
+		copy_in(write_pos, values, count);
+		mWritePos.store(write_pos + count, std::memory_order_release);
+
+		return true;
+	}
+
+	// Consumer: copies out up to `count` elements without removing them
+	// and returns how many were copied.
+	size_type peek(value_type* values, size_type count) const
+	{
+		const uint32_t read_pos = mReadPos.load(std::memory_order_relaxed);
+		const size_type available = static_cast<size_type>(mWritePos.load(std::memory_order_acquire) - read_pos);
+
+		if (count > available) {
+			count = available;
+		}
+
+		copy_out(read_pos, values, count);
+
+		return count;
+	}
+
+	// Consumer: removes up to `count` elements, copying them out unless
+	// `values` is NULL, and returns how many were removed.
+	size_type pull(value_type* values, size_type count)
+	{
+		const uint32_t read_pos = mReadPos.load(std::memory_order_relaxed);
+		const size_type available = static_cast<size_type>(mWritePos.load(std::memory_order_acquire) - read_pos);
+
+		if (count > available) {
+			count = available;
+		}
+
+		if (values != NULL) {
+			copy_out(read_pos, values, count);
+		}
+
+		mReadPos.store(read_pos + count, std::memory_order_release);
+
+		return count;
+	}
+
+	// Empties the buffer. Neither side may be using it meanwhile.
+	void clear()
+	{
+		mReadPos.store(0, std::memory_order_relaxed);
+		mWritePos.store(0, std::memory_order_relaxed);
+	}
+
+private:
+	static const uint32_t kMask = I - 1;
+
+	// The copies are split in two where they wrap around the end.
+	void copy_in(uint32_t pos, const value_type* values, size_type count)
+	{
+		const size_type offset = static_cast<size_type>(pos & kMask);
+		const size_type first = (count < buffer_size - offset) ? count : buffer_size - offset;
+
+		memcpy(&mBuffer[offset], values, first * sizeof(value_type));
+		memcpy(&mBuffer[0], values + first, (count - first) * sizeof(value_type));
+	}
+
+	void copy_out(uint32_t pos, value_type* values, size_type count) const
+	{
+		const size_type offset = static_cast<size_type>(pos & kMask);
+		const size_type first = (count < buffer_size - offset) ? count : buffer_size - offset;
+
+		memcpy(values, &mBuffer[offset], first * sizeof(value_type));
+		memcpy(values + first, &mBuffer[0], (count - first) * sizeof(value_type));
+	}
+
+	// Each position on its own cache line, so the two threads do not
+	// keep taking the line from each other.
+	alignas(64) std::atomic<uint32_t> mReadPos;
+	alignas(64) std::atomic<uint32_t> mWritePos;
+	alignas(64) value_type mBuffer[buffer_size];
+};
+
 }; // namespace nl
 
 #endif
@@ -98,6 +98,8 @@ TunnelIPv6Interface::TunnelIPv6Interface(const std::string& interface_name, int
 	mNetifMgmtFD(netif_mgmt_open()),
 #endif
 	mMLDMonitorFD(-1),
+	mInterfaceIndex(-1),
+	mBatchDepth(0),
 	mIsRunning(false),
 	mIsUp(false)
 {
@@ -126,6 +128,12 @@ TunnelIPv6Interface::TunnelIPv6Interface(const std::string& interface_name, int
 
 	netif_mgmt_set_mtu(mNetifMgmtFD, mInterfaceName.c_str(), mtu);
 
+	mInterfaceIndex = netif_mgmt_get_ifindex(mNetifMgmtFD, mInterfaceName.c_str());
+
+	if ((mInterfaceIndex <= 0) || (mRouteManager.open() != 0)) {
+		syslog(LOG_WARNING, "TunnelIPv6Interface: rtnetlink unavailable, using ioctls for addresses and routes");
+	}
+
 	setup_signals();
 	setup_mld_listener();
 #endif
@@ -148,6 +156,8 @@ TunnelIPv6Interface::on_link_state_changed(bool isUp, bool isRunning)
 		if (isRunning && !mIsRunning) {
 			std::map<struct in6_addr, Entry>::iterator iter;
 
+			begin_batch();
+
 			for (iter = mUnicastAddresses.begin(); iter != mUnicastAddresses.end(); ++iter) {
 				if (iter->second.mState != Entry::kWaitingToAdd) {
 					continue;
@@ -157,11 +167,17 @@ TunnelIPv6Interface::on_link_state_changed(bool isUp, bool isRunning)
 				       in6_addr_to_string(iter->first).c_str(), iter->second.mPrefixLen,
 				       mInterfaceName.c_str());
 
-				IGNORE_RETURN_VALUE(netif_mgmt_add_ipv6_address(mNetifMgmtFD, mInterfaceName.c_str(),
-				                    iter->first.s6_addr, iter->second.mPrefixLen));
+				if (mRouteManager.is_open()) {
+					mRouteManager.add_address(mInterfaceIndex, iter->first, iter->second.mPrefixLen);
+				} else {
+					IGNORE_RETURN_VALUE(netif_mgmt_add_ipv6_address(mNetifMgmtFD, mInterfaceName.c_str(),
+					                    iter->first.s6_addr, iter->second.mPrefixLen));
+				}
 				iter->second.mState = Entry::kWaitingForAddConfirm;
 			}
 
+			IGNORE_RETURN_VALUE(commit_batch());
+
 			for (iter = mPendingMulticastAddresses.begin(); iter != mPendingMulticastAddresses.end();	++iter) {
 				if (iter->second.mState != Entry::kWaitingToAdd) {
 					continue;
@@ -324,71 +340,117 @@ TunnelIPv6Interface::process(void)
 void
 TunnelIPv6Interface::processNetlinkFD(void)
 {
-	uint8_t buffer[4096];
-	ssize_t buffer_len(-1);
+	uint8_t buffers[kNetlinkRecvBatch][kNetlinkRecvBufferSize];
+	struct iovec iovecs[kNetlinkRecvBatch];
+	struct mmsghdr messages[kNetlinkRecvBatch];
+	int received;
 
-	if (mNetlinkFD >= 0) {
-		buffer_len = recv(mNetlinkFD, buffer, sizeof(buffer), 0);
+	if (mNetlinkFD < 0) {
+		return;
 	}
 
-	if (buffer_len > 0) {
-		struct nlmsghdr *nlp;
-		struct rtmsg *rtp;
-		int rta_len;
-		struct rtattr *rta;
+	for (int i = 0; i < kNetlinkRecvBatch; i++) {
+		iovecs[i].iov_base = buffers[i];
+		iovecs[i].iov_len = sizeof(buffers[i]);
+		memset(&messages[i], 0, sizeof(messages[i]));
+		messages[i].msg_hdr.msg_iov = &iovecs[i];
+		messages[i].msg_hdr.msg_iovlen = 1;
+	}
 
-		nlp = (struct nlmsghdr *)buffer;
-		for (;NLMSG_OK(nlp, buffer_len); nlp=NLMSG_NEXT(nlp, buffer_len))
-		{
-			char ifnamebuf[IF_NAMESIZE];
-			if (nlp->nlmsg_type == RTM_NEWADDR || nlp->nlmsg_type == RTM_DELADDR) {
-				struct ifaddrmsg *ifaddr = (struct ifaddrmsg *)NLMSG_DATA(nlp);
-				const char *ifname = if_indextoname(ifaddr->ifa_index, ifnamebuf);
-				struct in6_addr addr;
+	// A burst of changes (an NCP reset, a batch of our own) arrives as
+	// many datagrams; take them all now rather than one per main loop
+	// iteration.
+	do {
+		received = recvmmsg(mNetlinkFD, messages, kNetlinkRecvBatch, MSG_DONTWAIT, NULL);
+
+		if ((received < 0) && (errno == ENOBUFS)) {
+			// The socket overflowed and some notifications are lost.
+			// Addresses can't be recovered from here, but the link
+			// state can.
+			syslog(LOG_WARNING, "TunnelIPv6Interface: Missed netlink notifications for \"%s\"",
+			       mInterfaceName.c_str());
+			on_link_state_changed(is_up(), is_running());
+			received = kNetlinkRecvBatch;
+			continue;
+		}
 
-				if ((ifname == NULL) || (get_interface_name() != ifname)) {
-					continue;
-				}
+		for (int i = 0; i < received; i++) {
+			processNetlinkMessages(buffers[i], messages[i].msg_len);
+		}
+	} while (received == kNetlinkRecvBatch);
+}
+
+bool
+TunnelIPv6Interface::is_our_interface(int ifindex)
+{
+	char ifnamebuf[IF_NAMESIZE];
+	const char *ifname;
+
+	if (mInterfaceIndex > 0) {
+		return ifindex == mInterfaceIndex;
+	}
+
+	ifname = if_indextoname(ifindex, ifnamebuf);
+
+	return (ifname != NULL) && (get_interface_name() == ifname);
+}
+
+void
+TunnelIPv6Interface::processNetlinkMessages(const uint8_t* buffer, ssize_t buffer_len)
+{
+	struct nlmsghdr *nlp;
+	struct rtmsg *rtp;
+	int rta_len;
+	struct rtattr *rta;
+
+	nlp = (struct nlmsghdr *)buffer;
+	for (;NLMSG_OK(nlp, buffer_len); nlp=NLMSG_NEXT(nlp, buffer_len))
+	{
+		if (nlp->nlmsg_type == RTM_NEWADDR || nlp->nlmsg_type == RTM_DELADDR) {
+			struct ifaddrmsg *ifaddr = (struct ifaddrmsg *)NLMSG_DATA(nlp);
+			struct in6_addr addr;
 
-				// get RTNETLINK message header
-				// get start of attributes
-				rta = (struct rtattr *) IFA_RTA(ifaddr);
-
-				// get length of attributes
-				rta_len = IFA_PAYLOAD(nlp);
-
-				for(;RTA_OK(rta, rta_len); rta = RTA_NEXT(rta, rta_len)) {
-					switch(rta->rta_type) {
-					case IFA_ADDRESS:
-					case IFA_LOCAL:
-					case IFA_BROADCAST:
-					case IFA_ANYCAST:
-						memcpy(addr.s6_addr, RTA_DATA(rta), sizeof(addr));
-
-						if (nlp->nlmsg_type == RTM_NEWADDR) {
-							on_address_added(addr, ifaddr->ifa_prefixlen);
-						} else if (nlp->nlmsg_type == RTM_DELADDR) {
-							on_address_removed(addr, ifaddr->ifa_prefixlen);
-						}
-						break;
-					default:
-						break;
+			if (!is_our_interface(ifaddr->ifa_index)) {
+				continue;
+			}
+
+			// get RTNETLINK message header
+			// get start of attributes
+			rta = (struct rtattr *) IFA_RTA(ifaddr);
+
+			// get length of attributes
+			rta_len = IFA_PAYLOAD(nlp);
+
+			for(;RTA_OK(rta, rta_len); rta = RTA_NEXT(rta, rta_len)) {
+				switch(rta->rta_type) {
+				case IFA_ADDRESS:
+				case IFA_LOCAL:
+				case IFA_BROADCAST:
+				case IFA_ANYCAST:
+					memcpy(addr.s6_addr, RTA_DATA(rta), sizeof(addr));
+
+					if (nlp->nlmsg_type == RTM_NEWADDR) {
+						on_address_added(addr, ifaddr->ifa_prefixlen);
+					} else if (nlp->nlmsg_type == RTM_DELADDR) {
+						on_address_removed(addr, ifaddr->ifa_prefixlen);
 					}
+					break;
+				default:
+					break;
 				}
-			} else if (nlp->nlmsg_type == RTM_NEWLINK || nlp->nlmsg_type == RTM_DELLINK) {
-				struct ifinfomsg *ifinfo = (struct ifinfomsg *)NLMSG_DATA(nlp);
-				const char *ifname = if_indextoname(ifinfo->ifi_index, ifnamebuf);
-				bool isUp, isRunning;
+			}
+		} else if (nlp->nlmsg_type == RTM_NEWLINK || nlp->nlmsg_type == RTM_DELLINK) {
+			struct ifinfomsg *ifinfo = (struct ifinfomsg *)NLMSG_DATA(nlp);
+			bool isUp, isRunning;
 
-				if ((ifname == NULL) || (get_interface_name() != ifname)) {
-					continue;
-				}
+			if (!is_our_interface(ifinfo->ifi_index)) {
+				continue;
+			}
 
-				isUp = ((ifinfo->ifi_flags & IFF_UP) == IFF_UP);
-				isRunning = ((ifinfo->ifi_flags & IFF_RUNNING) == IFF_RUNNING);
+			isUp = ((ifinfo->ifi_flags & IFF_UP) == IFF_UP);
+			isRunning = ((ifinfo->ifi_flags & IFF_RUNNING) == IFF_RUNNING);
 
-				on_link_state_changed(isUp, isRunning);
-			}
+			on_link_state_changed(isUp, isRunning);
 		}
 	}
 }
@@ -631,11 +693,16 @@ TunnelIPv6Interface::add_address(const struct in6_addr *addr, int prefixlen)
 		syslog(LOG_INFO, "Adding address \"%s/%d\" to interface \"%s\"",
 		       in6_addr_to_string(*addr).c_str(), prefixlen, mInterfaceName.c_str());
 
-		require_noerr_action(
-			netif_mgmt_add_ipv6_address(mNetifMgmtFD, mInterfaceName.c_str(), addr->s6_addr, prefixlen),
-			bail,
-			mLastError = errno
-		);
+		if (mRouteManager.is_open()) {
+			mRouteManager.add_address(mInterfaceIndex, *addr, prefixlen);
+			require_action(flush_netlink_requests(), bail, mLastError = errno);
+		} else {
+			require_noerr_action(
+				netif_mgmt_add_ipv6_address(mNetifMgmtFD, mInterfaceName.c_str(), addr->s6_addr, prefixlen),
+				bail,
+				mLastError = errno
+			);
+		}
 		mUnicastAddresses[*addr] = Entry(Entry::kWaitingForAddConfirm, prefixlen);
 	} else {
 		mUnicastAddresses[*addr] = Entry(Entry::kWaitingToAdd, prefixlen);
@@ -658,7 +725,14 @@ TunnelIPv6Interface::remove_address(const struct in6_addr *addr, int prefixlen)
 		mUnicastAddresses.erase(*addr);
 	}
 
-	if (netif_mgmt_remove_ipv6_address(mNetifMgmtFD, mInterfaceName.c_str(), addr->s6_addr) != 0) {
+	if (mRouteManager.is_open()) {
+		mRouteManager.remove_address(mInterfaceIndex, *addr, prefixlen);
+
+		if (!flush_netlink_requests()) {
+			mLastError = errno;
+			goto bail;
+		}
+	} else if (netif_mgmt_remove_ipv6_address(mNetifMgmtFD, mInterfaceName.c_str(), addr->s6_addr) != 0) {
 		mLastError = errno;
 		goto bail;
 	}
@@ -726,7 +800,14 @@ TunnelIPv6Interface::add_route(const struct in6_addr *route, int prefixlen, uint
 {
 	bool ret = false;
 
-	if (netif_mgmt_add_ipv6_route(mNetifMgmtFD, mInterfaceName.c_str(), route->s6_addr, prefixlen, metric) != 0) {
+	if (mRouteManager.is_open()) {
+		mRouteManager.add_route(mInterfaceIndex, *route, prefixlen, metric);
+
+		if (!flush_netlink_requests()) {
+			mLastError = errno;
+			goto bail;
+		}
+	} else if (netif_mgmt_add_ipv6_route(mNetifMgmtFD, mInterfaceName.c_str(), route->s6_addr, prefixlen, metric) != 0) {
 		mLastError = errno;
 		goto bail;
 	}
@@ -744,7 +825,14 @@ TunnelIPv6Interface::remove_route(const struct in6_addr *route, int prefixlen, u
 {
 	bool ret = false;
 
-	if (netif_mgmt_remove_ipv6_route(mNetifMgmtFD, mInterfaceName.c_str(), route->s6_addr, prefixlen, metric) != 0) {
+	if (mRouteManager.is_open()) {
+		mRouteManager.remove_route(mInterfaceIndex, *route, prefixlen, metric);
+
+		if (!flush_netlink_requests()) {
+			mLastError = errno;
+			goto bail;
+		}
+	} else if (netif_mgmt_remove_ipv6_route(mNetifMgmtFD, mInterfaceName.c_str(), route->s6_addr, prefixlen, metric) != 0) {
 		mLastError = errno;
 		goto bail;
 	}
@@ -758,6 +846,62 @@ bail:
 	return ret;
 }
 
+// Sends what `mRouteManager` has queued, unless a batch is open.
+bool
+TunnelIPv6Interface::flush_netlink_requests(void)
+{
+	if (mBatchDepth > 0) {
+		return true;
+	}
+
+	return mRouteManager.flush() == 0;
+}
+
+void
+TunnelIPv6Interface::begin_batch(void)
+{
+	mBatchDepth++;
+}
+
+bool
+TunnelIPv6Interface::commit_batch(void)
+{
+	bool ret = true;
+
+	require_action(mBatchDepth > 0, bail, ret = false);
+
+	mBatchDepth--;
+
+	if (!flush_netlink_requests()) {
+		mLastError = errno;
+		ret = false;
+	}
+
+bail:
+	return ret;
+}
+
+int
+TunnelIPv6Interface::reconcile(const std::set<NetlinkRouteManager::Address>& addresses,
+                               const std::set<NetlinkRouteManager::Route>& routes)
+{
+	int ret = -1;
+
+	if (!mRouteManager.is_open()) {
+		mLastError = ENOTSUP;
+		goto bail;
+	}
+
+	ret = mRouteManager.reconcile(mInterfaceIndex, addresses, routes);
+
+	if (ret < 0) {
+		mLastError = errno;
+	}
+
+bail:
+	return ret;
+}
+
 ssize_t
 TunnelIPv6Interface::read(void* data, size_t len)
 {
@@ -26,6 +26,7 @@
 
 #include "tunnel.h"
 #include "netif-mgmt.h"
+#include "NetlinkRouteManager.h"
 #include <cstdio>
 #include <string>
 #include <errno.h>
@@ -70,6 +71,20 @@ public:
 	bool join_multicast_address(const struct in6_addr *addr);
 	bool leave_multicast_address(const struct in6_addr *addr);
 
+	// Address and route changes made between these are sent to the kernel
+	// together when the outermost batch is committed, instead of one at
+	// a time; until then they report success. Returns false if any of
+	// them failed (each failure is logged).
+	void begin_batch(void);
+	bool commit_batch(void);
+
+	// Reads the addresses and routes on the interface from the kernel
+	// and adds or removes whatever differs from `addresses` and `routes`.
+	// See `NetlinkRouteManager::reconcile()` for what is left alone.
+	// Returns the number of changes made, or -1.
+	int reconcile(const std::set<NetlinkRouteManager::Address>& addresses,
+	              const std::set<NetlinkRouteManager::Route>& routes);
+
 	virtual void reset(void);
 	virtual ssize_t write(const void* data, size_t len);
 	virtual ssize_t read(void* data, size_t len);
@@ -92,8 +107,12 @@ private:
 	void setup_mld_listener(void);
 
 	void processNetlinkFD(void);
+	void processNetlinkMessages(const uint8_t* buffer, ssize_t buffer_len);
+	bool is_our_interface(int ifindex);
 	void processMLDMonitorFD(void);
 
+	bool flush_netlink_requests(void);
+
 	void on_link_state_changed(bool isUp, bool isRunning);
 	void on_address_added(const struct in6_addr &address, uint8_t prefix_len);
 	void on_multicast_address_joined(const struct in6_addr &address);
@@ -108,6 +127,12 @@ private:
 	int mNetifMgmtFD;
 	int mMLDMonitorFD;
 
+	// Addresses and routes go through this when it could be opened,
+	// otherwise through `netif-mgmt`.
+	NetlinkRouteManager mRouteManager;
+	int mInterfaceIndex;
+	int mBatchDepth;
+
 	bool mIsRunning;
 	bool mIsUp;
 
@@ -126,6 +151,11 @@ private:
 	std::map<struct in6_addr, Entry> mUnicastAddresses;
 	std::map<struct in6_addr, Entry> mPendingMulticastAddresses;
 
+	enum {
+		kNetlinkRecvBatch = 8,
+		kNetlinkRecvBufferSize = 4096,
+	};
+
 	enum {
 		kICMPv6MLDv2Type = 143,
 		kICMPv6MLDv2RecordChangeToExcludeType = 3,
@@ -268,6 +268,18 @@ std::string any_to_string(const boost::any& value)
 		} else {
 			ret = "{ }";
 		}
+	} else if (value.type() == typeid(std::list<nl::Data>)) {
+		std::list<nl::Data> l = boost::any_cast<std::list<nl::Data> >(value);
+		if (!l.empty()) {
+			std::list<nl::Data>::const_iterator iter;
+			ret = "{\n";
+			for (iter = l.begin(); iter != l.end(); ++iter) {
+				ret += "\t[" + any_to_string(*iter) + "]\n";
+			}
+			ret += "}";
+		} else {
+			ret = "{ }";
+		}
 	} else if (value.type() == typeid(struct in6_addr)) {
 		struct in6_addr addr = boost::any_cast<struct in6_addr>(value);
 		ret = in6_addr_to_string(addr);
@@ -0,0 +1,70 @@
+/*
+ *
+ * Copyright (c) 2026 Texas Instruments
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *    Description:
+ *      Layout of the frame trace dumps written by the daemon and read
+ *      back by `wfanctl trace`.
+ *
+ */
+
+#ifndef wpantund_frame_trace_h
+#define wpantund_frame_trace_h
+
+// A dump is a header followed by `count` records, oldest first. Every
+// integer is little-endian.
+//
+// Header:
+//   0  magic "WFTR"
+//   4  format version (uint8)
+//   5  record length (uint8)
+//   6  reserved (uint16)
+//   8  record count (uint32)
+//  12  monotonic time of the dump, in microseconds (uint64)
+//  20  wall clock time of the dump, in microseconds since the epoch (uint64)
+//
+// Record:
+//   0  monotonic time the frame was seen, in microseconds (uint64)
+//   8  spinel command (uint32)
+//  12  spinel property key, if FRAME_TRACE_FLAG_HAS_KEY (uint32)
+//  16  length of the whole frame (uint16)
+//  18  direction (uint8)
+//  19  transaction ID (uint8)
+//  20  flags (uint8)
+//  21  number of payload bytes kept (uint8)
+//  22  first bytes of the value (or of the command payload if there is
+//      no key), zero padded to FRAME_TRACE_PAYLOAD_MAX
+
+#define FRAME_TRACE_MAGIC               "WFTR"
+#define FRAME_TRACE_VERSION             1
+#define FRAME_TRACE_HEADER_LEN          28
+#define FRAME_TRACE_PAYLOAD_MAX         32
+#define FRAME_TRACE_RECORD_LEN          (22 + FRAME_TRACE_PAYLOAD_MAX)
+
+#define FRAME_TRACE_DIRECTION_TO_NCP    0
+#define FRAME_TRACE_DIRECTION_FROM_NCP  1
+
+#define FRAME_TRACE_FLAG_HAS_KEY        (1 << 0)
+#define FRAME_TRACE_FLAG_REDACTED       (1 << 1)   // Value withheld, it holds key material
+
+// Where the daemon writes the trace when sent SIGUSR1, unless set
+// otherwise by `Config:Daemon:FrameTracePath`. Empty by default, so
+// nothing is written until a path the daemon owns is configured.
+#ifndef FRAME_TRACE_DEFAULT_DUMP_PATH
+#define FRAME_TRACE_DEFAULT_DUMP_PATH   ""
+#endif
+
+#endif // wpantund_frame_trace_h
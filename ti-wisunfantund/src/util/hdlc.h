@@ -0,0 +1,116 @@
+/*
+ *
+ * Copyright (c) 2026 Texas Instruments
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *    Description:
+ *      HDLC-lite framing shared by the spinel driver and the SPI adapter.
+ *
+ */
+
+#ifndef wpantund_hdlc_h
+#define wpantund_hdlc_h
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <sys/types.h>
+
+#define HDLC_BYTE_FLAG             0x7E
+#define HDLC_BYTE_ESC              0x7D
+#define HDLC_BYTE_XON              0x11
+#define HDLC_BYTE_XOFF             0x13
+#define HDLC_BYTE_SPECIAL          0xF8
+#define HDLC_ESCAPE_XFORM          0x20
+
+#define HDLC_CRC_RESET_VALUE       0xFFFF
+
+// Residue left in the CRC after running it over a frame
+// along with its own (complemented) frame check sequence.
+#define HDLC_GOOD_FCS              0xF0B8
+
+// Largest number of bytes `hdlc_encode()` can write for a frame of
+// `len` bytes: every byte escaped, plus the two byte FCS, also escaped.
+#define HDLC_ENCODED_MAX_LEN(len)  (2 * ((len) + 2))
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+// State of an incremental deframer. Frames are unescaped into `frame`
+// and run through the CRC as they arrive, so a frame can be split over
+// any number of reads.
+struct hdlc_deframer {
+	uint8_t* frame;         // Where frames are unescaped to
+	size_t frame_size;      // Size of `frame`
+	size_t frame_len;       // Bytes of the current frame unescaped so far
+	uint16_t crc;           // CRC of the frame so far, FCS included
+	bool escaped;           // The last byte was HDLC_BYTE_ESC
+	bool overrun;           // The current frame does not fit in `frame`
+	uint32_t overrun_count; // Frames dropped for not fitting in `frame`
+};
+
+static inline bool
+hdlc_byte_needs_escape(uint8_t byte)
+{
+	switch(byte) {
+	case HDLC_BYTE_SPECIAL:
+	case HDLC_BYTE_ESC:
+	case HDLC_BYTE_FLAG:
+	case HDLC_BYTE_XOFF:
+	case HDLC_BYTE_XON:
+		return true;
+
+	default:
+		return false;
+	}
+}
+
+// CRC-16/KERMIT update for a single byte.
+extern uint16_t hdlc_crc16(uint16_t fcs, uint8_t byte);
+
+// Same as calling `hdlc_crc16()` for each byte, eight bytes at a time.
+extern uint16_t hdlc_crc16_block(uint16_t fcs, const uint8_t* data, size_t len);
+
+// Returns the offset of the first byte of `data` which needs escaping,
+// or `len` if there is none.
+extern size_t hdlc_escape_scan(const uint8_t* data, size_t len);
+
+// Escapes `len` bytes of `data` into `out`, followed by the escaped
+// FCS. No flags are added. `out` must hold HDLC_ENCODED_MAX_LEN(len)
+// bytes. Returns the number of bytes written.
+extern size_t hdlc_encode(uint8_t* out, const uint8_t* data, size_t len);
+
+// Sets up `deframer` to unescape frames into the `frame_size` bytes at
+// `frame`, and starts it on a fresh frame.
+extern void hdlc_deframer_init(struct hdlc_deframer* deframer, uint8_t* frame, size_t frame_size);
+
+// Drops any partly received frame.
+extern void hdlc_deframer_reset(struct hdlc_deframer* deframer);
+
+// Unescapes bytes from `data` up to and including the next flag, and
+// returns how many were used. If that flag closed a frame, `*frame_len`
+// is set to its length (FCS included, possibly zero for back to back
+// flags) and `deframer->crc` holds its CRC residue, which is
+// HDLC_GOOD_FCS for an intact frame. Otherwise `*frame_len` is set to
+// -1 and all of `data` was used. Frames too big for the buffer are
+// dropped and counted in `overrun_count`.
+extern size_t hdlc_deframe(struct hdlc_deframer* deframer, const uint8_t* data, size_t len, ssize_t* frame_len);
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif // wpantund_hdlc_h
@@ -0,0 +1,395 @@
+/*
+ *
+ * Copyright (c) 2026 Texas Instruments
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *    Description:
+ *      Replays an HDLC stream from the NCP through a pipe, and times
+ *      the byte-at-a-time deframer `ncp_to_driver_pump()` used to run
+ *      against `hdlc_deframe()` on bulk reads. Then times `hdlc_encode()`
+ *      against the byte-at-a-time encoder the driver used before.
+ *
+ *      Usage: hdlc_bench [frame count] [frame length]
+ *
+ */
+
+#if HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+#include "hdlc.h"
+
+#define MAX_FRAME_LEN   1300
+
+// What the pump reads into since it went to bulk reads.
+#define READ_BUFFER_LEN 4096
+
+struct result {
+	double seconds;
+	unsigned long reads;
+	unsigned long frames;
+	unsigned long bad_frames;
+};
+
+static double
+now_seconds(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+// Fills `frame` with `frame_len` bytes which look like spinel traffic:
+// a header, a command, a property and a payload with the odd byte which
+// needs escaping.
+static void
+build_frame(uint8_t* frame, int f, size_t frame_len)
+{
+	size_t i;
+
+	frame[0] = 0x80;
+	frame[1] = 0x06;
+	frame[2] = 0x72;
+	for (i = 3; i < frame_len; i++) {
+		frame[i] = (uint8_t)(f * 31 + i * 7);
+	}
+}
+
+// Builds a stream of `frame_count` such frames of `frame_len` bytes.
+static uint8_t*
+build_stream(int frame_count, size_t frame_len, size_t* stream_len)
+{
+	uint8_t* stream = malloc(frame_count * (HDLC_ENCODED_MAX_LEN(frame_len) + 1) + 1);
+	uint8_t frame[MAX_FRAME_LEN];
+	size_t len = 0;
+	int f;
+
+	if (stream == NULL) {
+		return NULL;
+	}
+
+	for (f = 0; f < frame_count; f++) {
+		build_frame(frame, f, frame_len);
+
+		stream[len++] = HDLC_BYTE_FLAG;
+		len += hdlc_encode(&stream[len], frame, frame_len);
+	}
+	stream[len++] = HDLC_BYTE_FLAG;
+
+	*stream_len = len;
+	return stream;
+}
+
+// Starts a child writing `stream` into a pipe, and returns the read end.
+static int
+start_writer(const uint8_t* stream, size_t stream_len, pid_t* pid)
+{
+	int fds[2];
+
+	if (pipe(fds) != 0) {
+		return -1;
+	}
+
+	*pid = fork();
+
+	if (*pid == 0) {
+		size_t offset = 0;
+
+		close(fds[0]);
+		while (offset < stream_len) {
+			ssize_t ret = write(fds[1], stream + offset, stream_len - offset);
+
+			if (ret < 0) {
+				_exit(EXIT_FAILURE);
+			}
+			offset += ret;
+		}
+		_exit(EXIT_SUCCESS);
+	}
+
+	close(fds[1]);
+	return fds[0];
+}
+
+static void
+run_byte_at_a_time(int fd, struct result* result)
+{
+	uint8_t frame[MAX_FRAME_LEN + 2];
+	size_t frame_len = 0;
+	uint16_t crc = HDLC_CRC_RESET_VALUE;
+	bool escaped = false;
+	uint8_t byte;
+
+	while (read(fd, &byte, 1) == 1) {
+		result->reads++;
+
+		if (byte == HDLC_BYTE_FLAG) {
+			if (frame_len > 2) {
+				uint16_t frame_crc = frame[frame_len - 2] | (frame[frame_len - 1] << 8);
+
+				if ((uint16_t)(crc ^ 0xFFFF) == frame_crc) {
+					result->frames++;
+				} else {
+					result->bad_frames++;
+				}
+			}
+			frame_len = 0;
+			crc = HDLC_CRC_RESET_VALUE;
+			escaped = false;
+			continue;
+		}
+
+		if (byte == HDLC_BYTE_ESC) {
+			escaped = true;
+			continue;
+		}
+
+		if (escaped) {
+			byte ^= HDLC_ESCAPE_XFORM;
+			escaped = false;
+		}
+
+		if (frame_len >= 2) {
+			crc = hdlc_crc16(crc, frame[frame_len - 2]);
+		}
+
+		if (frame_len < sizeof(frame)) {
+			frame[frame_len++] = byte;
+		}
+	}
+}
+
+static void
+run_bulk(int fd, struct result* result)
+{
+	static uint8_t frame[MAX_FRAME_LEN + 2];
+	uint8_t buffer[READ_BUFFER_LEN];
+	struct hdlc_deframer deframer;
+	ssize_t read_len;
+
+	hdlc_deframer_init(&deframer, frame, sizeof(frame));
+
+	while ((read_len = read(fd, buffer, sizeof(buffer))) > 0) {
+		ssize_t offset = 0;
+
+		result->reads++;
+
+		while (offset < read_len) {
+			ssize_t frame_len;
+
+			offset += hdlc_deframe(&deframer, buffer + offset, read_len - offset, &frame_len);
+
+			if (frame_len > 2) {
+				if (deframer.crc == HDLC_GOOD_FCS) {
+					result->frames++;
+				} else {
+					result->bad_frames++;
+				}
+			}
+		}
+	}
+}
+
+static int
+replay(const char* name, const uint8_t* stream, size_t stream_len, void (*run)(int, struct result*))
+{
+	struct result result;
+	double begin;
+	pid_t pid;
+	int status;
+	int fd;
+
+	memset(&result, 0, sizeof(result));
+
+	fd = start_writer(stream, stream_len, &pid);
+
+	if (fd < 0) {
+		perror("pipe");
+		return -1;
+	}
+
+	begin = now_seconds();
+	run(fd, &result);
+	result.seconds = now_seconds() - begin;
+
+	close(fd);
+	waitpid(pid, &status, 0);
+
+	printf("%-16s %10.1f %12.0f %10.2f %8lu %6lu\n",
+		name,
+		stream_len / result.seconds / 1e6,
+		result.frames / result.seconds,
+		result.frames ? (double)result.reads / result.frames : 0.0,
+		result.frames,
+		result.bad_frames
+	);
+
+	return (result.bad_frames == 0) ? 0 : -1;
+}
+
+// What the driver did before `hdlc_encode()`: run the CRC and escape
+// one byte at a time.
+static size_t
+encode_byte_at_a_time(uint8_t* out, const uint8_t* data, size_t len)
+{
+	uint16_t fcs = HDLC_CRC_RESET_VALUE;
+	uint8_t* const out_begin = out;
+	size_t i;
+
+	for (i = 0; i < len; i++) {
+		fcs = hdlc_crc16(fcs, data[i]);
+
+		if (hdlc_byte_needs_escape(data[i])) {
+			*out++ = HDLC_BYTE_ESC;
+			*out++ = data[i] ^ HDLC_ESCAPE_XFORM;
+		} else {
+			*out++ = data[i];
+		}
+	}
+
+	fcs ^= 0xFFFF;
+
+	for (i = 0; i < 2; i++) {
+		uint8_t byte = (uint8_t)(fcs >> (8 * i));
+
+		if (hdlc_byte_needs_escape(byte)) {
+			*out++ = HDLC_BYTE_ESC;
+			*out++ = byte ^ HDLC_ESCAPE_XFORM;
+		} else {
+			*out++ = byte;
+		}
+	}
+
+	return out - out_begin;
+}
+
+// Encodes the `frame_count` frames of `frame_len` bytes at `frames`
+// into `out` `passes` times over, and returns how long that took.
+static double
+encode(
+	const char* name,
+	const uint8_t* frames,
+	int frame_count,
+	size_t frame_len,
+	int passes,
+	uint8_t* out,
+	size_t* out_len,
+	size_t (*encoder)(uint8_t*, const uint8_t*, size_t)
+) {
+	double begin = now_seconds();
+	double seconds;
+	int pass;
+	int f;
+
+	for (pass = 0; pass < passes; pass++) {
+		size_t len = 0;
+
+		for (f = 0; f < frame_count; f++) {
+			len += encoder(out + len, frames + f * frame_len, frame_len);
+		}
+
+		*out_len = len;
+	}
+
+	seconds = now_seconds() - begin;
+
+	printf("%-16s %10.1f %12.0f %10.1f\n",
+		name,
+		(double)frame_count * frame_len * passes / seconds / 1e6,
+		frame_count * passes / seconds,
+		seconds * 1e9 / ((double)frame_count * passes)
+	);
+
+	return seconds;
+}
+
+static int
+compare_encoders(int frame_count, size_t frame_len)
+{
+	const int passes = 20;
+	uint8_t* frames = malloc(frame_count * frame_len);
+	uint8_t* out = malloc(frame_count * HDLC_ENCODED_MAX_LEN(frame_len));
+	uint8_t* reference_out = malloc(frame_count * HDLC_ENCODED_MAX_LEN(frame_len));
+	size_t out_len = 0;
+	size_t reference_out_len = 0;
+	int ret = -1;
+	int f;
+
+	if ((frames == NULL) || (out == NULL) || (reference_out == NULL)) {
+		goto bail;
+	}
+
+	for (f = 0; f < frame_count; f++) {
+		build_frame(frames + f * frame_len, f, frame_len);
+	}
+
+	printf("\n%-16s %10s %12s %10s\n", "encoder", "MB/s", "frames/s", "ns/frame");
+
+	encode("byte-at-a-time", frames, frame_count, frame_len, passes, reference_out, &reference_out_len, &encode_byte_at_a_time);
+	encode("hdlc_encode", frames, frame_count, frame_len, passes, out, &out_len, &hdlc_encode);
+
+	if ((out_len != reference_out_len) || (memcmp(out, reference_out, out_len) != 0)) {
+		fprintf(stderr, "The two encoders disagree\n");
+		goto bail;
+	}
+
+	ret = 0;
+
+bail:
+	free(frames);
+	free(out);
+	free(reference_out);
+	return ret;
+}
+
+int main(int argc, char* argv[])
+{
+	int frame_count = (argc > 1) ? atoi(argv[1]) : 20000;
+	size_t frame_len = (argc > 2) ? (size_t)atoi(argv[2]) : 120;
+	uint8_t* stream;
+	size_t stream_len;
+	int ret = 0;
+
+	if ((frame_count <= 0) || (frame_len < 3) || (frame_len > MAX_FRAME_LEN)) {
+		fprintf(stderr, "usage: %s [frame count] [frame length, 3..%d]\n", argv[0], MAX_FRAME_LEN);
+		return EXIT_FAILURE;
+	}
+
+	stream = build_stream(frame_count, frame_len, &stream_len);
+
+	if (stream == NULL) {
+		return EXIT_FAILURE;
+	}
+
+	printf("%d frames of %d bytes, %lu bytes on the wire\n\n", frame_count, (int)frame_len, (unsigned long)stream_len);
+	printf("%-16s %10s %12s %10s %8s %6s\n", "deframer", "MB/s", "frames/s", "reads/frm", "frames", "bad");
+
+	ret |= replay("byte-at-a-time", stream, stream_len, &run_byte_at_a_time);
+	ret |= replay("bulk", stream, stream_len, &run_bulk);
+
+	ret |= compare_encoders(frame_count, frame_len);
+
+	free(stream);
+
+	return (ret == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,465 @@
+/*
+ *
+ * Copyright (c) 2026 Texas Instruments
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *    Description:
+ *      Checks the HDLC codec against the byte-at-a-time encoder and
+ *      deframer it replaced, on random frames and on corrupted streams,
+ *      and runs encoded streams back through the deframer in random
+ *      sized pieces.
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "hdlc.h"
+
+#define MAX_FRAME_LEN   1300
+#define ITERATIONS      20000
+
+static uint16_t
+reference_crc16(uint16_t aFcs, uint8_t aByte)
+{
+	uint16_t crc = aFcs ^ aByte;
+	int i;
+
+	// Bitwise CRC-16/KERMIT, independent of the tables under test.
+	for (i = 0; i < 8; i++) {
+		crc = (crc & 1) ? ((crc >> 1) ^ 0x8408) : (crc >> 1);
+	}
+
+	return crc;
+}
+
+// The encoder `driver_to_ncp_pump()` and `push_hdlc()` used to run.
+static size_t
+reference_encode(uint8_t* out, const uint8_t* frame_ptr, size_t frame_len)
+{
+	size_t len = 0;
+	size_t i;
+	uint8_t byte;
+	uint16_t crc = 0xFFFF;
+
+	for (i = 0; i < frame_len; i++) {
+		byte = frame_ptr[i];
+		crc = reference_crc16(crc, byte);
+		if (hdlc_byte_needs_escape(byte)) {
+			out[len++] = HDLC_BYTE_ESC;
+			out[len++] = byte ^ HDLC_ESCAPE_XFORM;
+		} else {
+			out[len++] = byte;
+		}
+	}
+	crc ^= 0xFFFF;
+	byte = (crc & 0xFF);
+	if (hdlc_byte_needs_escape(byte)) {
+		out[len++] = HDLC_BYTE_ESC;
+		out[len++] = byte ^ HDLC_ESCAPE_XFORM;
+	} else {
+		out[len++] = byte;
+	}
+	byte = ((crc >> 8) & 0xFF);
+	if (hdlc_byte_needs_escape(byte)) {
+		out[len++] = HDLC_BYTE_ESC;
+		out[len++] = byte ^ HDLC_ESCAPE_XFORM;
+	} else {
+		out[len++] = byte;
+	}
+
+	return len;
+}
+
+// The deframer `ncp_to_driver_pump()` used to run, one `read()` per
+// byte. Calls `deliver()` for every frame of more than two bytes, with
+// whether its FCS checked out.
+struct reference_deframer {
+	uint8_t frame[MAX_FRAME_LEN + 2];
+	size_t frame_len;
+	uint16_t crc;
+	bool escaped;
+};
+
+static void
+reference_deframer_init(struct reference_deframer* deframer)
+{
+	deframer->frame_len = 0;
+	deframer->crc = 0xFFFF;
+	deframer->escaped = false;
+}
+
+static void
+reference_deframe_byte(
+	struct reference_deframer* deframer,
+	uint8_t byte,
+	void (*deliver)(const uint8_t* frame_ptr, size_t frame_len, bool good)
+) {
+	uint16_t frame_crc;
+
+	if (deframer->escaped && (byte != HDLC_BYTE_FLAG)) {
+		deframer->escaped = false;
+		byte ^= HDLC_ESCAPE_XFORM;
+
+	} else if (byte == HDLC_BYTE_ESC) {
+		deframer->escaped = true;
+		return;
+
+	} else if (byte != HDLC_BYTE_FLAG) {
+		// Plain byte.
+
+	} else {
+		deframer->escaped = false;
+
+		if (deframer->frame_len > 2) {
+			frame_crc = deframer->frame[deframer->frame_len - 2]
+			          | (deframer->frame[deframer->frame_len - 1] << 8);
+			deliver(deframer->frame, deframer->frame_len, (uint16_t)(deframer->crc ^ 0xFFFF) == frame_crc);
+		}
+
+		deframer->frame_len = 0;
+		deframer->crc = 0xFFFF;
+		return;
+	}
+
+	// The CRC runs two bytes behind, so that the FCS is left out of it.
+	if (deframer->frame_len >= 2) {
+		deframer->crc = reference_crc16(deframer->crc, deframer->frame[deframer->frame_len - 2]);
+	}
+
+	deframer->frame[deframer->frame_len++] = byte;
+}
+
+static uint32_t sRandomState = 0x2545F491;
+
+static uint32_t
+next_random(void)
+{
+	sRandomState ^= sRandomState << 13;
+	sRandomState ^= sRandomState >> 17;
+	sRandomState ^= sRandomState << 5;
+	return sRandomState;
+}
+
+static void
+fill_frame(uint8_t* frame_ptr, size_t frame_len)
+{
+	static const uint8_t special[] = {
+		HDLC_BYTE_FLAG, HDLC_BYTE_ESC, HDLC_BYTE_XON, HDLC_BYTE_XOFF, HDLC_BYTE_SPECIAL
+	};
+	// Anything from no byte needing escaping to every byte needing it.
+	uint32_t special_odds = next_random() % 5 == 0 ? 0 : next_random() % 64;
+	size_t i;
+
+	for (i = 0; i < frame_len; i++) {
+		if ((special_odds != 0) && (next_random() % special_odds == 0)) {
+			frame_ptr[i] = special[next_random() % sizeof(special)];
+		} else {
+			frame_ptr[i] = (uint8_t)next_random();
+		}
+	}
+}
+
+// Encodes a run of random frames, one of them too big for the deframer,
+// feeds the stream to the deframer in random sized reads, and checks
+// that every other frame comes back out intact.
+static int
+check_deframe(void)
+{
+	static uint8_t frames[8][MAX_FRAME_LEN + 1];
+	static size_t frame_lens[8];
+	static uint8_t stream[8 * (HDLC_ENCODED_MAX_LEN(MAX_FRAME_LEN + 1) + 2)];
+	static uint8_t buffer[MAX_FRAME_LEN + 2];
+	struct hdlc_deframer deframer;
+	const int frame_count = 1 + next_random() % 8;
+	const int oversize = next_random() % 16;
+	size_t stream_len = 0;
+	size_t offset = 0;
+	int next_frame = 0;
+	int f;
+
+	hdlc_deframer_init(&deframer, buffer, sizeof(buffer));
+
+	for (f = 0; f < frame_count; f++) {
+		// With its FCS, the oversize frame is one byte too big for `buffer`.
+		frame_lens[f] = (f == oversize) ? MAX_FRAME_LEN + 1 : next_random() % (MAX_FRAME_LEN + 1);
+		fill_frame(frames[f], frame_lens[f]);
+
+		stream[stream_len++] = HDLC_BYTE_FLAG;
+		stream_len += hdlc_encode(&stream[stream_len], frames[f], frame_lens[f]);
+	}
+	stream[stream_len++] = HDLC_BYTE_FLAG;
+
+	while (offset < stream_len) {
+		size_t chunk_len = 1 + next_random() % 64;
+		ssize_t frame_len;
+
+		if (chunk_len > stream_len - offset) {
+			chunk_len = stream_len - offset;
+		}
+
+		while (chunk_len > 0) {
+			size_t used = hdlc_deframe(&deframer, &stream[offset], chunk_len, &frame_len);
+
+			offset += used;
+			chunk_len -= used;
+
+			if (frame_len <= 0) {
+				continue;
+			}
+
+			if (next_frame == oversize) {
+				next_frame++;
+			}
+
+			if ((next_frame >= frame_count)
+				|| ((size_t)frame_len != frame_lens[next_frame] + 2)
+				|| (deframer.crc != HDLC_GOOD_FCS)
+				|| (memcmp(buffer, frames[next_frame], frame_lens[next_frame]) != 0)) {
+				printf("hdlc_deframe mismatch (frame %d)\n", next_frame);
+				return 1;
+			}
+
+			next_frame++;
+		}
+	}
+
+	if (next_frame == oversize) {
+		next_frame++;
+	}
+
+	if (next_frame < frame_count) {
+		printf("hdlc_deframe lost frames (%d of %d)\n", next_frame, frame_count);
+		return 1;
+	}
+
+	if (deframer.overrun_count != (oversize < frame_count ? 1 : 0)) {
+		printf("hdlc_deframe overrun count is %d\n", (int)deframer.overrun_count);
+		return 1;
+	}
+
+	return 0;
+}
+
+#define MAX_DELIVERED   16
+
+struct delivered_frame {
+	uint8_t frame[MAX_FRAME_LEN + 2];
+	size_t frame_len;
+	bool good;
+};
+
+static struct delivered_frame sReferenceFrames[MAX_DELIVERED];
+static int sReferenceFrameCount;
+
+static void
+deliver_reference_frame(const uint8_t* frame_ptr, size_t frame_len, bool good)
+{
+	if (sReferenceFrameCount < MAX_DELIVERED) {
+		memcpy(sReferenceFrames[sReferenceFrameCount].frame, frame_ptr, frame_len);
+		sReferenceFrames[sReferenceFrameCount].frame_len = frame_len;
+		sReferenceFrames[sReferenceFrameCount].good = good;
+	}
+	sReferenceFrameCount++;
+}
+
+// Encodes a run of random frames, damages the stream the ways a noisy
+// UART does (stray bytes before and between frames, flipped and dropped
+// bytes, aborts with ESC+FLAG), and checks that `hdlc_deframe()`, fed
+// random sized reads, passes up the same frames with the same verdict
+// on their FCS as the old byte-at-a-time deframer.
+static int
+check_deframe_equivalence(void)
+{
+	static uint8_t frame[MAX_FRAME_LEN];
+	static uint8_t stream[MAX_DELIVERED * (HDLC_ENCODED_MAX_LEN(MAX_FRAME_LEN) + 8)];
+	static uint8_t buffer[MAX_FRAME_LEN + 2];
+	struct reference_deframer reference;
+	struct hdlc_deframer deframer;
+	const int frame_count = 1 + next_random() % (MAX_DELIVERED / 2);
+	size_t stream_len = 0;
+	size_t offset = 0;
+	int delivered = 0;
+	size_t i;
+	int f;
+
+	for (f = 0; f < frame_count; f++) {
+		size_t frame_len = next_random() % (MAX_FRAME_LEN / 4);
+		size_t encoded_begin;
+
+		// Junk between frames, as seen at startup.
+		if (next_random() % 4 == 0) {
+			size_t junk_len = 1 + next_random() % 4;
+
+			while (junk_len-- != 0) {
+				stream[stream_len++] = (uint8_t)next_random();
+			}
+		}
+
+		fill_frame(frame, frame_len);
+
+		stream[stream_len++] = HDLC_BYTE_FLAG;
+		encoded_begin = stream_len;
+		stream_len += hdlc_encode(&stream[stream_len], frame, frame_len);
+
+		switch (next_random() % 8) {
+		case 0:
+			// Flip a byte.
+			if (stream_len > encoded_begin) {
+				stream[encoded_begin + next_random() % (stream_len - encoded_begin)] ^= (uint8_t)(1 + next_random() % 255);
+			}
+			break;
+
+		case 1:
+			// Drop a byte.
+			if (stream_len > encoded_begin) {
+				stream_len--;
+			}
+			break;
+
+		case 2:
+			// Abort the frame.
+			stream[stream_len++] = HDLC_BYTE_ESC;
+			break;
+
+		default:
+			break;
+		}
+	}
+	stream[stream_len++] = HDLC_BYTE_FLAG;
+
+	sReferenceFrameCount = 0;
+	reference_deframer_init(&reference);
+
+	for (i = 0; i < stream_len; i++) {
+		reference_deframe_byte(&reference, stream[i], &deliver_reference_frame);
+	}
+
+	if (sReferenceFrameCount > MAX_DELIVERED) {
+		printf("reference deframer returned too many frames\n");
+		return 1;
+	}
+
+	hdlc_deframer_init(&deframer, buffer, sizeof(buffer));
+
+	while (offset < stream_len) {
+		size_t chunk_len = 1 + next_random() % 64;
+		ssize_t frame_len;
+
+		if (chunk_len > stream_len - offset) {
+			chunk_len = stream_len - offset;
+		}
+
+		while (chunk_len > 0) {
+			size_t used = hdlc_deframe(&deframer, &stream[offset], chunk_len, &frame_len);
+
+			offset += used;
+			chunk_len -= used;
+
+			if (frame_len <= 2) {
+				continue;
+			}
+
+			if ((delivered >= sReferenceFrameCount)
+				|| ((size_t)frame_len != sReferenceFrames[delivered].frame_len)
+				|| ((deframer.crc == HDLC_GOOD_FCS) != sReferenceFrames[delivered].good)
+				|| (memcmp(buffer, sReferenceFrames[delivered].frame, frame_len) != 0)) {
+				printf("hdlc_deframe differs from the byte-at-a-time deframer (frame %d)\n", delivered);
+				return 1;
+			}
+
+			delivered++;
+		}
+	}
+
+	if (delivered != sReferenceFrameCount) {
+		printf("hdlc_deframe returned %d frames, byte-at-a-time returned %d\n", delivered, sReferenceFrameCount);
+		return 1;
+	}
+
+	return 0;
+}
+
+int main(void)
+{
+	static uint8_t frame[MAX_FRAME_LEN + 16];
+	static uint8_t expected[HDLC_ENCODED_MAX_LEN(MAX_FRAME_LEN)];
+	static uint8_t actual[HDLC_ENCODED_MAX_LEN(MAX_FRAME_LEN)];
+	int errors = 0;
+	int i;
+
+	if ((uint16_t)(hdlc_crc16_block(0xFFFF, (const uint8_t*)"123456789", 9) ^ 0xFFFF) != 0x906E) {
+		printf("hdlc_crc16_block check value is wrong\n");
+		errors++;
+	}
+
+	for (i = 0; (i < ITERATIONS) && (errors == 0); i++) {
+		size_t frame_len = next_random() % (MAX_FRAME_LEN + 1);
+		// Exercise unaligned starts too.
+		uint8_t* frame_ptr = frame + next_random() % 16;
+		size_t expected_len;
+		size_t actual_len;
+		size_t j;
+		uint16_t crc = 0xFFFF;
+
+		fill_frame(frame_ptr, frame_len);
+
+		for (j = 0; j < frame_len; j++) {
+			crc = reference_crc16(crc, frame_ptr[j]);
+		}
+
+		if (hdlc_crc16_block(0xFFFF, frame_ptr, frame_len) != crc) {
+			printf("hdlc_crc16_block mismatch (len %d)\n", (int)frame_len);
+			errors++;
+		}
+
+		for (j = 0; j < frame_len && !hdlc_byte_needs_escape(frame_ptr[j]); j++) {
+		}
+
+		if (hdlc_escape_scan(frame_ptr, frame_len) != j) {
+			printf("hdlc_escape_scan mismatch (len %d)\n", (int)frame_len);
+			errors++;
+		}
+
+		expected_len = reference_encode(expected, frame_ptr, frame_len);
+		actual_len = hdlc_encode(actual, frame_ptr, frame_len);
+
+		if ((actual_len != expected_len) || (memcmp(actual, expected, expected_len) != 0)) {
+			printf("hdlc_encode mismatch (len %d)\n", (int)frame_len);
+			errors++;
+		}
+
+		if (actual_len > HDLC_ENCODED_MAX_LEN(frame_len)) {
+			printf("hdlc_encode overran HDLC_ENCODED_MAX_LEN (len %d)\n", (int)frame_len);
+			errors++;
+		}
+
+		if ((i % 8 == 0) && (check_deframe() != 0)) {
+			errors++;
+		}
+
+		if ((i % 8 == 4) && (check_deframe_equivalence() != 0)) {
+			errors++;
+		}
+	}
+
+	if (errors != 0) {
+		printf("FAIL\n");
+		return EXIT_FAILURE;
+	}
+
+	printf("OK\n");
+	return EXIT_SUCCESS;
+}
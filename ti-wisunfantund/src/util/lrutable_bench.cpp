@@ -0,0 +1,230 @@
+/*
+ *
+ * Copyright (c) 2026 Texas Instruments
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *    Description:
+ *      Times the per packet node lookup of StatCollector, using
+ *      `nl::LruTable<>` as it does now against the `std::map<>` with
+ *      a scan for the oldest entry on eviction it used before.
+ *
+ *      Usage: lrutable_bench [node count] [packet count] [capacity]
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <time.h>
+#include <map>
+#include <vector>
+#include "LruTable.h"
+
+using namespace nl;
+
+// Same layout and hash as StatCollector::IPAddress.
+struct Address
+{
+	uint32_t mAddressBuffer[4];
+
+	bool operator==(const Address& other) const
+	{
+		return memcmp(mAddressBuffer, other.mAddressBuffer, sizeof(mAddressBuffer)) == 0;
+	}
+
+	bool operator<(const Address& other) const
+	{
+		return memcmp(mAddressBuffer, other.mAddressBuffer, sizeof(mAddressBuffer)) < 0;
+	}
+
+	uint32_t hash(void) const;
+};
+
+static uint32_t
+mix_hash(uint32_t hash)
+{
+	hash ^= hash >> 16;
+	hash *= 0x85ebca6b;
+	hash ^= hash >> 13;
+	hash *= 0xc2b2ae35;
+	hash ^= hash >> 16;
+	return hash;
+}
+
+uint32_t
+Address::hash(void) const
+{
+	return mix_hash(mAddressBuffer[0] ^ mix_hash(mAddressBuffer[1] ^ mix_hash(mAddressBuffer[2] ^ mix_hash(mAddressBuffer[3]))));
+}
+
+// Roughly the size of StatCollector::NodeStat::NodeInfo, history included.
+struct NodeInfo
+{
+	uint32_t mPackets;
+	uint32_t mLastSeen;
+	uint8_t mHistory[480];
+};
+
+static uint32_t sRandomState = 0x2545F491;
+
+static uint32_t
+next_random(void)
+{
+	sRandomState ^= sRandomState << 13;
+	sRandomState ^= sRandomState >> 17;
+	sRandomState ^= sRandomState << 5;
+	return sRandomState;
+}
+
+static double
+now_ns(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static uint32_t
+run_lru_table(const std::vector<Address>& packets, int capacity, unsigned long& evictions)
+{
+	LruTable<Address, NodeInfo> table(capacity);
+	uint32_t checksum = 0;
+
+	for (size_t i = 0; i < packets.size(); i++) {
+		bool inserted;
+		bool evicted;
+		NodeInfo *info = table.touch(packets[i], inserted, evicted);
+
+		if (inserted) {
+			info->mPackets = 0;
+		}
+
+		if (evicted) {
+			evictions++;
+		}
+
+		info->mPackets++;
+		info->mLastSeen = static_cast<uint32_t>(i);
+		checksum += info->mPackets;
+	}
+
+	return checksum;
+}
+
+// What NodeStat did before: a map into a pool, and a full scan for the
+// least recently seen node whenever a new one arrives with the pool full.
+static uint32_t
+run_map(const std::vector<Address>& packets, int capacity, unsigned long& evictions)
+{
+	std::vector<NodeInfo> pool(capacity);
+	std::vector<int> free_list;
+	std::map<Address, int> nodes;
+	uint32_t checksum = 0;
+
+	for (int i = capacity - 1; i >= 0; i--) {
+		free_list.push_back(i);
+	}
+
+	for (size_t i = 0; i < packets.size(); i++) {
+		std::map<Address, int>::iterator iter = nodes.find(packets[i]);
+		NodeInfo *info;
+
+		if (iter == nodes.end()) {
+			if (free_list.empty()) {
+				std::map<Address, int>::iterator oldest = nodes.begin();
+
+				for (std::map<Address, int>::iterator scan = nodes.begin(); scan != nodes.end(); ++scan) {
+					if (pool[scan->second].mLastSeen < pool[oldest->second].mLastSeen) {
+						oldest = scan;
+					}
+				}
+
+				free_list.push_back(oldest->second);
+				nodes.erase(oldest);
+				evictions++;
+			}
+
+			iter = nodes.insert(std::make_pair(packets[i], free_list.back())).first;
+			free_list.pop_back();
+			pool[iter->second].mPackets = 0;
+		}
+
+		info = &pool[iter->second];
+		info->mPackets++;
+		info->mLastSeen = static_cast<uint32_t>(i);
+		checksum += info->mPackets;
+	}
+
+	return checksum;
+}
+
+static uint32_t
+report(const char *name, const std::vector<Address>& packets, int capacity,
+	uint32_t (*run)(const std::vector<Address>&, int, unsigned long&))
+{
+	unsigned long evictions = 0;
+	double begin = now_ns();
+	uint32_t checksum = run(packets, capacity, evictions);
+	double elapsed = now_ns() - begin;
+
+	printf("%-10s %12.1f %12.0f %10lu\n",
+		name,
+		elapsed / packets.size(),
+		packets.size() / elapsed * 1e9,
+		evictions
+	);
+
+	return checksum;
+}
+
+int
+main(int argc, char* argv[])
+{
+	int node_count = (argc > 1) ? atoi(argv[1]) : 1000;
+	int packet_count = (argc > 2) ? atoi(argv[2]) : 5000000;
+	int capacity = (argc > 3) ? atoi(argv[3]) : 1024;
+	std::vector<Address> nodes;
+	std::vector<Address> packets;
+	uint32_t checksum;
+
+	if ((node_count <= 0) || (packet_count <= 0) || (capacity <= 0)) {
+		fprintf(stderr, "usage: %s [node count] [packet count] [capacity]\n", argv[0]);
+		return EXIT_FAILURE;
+	}
+
+	// Nodes of one mesh prefix, differing only in the interface identifier.
+	for (int i = 0; i < node_count; i++) {
+		Address address = { { 0x20200000, 0x0000abcd, 0x02124b00, next_random() } };
+		nodes.push_back(address);
+	}
+
+	for (int i = 0; i < packet_count; i++) {
+		packets.push_back(nodes[next_random() % node_count]);
+	}
+
+	printf("%d nodes, %d packets, capacity %d\n\n", node_count, packet_count, capacity);
+	printf("%-10s %12s %12s %10s\n", "table", "ns/packet", "packets/s", "evictions");
+
+	checksum = report("LruTable", packets, capacity, &run_lru_table);
+
+	if (report("std::map", packets, capacity, &run_map) != checksum) {
+		fprintf(stderr, "The two tables disagree on the packet counts\n");
+		return EXIT_FAILURE;
+	}
+
+	return EXIT_SUCCESS;
+}
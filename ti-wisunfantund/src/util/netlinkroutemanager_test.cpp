@@ -0,0 +1,471 @@
+/*
+ *
+ * Copyright (c) 2026 Texas Instruments
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *    Description:
+ *      Checks the requests `NetlinkRouteManager` sends and how it
+ *      matches ACKs back to them, with a thread playing the kernel on
+ *      the other end of a socket pair. The ACKs come back out of order,
+ *      mixed with ACKs for other requests and other batches, and with
+ *      errors and missing ones.
+ *
+ */
+
+#if HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <sys/socket.h>
+#include <linux/netlink.h>
+#include <linux/rtnetlink.h>
+#include <algorithm>
+#include <map>
+#include <set>
+#include <thread>
+#include <vector>
+#include "assert-macros.h"
+#include "NetlinkRouteManager.h"
+
+#define IFINDEX         7
+
+// Plays the kernel: takes request datagrams, keeps them for checking
+// and answers each request with an ACK.
+struct FakeKernel {
+	int mFD;
+	std::vector<std::vector<uint8_t> > mDatagrams;
+
+	// How to answer, by sequence number: with an error, or not at all.
+	std::map<uint32_t, int> mErrors;
+	std::set<uint32_t> mUnanswered;
+
+	// Answer the requests of a datagram last to first.
+	bool mReverse;
+
+	// Before the real ACKs, send an ACK for a request we never got, one
+	// for the previous batch, a message which is not an ACK and, after
+	// them, a second ACK for the first request.
+	bool mNoise;
+
+	uint32_t mLastSeq;
+
+	FakeKernel(int fd) : mFD(fd), mReverse(false), mNoise(false), mLastSeq(0) { }
+
+	void send_message(uint16_t type, uint32_t seq, int error)
+	{
+		struct {
+			struct nlmsghdr header;
+			struct nlmsgerr err;
+		} message;
+
+		memset(&message, 0, sizeof(message));
+		message.header.nlmsg_len = NLMSG_LENGTH(sizeof(message.err));
+		message.header.nlmsg_type = type;
+		message.header.nlmsg_seq = seq;
+		message.err.error = -error;
+		message.err.msg.nlmsg_seq = seq;
+
+		IGNORE_RETURN_VALUE(send(mFD, &message, message.header.nlmsg_len, 0));
+	}
+
+	void serve_datagram(void)
+	{
+		std::vector<uint8_t> buffer(64 * 1024);
+		std::vector<uint32_t> seqs;
+		const struct nlmsghdr* nlh;
+		ssize_t len = recv(mFD, &buffer[0], buffer.size(), 0);
+
+		if (len < 0) {
+			return;
+		}
+
+		buffer.resize(len);
+		mDatagrams.push_back(buffer);
+
+		nlh = reinterpret_cast<const struct nlmsghdr*>(&buffer[0]);
+		for (int remaining = static_cast<int>(len); NLMSG_OK(nlh, remaining); nlh = NLMSG_NEXT(nlh, remaining)) {
+			seqs.push_back(nlh->nlmsg_seq);
+		}
+
+		if (seqs.empty()) {
+			return;
+		}
+
+		if (mReverse) {
+			std::reverse(seqs.begin(), seqs.end());
+		}
+
+		if (mNoise) {
+			send_message(NLMSG_ERROR, 0xDEAD0000, 0);
+			if (mLastSeq != 0) {
+				send_message(NLMSG_ERROR, mLastSeq, EPERM);
+			}
+			send_message(RTM_NEWADDR, seqs[0], EPERM);
+		}
+
+		for (size_t i = 0; i < seqs.size(); i++) {
+			if (mUnanswered.count(seqs[i]) == 0) {
+				send_message(NLMSG_ERROR, seqs[i], mErrors.count(seqs[i]) ? mErrors[seqs[i]] : 0);
+			}
+		}
+
+		if (mNoise) {
+			send_message(NLMSG_ERROR, seqs[0], EPERM);
+		}
+
+		mLastSeq = *std::max_element(seqs.begin(), seqs.end());
+	}
+};
+
+// Flushes `manager` with `kernel` answering `datagrams` datagrams.
+static int
+flush_with(NetlinkRouteManager& manager, FakeKernel& kernel, int datagrams, int& error)
+{
+	std::thread thread([&kernel, datagrams]() {
+		for (int i = 0; i < datagrams; i++) {
+			kernel.serve_datagram();
+		}
+	});
+	int ret = manager.flush();
+
+	error = errno;
+	thread.join();
+
+	return ret;
+}
+
+static struct in6_addr
+make_address(const char* string)
+{
+	struct in6_addr address;
+
+	inet_pton(AF_INET6, string, &address);
+
+	return address;
+}
+
+// Returns the attribute `type` of the message, or NULL.
+static const struct rtattr*
+find_attribute(const struct nlmsghdr* nlh, size_t header_len, uint16_t type)
+{
+	const struct rtattr* rta = reinterpret_cast<const struct rtattr*>(
+		reinterpret_cast<const uint8_t*>(NLMSG_DATA(nlh)) + NLMSG_ALIGN(header_len));
+	int len = static_cast<int>(nlh->nlmsg_len - NLMSG_LENGTH(NLMSG_ALIGN(header_len)));
+
+	for (; RTA_OK(rta, len); rta = RTA_NEXT(rta, len)) {
+		if (rta->rta_type == type) {
+			return rta;
+		}
+	}
+
+	return NULL;
+}
+
+static bool
+attribute_is(const struct rtattr* rta, const void* data, size_t len)
+{
+	return (rta != NULL) && (RTA_PAYLOAD(rta) == len) && (memcmp(RTA_DATA(rta), data, len) == 0);
+}
+
+static int
+check_address_request(const struct nlmsghdr* nlh, uint16_t type, const struct in6_addr& address, uint8_t prefix_len)
+{
+	const struct ifaddrmsg* ifa = reinterpret_cast<const struct ifaddrmsg*>(NLMSG_DATA(nlh));
+	uint16_t flags = NLM_F_REQUEST | NLM_F_ACK | ((type == RTM_NEWADDR) ? NLM_F_CREATE : 0);
+
+	if ((nlh->nlmsg_type != type) || (nlh->nlmsg_flags != flags)
+		|| (ifa->ifa_family != AF_INET6) || (ifa->ifa_prefixlen != prefix_len)
+		|| (ifa->ifa_index != IFINDEX)
+		|| !attribute_is(find_attribute(nlh, sizeof(*ifa), IFA_LOCAL), &address, sizeof(address))
+		|| !attribute_is(find_attribute(nlh, sizeof(*ifa), IFA_ADDRESS), &address, sizeof(address))
+	) {
+		printf("address request %d encoded wrong\n", type);
+		return 1;
+	}
+
+	return 0;
+}
+
+static int
+check_route_request(const struct nlmsghdr* nlh, uint16_t type, const struct in6_addr& prefix, uint8_t prefix_len, uint32_t metric)
+{
+	const struct rtmsg* rtm = reinterpret_cast<const struct rtmsg*>(NLMSG_DATA(nlh));
+	const struct rtattr* priority = find_attribute(nlh, sizeof(*rtm), RTA_PRIORITY);
+	uint16_t flags = NLM_F_REQUEST | NLM_F_ACK | ((type == RTM_NEWROUTE) ? NLM_F_CREATE : 0);
+	uint8_t protocol = (type == RTM_NEWROUTE) ? NetlinkRouteManager::kRouteProtocol : RTPROT_UNSPEC;
+	uint32_t oif = IFINDEX;
+
+	if ((nlh->nlmsg_type != type) || (nlh->nlmsg_flags != flags)
+		|| (rtm->rtm_family != AF_INET6) || (rtm->rtm_dst_len != prefix_len)
+		|| (rtm->rtm_table != RT_TABLE_MAIN) || (rtm->rtm_type != RTN_UNICAST)
+		|| (rtm->rtm_protocol != protocol)
+		|| !attribute_is(find_attribute(nlh, sizeof(*rtm), RTA_DST), &prefix, sizeof(prefix))
+		|| !attribute_is(find_attribute(nlh, sizeof(*rtm), RTA_OIF), &oif, sizeof(oif))
+		|| ((metric == 0) ? (priority != NULL) : !attribute_is(priority, &metric, sizeof(metric)))
+	) {
+		printf("route request %d encoded wrong\n", type);
+		return 1;
+	}
+
+	return 0;
+}
+
+static int
+test_encoding(NetlinkRouteManager& manager, FakeKernel& kernel)
+{
+	const struct in6_addr address1 = make_address("2001:db8::1");
+	const struct in6_addr address2 = make_address("2001:db8::2");
+	const struct in6_addr prefix1 = make_address("2001:db8:1::");
+	const struct in6_addr prefix2 = make_address("2001:db8:2::");
+	const struct in6_addr prefix3 = make_address("2001:db8:3::");
+	std::vector<const struct nlmsghdr*> requests;
+	const struct nlmsghdr* nlh;
+	int remaining;
+	int errors = 0;
+	int error;
+
+	manager.add_address(IFINDEX, address1, 64);
+	manager.remove_address(IFINDEX, address2, 64);
+	manager.add_route(IFINDEX, prefix1, 48, 0);
+	manager.add_route(IFINDEX, prefix2, 64, 256);
+	manager.remove_route(IFINDEX, prefix3, 64, 0);
+
+	if (manager.get_pending_count() != 5) {
+		printf("encoding: %d requests pending, expected 5\n", manager.get_pending_count());
+		return 1;
+	}
+
+	if (flush_with(manager, kernel, 1, error) != 0) {
+		printf("encoding: flush failed: %s\n", strerror(error));
+		return 1;
+	}
+
+	if ((kernel.mDatagrams.size() != 1) || (manager.get_pending_count() != 0)) {
+		printf("encoding: sent in %d datagrams, expected 1\n", (int)kernel.mDatagrams.size());
+		return 1;
+	}
+
+	nlh = reinterpret_cast<const struct nlmsghdr*>(&kernel.mDatagrams[0][0]);
+	for (remaining = static_cast<int>(kernel.mDatagrams[0].size()); NLMSG_OK(nlh, remaining); nlh = NLMSG_NEXT(nlh, remaining)) {
+		requests.push_back(nlh);
+	}
+
+	if ((requests.size() != 5) || (remaining != 0)) {
+		printf("encoding: %d requests in the datagram, %d bytes left over\n", (int)requests.size(), remaining);
+		return 1;
+	}
+
+	for (size_t i = 1; i < requests.size(); i++) {
+		if (requests[i]->nlmsg_seq != requests[0]->nlmsg_seq + i) {
+			printf("encoding: sequence numbers are not consecutive\n");
+			errors++;
+		}
+	}
+
+	errors += check_address_request(requests[0], RTM_NEWADDR, address1, 64);
+	errors += check_address_request(requests[1], RTM_DELADDR, address2, 64);
+	errors += check_route_request(requests[2], RTM_NEWROUTE, prefix1, 48, 0);
+	errors += check_route_request(requests[3], RTM_NEWROUTE, prefix2, 64, 256);
+	errors += check_route_request(requests[4], RTM_DELROUTE, prefix3, 64, 0);
+
+	return errors;
+}
+
+static int
+test_ack_matching(NetlinkRouteManager& manager, FakeKernel& kernel)
+{
+	const NetlinkRouteManager::Stats before = manager.get_stats();
+	NetlinkRouteManager::Stats after;
+	const struct nlmsghdr* nlh;
+	int errors = 0;
+	int error;
+
+	manager.add_address(IFINDEX, make_address("2001:db8::10"), 64);
+	manager.add_route(IFINDEX, make_address("2001:db8:10::"), 64, 0);
+	manager.remove_route(IFINDEX, make_address("2001:db8:11::"), 64, 0);
+	manager.add_route(IFINDEX, make_address("2001:db8:12::"), 64, 0);
+
+	kernel.mDatagrams.clear();
+	kernel.mReverse = true;
+	kernel.mNoise = true;
+
+	// Without looking at the datagram, the sequence numbers follow on
+	// from the ones of the previous test.
+	kernel.mErrors[kernel.mLastSeq + 1] = EEXIST;
+	kernel.mErrors[kernel.mLastSeq + 3] = ESRCH;
+	kernel.mErrors[kernel.mLastSeq + 4] = ENETUNREACH;
+
+	if ((flush_with(manager, kernel, 1, error) != -1) || (error != ENETUNREACH)) {
+		printf("ack matching: flush did not fail with ENETUNREACH: %s\n", strerror(error));
+		errors++;
+	}
+
+	after = manager.get_stats();
+
+	if ((after.mFailures - before.mFailures != 1) || (after.mRequests - before.mRequests != 4)) {
+		printf("ack matching: %d failures, expected 1\n", (int)(after.mFailures - before.mFailures));
+		errors++;
+	}
+
+	nlh = reinterpret_cast<const struct nlmsghdr*>(&kernel.mDatagrams[0][0]);
+	if (nlh->nlmsg_seq != kernel.mLastSeq - 3) {
+		printf("ack matching: sequence numbers did not follow on\n");
+		errors++;
+	}
+
+	kernel.mErrors.clear();
+	kernel.mReverse = false;
+	kernel.mNoise = false;
+
+	return errors;
+}
+
+static int
+test_missing_ack(NetlinkRouteManager& manager, FakeKernel& kernel)
+{
+	cms_t begin;
+	cms_t elapsed;
+	int errors = 0;
+	int error;
+
+	manager.add_route(IFINDEX, make_address("2001:db8:20::"), 64, 0);
+	manager.add_route(IFINDEX, make_address("2001:db8:21::"), 64, 0);
+
+	kernel.mUnanswered.insert(kernel.mLastSeq + 2);
+
+	begin = time_ms();
+
+	if ((flush_with(manager, kernel, 1, error) != -1) || (error != ETIMEDOUT)) {
+		printf("missing ack: flush did not fail with ETIMEDOUT: %s\n", strerror(error));
+		errors++;
+	}
+
+	elapsed = time_ms() - begin;
+
+	if ((elapsed < NetlinkRouteManager::kTimeoutMs / 2) || (elapsed > NetlinkRouteManager::kTimeoutMs + 500)) {
+		printf("missing ack: gave up after %dms, expected about %dms\n", (int)elapsed, NetlinkRouteManager::kTimeoutMs);
+		errors++;
+	}
+
+	kernel.mUnanswered.clear();
+
+	return errors;
+}
+
+static int
+test_batches(NetlinkRouteManager& manager, FakeKernel& kernel)
+{
+	const NetlinkRouteManager::Stats before = manager.get_stats();
+	const int count = 300;
+	NetlinkRouteManager::Stats after;
+	int requests = 0;
+	int errors = 0;
+	int error;
+
+	for (int i = 0; i < count; i++) {
+		struct in6_addr prefix = make_address("2001:db8:100::");
+
+		prefix.s6_addr[4] = static_cast<uint8_t>(i >> 8);
+		prefix.s6_addr[5] = static_cast<uint8_t>(i);
+		manager.add_route(IFINDEX, prefix, 64, i % 3);
+	}
+
+	kernel.mDatagrams.clear();
+	kernel.mReverse = true;
+	kernel.mNoise = true;
+
+	if (flush_with(manager, kernel, 3, error) != 0) {
+		printf("batches: flush failed: %s\n", strerror(error));
+		errors++;
+	}
+
+	after = manager.get_stats();
+
+	if ((kernel.mDatagrams.size() != 3) || (after.mSends - before.mSends != 3)) {
+		printf("batches: sent in %d datagrams, expected 3\n", (int)kernel.mDatagrams.size());
+		return errors + 1;
+	}
+
+	for (size_t i = 0; i < kernel.mDatagrams.size(); i++) {
+		const struct nlmsghdr* nlh = reinterpret_cast<const struct nlmsghdr*>(&kernel.mDatagrams[i][0]);
+
+		for (int remaining = static_cast<int>(kernel.mDatagrams[i].size()); NLMSG_OK(nlh, remaining); nlh = NLMSG_NEXT(nlh, remaining)) {
+			requests++;
+		}
+	}
+
+	if ((requests != count) || (after.mRequests - before.mRequests != count) || (after.mFailures != before.mFailures)) {
+		printf("batches: %d requests sent, expected %d\n", requests, count);
+		errors++;
+	}
+
+	return errors;
+}
+
+static int
+test_not_open(void)
+{
+	NetlinkRouteManager manager;
+
+	manager.add_address(IFINDEX, make_address("2001:db8::1"), 64);
+
+	if ((manager.flush() != -1) || (errno != EBADF) || (manager.get_pending_count() != 0)) {
+		printf("not open: flush did not fail with EBADF\n");
+		return 1;
+	}
+
+	return 0;
+}
+
+int main(void)
+{
+	NetlinkRouteManager manager;
+	int errors = 0;
+	int fds[2];
+
+	if (socketpair(AF_UNIX, SOCK_DGRAM | SOCK_CLOEXEC, 0, fds) != 0) {
+		perror("socketpair");
+		return EXIT_FAILURE;
+	}
+
+	manager.open(fds[0]);
+
+	{
+		FakeKernel kernel(fds[1]);
+
+		errors += test_encoding(manager, kernel);
+		errors += test_ack_matching(manager, kernel);
+		errors += test_missing_ack(manager, kernel);
+		errors += test_batches(manager, kernel);
+	}
+
+	errors += test_not_open();
+
+	close(fds[1]);
+
+	if (errors != 0) {
+		printf("FAIL\n");
+		return EXIT_FAILURE;
+	}
+
+	printf("OK\n");
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,262 @@
+/*
+ *
+ * Copyright (c) 2026 Texas Instruments
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *    Description:
+ *      Times the property handler lookup of NCPInstanceBase, using
+ *      `nl::PropertyTable<>` as it does now against the `std::map<>`
+ *      keyed by an upper-cased copy of the name it used before.
+ *
+ *      Usage: propertytable_bench [table size] [lookup count]
+ *
+ */
+
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <time.h>
+#include <map>
+#include <string>
+#include <vector>
+#include "PropertyTable.h"
+#include "wpan-properties.h"
+
+using namespace nl;
+
+// The names looked up. The rest of the table is filled with made up
+// names, so both tables hold as many keys as the daemon registers.
+static const char* const kPropertyNames[] = {
+	kWPANTUNDProperty_NCPProtocolVersion,
+	kWPANTUNDProperty_NCPVersion,
+	kWPANTUNDProperty_NCPInterfaceType,
+	kWPANTUNDProperty_NCPHardwareAddress,
+	kWPANTUNDProperty_NCPCCAThreshold,
+	kWPANTUNDProperty_NCPTXPower,
+	kWPANTUNDProperty_NCPPhyRegion,
+	kWPANTUNDProperty_NCPModeID,
+	kWPANTUNDProperty_UnicastChList,
+	kWPANTUNDProperty_BroadcastChList,
+	kWPANTUNDProperty_AsyncChList,
+	kWPANTUNDProperty_ChSpacing,
+	kWPANTUNDProperty_Ch0CenterFreq,
+	kWPANTUNDProperty_NetworkPANID,
+	kWPANTUNDProperty_UCDwellInterval,
+	kWPANTUNDProperty_BCDwellInterval,
+	kWPANTUNDProperty_BCInterval,
+	kWPANTUNDProperty_UCChFunction,
+	kWPANTUNDProperty_BCChFunction,
+	kWPANTUNDProperty_MacFilterList,
+	kWPANTUNDProperty_MacFilterMode,
+	kWPANTUNDProperty_InterfaceUp,
+	kWPANTUNDProperty_StackUp,
+	kWPANTUNDProperty_NetworkRole,
+	kWPANTUNDProperty_NetworkName,
+	kWPANTUNDProperty_DodagRouteDest,
+	kWPANTUNDProperty_DodagRouteDestBinary,
+	kWPANTUNDProperty_DodagRoute,
+	kWPANTUNDProperty_DodagRouteAsValMap,
+	kWPANTUNDProperty_DodagRouteBinary,
+	kWPANTUNDProperty_NumConnectedDevices,
+	kWPANTUNDProperty_ConnectedDevices,
+	kWPANTUNDProperty_ConnectedDevicesAsValMap,
+	kWPANTUNDProperty_ConnectedDevicesBinary,
+	kWPANTUNDProperty_ConnectedDevicesAll,
+	kWPANTUNDProperty_ConnectedDevicesAllBinary,
+	kWPANTUNDProperty_NetworkTopology,
+	kWPANTUNDProperty_NetworkTopologyAsValMap,
+	kWPANTUNDProperty_NetworkTopologyBinary,
+	kWPANTUNDProperty_NetworkTopologyGeneration,
+	kWPANTUNDProperty_IPv6AllAddresses,
+	kWPANTUNDProperty_ConfigNCPSocketPath,
+	kWPANTUNDProperty_ConfigNCPSocketBaud,
+	kWPANTUNDProperty_ConfigNCPDriverName,
+	kWPANTUNDProperty_ConfigNCPHardResetPath,
+	kWPANTUNDProperty_ConfigNCPPowerPath,
+	kWPANTUNDProperty_ConfigNCPReliabilityLayer,
+	kWPANTUNDProperty_ConfigNCPFirmwareCheckCommand,
+	kWPANTUNDProperty_ConfigNCPFirmwareUpgradeCommand,
+	kWPANTUNDProperty_ConfigTUNInterfaceName,
+	kWPANTUNDProperty_ConfigDaemonPIDFile,
+	kWPANTUNDProperty_ConfigDaemonPrivDropToUser,
+	kWPANTUNDProperty_ConfigDaemonChroot,
+	kWPANTUNDProperty_ConfigDaemonNetworkRetainCommand,
+	kWPANTUNDProperty_ConfigDaemonInboundFrameBudget,
+	kWPANTUNDProperty_ConfigDaemonInboundTimeBudget,
+	kWPANTUNDProperty_ConfigDaemonPropertyCachePath,
+	kWPANTUNDProperty_ConfigDaemonPropertyChangeInterval,
+	kWPANTUNDProperty_ConfigDaemonPropertyChangeBatchSize,
+	kWPANTUNDProperty_ConfigDaemonPropChangedInterval,
+	kWPANTUNDProperty_ConfigDaemonFrameTracePath,
+	kWPANTUNDProperty_ConfigDaemonSerialReaderThread,
+	kWPANTUNDProperty_DaemonVersion,
+	kWPANTUNDProperty_DaemonEnabled,
+	kWPANTUNDProperty_DaemonSyslogMask,
+	kWPANTUNDProperty_DaemonTerminateOnFault,
+	kWPANTUNDProperty_DaemonReadyForHostSleep,
+	kWPANTUNDProperty_DaemonAutoAssociateAfterReset,
+	kWPANTUNDProperty_DaemonAutoFirmwareUpdate,
+	kWPANTUNDProperty_DaemonAutoDeepSleep,
+	kWPANTUNDProperty_DaemonFaultReason,
+	kWPANTUNDProperty_DaemonTickleOnHostDidWake,
+	kWPANTUNDProperty_DaemonIPv6AutoUpdateIntfaceAddrOnNCP,
+	kWPANTUNDProperty_DaemonIPv6FilterUserAddedLinkLocal,
+	kWPANTUNDProperty_DaemonIPv6AutoAddSLAACAddress,
+	kWPANTUNDProperty_DaemonSetDefRouteForAutoAddedPrefix,
+	kWPANTUNDProperty_DaemonOffMeshRouteAutoAddOnInterface,
+	kWPANTUNDProperty_DaemonOffMeshRouteFilterSelfAutoAdded,
+	kWPANTUNDProperty_DaemonOnMeshPrefixAutoAddAsIfaceRoute,
+	kWPANTUNDProperty_DaemonOutboundQueueDepth,
+	kWPANTUNDProperty_DaemonOutboundQueueDrops,
+};
+
+#define PROPERTY_NAME_COUNT     (sizeof(kPropertyNames) / sizeof(kPropertyNames[0]))
+
+static double
+now_ns(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+// Same as NCPInstanceBase::to_upper().
+static std::string
+to_upper(const std::string &str)
+{
+	std::string new_str = str;
+
+	for (size_t i = 0; i < str.length(); i++) {
+		new_str[i] = toupper(new_str[i]);
+	}
+
+	return new_str;
+}
+
+static uint32_t
+run_property_table(const std::vector<std::string>& keys, const std::vector<std::string>& lookups)
+{
+	PropertyTable<uint32_t> table;
+	uint32_t checksum = 0;
+
+	for (size_t i = 0; i < keys.size(); i++) {
+		table.insert(keys[i], static_cast<uint32_t>(i));
+	}
+
+	for (size_t i = 0; i < lookups.size(); i++) {
+		PropertyTable<uint32_t>::handle_type handle = table.find(lookups[i]);
+
+		if (handle != PropertyTable<uint32_t>::kInvalidHandle) {
+			checksum += table.at(handle) + 1;
+		}
+	}
+
+	return checksum;
+}
+
+// What the handler registries did before.
+static uint32_t
+run_map(const std::vector<std::string>& keys, const std::vector<std::string>& lookups)
+{
+	std::map<std::string, uint32_t> table;
+	uint32_t checksum = 0;
+
+	for (size_t i = 0; i < keys.size(); i++) {
+		table[to_upper(keys[i])] = static_cast<uint32_t>(i);
+	}
+
+	for (size_t i = 0; i < lookups.size(); i++) {
+		std::map<std::string, uint32_t>::const_iterator iter = table.find(to_upper(lookups[i]));
+
+		if (iter != table.end()) {
+			checksum += iter->second + 1;
+		}
+	}
+
+	return checksum;
+}
+
+static uint32_t
+report(const char *name, const std::vector<std::string>& keys, const std::vector<std::string>& lookups,
+	uint32_t (*run)(const std::vector<std::string>&, const std::vector<std::string>&))
+{
+	double begin = now_ns();
+	uint32_t checksum = run(keys, lookups);
+	double elapsed = now_ns() - begin;
+
+	printf("%-14s %12.1f %12.0f\n",
+		name,
+		elapsed / lookups.size(),
+		lookups.size() / elapsed * 1e9
+	);
+
+	return checksum;
+}
+
+int
+main(int argc, char* argv[])
+{
+	int table_size = (argc > 1) ? atoi(argv[1]) : 300;
+	int lookup_count = (argc > 2) ? atoi(argv[2]) : 5000000;
+	std::vector<std::string> keys;
+	std::vector<std::string> lookups;
+	uint32_t checksum;
+
+	if ((table_size < (int)PROPERTY_NAME_COUNT) || (lookup_count <= 0)) {
+		fprintf(stderr, "usage: %s [table size, at least %d] [lookup count]\n", argv[0], (int)PROPERTY_NAME_COUNT);
+		return EXIT_FAILURE;
+	}
+
+	for (size_t i = 0; i < PROPERTY_NAME_COUNT; i++) {
+		keys.push_back(kPropertyNames[i]);
+	}
+
+	for (int i = (int)PROPERTY_NAME_COUNT; i < table_size; i++) {
+		char name[32];
+
+		snprintf(name, sizeof(name), "Vendor:Bench:Filler%d", i);
+		keys.push_back(name);
+	}
+
+	// Names come in as the clients spell them: mostly as defined, some
+	// in lower case, and now and then one that isn't there.
+	for (int i = 0; i < lookup_count; i++) {
+		std::string name = kPropertyNames[i % PROPERTY_NAME_COUNT];
+
+		if (i % 4 == 1) {
+			for (size_t j = 0; j < name.size(); j++) {
+				name[j] = tolower(name[j]);
+			}
+		} else if (i % 16 == 3) {
+			name += ":Missing";
+		}
+
+		lookups.push_back(name);
+	}
+
+	printf("%d keys, %d lookups\n\n", table_size, lookup_count);
+	printf("%-14s %12s %12s\n", "table", "ns/lookup", "lookups/s");
+
+	checksum = report("PropertyTable", keys, lookups, &run_property_table);
+
+	if (report("std::map", keys, lookups, &run_map) != checksum) {
+		fprintf(stderr, "The two tables disagree on the lookups\n");
+		return EXIT_FAILURE;
+	}
+
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,169 @@
+/*
+ *
+ * Copyright (c) 2026 Texas Instruments
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *    Description:
+ *      Times bulk `push()` and `pull()` of `nl::RingBuffer<>` against
+ *      the element at a time copies it used to do, on a buffer shaped
+ *      like the outbound queue of the spinel driver.
+ *
+ *      Usage: ringbuffer_bench [megabytes]
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <time.h>
+#include <stdexcept>
+#include "RingBuffer.h"
+
+using namespace nl;
+
+// SPINEL_FRAME_BUFFER_SIZE * 8, which is not a power of two.
+#define QUEUE_SIZE      10400
+
+// The bulk operations of RingBuffer<> before they copied in runs: one
+// element at a time, with a `%` on every step.
+template <typename T, int I>
+class ElementRingBuffer
+{
+public:
+	typedef int size_type;
+
+	static const size_type buffer_size = I;
+
+	ElementRingBuffer() : mReadIdx(0), mWriteIdx(0), mCount(0) { }
+
+	size_type size() const { return mCount; }
+
+	void push(const T* values, size_type value_count)
+	{
+		if (buffer_size - mCount < value_count) {
+			throw std::overflow_error("not enough room in ring buffer");
+		}
+
+		while (value_count--) {
+			mBuffer[mWriteIdx] = *values++;
+			mWriteIdx++;
+			mWriteIdx %= buffer_size;
+			mCount++;
+		}
+	}
+
+	size_type pull(T* values, size_type value_count)
+	{
+		size_type bytes_read = size();
+
+		if (bytes_read < value_count) {
+			value_count = bytes_read;
+		} else {
+			bytes_read = value_count;
+		}
+
+		while (value_count--) {
+			*values++ = mBuffer[mReadIdx];
+			mReadIdx++;
+			mReadIdx %= buffer_size;
+			mCount--;
+		}
+
+		return bytes_read;
+	}
+
+private:
+	size_type mReadIdx, mWriteIdx;
+	size_type mCount;
+	T mBuffer[buffer_size];
+};
+
+static double
+now_seconds(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+// Pushes two frames of `frame_len` bytes and pulls them back out until
+// `total` bytes went through, so the indices keep moving around the
+// buffer and wrapping. Returns GB/s, and a checksum of what came out.
+template <typename Buffer>
+static double
+run(Buffer& buffer, int frame_len, long total, uint32_t& checksum)
+{
+	static uint8_t in[2][2048];
+	static uint8_t out[2048];
+	double begin;
+	long moved = 0;
+
+	for (int i = 0; i < frame_len; i++) {
+		in[0][i] = (uint8_t)(i * 7);
+		in[1][i] = (uint8_t)(i * 13 + 1);
+	}
+
+	checksum = 0;
+	begin = now_seconds();
+
+	while (moved < total) {
+		buffer.push(in[0], frame_len);
+		buffer.push(in[1], frame_len);
+
+		for (int f = 0; f < 2; f++) {
+			buffer.pull(out, frame_len);
+			checksum = checksum * 31 + out[frame_len - 1] + out[moved % frame_len];
+		}
+
+		moved += 2 * frame_len;
+	}
+
+	return moved / (now_seconds() - begin) / 1e9;
+}
+
+int
+main(int argc, char* argv[])
+{
+	static const int frame_lengths[] = { 60, 127, 1280 };
+	static ElementRingBuffer<uint8_t, QUEUE_SIZE> element_buffer;
+	static RingBuffer<uint8_t, QUEUE_SIZE> bulk_buffer;
+	long megabytes = (argc > 1) ? atol(argv[1]) : 256;
+	int ret = EXIT_SUCCESS;
+
+	if (megabytes <= 0) {
+		fprintf(stderr, "usage: %s [megabytes]\n", argv[0]);
+		return EXIT_FAILURE;
+	}
+
+	printf("%ld MB through a %d byte buffer, per frame size\n\n", megabytes, QUEUE_SIZE);
+	printf("%6s %16s %16s\n", "frame", "element GB/s", "bulk GB/s");
+
+	for (size_t i = 0; i < sizeof(frame_lengths) / sizeof(frame_lengths[0]); i++) {
+		uint32_t element_checksum;
+		uint32_t bulk_checksum;
+		double element_rate = run(element_buffer, frame_lengths[i], megabytes << 20, element_checksum);
+		double bulk_rate = run(bulk_buffer, frame_lengths[i], megabytes << 20, bulk_checksum);
+
+		printf("%6d %16.2f %16.2f\n", frame_lengths[i], element_rate, bulk_rate);
+
+		if (element_checksum != bulk_checksum) {
+			fprintf(stderr, "The two buffers disagree on %d byte frames\n", frame_lengths[i]);
+			ret = EXIT_FAILURE;
+		}
+	}
+
+	return ret;
+}
@@ -0,0 +1,307 @@
+/*
+ *
+ * Copyright (c) 2026 Texas Instruments
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *    Description:
+ *      Checks `nl::RingBuffer<>` against a `std::deque<>` over random
+ *      sequences of operations, for power-of-two and other sizes and
+ *      for element types that are and are not trivially copyable.
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <deque>
+#include <string>
+#include "RingBuffer.h"
+
+using namespace nl;
+
+#define ITERATIONS      20000
+
+static uint32_t sRandomState = 0x2545F491;
+
+static uint32_t
+next_random(void)
+{
+	sRandomState ^= sRandomState << 13;
+	sRandomState ^= sRandomState >> 17;
+	sRandomState ^= sRandomState << 5;
+	return sRandomState;
+}
+
+static int sNextValue;
+
+static void
+make_value(uint8_t& value)
+{
+	value = static_cast<uint8_t>(sNextValue++);
+}
+
+static void
+make_value(std::string& value)
+{
+	char buffer[16];
+
+	snprintf(buffer, sizeof(buffer), "%d", sNextValue++);
+	value = buffer;
+}
+
+template <typename R, typename T>
+static bool
+matches(const R& ring, const std::deque<T>& model)
+{
+	typename R::Iterator iter;
+	typename R::ReverseIterator riter;
+	typename std::deque<T>::const_iterator model_iter;
+	typename std::deque<T>::const_reverse_iterator model_riter;
+
+	if ((ring.size() != static_cast<int>(model.size()))
+		|| (ring.empty() != model.empty())
+		|| (ring.full() != (static_cast<int>(model.size()) == R::buffer_size))
+		|| (ring.space_available() != R::buffer_size - static_cast<int>(model.size()))
+	) {
+		return false;
+	}
+
+	if (model.empty()) {
+		return (ring.front() == NULL) && (ring.back() == NULL)
+		    && (ring.size_of_data_ptr() == 0) && (ring.begin() == ring.end());
+	}
+
+	if ((*ring.front() != model.front()) || (*ring.back() != model.back())) {
+		return false;
+	}
+
+	// The read span must be a prefix of the contents, and the write span
+	// must leave room for the rest.
+	if ((ring.size_of_data_ptr() <= 0) || (ring.size_of_data_ptr() > ring.size())
+		|| (ring.data_ptr() != ring.front())
+	) {
+		return false;
+	}
+
+	for (iter = ring.begin(), model_iter = model.begin(); iter != ring.end(); ++iter, ++model_iter) {
+		if ((model_iter == model.end()) || (*iter != *model_iter)) {
+			return false;
+		}
+	}
+
+	if (model_iter != model.end()) {
+		return false;
+	}
+
+	for (riter = ring.rbegin(), model_riter = model.rbegin(); riter != ring.rend(); ++riter, ++model_riter) {
+		if ((model_riter == model.rend()) || (*riter != *model_riter)) {
+			return false;
+		}
+	}
+
+	return model_riter == model.rend();
+}
+
+template <typename T, int I>
+static int
+check_ring_buffer(const char* name)
+{
+	RingBuffer<T, I> ring;
+	std::deque<T> model;
+	T values[I + 8];
+	int errors = 0;
+	int i;
+
+	for (i = 0; (i < ITERATIONS) && (errors == 0); i++) {
+		const int space = I - static_cast<int>(model.size());
+		int count = next_random() % (I + 8);
+		T value;
+
+		switch (next_random() % 10) {
+		case 0:
+			// Bulk push, sometimes more than fits.
+			for (int j = 0; j < count; j++) {
+				make_value(values[j]);
+			}
+			try {
+				ring.push(values, count);
+				if (count > space) {
+					printf("%s: push of %d into %d free did not throw\n", name, count, space);
+					errors++;
+				}
+				model.insert(model.end(), values, values + count);
+			} catch (std::overflow_error&) {
+				if (count <= space) {
+					printf("%s: push of %d into %d free threw\n", name, count, space);
+					errors++;
+				}
+			}
+			break;
+
+		case 1:
+			// Bulk push over the oldest.
+			for (int j = 0; j < count; j++) {
+				make_value(values[j]);
+			}
+			{
+				int expected_dropped = 0;
+
+				model.insert(model.end(), values, values + count);
+				while (static_cast<int>(model.size()) > I) {
+					model.pop_front();
+					expected_dropped++;
+				}
+				expected_dropped -= (count > I) ? (count - I) : 0;
+
+				if (ring.force_push(values, count) != expected_dropped) {
+					printf("%s: force_push dropped wrong count\n", name);
+					errors++;
+				}
+			}
+			break;
+
+		case 2:
+		case 3:
+			// Bulk pull, sometimes more than there is.
+			{
+				const int expected = (count < static_cast<int>(model.size())) ? count : static_cast<int>(model.size());
+
+				if (ring.pull(values, count) != expected) {
+					printf("%s: pull returned wrong count\n", name);
+					errors++;
+					break;
+				}
+				for (int j = 0; j < expected; j++) {
+					if (values[j] != model.front()) {
+						printf("%s: pull returned wrong value\n", name);
+						errors++;
+						break;
+					}
+					model.pop_front();
+				}
+			}
+			break;
+
+		case 4:
+			// Read through the spans, as a caller writing to a socket would.
+			count %= 1 + ring.size_of_data_ptr();
+			for (int j = 0; j < count; j++) {
+				if (ring.data_ptr()[j] != model[j]) {
+					printf("%s: read span has wrong value\n", name);
+					errors++;
+					break;
+				}
+			}
+			if (ring.pop(count) != count) {
+				printf("%s: pop returned wrong count\n", name);
+				errors++;
+			}
+			model.erase(model.begin(), model.begin() + count);
+			break;
+
+		case 5:
+			// Fill in through the spans, as a caller reading from a
+			// socket would.
+			if (ring.size_of_write_ptr() > space) {
+				printf("%s: write span larger than free space\n", name);
+				errors++;
+				break;
+			}
+			if ((space > 0) && (ring.size_of_write_ptr() == 0)) {
+				printf("%s: empty write span with %d free\n", name, space);
+				errors++;
+				break;
+			}
+			count %= 1 + ring.size_of_write_ptr();
+			for (int j = 0; j < count; j++) {
+				make_value(ring.write_ptr()[j]);
+				model.push_back(ring.write_ptr()[j]);
+			}
+			ring.commit(count);
+			break;
+
+		case 6:
+			make_value(value);
+			if (ring.write(value) != (space > 0)) {
+				printf("%s: write returned wrong result\n", name);
+				errors++;
+			}
+			if (space > 0) {
+				model.push_back(value);
+			}
+			break;
+
+		case 7:
+			make_value(value);
+			ring.force_write(value);
+			if (space == 0) {
+				model.pop_front();
+			}
+			model.push_back(value);
+			break;
+
+		case 8:
+			if (ring.read(value) != !model.empty()) {
+				printf("%s: read returned wrong result\n", name);
+				errors++;
+			} else if (!model.empty()) {
+				if (value != model.front()) {
+					printf("%s: read returned wrong value\n", name);
+					errors++;
+				}
+				model.pop_front();
+			}
+			break;
+
+		default:
+			if ((next_random() % 16) == 0) {
+				ring.clear();
+				model.clear();
+			} else if (ring.remove() != !model.empty()) {
+				printf("%s: remove returned wrong result\n", name);
+				errors++;
+			} else if (!model.empty()) {
+				model.pop_front();
+			}
+			break;
+		}
+
+		if ((errors == 0) && !matches(ring, model)) {
+			printf("%s: contents differ after %d operations\n", name, i + 1);
+			errors++;
+		}
+	}
+
+	return errors;
+}
+
+int main(void)
+{
+	int errors = 0;
+
+	errors += check_ring_buffer<uint8_t, 1>("uint8_t[1]");
+	errors += check_ring_buffer<uint8_t, 5>("uint8_t[5]");
+	errors += check_ring_buffer<uint8_t, 64>("uint8_t[64]");
+	errors += check_ring_buffer<uint8_t, 1300>("uint8_t[1300]");
+	errors += check_ring_buffer<std::string, 8>("string[8]");
+	errors += check_ring_buffer<std::string, 40>("string[40]");
+
+	if (errors != 0) {
+		printf("FAIL\n");
+		return EXIT_FAILURE;
+	}
+
+	printf("OK\n");
+	return EXIT_SUCCESS;
+}
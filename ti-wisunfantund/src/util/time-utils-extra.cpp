@@ -17,6 +17,10 @@
  *
  */
 
+#if HAVE_CONFIG_H
+#include <config.h>
+#endif
+
 #include "time-utils.h"
 
 #if USE_BOOST_CHRONO_MONOTONIC_TIME
@@ -27,4 +31,17 @@ extern "C" uint64_t time_get_monotonic_us() {
 		boost::chrono::steady_clock::now().time_since_epoch())
 			.count();
 }
+#elif HAVE_CLOCK_GETTIME && !FUZZING_BUILD_MODE_UNSAFE_FOR_PRODUCTION
+extern "C" uint64_t time_get_monotonic_us() {
+	struct timespec ts = { 0 };
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return static_cast<uint64_t>(ts.tv_sec) * MSEC_PER_SEC * USEC_PER_MSEC
+		+ static_cast<uint64_t>(ts.tv_nsec) / (NSEC_PER_MSEC / USEC_PER_MSEC);
+}
+#else
+extern "C" uint64_t time_get_monotonic_us() {
+	return static_cast<uint64_t>(time_ms()) * USEC_PER_MSEC;
+}
 #endif // USE_BOOST_CHRONO_MONOTONIC_TIME
@@ -28,7 +28,9 @@
 #include "args.h"
 #include "assert-macros.h"
 #include "wpan-dbus.h"
+#include "wpan-properties.h"
 
+#include <stdlib.h>
 #include <string.h>
 
 const char getprop_cmd_syntax[] = "[args] <property-name>";
@@ -36,56 +38,245 @@ const char getprop_cmd_syntax[] = "[args] <property-name>";
 static const arg_list_item_t getprop_option_list[] = {
 	{'h', "help", NULL, "Print Help.  For the list of TI Wi-SUN Supported Properties, please see ti_wisun_commands.MD."},
 	{'t', "timeout", "ms", "Set timeout period"},
+	{'a', "all", NULL, "Print all properties"},
 	{'v', "value-only", NULL, "Print only the value of the property"},
 	{0}
 };
 
-#define MAX_CONNECTED_DEVICES 1000
-#define TMP_CONNECTED_DEVICES_FILENAME "wfanctl_connected_devices_output.txt"
-char* connected_devices[MAX_CONNECTED_DEVICES] = {NULL};
-FILE *connected_devices_fp;
+// `get connecteddevices` asks the daemon for the whole list at once
+// instead of reading it one block per call.
+#define CONNECTED_DEVICES_PROPERTY_NAME "connecteddevices"
 
-void add_to_connected_devices_array(char* connected_device)
+// Finds the dictionary entry for `key` in the `a{sv}` or `a{si}` at
+// `dict_iter`, leaving `value_iter` on its value.
+static bool
+find_dict_entry(DBusMessageIter *dict_iter, const char *key, DBusMessageIter *value_iter)
 {
-	int i;
-	for(i=0; i<MAX_CONNECTED_DEVICES; i++) {
-		// If the device is already in the array, return
-		if (connected_devices[i] != NULL && (strcmp(connected_devices[i], connected_device) == 0))
-			return;
-		// If the spot is empty, add this device
-		if (connected_devices[i] == NULL) {
-			connected_devices[i] = strdup(connected_device);
-			return;
+	DBusMessageIter entries_iter;
+
+	if (dbus_message_iter_get_arg_type(dict_iter) != DBUS_TYPE_ARRAY) {
+		return false;
+	}
+
+	dbus_message_iter_recurse(dict_iter, &entries_iter);
+
+	for (;
+	     dbus_message_iter_get_arg_type(&entries_iter) == DBUS_TYPE_DICT_ENTRY;
+	     dbus_message_iter_next(&entries_iter)) {
+		const char *entry_key = NULL;
+
+		dbus_message_iter_recurse(&entries_iter, value_iter);
+		dbus_message_iter_get_basic(value_iter, &entry_key);
+
+		if (strcmp(entry_key, key) == 0) {
+			dbus_message_iter_next(value_iter);
+			return true;
 		}
 	}
+
+	return false;
 }
 
-bool parse_connected_devices_output(void)
-{
-	char * line = NULL;
-	size_t len = 0;
-	ssize_t read;
-	bool find_more_devices = true;
-
-	if (connected_devices_fp != NULL) {
-		rewind(connected_devices_fp);
-		while ((read = getline(&line, &len, connected_devices_fp)) != -1) {
-			// If the line says 'Last IPs' then no need to find more devices
-			char *ret;
-			ret = strstr(line, "Last IPs");
-			if (ret) {
-				find_more_devices = false;
-			}
+// Reads all of `property_names` with a single PropGetMany call and
+// prints them in the order given.
+static int
+getprop_many(
+	DBusConnection *connection,
+	const char *interface_dbus_name,
+	const char *path,
+	const char **property_names,
+	int count,
+	int timeout,
+	bool value_only,
+	const char *cmd_name
+) {
+	int ret = 0;
+	int i;
+	DBusMessage *message = NULL;
+	DBusMessage *reply = NULL;
+	DBusMessageIter iter;
+	DBusMessageIter values_iter;
+	DBusMessageIter status_iter;
+	DBusError error;
+
+	dbus_error_init(&error);
+
+	message = dbus_message_new_method_call(
+	    interface_dbus_name,
+	    path,
+	    WPAN_TUNNEL_DBUS_INTERFACE,
+	    WPANTUND_IF_CMD_PROP_GET_MANY
+	    );
+
+	dbus_message_append_args(
+	    message,
+	    DBUS_TYPE_ARRAY, DBUS_TYPE_STRING, &property_names, count,
+	    DBUS_TYPE_INVALID
+	    );
+
+	reply = dbus_connection_send_with_reply_and_block(
+	    connection,
+	    message,
+	    timeout,
+	    &error
+	    );
+
+	if (!reply) {
+		fprintf(stderr, "%s: error: %s\n", cmd_name, error.message);
+		ret = ERRORCODE_TIMEOUT;
+		goto bail;
+	}
+
+	dbus_message_iter_init(reply, &iter);
+
+	// Get return code
+	dbus_message_iter_get_basic(&iter, &ret);
+
+	if (ret) {
+		fprintf(stderr, "%s: %s (%d)\n", cmd_name, wpantund_status_to_cstr(ret), ret);
+		goto bail;
+	}
+
+	dbus_message_iter_next(&iter);
+	values_iter = iter;
+	dbus_message_iter_next(&iter);
+	status_iter = iter;
+
+	for (i = 0; i < count; i++) {
+		DBusMessageIter value_iter;
 
-			const char firstChar = line[0];
-			// If firstChar is a digit, the line being read is an IP address
-			if( firstChar >= '0' && firstChar <= '9' ) {
-				add_to_connected_devices_array(line); // line == connected_device IP
+		if (find_dict_entry(&values_iter, property_names[i], &value_iter)) {
+			if (!value_only) {
+				fprintf(stdout, "%s = ", property_names[i]);
 			}
+			dump_info_from_iter(stdout, &value_iter, 0, false, false);
+
+		} else if (find_dict_entry(&status_iter, property_names[i], &value_iter)) {
+			int status = 0;
+
+			dbus_message_iter_get_basic(&value_iter, &status);
+			fprintf(stderr, "%s: %s (%d)\n", property_names[i], wpantund_status_to_cstr(status), status);
+			ret = status;
 		}
-		fclose(connected_devices_fp);
 	}
-	return find_more_devices;
+
+bail:
+
+	if (message)
+		dbus_message_unref(message);
+
+	if (reply)
+		dbus_message_unref(reply);
+
+	dbus_error_free(&error);
+
+	return ret;
+}
+
+// Reads every connected device with a single call and prints them, one
+// uncompressed address per line.
+static int
+getprop_connected_devices(
+	DBusConnection *connection,
+	const char *interface_dbus_name,
+	const char *path,
+	int timeout,
+	const char *cmd_name
+) {
+	int ret = 0;
+	const char *property_name = kWPANTUNDProperty_ConnectedDevicesAllBinary;
+	DBusMessage *message = NULL;
+	DBusMessage *reply = NULL;
+	DBusMessageIter iter;
+	DBusMessageIter array_iter;
+	DBusError error;
+	const uint8_t *addresses = NULL;
+	int addresses_len = 0;
+	int count;
+	int i;
+
+	dbus_error_init(&error);
+
+	message = dbus_message_new_method_call(
+	    interface_dbus_name,
+	    path,
+	    WPAN_TUNNEL_DBUS_INTERFACE,
+	    WPANTUND_IF_CMD_PROP_GET
+	    );
+
+	dbus_message_append_args(
+	    message,
+	    DBUS_TYPE_STRING, &property_name,
+	    DBUS_TYPE_INVALID
+	    );
+
+	reply = dbus_connection_send_with_reply_and_block(
+	    connection,
+	    message,
+	    timeout,
+	    &error
+	    );
+
+	if (!reply) {
+		fprintf(stderr, "%s: error: %s\n", cmd_name, error.message);
+		ret = ERRORCODE_TIMEOUT;
+		goto bail;
+	}
+
+	dbus_message_iter_init(reply, &iter);
+
+	// Get return code
+	dbus_message_iter_get_basic(&iter, &ret);
+
+	if (ret) {
+		fprintf(stderr, "%s: %s (%d)\n", CONNECTED_DEVICES_PROPERTY_NAME, wpantund_status_to_cstr(ret), ret);
+		goto bail;
+	}
+
+	// Move to the addresses, 16 bytes each
+	dbus_message_iter_next(&iter);
+
+	if (dbus_message_iter_get_arg_type(&iter) == DBUS_TYPE_VARIANT) {
+		dbus_message_iter_recurse(&iter, &iter);
+	}
+
+	if ((dbus_message_iter_get_arg_type(&iter) != DBUS_TYPE_ARRAY)
+	 || (dbus_message_iter_get_element_type(&iter) != DBUS_TYPE_BYTE)
+	) {
+		fprintf(stderr, "%s: error: Unexpected reply from the daemon\n", cmd_name);
+		ret = ERRORCODE_UNKNOWN;
+		goto bail;
+	}
+
+	dbus_message_iter_recurse(&iter, &array_iter);
+	dbus_message_iter_get_fixed_array(&array_iter, &addresses, &addresses_len);
+
+	count = addresses_len / 16;
+
+	fprintf(stdout, "%s = \"\nList of connected devices currently in routing table:\n\n", CONNECTED_DEVICES_PROPERTY_NAME);
+
+	for (i = 0; i < count; i++, addresses += 16) {
+		fprintf(stdout,
+		        "%02x%02x:%02x%02x:%02x%02x:%02x%02x:%02x%02x:%02x%02x:%02x%02x:%02x%02x\n",
+		        addresses[0], addresses[1], addresses[2], addresses[3],
+		        addresses[4], addresses[5], addresses[6], addresses[7],
+		        addresses[8], addresses[9], addresses[10], addresses[11],
+		        addresses[12], addresses[13], addresses[14], addresses[15]);
+	}
+
+	fprintf(stdout, "\nNumber of connected devices: %d\n\"\n", count);
+
+bail:
+
+	if (message)
+		dbus_message_unref(message);
+
+	if (reply)
+		dbus_message_unref(reply);
+
+	dbus_error_free(&error);
+
+	return ret;
 }
 
 int tool_cmd_getprop(int argc, char *argv[])
@@ -168,14 +359,25 @@ int tool_cmd_getprop(int argc, char *argv[])
 	}
 
 	if (optind + 1 < argc) {
-		int cmd_and_flags = optind;
 		int j;
+
+		// Connected devices are printed in their own format, so read one
+		// property at a time.
 		for (j = optind; j < argc; j++) {
-			optind = 0;
-			argv[cmd_and_flags] = argv[j];
-			ret = tool_cmd_getprop(cmd_and_flags + 1, argv);
+			if (strcmp(argv[j], CONNECTED_DEVICES_PROPERTY_NAME) == 0) {
+				break;
+			}
+		}
+
+		if (j < argc) {
+			int cmd_and_flags = optind;
+			for (j = optind; j < argc; j++) {
+				optind = 0;
+				argv[cmd_and_flags] = argv[j];
+				ret = tool_cmd_getprop(cmd_and_flags + 1, argv);
+			}
+			goto bail;
 		}
-		goto bail;
 	}
 
 
@@ -198,6 +400,19 @@ int tool_cmd_getprop(int argc, char *argv[])
 		         WPAN_TUNNEL_DBUS_PATH,
 		         gInterfaceName);
 
+		if (!get_all && (strcmp(property_name, CONNECTED_DEVICES_PROPERTY_NAME) == 0)) {
+			if (!value_only) {
+				ret = getprop_connected_devices(connection, interface_dbus_name, path, timeout, argv[0]);
+			}
+			goto bail;
+		}
+
+		if (!get_all && (optind + 1 < argc)) {
+			ret = getprop_many(connection, interface_dbus_name, path, (const char **)&argv[optind],
+			                   argc - optind, timeout, value_only, argv[0]);
+			goto bail;
+		}
+
 		message = dbus_message_new_method_call(
 		    interface_dbus_name,
 		    path,
@@ -251,46 +466,38 @@ int tool_cmd_getprop(int argc, char *argv[])
 		dbus_message_iter_next(&iter);
 
 		if (get_all) {
+			const char **property_names = NULL;
+			int count = 0;
+
+			// The reply holds the names of all the properties...
 			dbus_message_iter_recurse(&iter, &list_iter);
 
-			for (;
+			while (dbus_message_iter_get_arg_type(&list_iter) == DBUS_TYPE_STRING) {
+				count++;
+				dbus_message_iter_next(&list_iter);
+			}
+
+			property_names = calloc(count + 1, sizeof(*property_names));
+			require_action(property_names != NULL, bail, ret = ERRORCODE_UNKNOWN);
+
+			dbus_message_iter_recurse(&iter, &list_iter);
+
+			for (count = 0;
 			     dbus_message_iter_get_arg_type(&list_iter) == DBUS_TYPE_STRING;
 			     dbus_message_iter_next(&list_iter)) {
-				char* args[3] = { argv[0] };
-				dbus_message_iter_get_basic(&list_iter, &args[1]);
-				ret = tool_cmd_getprop(2, args);
+				dbus_message_iter_get_basic(&list_iter, &property_names[count++]);
 			}
+
+			// Then read them all in a single call, on this same connection.
+			ret = getprop_many(connection, interface_dbus_name, path, property_names, count,
+			                   timeout, value_only, argv[0]);
+
+			free(property_names);
 		} else {
-			if(!value_only && property_name[0])
-			{
-				// Do special parsing for connecteddevices
-				if (strcmp(property_name, "connecteddevices") == 0)
-				{
-					connected_devices_fp = fopen(TMP_CONNECTED_DEVICES_FILENAME, "w+");
-					dump_info_from_iter(connected_devices_fp, &iter, 0, false, false);
-					// Parse returns true if need to poll for more devices;
-					if (parse_connected_devices_output())
-					{
-						// Call same command (get connecteddevices again)
-						ret = tool_cmd_getprop(argc, argv);
-					} else {
-						// Print the connected devices once they've all been found
-						fprintf(stdout, "%s = \"\nList of connected devices currently in routing table:\n\n", property_name);
-						int index = 0;
-						while(index < MAX_CONNECTED_DEVICES && connected_devices[index] != NULL) {
-							fprintf(stdout, "%s", connected_devices[index]);
-							index ++;
-						}
-						fprintf(stdout, "\nNumber of connected devices: %d\n\"\n", index);
-						// Reset the connected_devices_array and remove temp output file since get connecteddevices is complete
-						memset(connected_devices, '\0', MAX_CONNECTED_DEVICES);
-						remove(TMP_CONNECTED_DEVICES_FILENAME);
-					}
-				} else {
-					fprintf(stdout, "%s = ", property_name);
-					dump_info_from_iter(stdout, &iter, 0, false, false);
-				}
-			}			
+			if (!value_only && property_name[0]) {
+				fprintf(stdout, "%s = ", property_name);
+				dump_info_from_iter(stdout, &iter, 0, false, false);
+			}
 		}
 	}
 
@@ -0,0 +1,401 @@
+/*
+ *
+ * Copyright (c) 2026 Texas Instruments
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#if HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <getopt.h>
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "wpanctl-utils.h"
+#include "tool-cmd-trace.h"
+#include "assert-macros.h"
+#include "args.h"
+#include "wpan-dbus.h"
+#include "wpan-properties.h"
+#include "frame-trace.h"
+#include "spinel.h"
+
+const char trace_cmd_syntax[] = "[args]";
+
+static const arg_list_item_t trace_option_list[] = {
+	{'h', "help", NULL, "Print Help"},
+	{'t', "timeout", "ms", "Set timeout period"},
+	{'o', "output", "file", "Save the raw trace to a file instead of printing it"},
+	{'f', "file", "file", "Print a trace saved earlier instead of asking the daemon"},
+	{0}
+};
+
+static uint64_t
+read_le(const uint8_t *ptr, int len)
+{
+	uint64_t value = 0;
+
+	while (len-- > 0) {
+		value = (value << 8) | ptr[len];
+	}
+
+	return value;
+}
+
+// Prints the frames held in a trace dump, one per line, with the wall
+// clock time each of them was seen at.
+static int
+print_trace(FILE *out, const uint8_t *trace_ptr, size_t trace_len)
+{
+	int ret = ERRORCODE_OK;
+	uint32_t count;
+	uint8_t record_len;
+	uint64_t dump_monotonic_us;
+	uint64_t dump_realtime_us;
+	uint32_t i;
+
+	if ((trace_len < FRAME_TRACE_HEADER_LEN) || (memcmp(trace_ptr, FRAME_TRACE_MAGIC, 4) != 0)) {
+		fprintf(stderr, "trace: error: Not a frame trace\n");
+		ret = ERRORCODE_BADARG;
+		goto bail;
+	}
+
+	if (trace_ptr[4] != FRAME_TRACE_VERSION) {
+		fprintf(stderr, "trace: error: Unsupported frame trace version %d\n", trace_ptr[4]);
+		ret = ERRORCODE_BADVERSION;
+		goto bail;
+	}
+
+	record_len = trace_ptr[5];
+	count = (uint32_t)read_le(trace_ptr + 8, 4);
+	dump_monotonic_us = read_le(trace_ptr + 12, 8);
+	dump_realtime_us = read_le(trace_ptr + 20, 8);
+
+	if ((record_len < FRAME_TRACE_RECORD_LEN)
+	 || ((trace_len - FRAME_TRACE_HEADER_LEN) / record_len < count)
+	) {
+		fprintf(stderr, "trace: error: Truncated frame trace\n");
+		ret = ERRORCODE_BADARG;
+		goto bail;
+	}
+
+	trace_ptr += FRAME_TRACE_HEADER_LEN;
+
+	for (i = 0; i < count; i++, trace_ptr += record_len) {
+		uint64_t timestamp = read_le(trace_ptr, 8);
+		uint32_t command = (uint32_t)read_le(trace_ptr + 8, 4);
+		uint32_t key = (uint32_t)read_le(trace_ptr + 12, 4);
+		uint16_t frame_len = (uint16_t)read_le(trace_ptr + 16, 2);
+		uint8_t direction = trace_ptr[18];
+		uint8_t tid = trace_ptr[19];
+		uint8_t flags = trace_ptr[20];
+		uint8_t payload_len = trace_ptr[21];
+		uint64_t realtime_us = dump_realtime_us - (dump_monotonic_us - timestamp);
+		time_t seconds = (time_t)(realtime_us / 1000000);
+		struct tm tm;
+		char time_str[32];
+		int j;
+
+		localtime_r(&seconds, &tm);
+		strftime(time_str, sizeof(time_str), "%Y-%m-%d %H:%M:%S", &tm);
+
+		fprintf(
+			out,
+			"%s.%06u %s (%d) %s",
+			time_str,
+			(unsigned int)(realtime_us % 1000000),
+			(direction == FRAME_TRACE_DIRECTION_TO_NCP) ? "[->NCP]" : "[NCP->]",
+			tid,
+			spinel_command_to_cstr(command)
+		);
+
+		if (flags & FRAME_TRACE_FLAG_HAS_KEY) {
+			fprintf(out, "(%s)", spinel_prop_key_to_cstr(key));
+		}
+
+		fprintf(out, " len:%d", frame_len);
+
+		if (flags & FRAME_TRACE_FLAG_REDACTED) {
+			fprintf(out, " [-- value hidden --]");
+
+		} else if (payload_len > 0) {
+			if (payload_len > FRAME_TRACE_PAYLOAD_MAX) {
+				payload_len = FRAME_TRACE_PAYLOAD_MAX;
+			}
+
+			fprintf(out, " [");
+			for (j = 0; j < payload_len; j++) {
+				fprintf(out, "%02X", trace_ptr[22 + j]);
+			}
+			fprintf(out, "%s]", (payload_len == FRAME_TRACE_PAYLOAD_MAX) ? "..." : "");
+		}
+
+		fprintf(out, "\n");
+	}
+
+bail:
+	return ret;
+}
+
+// Reads the whole of `filename` into a newly allocated buffer.
+static int
+read_trace_file(const char *filename, uint8_t **trace_ptr, size_t *trace_len)
+{
+	int ret = ERRORCODE_OK;
+	FILE *file = NULL;
+	uint8_t *buffer = NULL;
+	size_t len = 0;
+	size_t size = 0;
+
+	file = fopen(filename, "rb");
+
+	if (file == NULL) {
+		fprintf(stderr, "trace: error: Unable to open \"%s\": %s\n", filename, strerror(errno));
+		ret = ERRORCODE_ERRNO;
+		goto bail;
+	}
+
+	do {
+		if (len == size) {
+			uint8_t *new_buffer;
+
+			size = (size == 0) ? 64 * 1024 : size * 2;
+			new_buffer = realloc(buffer, size);
+			require_action(new_buffer != NULL, bail, ret = ERRORCODE_ALLOC);
+			buffer = new_buffer;
+		}
+
+		len += fread(buffer + len, 1, size - len, file);
+	} while (!feof(file) && !ferror(file));
+
+	*trace_ptr = buffer;
+	*trace_len = len;
+	buffer = NULL;
+
+bail:
+	if (file) {
+		fclose(file);
+	}
+
+	free(buffer);
+
+	return ret;
+}
+
+static int
+write_trace_file(const char *filename, const uint8_t *trace_ptr, size_t trace_len)
+{
+	int ret = ERRORCODE_OK;
+	FILE *file = fopen(filename, "wb");
+
+	if ((file == NULL)
+	 || (fwrite(trace_ptr, 1, trace_len, file) != trace_len)
+	) {
+		fprintf(stderr, "trace: error: Unable to write \"%s\": %s\n", filename, strerror(errno));
+		ret = ERRORCODE_ERRNO;
+	}
+
+	if (file) {
+		fclose(file);
+	}
+
+	return ret;
+}
+
+int tool_cmd_trace(int argc, char *argv[])
+{
+	int ret = 0;
+	int c;
+	int timeout = 10 * 1000;
+	DBusConnection *connection = NULL;
+	DBusMessage *message = NULL;
+	DBusMessage *reply = NULL;
+	DBusError error;
+	const char *property_name = kWPANTUNDProperty_DaemonFrameTrace;
+	const char *output_filename = NULL;
+	const char *input_filename = NULL;
+	uint8_t *trace_ptr = NULL;
+	int trace_len = 0;
+
+	dbus_error_init(&error);
+
+	optind = 0;
+
+	while (1) {
+		static struct option long_options[] = {
+			{"help", no_argument, 0, 'h'},
+			{"timeout", required_argument, 0, 't'},
+			{"output", required_argument, 0, 'o'},
+			{"file", required_argument, 0, 'f'},
+			{0, 0, 0, 0}
+		};
+
+		int option_index = 0;
+		c = getopt_long(argc, argv, "ht:o:f:", long_options,
+				&option_index);
+
+		if (c == -1)
+			break;
+
+		switch (c) {
+		case 'h':
+			print_arg_list_help(trace_option_list, argv[0],
+					    trace_cmd_syntax);
+			ret = ERRORCODE_HELP;
+			goto bail;
+
+		case 't':
+			timeout = strtol(optarg, NULL, 0);
+			break;
+
+		case 'o':
+			output_filename = optarg;
+			break;
+
+		case 'f':
+			input_filename = optarg;
+			break;
+		}
+	}
+
+	if (optind < argc) {
+		fprintf(stderr, "%s: error: Unexpected extra argument: \"%s\"\n",
+		        argv[0], argv[optind]);
+		ret = ERRORCODE_BADARG;
+		goto bail;
+	}
+
+	if (input_filename != NULL) {
+		uint8_t *file_ptr = NULL;
+		size_t file_len = 0;
+
+		ret = read_trace_file(input_filename, &file_ptr, &file_len);
+
+		if (ret == ERRORCODE_OK) {
+			ret = print_trace(stdout, file_ptr, file_len);
+		}
+
+		free(file_ptr);
+		goto bail;
+	}
+
+	if (gInterfaceName[0] == 0) {
+		fprintf(stderr,
+		        "%s: error: No WPAN interface set (use the `cd` command, or the `-I` argument for `wpanctl`).\n",
+		        argv[0]);
+		ret = ERRORCODE_BADARG;
+		goto bail;
+	}
+
+	connection = dbus_bus_get(DBUS_BUS_SYSTEM, &error);
+
+	require_string(connection != NULL, bail, error.message);
+
+	{
+		DBusMessageIter iter;
+		DBusMessageIter array_iter;
+		char path[DBUS_MAXIMUM_NAME_LENGTH+1];
+		char interface_dbus_name[DBUS_MAXIMUM_NAME_LENGTH+1];
+
+		ret = lookup_dbus_name_from_interface(interface_dbus_name, gInterfaceName);
+
+		require_noerr(ret, bail);
+
+		snprintf(path,
+		         sizeof(path),
+		         "%s/%s",
+		         WPAN_TUNNEL_DBUS_PATH,
+		         gInterfaceName);
+
+		message = dbus_message_new_method_call(
+		    interface_dbus_name,
+		    path,
+		    WPAN_TUNNEL_DBUS_INTERFACE,
+		    WPANTUND_IF_CMD_PROP_GET
+		    );
+
+		dbus_message_append_args(
+		    message,
+		    DBUS_TYPE_STRING, &property_name,
+		    DBUS_TYPE_INVALID
+		    );
+
+		reply = dbus_connection_send_with_reply_and_block(
+		    connection,
+		    message,
+		    timeout,
+		    &error
+		    );
+
+		if (!reply) {
+			fprintf(stderr, "%s: error: %s\n", argv[0], error.message);
+			ret = ERRORCODE_TIMEOUT;
+			goto bail;
+		}
+
+		dbus_message_iter_init(reply, &iter);
+
+		// Get return code
+		dbus_message_iter_get_basic(&iter, &ret);
+
+		if (ret) {
+			fprintf(stderr, "%s: %s (%d)\n", argv[0], wpantund_status_to_cstr(ret), ret);
+			goto bail;
+		}
+
+		// Move to the trace, an array of bytes
+		dbus_message_iter_next(&iter);
+
+		if (dbus_message_iter_get_arg_type(&iter) == DBUS_TYPE_VARIANT) {
+			dbus_message_iter_recurse(&iter, &iter);
+		}
+
+		if ((dbus_message_iter_get_arg_type(&iter) != DBUS_TYPE_ARRAY)
+		 || (dbus_message_iter_get_element_type(&iter) != DBUS_TYPE_BYTE)
+		) {
+			fprintf(stderr, "%s: error: Unexpected reply from the daemon\n", argv[0]);
+			ret = ERRORCODE_UNKNOWN;
+			goto bail;
+		}
+
+		dbus_message_iter_recurse(&iter, &array_iter);
+		dbus_message_iter_get_fixed_array(&array_iter, &trace_ptr, &trace_len);
+
+		if (output_filename != NULL) {
+			ret = write_trace_file(output_filename, trace_ptr, (size_t)trace_len);
+		} else {
+			ret = print_trace(stdout, trace_ptr, (size_t)trace_len);
+		}
+	}
+
+bail:
+
+	if (connection)
+		dbus_connection_unref(connection);
+
+	if (message)
+		dbus_message_unref(message);
+
+	if (reply)
+		dbus_message_unref(reply);
+
+	dbus_error_free(&error);
+
+	return ret;
+}
@@ -32,6 +32,7 @@
 #include "tool-cmd-remove-route.h"
 #include "tool-cmd-status.h"
 #include "tool-cmd-reset.h"
+#include "tool-cmd-trace.h"
 
 #include "wpanctl-utils.h"
 
@@ -65,6 +66,11 @@
 		"remove", \
 		"Used for removing values to macfilterlist", \
 		&tool_cmd_removeprop, 1 \
+	}, \
+	{ \
+		"trace", \
+		"Print or save the last frames exchanged with the NCP", \
+		&tool_cmd_trace \
 	} \
 
 #endif
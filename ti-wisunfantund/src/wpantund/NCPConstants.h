@@ -39,6 +39,13 @@
 
 #define NCP_DEBUG_LINE_LENGTH_MAX               400
 
+#define NCP_DEFAULT_INBOUND_FRAME_BUDGET        16 // frames per main loop iteration
+#define NCP_DEFAULT_INBOUND_TIME_BUDGET         10 // milliseconds per main loop iteration
+
+#define NCP_DEFAULT_PROPERTY_CHANGE_INTERVAL    100 // milliseconds between property change signals
+#define NCP_DEFAULT_PROPERTY_CHANGE_BATCH_SIZE  32 // properties per property change signal
+#define NCP_DEFAULT_PROP_CHANGED_INTERVAL       1000 // milliseconds between PropChanged signals for a noisy property
+
 #if HAVE_LIBUDEV
 #define NCP_RESET_TIMEOUT                       10 // seconds
 #else
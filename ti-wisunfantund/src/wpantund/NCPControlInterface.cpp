@@ -87,6 +87,18 @@ struct GetPropertyHelper {
 	}
 };
 
+NCPControlInterface::PropertyHandle
+NCPControlInterface::get_property_handle(const std::string& key)
+{
+	return kInvalidPropertyHandle;
+}
+
+void
+NCPControlInterface::property_get_value_with_handle(PropertyHandle handle, CallbackWithStatusArg1 cb)
+{
+	cb(kWPANTUNDStatus_PropertyNotFound, boost::any(std::string("Property Not Found")));
+}
+
 boost::any
 NCPControlInterface::property_get_value(const std::string& key)
 {
@@ -166,12 +166,32 @@ public:
 		CallbackWithStatusArg1 cb
 	) = 0;
 
+	//! A key read over and over can be resolved to a handle once and
+	//! then read with `property_get_value_with_handle()`. Keys without
+	//! a handle give `kInvalidPropertyHandle` and are read by name.
+	typedef int PropertyHandle;
+	static const PropertyHandle kInvalidPropertyHandle = -1;
+
+	virtual PropertyHandle get_property_handle(const std::string& key);
+
+	virtual void property_get_value_with_handle(
+		PropertyHandle handle,
+		CallbackWithStatusArg1 cb
+	);
+
 	virtual void property_set_value(
 		const std::string& key,
 		const boost::any& value,
 		CallbackWithStatus cb
 	) = 0;
 
+	//! Property gets issued until the matching `end_property_batch()` may
+	//! be held back, so that gets which need the same value from the NCP
+	//! can share a single request. Batches may be nested.
+	virtual void begin_property_batch(void) { }
+
+	virtual void end_property_batch(void) { }
+
 	virtual void reset_NCP(
 		CallbackWithStatus cb
 	) = 0;
@@ -388,6 +408,18 @@ public:
 
 	boost::signals2::signal<void(const ValueMap&)> mOnNetworkTimeUpdate;
 
+public:
+	// ========================================================================
+	// Topology-related Member Functions
+
+	enum TopologyChange {
+		TOPOLOGY_NODE_JOINED,
+		TOPOLOGY_NODE_LEFT,
+		TOPOLOGY_PARENT_CHANGED,
+	};
+
+	boost::signals2::signal<void(TopologyChange, const ValueMap&)> mOnTopologyChange;
+
 public:
 	// ========================================================================
 	// Power-related Member Functions
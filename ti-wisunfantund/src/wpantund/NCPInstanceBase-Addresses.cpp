@@ -418,6 +418,8 @@ NCPInstanceBase::remove_all_address_prefix_route_entries(void)
 {
 	syslog(LOG_INFO, "Removing all address/prefix/route entries");
 
+	mPrimaryInterface->begin_batch();
+
 	// Unicast addresses
 	for (
 		std::map<struct in6_addr, UnicastAddressEntry>::iterator iter = mUnicastAddresses.begin();
@@ -445,6 +447,8 @@ NCPInstanceBase::remove_all_address_prefix_route_entries(void)
 		mPrimaryInterface->remove_route(&iter->first.get_prefix(), iter->first.get_length(), iter->second.get_metric());
 	}
 
+	mPrimaryInterface->commit_batch();
+
 	memset(&mNCPLinkLocalAddress, 0, sizeof(mNCPLinkLocalAddress));
 	memset(&mNCPMeshLocalAddress, 0, sizeof(mNCPMeshLocalAddress));
 
@@ -1212,6 +1216,9 @@ NCPInstanceBase::refresh_routes_on_interface(void)
 		syslog(LOG_INFO, "Refreshing routes on primary interface");
 	}
 
+	// The removals and additions below go to the kernel together.
+	mPrimaryInterface->begin_batch();
+
 	// First, check all currently added routes on primary interface and remove any one that is no longer valid.
 
 	do {
@@ -1280,6 +1287,39 @@ NCPInstanceBase::refresh_routes_on_interface(void)
 			}
 		}
 	}
+
+	mPrimaryInterface->commit_batch();
+}
+
+void
+NCPInstanceBase::reconcile_address_route_entries_on_interface(void)
+{
+	std::set<NetlinkRouteManager::Address> addresses;
+	std::set<NetlinkRouteManager::Route> routes;
+
+	// The addresses we put on the interface (see `unicast_address_was_added()`)
+	// and the routes in `mInterfaceRoutes`.
+
+	for (
+		std::map<struct in6_addr, UnicastAddressEntry>::iterator iter = mUnicastAddresses.begin();
+		iter != mUnicastAddresses.end();
+		++iter
+	) {
+		if (iter->second.is_from_ncp() || iter->second.is_from_user()) {
+			addresses.insert(NetlinkRouteManager::Address(iter->first, iter->second.get_prefix_len()));
+		}
+	}
+
+	for (
+		std::map<IPv6Prefix, InterfaceRouteEntry>::iterator iter = mInterfaceRoutes.begin();
+		iter != mInterfaceRoutes.end();
+		++iter
+	) {
+		routes.insert(NetlinkRouteManager::Route(iter->first.get_prefix(), iter->first.get_length(),
+			iter->second.get_metric()));
+	}
+
+	IGNORE_RETURN_VALUE(mPrimaryInterface->reconcile(addresses, routes));
 }
 
 // ========================================================================
@@ -205,6 +205,19 @@ bail:
 	return ret;
 }
 
+bool
+NCPInstanceBase::inbound_budget_exhausted(void) const
+{
+	return (mInboundFrameCount >= mInboundFrameBudget)
+	    || (time_ms() - mInboundStartTime >= mInboundTimeBudget);
+}
+
+void
+NCPInstanceBase::inbound_budget_did_starve(void)
+{
+	get_stat_collector().record_inbound_starvation(mInboundFrameCount < mInboundFrameBudget);
+}
+
 void
 NCPInstanceBase::process(void)
 {
@@ -241,7 +254,14 @@ NCPInstanceBase::process(void)
 
 		require_noerr(ret = mSerialAdapter->process(), socket_failure);
 
+		mInboundFrameCount = 0;
+		mInboundStartTime = time_ms();
+
 		ncp_to_driver_pump();
+
+		if (mInboundFrameCount != 0) {
+			get_stat_collector().record_inbound_drain(mInboundFrameCount);
+		}
 	}
 
 	EventHandler::process_event(EVENT_IDLE);
@@ -39,6 +39,15 @@ NCPInstanceBase::link_state_changed(bool isUp, bool isRunning)
 {
 	syslog(LOG_INFO, "Primary link state changed: UP=%d RUNNING=%d", isUp, isRunning);
 
+	// Whatever the kernel dropped while the link was down has to be put
+	// back; it won't tell us about addresses it took away from the NCP.
+	// This blocks the main loop, but for no more than
+	// `NetlinkRouteManager::kTimeoutMs`, and only that long if the
+	// kernel fails to answer.
+	if (isUp && isRunning) {
+		reconcile_address_route_entries_on_interface();
+	}
+
 	// The big take away from this callback is "isUp",
 	// because theoretically we are the one who is in charge
 	// of "isRunning". We interpret isUp as meaning if
@@ -35,6 +35,9 @@
 #include "wpantund.h"
 #include "any-to.h"
 #include "IPv6Helpers.h"
+#include "FileExporter.h"
+#include "FrameTrace.h"
+#include "PropertyChangeQueue.h"
 #include <math.h>
 #include <vector>
 
@@ -69,6 +72,13 @@ NCPInstanceBase::NCPInstanceBase(const Settings& settings):
 	mEnabled = true;
 	mFailureCount = 0;
 	mFailureThreshold = 3;
+	mInboundFrameBudget = NCP_DEFAULT_INBOUND_FRAME_BUDGET;
+	mInboundTimeBudget = NCP_DEFAULT_INBOUND_TIME_BUDGET;
+	mInboundFrameCount = 0;
+	mInboundStartTime = 0;
+	mPropertyChangeInterval = NCP_DEFAULT_PROPERTY_CHANGE_INTERVAL;
+	mPropertyChangeBatchSize = NCP_DEFAULT_PROPERTY_CHANGE_BATCH_SIZE;
+	mPropChangedInterval = NCP_DEFAULT_PROP_CHANGED_INTERVAL;
 	mIsInitializingNCP = false;
 	mIsInterfaceOnline = false;
 	mLastChangedBusy = 0;
@@ -443,8 +453,7 @@ NCPInstanceBase::to_upper(const std::string &str)
 void
 NCPInstanceBase::register_prop_get_handler(const char *prop, PropGetHandler handler)
 {
-	std::string key = to_upper(prop);
-	mPropertyGetHandlers[key] = PropGetHandlerEntry(prop, handler);
+	mPropertyGetHandlers.insert(prop, PropGetHandlerEntry(prop, handler));
 }
 
 void
@@ -522,6 +531,16 @@ NCPInstanceBase::regsiter_all_get_handlers(void)
 	REGISTER_GET_HANDLER(IPv6MulticastAddresses);
 	REGISTER_GET_HANDLER(IPv6InterfaceRoutes);
 	REGISTER_GET_HANDLER(DaemonSyslogMask);
+	REGISTER_GET_HANDLER(ConfigDaemonInboundFrameBudget);
+	REGISTER_GET_HANDLER(ConfigDaemonInboundTimeBudget);
+	REGISTER_GET_HANDLER(DaemonFileExportBacklog);
+	REGISTER_GET_HANDLER(DaemonFileExportLatency);
+	REGISTER_GET_HANDLER(ConfigDaemonPropertyChangeInterval);
+	REGISTER_GET_HANDLER(ConfigDaemonPropertyChangeBatchSize);
+	REGISTER_GET_HANDLER(ConfigDaemonPropChangedInterval);
+	REGISTER_GET_HANDLER(DaemonPropertyChangeStats);
+	REGISTER_GET_HANDLER(ConfigDaemonFrameTracePath);
+	REGISTER_GET_HANDLER(DaemonFrameTrace);
 
 #undef REGISTER_GET_HANDLER
 }
@@ -529,12 +548,10 @@ NCPInstanceBase::regsiter_all_get_handlers(void)
 void
 NCPInstanceBase::property_get_value(const std::string &key, CallbackWithStatusArg1 cb)
 {
-	std::map<std::string, PropGetHandlerEntry>::iterator iter;
+	PropertyHandle handle = NCPInstanceBase::get_property_handle(key);
 
-	iter = mPropertyGetHandlers.find(to_upper(key));
-
-	if (iter != mPropertyGetHandlers.end()) {
-		iter->second(cb);
+	if (handle != kInvalidPropertyHandle) {
+		NCPInstanceBase::property_get_value_with_handle(handle, cb);
 
 	} else if (StatCollector::is_a_stat_property(key)) {
 		get_stat_collector().property_get_value(key, cb);
@@ -544,6 +561,23 @@ NCPInstanceBase::property_get_value(const std::string &key, CallbackWithStatusAr
 		cb(kWPANTUNDStatus_PropertyNotFound, boost::any(std::string("Property Not Found")));
 	}
 }
+
+NCPInstanceBase::PropertyHandle
+NCPInstanceBase::get_property_handle(const std::string& key) const
+{
+	return mPropertyGetHandlers.find(key);
+}
+
+void
+NCPInstanceBase::property_get_value_with_handle(PropertyHandle handle, CallbackWithStatusArg1 cb)
+{
+	if ((handle >= 0) && (handle < mPropertyGetHandlers.size())) {
+		mPropertyGetHandlers.at(handle)(cb);
+	} else {
+		cb(kWPANTUNDStatus_PropertyNotFound, boost::any(std::string("Property Not Found")));
+	}
+}
+
 void
 NCPInstanceBase::get_prop_DodagRouteDest(CallbackWithStatusArg1 cb)
 {
@@ -1057,6 +1091,90 @@ NCPInstanceBase::get_prop_DaemonSyslogMask(CallbackWithStatusArg1 cb)
 	cb(kWPANTUNDStatus_Ok, mask_string);
 }
 
+void
+NCPInstanceBase::get_prop_ConfigDaemonInboundFrameBudget(CallbackWithStatusArg1 cb)
+{
+	cb(kWPANTUNDStatus_Ok, boost::any(mInboundFrameBudget));
+}
+
+void
+NCPInstanceBase::get_prop_ConfigDaemonInboundTimeBudget(CallbackWithStatusArg1 cb)
+{
+	cb(kWPANTUNDStatus_Ok, boost::any(static_cast<int>(mInboundTimeBudget)));
+}
+
+void
+NCPInstanceBase::get_prop_DaemonFileExportBacklog(CallbackWithStatusArg1 cb)
+{
+	FileExporter::Stats stats = FileExporter::shared().get_stats();
+	ValueMap result;
+
+	result[kWPANTUNDValueMapKey_FileExport_Pending] = boost::any(stats.mBacklog);
+	result[kWPANTUNDValueMapKey_FileExport_Written] = boost::any(stats.mWritten);
+	result[kWPANTUNDValueMapKey_FileExport_Coalesced] = boost::any(stats.mCoalesced);
+	result[kWPANTUNDValueMapKey_FileExport_Failed] = boost::any(stats.mFailed);
+
+	cb(kWPANTUNDStatus_Ok, boost::any(result));
+}
+
+void
+NCPInstanceBase::get_prop_DaemonFileExportLatency(CallbackWithStatusArg1 cb)
+{
+	FileExporter::Stats stats = FileExporter::shared().get_stats();
+	ValueMap result;
+
+	result[kWPANTUNDValueMapKey_FileExport_LatencyAvg] = boost::any(stats.mLatencyAvg);
+	result[kWPANTUNDValueMapKey_FileExport_LatencyMax] = boost::any(stats.mLatencyMax);
+
+	cb(kWPANTUNDStatus_Ok, boost::any(result));
+}
+
+void
+NCPInstanceBase::get_prop_ConfigDaemonPropertyChangeInterval(CallbackWithStatusArg1 cb)
+{
+	cb(kWPANTUNDStatus_Ok, boost::any(mPropertyChangeInterval));
+}
+
+void
+NCPInstanceBase::get_prop_ConfigDaemonPropertyChangeBatchSize(CallbackWithStatusArg1 cb)
+{
+	cb(kWPANTUNDStatus_Ok, boost::any(mPropertyChangeBatchSize));
+}
+
+void
+NCPInstanceBase::get_prop_ConfigDaemonPropChangedInterval(CallbackWithStatusArg1 cb)
+{
+	cb(kWPANTUNDStatus_Ok, boost::any(mPropChangedInterval));
+}
+
+void
+NCPInstanceBase::get_prop_DaemonPropertyChangeStats(CallbackWithStatusArg1 cb)
+{
+	PropertyChangeQueue::Stats stats = PropertyChangeQueue::get_totals();
+	ValueMap result;
+
+	result[kWPANTUNDValueMapKey_PropertyChange_Queued] = boost::any(stats.mQueued);
+	result[kWPANTUNDValueMapKey_PropertyChange_Merged] = boost::any(stats.mMerged);
+	result[kWPANTUNDValueMapKey_PropertyChange_Signals] = boost::any(stats.mSignals);
+	result[kWPANTUNDValueMapKey_PropertyChange_Dropped] = boost::any(stats.mDropped);
+
+	cb(kWPANTUNDStatus_Ok, boost::any(result));
+}
+
+void
+NCPInstanceBase::get_prop_ConfigDaemonFrameTracePath(CallbackWithStatusArg1 cb)
+{
+	cb(kWPANTUNDStatus_Ok, boost::any(FrameTrace::shared().get_dump_path()));
+}
+
+void
+NCPInstanceBase::get_prop_DaemonFrameTrace(CallbackWithStatusArg1 cb)
+{
+	std::string dump = FrameTrace::shared().dump();
+
+	cb(kWPANTUNDStatus_Ok, boost::any(Data(reinterpret_cast<const uint8_t*>(dump.data()), dump.size())));
+}
+
 // ----------------------------------------------------------------------------
 // MARK: -
 // MARK: Property Set Handlers
@@ -1064,8 +1182,7 @@ NCPInstanceBase::get_prop_DaemonSyslogMask(CallbackWithStatusArg1 cb)
 void
 NCPInstanceBase::register_prop_set_handler(const char *prop, PropUpdateHandler handler)
 {
-	std::string key = to_upper(prop);
-	mPropertySetHandlers[key] = PropUpdateHandlerEntry(prop, handler);
+	mPropertySetHandlers.insert(prop, PropUpdateHandlerEntry(prop, handler));
 }
 
 void
@@ -1102,6 +1219,12 @@ NCPInstanceBase::regsiter_all_set_handlers(void)
 	REGISTER_SET_HANDLER(IPv6MeshLocalAddress);
 	REGISTER_SET_HANDLER(DaemonAutoDeepSleep);
 	REGISTER_SET_HANDLER(DaemonSyslogMask);
+	REGISTER_SET_HANDLER(ConfigDaemonInboundFrameBudget);
+	REGISTER_SET_HANDLER(ConfigDaemonInboundTimeBudget);
+	REGISTER_SET_HANDLER(ConfigDaemonPropertyChangeInterval);
+	REGISTER_SET_HANDLER(ConfigDaemonPropertyChangeBatchSize);
+	REGISTER_SET_HANDLER(ConfigDaemonPropChangedInterval);
+	REGISTER_SET_HANDLER(ConfigDaemonFrameTracePath);
 
 #undef REGISTER_SET_HANDLER
 }
@@ -1117,12 +1240,10 @@ NCPInstanceBase::property_set_value(const std::string &key, const boost::any &va
 	}
 
 	try {
-		std::map<std::string, PropUpdateHandlerEntry>::iterator iter;
-
-		iter = mPropertySetHandlers.find(to_upper(key));
+		PropertyHandle handle = mPropertySetHandlers.find(key);
 
-		if (iter != mPropertySetHandlers.end()) {
-			iter->second(value, cb);
+		if (handle != kInvalidPropertyHandle) {
+			mPropertySetHandlers.at(handle)(value, cb);
 
 		} else if (StatCollector::is_a_stat_property(key)) {
 			get_stat_collector().property_set_value(key, value, cb);
@@ -1444,6 +1565,86 @@ NCPInstanceBase::set_prop_DaemonSyslogMask(const boost::any &value, CallbackWith
 
 }
 
+void
+NCPInstanceBase::set_prop_ConfigDaemonInboundFrameBudget(const boost::any &value, CallbackWithStatus cb)
+{
+	int budget = any_to_int(value);
+
+	if (budget <= 0) {
+		cb(kWPANTUNDStatus_InvalidArgument);
+		return;
+	}
+
+	mInboundFrameBudget = budget;
+	cb(kWPANTUNDStatus_Ok);
+}
+
+void
+NCPInstanceBase::set_prop_ConfigDaemonInboundTimeBudget(const boost::any &value, CallbackWithStatus cb)
+{
+	int budget = any_to_int(value);
+
+	if (budget <= 0) {
+		cb(kWPANTUNDStatus_InvalidArgument);
+		return;
+	}
+
+	mInboundTimeBudget = budget;
+	cb(kWPANTUNDStatus_Ok);
+}
+
+void
+NCPInstanceBase::set_prop_ConfigDaemonPropertyChangeInterval(const boost::any &value, CallbackWithStatus cb)
+{
+	int interval = any_to_int(value);
+
+	if (interval < 0) {
+		cb(kWPANTUNDStatus_InvalidArgument);
+		return;
+	}
+
+	mPropertyChangeInterval = interval;
+	cb(kWPANTUNDStatus_Ok);
+	signal_property_changed(kWPANTUNDProperty_ConfigDaemonPropertyChangeInterval, mPropertyChangeInterval);
+}
+
+void
+NCPInstanceBase::set_prop_ConfigDaemonPropertyChangeBatchSize(const boost::any &value, CallbackWithStatus cb)
+{
+	int batch_size = any_to_int(value);
+
+	if (batch_size < 0) {
+		cb(kWPANTUNDStatus_InvalidArgument);
+		return;
+	}
+
+	mPropertyChangeBatchSize = batch_size;
+	cb(kWPANTUNDStatus_Ok);
+	signal_property_changed(kWPANTUNDProperty_ConfigDaemonPropertyChangeBatchSize, mPropertyChangeBatchSize);
+}
+
+void
+NCPInstanceBase::set_prop_ConfigDaemonPropChangedInterval(const boost::any &value, CallbackWithStatus cb)
+{
+	int interval = any_to_int(value);
+
+	if (interval < 0) {
+		cb(kWPANTUNDStatus_InvalidArgument);
+		return;
+	}
+
+	mPropChangedInterval = interval;
+	cb(kWPANTUNDStatus_Ok);
+	signal_property_changed(kWPANTUNDProperty_ConfigDaemonPropChangedInterval, mPropChangedInterval);
+}
+
+void
+NCPInstanceBase::set_prop_ConfigDaemonFrameTracePath(const boost::any &value, CallbackWithStatus cb)
+{
+	FrameTrace::shared().set_dump_path(any_to_string(value));
+	cb(kWPANTUNDStatus_Ok);
+}
+
 // ----------------------------------------------------------------------------
 // MARK: -
 // MARK: Property Insert Handlers
@@ -1451,8 +1652,7 @@ NCPInstanceBase::set_prop_DaemonSyslogMask(const boost::any &value, CallbackWith
 void
 NCPInstanceBase::register_prop_insert_handler(const char *prop, PropUpdateHandler handler)
 {
-	std::string key = to_upper(prop);
-	mPropertyInsertHandlers[key] = PropUpdateHandlerEntry(prop, handler);
+	mPropertyInsertHandlers.insert(prop, PropUpdateHandlerEntry(prop, handler));
 }
 
 void
@@ -1473,12 +1673,10 @@ void
 NCPInstanceBase::property_insert_value(const std::string &key, const boost::any &value, CallbackWithStatus cb)
 {
 	try {
-		std::map<std::string, PropUpdateHandlerEntry>::iterator iter;
-
-		iter = mPropertyInsertHandlers.find(to_upper(key));
+		PropertyHandle handle = mPropertyInsertHandlers.find(key);
 
-		if (iter != mPropertyInsertHandlers.end()) {
-			iter->second(value, cb);
+		if (handle != kInvalidPropertyHandle) {
+			mPropertyInsertHandlers.at(handle)(value, cb);
 
 		} else {
 			syslog(LOG_ERR, "property_insert_value: Property not supported or not insert-value capable \"%s\"", key.c_str());
@@ -1517,8 +1715,7 @@ void NCPInstanceBase::insert_prop_MacFilterList(const boost::any &value, Callbac
 void
 NCPInstanceBase::register_prop_remove_handler(const char *prop, PropUpdateHandler handler)
 {
-	std::string key = to_upper(prop);
-	mPropertyRemoveHandlers[key] = PropUpdateHandlerEntry(prop, handler);
+	mPropertyRemoveHandlers.insert(prop, PropUpdateHandlerEntry(prop, handler));
 }
 
 void
@@ -1539,12 +1736,10 @@ void
 NCPInstanceBase::property_remove_value(const std::string &key, const boost::any &value, CallbackWithStatus cb)
 {
 	try {
-		std::map<std::string, PropUpdateHandlerEntry>::iterator iter;
+		PropertyHandle handle = mPropertyRemoveHandlers.find(key);
 
-		iter = mPropertyRemoveHandlers.find(to_upper(key));
-
-		if (iter != mPropertyRemoveHandlers.end()) {
-			iter->second(value, cb);
+		if (handle != kInvalidPropertyHandle) {
+			mPropertyRemoveHandlers.at(handle)(value, cb);
 
 		} else {
 			syslog(LOG_ERR, "property_remove_value: Property not supported or not remove-value capable \"%s\"", key.c_str());
@@ -1806,6 +2001,15 @@ NCPInstanceBase::handle_network_time_update(const ValueMap &update)
 	get_control_interface().mOnNetworkTimeUpdate(update);
 }
 
+// ----------------------------------------------------------------------------
+// MARK: Topology Change
+
+void
+NCPInstanceBase::handle_topology_change(NCPControlInterface::TopologyChange change, const ValueMap &delta)
+{
+	get_control_interface().mOnTopologyChange(change, delta);
+}
+
 // ----------------------------------------------------------------------------
 // MARK: -
 
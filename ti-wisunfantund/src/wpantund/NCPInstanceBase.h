@@ -34,6 +34,7 @@
 #include "NetworkRetain.h"
 #include "RunawayResetBackoffManager.h"
 #include "Pcap.h"
+#include "PropertyTable.h"
 
 namespace nl {
 namespace wpantund {
@@ -89,6 +90,12 @@ protected:
 	virtual char ncp_to_driver_pump() = 0;
 	virtual char driver_to_ncp_pump() = 0;
 
+	// Inbound frame budget for a single run of `ncp_to_driver_pump()`.
+	// The pump calls `inbound_budget_exhausted()` before each frame
+	// and yields back to the main loop once it returns true.
+	bool inbound_budget_exhausted(void) const;
+	void inbound_budget_did_starve(void);
+
 public:
 	// ========================================================================
 	// MARK: NCP Behavior
@@ -129,6 +136,11 @@ public:
 
 	void handle_network_time_update(const ValueMap &update);
 
+	// ========================================================================
+	// MARK: Topology Change
+
+	void handle_topology_change(NCPControlInterface::TopologyChange change, const ValueMap &delta);
+
 public:
 	// ========================================================================
 	// MARK: Network Interface Methods
@@ -199,6 +211,8 @@ protected:
 
 	void restore_address_prefix_route_entries_on_ncp(void);
 
+	void reconcile_address_route_entries_on_interface(void);
+
 protected:
 	// ========================================================================
 	// MARK: Subclass hooks related to address/prefix/route management
@@ -285,6 +299,18 @@ public:
 
 	virtual void property_get_value(const std::string& key, CallbackWithStatusArg1 cb);
 
+	// A property which is read over and over can be looked up once and
+	// then read through its handle, skipping the name lookup. Keys which
+	// have no handle (unknown keys, statistics, and whatever a subclass
+	// serves by name) get `kInvalidPropertyHandle` and must be read with
+	// `property_get_value()`.
+	typedef PropertyTable<int>::handle_type PropertyHandle;
+	static const PropertyHandle kInvalidPropertyHandle = -1;
+
+	virtual PropertyHandle get_property_handle(const std::string& key) const;
+
+	virtual void property_get_value_with_handle(PropertyHandle handle, CallbackWithStatusArg1 cb);
+
 	virtual void property_set_value(const std::string& key, const boost::any& value, CallbackWithStatus cb = NilReturn());
 
 	virtual void property_insert_value(const std::string& key, const boost::any& value, CallbackWithStatus cb = NilReturn());
@@ -430,6 +456,16 @@ private:
 	void get_prop_IPv6MulticastAddresses(CallbackWithStatusArg1 cb);
 	void get_prop_IPv6InterfaceRoutes(CallbackWithStatusArg1 cb);
 	void get_prop_DaemonSyslogMask(CallbackWithStatusArg1 cb);
+	void get_prop_ConfigDaemonInboundFrameBudget(CallbackWithStatusArg1 cb);
+	void get_prop_ConfigDaemonInboundTimeBudget(CallbackWithStatusArg1 cb);
+	void get_prop_DaemonFileExportBacklog(CallbackWithStatusArg1 cb);
+	void get_prop_DaemonFileExportLatency(CallbackWithStatusArg1 cb);
+	void get_prop_ConfigDaemonPropertyChangeInterval(CallbackWithStatusArg1 cb);
+	void get_prop_ConfigDaemonPropertyChangeBatchSize(CallbackWithStatusArg1 cb);
+	void get_prop_ConfigDaemonPropChangedInterval(CallbackWithStatusArg1 cb);
+	void get_prop_DaemonPropertyChangeStats(CallbackWithStatusArg1 cb);
+	void get_prop_ConfigDaemonFrameTracePath(CallbackWithStatusArg1 cb);
+	void get_prop_DaemonFrameTrace(CallbackWithStatusArg1 cb);
 
 	void regsiter_all_set_handlers(void);
 
@@ -461,6 +497,12 @@ private:
 	void set_prop_IPv6MeshLocalAddress(const boost::any &value, CallbackWithStatus cb);
 	void set_prop_DaemonAutoDeepSleep(const boost::any &value, CallbackWithStatus cb);
 	void set_prop_DaemonSyslogMask(const boost::any &value, CallbackWithStatus cb);
+	void set_prop_ConfigDaemonInboundFrameBudget(const boost::any &value, CallbackWithStatus cb);
+	void set_prop_ConfigDaemonInboundTimeBudget(const boost::any &value, CallbackWithStatus cb);
+	void set_prop_ConfigDaemonPropertyChangeInterval(const boost::any &value, CallbackWithStatus cb);
+	void set_prop_ConfigDaemonPropertyChangeBatchSize(const boost::any &value, CallbackWithStatus cb);
+	void set_prop_ConfigDaemonPropChangedInterval(const boost::any &value, CallbackWithStatus cb);
+	void set_prop_ConfigDaemonFrameTracePath(const boost::any &value, CallbackWithStatus cb);
 
 	void regsiter_all_insert_handlers(void);
 
@@ -500,10 +542,10 @@ private:
 		PropUpdateHandler mHandler;
 	};
 
-	std::map<std::string, PropGetHandlerEntry> mPropertyGetHandlers;
-	std::map<std::string, PropUpdateHandlerEntry> mPropertySetHandlers;
-	std::map<std::string, PropUpdateHandlerEntry> mPropertyInsertHandlers;
-	std::map<std::string, PropUpdateHandlerEntry> mPropertyRemoveHandlers;
+	PropertyTable<PropGetHandlerEntry> mPropertyGetHandlers;
+	PropertyTable<PropUpdateHandlerEntry> mPropertySetHandlers;
+	PropertyTable<PropUpdateHandlerEntry> mPropertyInsertHandlers;
+	PropertyTable<PropUpdateHandlerEntry> mPropertyRemoveHandlers;
 
 protected:
 	// ========================================================================
@@ -894,6 +936,19 @@ protected:
 	int mFailureCount;
 	int mFailureThreshold;
 
+	// Limits on how much inbound NCP traffic is handled per run
+	// through the main loop, and the bookkeeping for the current run.
+	int mInboundFrameBudget;
+	cms_t mInboundTimeBudget; // In milliseconds
+	int mInboundFrameCount;
+	cms_t mInboundStartTime;
+
+	// How property change signals are batched by the IPC servers,
+	// which pick up changes to these through `mOnPropertyChanged`.
+	int mPropertyChangeInterval; // In milliseconds
+	int mPropertyChangeBatchSize;
+	int mPropChangedInterval; // In milliseconds, for noisy properties only
+
 	RunawayResetBackoffManager mRunawayResetBackoffManager;
 
 protected:
@@ -166,7 +166,7 @@ StatCollector::IPAddress::operator==(const IPAddress& lhs) const
 {
 	// Since IPv6 addresses typically start with same prefix, we intentionally
 	// start the comparison from the end of address buffer
-	for(int indx = sizeof(mAddressBuffer)/sizeof(mAddressBuffer[0]) - 1; indx ; indx--) {
+	for(int indx = sizeof(mAddressBuffer)/sizeof(mAddressBuffer[0]) - 1; indx >= 0; indx--) {
 		if (mAddressBuffer[indx] != lhs.mAddressBuffer[indx]) {
 			return false;
 		}
@@ -181,7 +181,7 @@ StatCollector::IPAddress::operator<(const IPAddress& lhs) const
 	// Since IPv6 addresses typically start with same prefix, we intentionally
 	// start the comparison from the end of address buffer
 
-	for(int indx = sizeof(mAddressBuffer)/sizeof(mAddressBuffer[0]) - 1; indx ; indx--) {
+	for(int indx = sizeof(mAddressBuffer)/sizeof(mAddressBuffer[0]) - 1; indx >= 0; indx--) {
 		if (mAddressBuffer[indx] < lhs.mAddressBuffer[indx]) {
 			return true;
 		}
@@ -195,6 +195,23 @@ StatCollector::IPAddress::operator<(const IPAddress& lhs) const
 	return false;
 }
 
+static uint32_t
+mix_hash(uint32_t hash)
+{
+	hash ^= hash >> 16;
+	hash *= 0x85ebca6b;
+	hash ^= hash >> 13;
+	hash *= 0xc2b2ae35;
+	hash ^= hash >> 16;
+	return hash;
+}
+
+uint32_t
+StatCollector::IPAddress::hash(void) const
+{
+	return mix_hash(mAddressBuffer[0] ^ mix_hash(mAddressBuffer[1] ^ mix_hash(mAddressBuffer[2] ^ mix_hash(mAddressBuffer[3]))));
+}
+
 //-------------------------------------------------------------------
 // EUI64Address
 
@@ -235,6 +252,12 @@ StatCollector::EUI64Address::operator<(const EUI64Address& lhs) const
 	return false;
 }
 
+uint32_t
+StatCollector::EUI64Address::hash(void) const
+{
+	return mix_hash(mAddress[0] ^ mix_hash(mAddress[1]));
+}
+
 //-------------------------------------------------------------------
 // TimeStamp
 
@@ -519,7 +542,7 @@ StatCollector::ReadyForHostSleepState::to_string(void) const
 // Node Stat
 
 StatCollector::NodeStat::NodeStat():
-	mNodeInfoPool(), mNodeInfoMap()
+	mNodeInfoTable(STAT_COLLECTOR_MAX_NODES), mEvictionCount(0)
 {
 	return;
 }
@@ -527,72 +550,53 @@ StatCollector::NodeStat::NodeStat():
 void
 StatCollector::NodeStat::clear()
 {
-	mNodeInfoMap.clear();
-	mNodeInfoPool.free_all();
+	mNodeInfoTable.clear();
+	mEvictionCount = 0;
 }
 
-StatCollector::NodeStat::NodeInfo *
-StatCollector::NodeStat::find_node_info(const IPAddress& address)
+void
+StatCollector::NodeStat::set_capacity(int capacity)
 {
-	std::map<IPAddress, NodeInfo*>::iterator it = mNodeInfoMap.find(address);
-
-	if (it == mNodeInfoMap.end())
-		return NULL;
+	mNodeInfoTable.set_capacity(capacity);
+	mEvictionCount = 0;
+}
 
-	return it->second;
+int
+StatCollector::NodeStat::get_capacity(void) const
+{
+	return mNodeInfoTable.capacity();
 }
 
+// Called for every packet, so this has to stay O(1). The table keeps the
+// nodes in least recently used order, which is the same as ordering them
+// by their last rx/tx time.
 StatCollector::NodeStat::NodeInfo *
-StatCollector::NodeStat::create_new_node_info(const IPAddress& address)
+StatCollector::NodeStat::get_node_info(const IPAddress& address)
 {
-	NodeInfo *node_info_ptr = NULL;
+	bool inserted, evicted;
+	NodeInfo *node_info_ptr = mNodeInfoTable.touch(address, inserted, evicted);
 
-	do {
-		node_info_ptr = mNodeInfoPool.alloc();
+	if (inserted) {
+		node_info_ptr->clear();
+	}
 
-		// If we can not allocate a new node info (all objects in the pool are used),
-		// we will remove oldest node info and try again.
-		if (!node_info_ptr) {
-			remove_oldest_node_info();
+	if (evicted) {
+		// Only log the first time, a busy network would flood the log otherwise.
+		if (mEvictionCount++ == 0) {
+			syslog(LOG_INFO, "StatCollector: Out of NodeInfo objects --> Deleting the oldest NodeInfo");
 		}
-	} while (!node_info_ptr);
-
-	node_info_ptr->clear();
-
-	mNodeInfoMap.insert(std::pair<IPAddress, NodeInfo*>(address, node_info_ptr));
+	}
 
 	return node_info_ptr;
 }
 
 void
-StatCollector::NodeStat::remove_oldest_node_info(void)
+StatCollector::NodeStat::get_sorted_node_infos(SortedNodeInfoMap& sorted) const
 {
-	std::map<IPAddress, NodeInfo*>::iterator cur_iter, oldest_iter;
-	TimeStamp ts, oldest_ts;
-
-	for (cur_iter = oldest_iter = mNodeInfoMap.begin(); cur_iter != mNodeInfoMap.end(); cur_iter++) {
-
-		ts = cur_iter->second->get_last_rx_or_tx_time();
-
-		if (oldest_ts.is_uninitialized()) {
-			oldest_ts = ts;
-			oldest_iter = cur_iter;
-		}
-
-		if (!ts.is_uninitialized()) {
-			if (ts < oldest_ts) {
-				oldest_ts = ts;
-				oldest_iter = cur_iter;
-			}
-		}
-	}
+	LruTable<IPAddress, NodeInfo>::index_type index;
 
-	if (oldest_iter != mNodeInfoMap.end()) {
-		NodeInfo *node_info_ptr = oldest_iter->second;
-		mNodeInfoMap.erase(oldest_iter);
-		mNodeInfoPool.free(node_info_ptr);
-
-		syslog(LOG_INFO, "StatCollector: Out of NodeInfo objects --> Deleted the oldest NodeInfo");
+	for (index = mNodeInfoTable.first(); index != mNodeInfoTable.kInvalidIndex; index = mNodeInfoTable.next(index)) {
+		sorted[mNodeInfoTable.key_at(index)] = &mNodeInfoTable.value_at(index);
 	}
 }
 
@@ -601,10 +605,7 @@ StatCollector::NodeStat::update_from_inbound_packet(const PacketInfo& packet_inf
 {
 	NodeInfo *node_info_ptr;
 
-	node_info_ptr = find_node_info(packet_info.mSrcAddress);
-	if (!node_info_ptr) {
-		node_info_ptr = create_new_node_info(packet_info.mSrcAddress);
-	}
+	node_info_ptr = get_node_info(packet_info.mSrcAddress);
 
 	if (node_info_ptr) {
 		node_info_ptr->mRxPacketsTotal++;
@@ -621,10 +622,7 @@ StatCollector::NodeStat::update_from_outbound_packet(const PacketInfo& packet_in
 {
 	NodeInfo *node_info_ptr;
 
-	node_info_ptr = find_node_info(packet_info.mDstAddress);
-	if (!node_info_ptr) {
-		node_info_ptr = create_new_node_info(packet_info.mDstAddress);
-	}
+	node_info_ptr = get_node_info(packet_info.mDstAddress);
 
 	if (node_info_ptr) {
 		node_info_ptr->mTxPacketsTotal++;
@@ -637,7 +635,7 @@ StatCollector::NodeStat::update_from_outbound_packet(const PacketInfo& packet_in
 }
 
 void
-StatCollector::NodeStat::add_node_info_map_iter(StringList &output, const std::map<IPAddress, NodeInfo*>::const_iterator& it) const
+StatCollector::NodeStat::add_node_info_map_iter(StringList &output, const SortedNodeInfoMap::const_iterator& it) const
 {
 	output.push_back("========================================================");
 	output.push_back("Address: " + it->first.to_string());
@@ -648,10 +646,13 @@ StatCollector::NodeStat::add_node_info_map_iter(StringList &output, const std::m
 void
 StatCollector::NodeStat::add_node_stat_history(StringList& output, std::string node_indicator) const
 {
-	std::map<IPAddress, NodeInfo*>::const_iterator it;
+	SortedNodeInfoMap sorted;
+	SortedNodeInfoMap::const_iterator it;
+
+	get_sorted_node_infos(sorted);
 
 	if (node_indicator.empty()) {
-		for (it = mNodeInfoMap.begin(); it != mNodeInfoMap.end(); it++) {
+		for (it = sorted.begin(); it != sorted.end(); it++) {
 			add_node_info_map_iter(output, it);
 		}
 	} else {
@@ -674,8 +675,8 @@ StatCollector::NodeStat::add_node_stat_history(StringList& output, std::string n
 			if (inet_pton(AF_INET6, ip_addr_str.c_str(), ip_addr_buf) > 0) {
 				IPAddress ip_address;
 				ip_address.read_from(ip_addr_buf);
-				it = mNodeInfoMap.find(ip_address);
-				if (it != mNodeInfoMap.end()) {
+				it = sorted.find(ip_address);
+				if (it != sorted.end()) {
 					add_node_info_map_iter(output, it);
 				} else {
 					output.push_back(string_printf("Error : Address does not exist (\'%s\')", node_indicator.c_str()));
@@ -686,8 +687,8 @@ StatCollector::NodeStat::add_node_stat_history(StringList& output, std::string n
 		} else { // Index mode:
 			int index;
 			index = static_cast<int>(strtol(node_indicator.c_str(), NULL, 0));
-			if (index < mNodeInfoMap.size()) {
-				it = mNodeInfoMap.begin();
+			if ((index >= 0) && (index < static_cast<int>(sorted.size()))) {
+				it = sorted.begin();
 				std::advance(it, index);
 				add_node_info_map_iter(output, it);
 			} else {
@@ -700,9 +701,18 @@ StatCollector::NodeStat::add_node_stat_history(StringList& output, std::string n
 void
 StatCollector::NodeStat::add_node_stat(StringList& output) const
 {
-	std::map<IPAddress, NodeInfo*>::const_iterator it;
+	SortedNodeInfoMap sorted;
+	SortedNodeInfoMap::const_iterator it;
+
+	get_sorted_node_infos(sorted);
 
-	for (it = mNodeInfoMap.begin(); it != mNodeInfoMap.end(); it++) {
+	if (mEvictionCount != 0) {
+		output.push_back(string_printf("Tracking the last %d nodes, %u older nodes were dropped",
+			mNodeInfoTable.capacity(), mEvictionCount));
+		output.push_back("");
+	}
+
+	for (it = sorted.begin(); it != sorted.end(); it++) {
 		output.push_back("========================================================");
 		output.push_back("Address: " + it->first.to_string());
 		it->second->add_tx_stat(output);
@@ -956,81 +966,31 @@ StatCollector::LinkStat::LinkInfo::get_last_update_time(void) const
 // LinkStat
 
 StatCollector::LinkStat::LinkStat()
-		: mLinkInfoPool(), mLinkInfoMap()
+		: mLinkInfoTable(STAT_COLLECTOR_MAX_LINKS)
 {
 }
 
 void
 StatCollector::LinkStat::clear(void)
 {
-	mLinkInfoMap.clear();
-	mLinkInfoPool.free_all();
+	mLinkInfoTable.clear();
 }
 
-
 StatCollector::LinkStat::LinkInfo *
-StatCollector::LinkStat::find_link_info(const EUI64Address& address)
+StatCollector::LinkStat::get_link_info(const EUI64Address& address)
 {
-	std::map<EUI64Address, LinkInfo *>::iterator it = mLinkInfoMap.find(address);
-
-	if (it == mLinkInfoMap.end())
-		return NULL;
-
-	return it->second;
-}
-
-StatCollector::LinkStat::LinkInfo *
-StatCollector::LinkStat::create_new_link_info(const EUI64Address& address)
-{
-	LinkInfo *link_info_ptr = NULL;
-
-	do {
-		link_info_ptr = mLinkInfoPool.alloc();
-
-		// If we can not allocate a new link info (all objects in the pool are used),
-		// we will remove oldest one in the map and try again.
-		if (!link_info_ptr) {
-			remove_oldest_link_info();
-		}
-	} while (!link_info_ptr);
-
-	link_info_ptr->clear();
-
-	mLinkInfoMap.insert(std::pair<EUI64Address, LinkInfo*>(address, link_info_ptr));
-
-	return link_info_ptr;
-}
+	bool inserted, evicted;
+	LinkInfo *link_info_ptr = mLinkInfoTable.touch(address, inserted, evicted);
 
-void
-StatCollector::LinkStat::remove_oldest_link_info(void)
-{
-	std::map<EUI64Address, LinkInfo*>::iterator cur_iter, oldest_iter;
-	TimeStamp ts, oldest_ts;
-
-	for (cur_iter = oldest_iter = mLinkInfoMap.begin(); cur_iter != mLinkInfoMap.end(); cur_iter++) {
-
-		ts = cur_iter->second->get_last_update_time();
-
-		if (oldest_ts.is_uninitialized()) {
-			oldest_ts = ts;
-			oldest_iter = cur_iter;
-		}
-
-		if (!ts.is_uninitialized()) {
-			if (ts < oldest_ts) {
-				oldest_ts = ts;
-				oldest_iter = cur_iter;
-			}
-		}
+	if (inserted) {
+		link_info_ptr->clear();
 	}
 
-	if (oldest_iter != mLinkInfoMap.end()) {
-		LinkInfo *link_info_ptr = oldest_iter->second;
-		mLinkInfoMap.erase(oldest_iter);
-		mLinkInfoPool.free(link_info_ptr);
-
+	if (evicted) {
 		syslog(LOG_INFO, "StatCollector: Out of LinkInfo objects --> Deleted the oldest LinkInfo");
 	}
+
+	return link_info_ptr;
 }
 
 void
@@ -1048,10 +1008,7 @@ StatCollector::LinkStat::update(const uint8_t *eui64_address_arr, int8_t rssi,
 
 		link_quality.set(rssi, incoming_link_quality, outgoing_link_quality);
 
-		link_info_ptr = find_link_info(address);
-		if (!link_info_ptr) {
-			link_info_ptr = create_new_link_info(address);
-		}
+		link_info_ptr = get_link_info(address);
 
 		if (link_info_ptr) {
 			link_info_ptr->mLinkQualityHistory.force_write(link_quality);
@@ -1063,9 +1020,15 @@ StatCollector::LinkStat::update(const uint8_t *eui64_address_arr, int8_t rssi,
 void
 StatCollector::LinkStat::add_link_stat(StringList& output, int count) const
 {
-	std::map<EUI64Address, LinkInfo*>::const_iterator it;
+	std::map<EUI64Address, const LinkInfo*> sorted;
+	std::map<EUI64Address, const LinkInfo*>::const_iterator it;
+	LruTable<EUI64Address, LinkInfo>::index_type index;
 
-	for (it = mLinkInfoMap.begin(); it != mLinkInfoMap.end(); ++it) {
+	for (index = mLinkInfoTable.first(); index != mLinkInfoTable.kInvalidIndex; index = mLinkInfoTable.next(index)) {
+		sorted[mLinkInfoTable.key_at(index)] = &mLinkInfoTable.value_at(index);
+	}
+
+	for (it = sorted.begin(); it != sorted.end(); ++it) {
 		output.push_back("========================================================");
 		output.push_back("EUI64 address: " + it->first.to_string() + " -  Node type: " +
 			node_type_to_string(it->second->mNodeType));
@@ -1097,6 +1060,13 @@ StatCollector::StatCollector() :
 
 	mLastReadyForHostSleepState = true;
 
+	mInboundDrainIterations = 0;
+	mInboundDrainFrames = 0;
+	mInboundDrainMaxFrames = 0;
+	mInboundDrainFrameBudgetStarved = 0;
+	mInboundDrainTimeBudgetStarved = 0;
+	memset(mInboundDrainHistogram, 0, sizeof(mInboundDrainHistogram));
+
 	mUserRequestLogLevel = STAT_COLLECTOR_LOG_LEVEL_USER_REQUEST;
 	mAutoLogLevel = STAT_COLLECTOR_AUTO_LOG_DEFAULT_LOG_LEVEL;
 
@@ -1206,6 +1176,38 @@ StatCollector::record_ncp_ready_for_host_sleep_state(bool ready_for_sleep_state)
 	mLastReadyForHostSleepState = ready_for_sleep_state;
 }
 
+void
+StatCollector::record_inbound_drain(int frame_count)
+{
+	int bucket = 0;
+
+	if (frame_count <= 0) {
+		return;
+	}
+
+	while ((bucket < STAT_COLLECTOR_INBOUND_DRAIN_HISTOGRAM_SIZE - 1) && (frame_count > (1 << bucket))) {
+		bucket++;
+	}
+
+	mInboundDrainIterations++;
+	mInboundDrainFrames += frame_count;
+	mInboundDrainHistogram[bucket]++;
+
+	if (static_cast<uint32_t>(frame_count) > mInboundDrainMaxFrames) {
+		mInboundDrainMaxFrames = frame_count;
+	}
+}
+
+void
+StatCollector::record_inbound_starvation(bool time_budget)
+{
+	if (time_budget) {
+		mInboundDrainTimeBudgetStarved++;
+	} else {
+		mInboundDrainFrameBudgetStarved++;
+	}
+}
+
 void
 StatCollector::add_tx_history(StringList& output, int count) const
 {
@@ -1319,6 +1321,32 @@ StatCollector::add_rx_stat(StringList& output) const
 	);
 }
 
+void
+StatCollector::add_inbound_drain_stat(StringList& output) const
+{
+	int bucket;
+
+	output.push_back(
+		string_printf("Inbound: %u frame%s over %u iteration%s (max %u per iteration) -- starved %u by frame budget, %u by time budget",
+			mInboundDrainFrames, (mInboundDrainFrames == 1)? "" : "s",
+			mInboundDrainIterations, (mInboundDrainIterations == 1)? "" : "s",
+			mInboundDrainMaxFrames,
+			mInboundDrainFrameBudgetStarved,
+			mInboundDrainTimeBudgetStarved
+		)
+	);
+
+	for (bucket = 0; bucket < STAT_COLLECTOR_INBOUND_DRAIN_HISTOGRAM_SIZE; bucket++) {
+		if (bucket == STAT_COLLECTOR_INBOUND_DRAIN_HISTOGRAM_SIZE - 1) {
+			output.push_back(string_printf("\t%4d+      frames : %u", (1 << (bucket - 1)) + 1, mInboundDrainHistogram[bucket]));
+		} else if (bucket == 0) {
+			output.push_back(string_printf("\t%4d       frames : %u", 1, mInboundDrainHistogram[bucket]));
+		} else {
+			output.push_back(string_printf("\t%4d-%-4d  frames : %u", (1 << (bucket - 1)) + 1, 1 << bucket, mInboundDrainHistogram[bucket]));
+		}
+	}
+}
+
 void
 StatCollector::add_all_info(StringList& output, int count) const
 {
@@ -1336,6 +1364,10 @@ StatCollector::add_all_info(StringList& output, int count) const
 
 	output.push_back("");
 
+	add_inbound_drain_stat(output);
+
+	output.push_back("");
+
 	if (count == 0) {
 		mNodeStat.add_node_stat_history(output);
 	} else {
@@ -1368,6 +1400,7 @@ StatCollector::add_help(StringList& output) const
 	output.push_back(string_printf("\t %-26s - Both RX & TX packet info history (all nodes)", kWPANTUNDProperty_StatHistory));
 	output.push_back(string_printf("\t %-26s - NCP state change history", kWPANTUNDProperty_StatNCP));
 	output.push_back(string_printf("\t %-26s - \'Blocking Host Sleep\' state change history", kWPANTUNDProperty_StatBlockingHostSleep));
+	output.push_back(string_printf("\t %-26s - Inbound NCP frames per main loop iteration and budget starvation", kWPANTUNDProperty_StatInboundDrain));
 	output.push_back(string_printf("\t %-26s - List of nodes + RX/TX statistics per node", kWPANTUNDProperty_StatNode));
 	output.push_back(string_printf("\t %-26s - List of nodes + RX/TX statistics and packet history per node", kWPANTUNDProperty_StatNodeHistory));
 	output.push_back(string_printf("\t %-26s - List of nodes + RX/TX statistics and packet history for a specific node with given IP address", kWPANTUNDProperty_StatNodeHistoryID "[<ipv6>]"));
@@ -1379,6 +1412,7 @@ StatCollector::add_help(StringList& output) const
 	output.push_back(string_printf("\t "));
 	output.push_back(string_printf("\t %-26s - Peer link quality information - get only", kWPANTUNDProperty_StatLinkQuality));
 	output.push_back(string_printf("\t %-26s - Period interval (in seconds) for collecting peer link quality - get/set - zero to disable", kWPANTUNDProperty_StatLinkQualityPeriod));
+	output.push_back(string_printf("\t %-26s - Max number of nodes tracked, the least recently seen is dropped first - get/set (clears node stats)", kWPANTUNDProperty_StatNodeCapacity));
 	output.push_back(string_printf("\t %-26s - AutoLog information - get only", kWPANTUNDProperty_StatAutoLog));
 	output.push_back(string_printf("\t %-26s - AutoLog state (\'disabled\',\'long\',\'short\'') - get/set", kWPANTUNDProperty_StatAutoLogState));
 	output.push_back(string_printf("\t %-26s - AutoLog period in minutes - get/set", kWPANTUNDProperty_StatAutoLogPeriod));
@@ -1416,6 +1450,8 @@ StatCollector::get_stat_property(const std::string& key, StringList& output) con
 		add_ncp_state_history(output);
 	} else if (strcaseequal(key.c_str(), kWPANTUNDProperty_StatBlockingHostSleep)) {
 		add_ncp_ready_for_host_sleep_state_history(output);
+	} else if (strcaseequal(key.c_str(), kWPANTUNDProperty_StatInboundDrain)) {
+		add_inbound_drain_stat(output);
 	} else if (strcaseequal(key.c_str(), kWPANTUNDProperty_StatNode)) {
 		mNodeStat.add_node_stat(output);
 	} else if (strcaseequal(key.c_str(), kWPANTUNDProperty_StatNodeHistory)) {
@@ -1496,6 +1532,9 @@ StatCollector::property_get_value(const std::string& key, CallbackWithStatusArg1
 		int period_in_sec = static_cast<int>(mLinkStatTimer.get_interval() / Timer::kOneSecond);
 		cb(kWPANTUNDStatus_Ok, boost::any(period_in_sec));
 
+	} else if (strcaseequal(key.c_str(), kWPANTUNDProperty_StatNodeCapacity)) {
+		cb(kWPANTUNDStatus_Ok, boost::any(mNodeStat.get_capacity()));
+
 	} else {
 		// If not an AutoLog property, check for the stat properties.
 		StringList output;
@@ -1578,6 +1617,13 @@ StatCollector::property_set_value(const std::string& key, const boost::any& valu
 		} else {
 			status = kWPANTUNDStatus_InvalidArgument;
 		}
+	} else if (strcaseequal(key.c_str(), kWPANTUNDProperty_StatNodeCapacity)) {
+		int capacity = any_to_int(value);
+		if ((capacity > 0) && (capacity <= STAT_COLLECTOR_MAX_NODES_LIMIT)) {
+			mNodeStat.set_capacity(capacity);
+		} else {
+			status = kWPANTUNDStatus_InvalidArgument;
+		}
 	} else {
 		StringList output;
 
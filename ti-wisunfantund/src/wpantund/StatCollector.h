@@ -29,7 +29,7 @@
 #include <map>
 #include "time-utils.h"
 #include "RingBuffer.h"
-#include "ObjectPool.h"
+#include "LruTable.h"
 #include "NCPControlInterface.h"
 #include "NCPTypes.h"
 #include "Timer.h"
@@ -48,19 +48,32 @@ namespace wpantund {
 // Size of the NCP "ReadyForHostSleep" state history
 #define STAT_COLLECTOR_NCP_READY_FOR_HOST_SLEEP_STATE_HISTORY_SIZE  64
 
-// Max number of nodes to track at the same time (nodes are tracked by IP address)
-#define STAT_COLLECTOR_MAX_NODES   64
+// Default number of nodes to track at the same time (nodes are tracked by IP address).
+// Can be changed at run time through the "Stat:Node:Capacity" property.
+#ifndef STAT_COLLECTOR_MAX_NODES
+#define STAT_COLLECTOR_MAX_NODES   1024
+#endif
+
+// Upper bound for "Stat:Node:Capacity"
+#define STAT_COLLECTOR_MAX_NODES_LIMIT   16384
 
 // Size of rx/tx history per node
 #define STAT_COLLECTOR_PER_NODE_RX_HISTORY_SIZE  5
 #define STAT_COLLECTOR_PER_NODE_TX_HISTORY_SIZE  5
 
 // Maximm number of peer nodes for which we store link quality
-#define STAT_COLLECTOR_MAX_LINKS   64
+#ifndef STAT_COLLECTOR_MAX_LINKS
+#define STAT_COLLECTOR_MAX_LINKS   256
+#endif
 
 // History length of link quality info per peer
 #define STAT_COLLECTOR_LINK_QUALITY_HISTORY_SIZE 40
 
+// Number of buckets in the inbound frames-per-iteration histogram. Bucket
+// `n` counts iterations which handled up to 2^n frames, the last bucket
+// counts everything above that.
+#define STAT_COLLECTOR_INBOUND_DRAIN_HISTOGRAM_SIZE 8
+
 class StatCollector
 {
 public:
@@ -80,6 +93,10 @@ public:
 	void record_inbound_packet(const uint8_t *ipv6_packet);
 	void record_outbound_packet(const uint8_t *ipv6_packet);
 
+	// Methods to inform StatCollector about how the inbound NCP frame budget is used
+	void record_inbound_drain(int frame_count);
+	void record_inbound_starvation(bool time_budget);
+
 private:
 	// Internal types and data structures
 
@@ -91,6 +108,7 @@ private:
 		void read_from(const uint8_t *arr);
 		bool operator==(const IPAddress& lhs) const;
 		bool operator<(const IPAddress& lhs) const;
+		uint32_t hash(void) const;
 	private:
 		uint32_t mAddressBuffer[4];
 	};
@@ -102,6 +120,7 @@ private:
 
 		bool operator==(const EUI64Address& lhs) const;
 		bool operator<(const EUI64Address& lhs) const;
+		uint32_t hash(void) const;
 	private:
 		uint32_t mAddress[2];
 	};
@@ -201,19 +220,22 @@ private:
 
 		NodeStat();
 		void clear(void);
+		void set_capacity(int capacity);
+		int get_capacity(void) const;
 		void update_from_inbound_packet(const PacketInfo& packet_info);
 		void update_from_outbound_packet(const PacketInfo& packet_info);
 		void add_node_stat(StringList& output) const;
 		void add_node_stat_history(StringList& output, std::string node_indicator = "") const;
 
 	private:
-		NodeInfo *find_node_info(const IPAddress& address);
-		NodeInfo *create_new_node_info(const IPAddress& address);
-		void remove_oldest_node_info(void);
-		void add_node_info_map_iter(StringList &output, const std::map<IPAddress, NodeInfo*>::const_iterator& it) const;
+		typedef std::map<IPAddress, const NodeInfo*> SortedNodeInfoMap;
 
-		ObjectPool<NodeInfo, STAT_COLLECTOR_MAX_NODES> mNodeInfoPool;
-		std::map<IPAddress, NodeInfo*> mNodeInfoMap;
+		NodeInfo *get_node_info(const IPAddress& address);
+		void get_sorted_node_infos(SortedNodeInfoMap& sorted) const;
+		void add_node_info_map_iter(StringList &output, const SortedNodeInfoMap::const_iterator& it) const;
+
+		LruTable<IPAddress, NodeInfo> mNodeInfoTable;
+		uint32_t mEvictionCount;
 	};
 
 	class LinkStat
@@ -253,12 +275,9 @@ private:
 		void add_link_stat(StringList& output, int count = 0) const;
 
 	private:
-		LinkInfo *find_link_info(const EUI64Address& address);
-		LinkInfo *create_new_link_info(const EUI64Address & address);
-		void remove_oldest_link_info(void);
+		LinkInfo *get_link_info(const EUI64Address& address);
 
-		ObjectPool<LinkInfo, STAT_COLLECTOR_MAX_LINKS> mLinkInfoPool;
-		std::map<EUI64Address, LinkInfo *> mLinkInfoMap;
+		LruTable<EUI64Address, LinkInfo> mLinkInfoTable;
 	};
 
 	enum AutoLogState
@@ -277,6 +296,7 @@ private:
 	void add_tx_history(StringList& output, int count = 0) const;
 	void add_ncp_state_history(StringList& output, int count = 0) const;
 	void add_ncp_ready_for_host_sleep_state_history(StringList& output, int count = 0) const;
+	void add_inbound_drain_stat(StringList& output) const;
 	void add_help(StringList& output) const;
 	void add_all_info(StringList& output, int count = 0) const;
 	int  get_stat_property(const std::string& key, StringList& output) const;
@@ -313,6 +333,13 @@ private:
 	bool mLastReadyForHostSleepState;
 	TimeStamp mLastBlockingHostSleepTime;
 
+	uint32_t mInboundDrainIterations;
+	uint32_t mInboundDrainFrames;
+	uint32_t mInboundDrainMaxFrames;
+	uint32_t mInboundDrainFrameBudgetStarved;
+	uint32_t mInboundDrainTimeBudgetStarved;
+	uint32_t mInboundDrainHistogram[STAT_COLLECTOR_INBOUND_DRAIN_HISTOGRAM_SIZE];
+
 	NodeStat mNodeStat;
 	LinkStat mLinkStat;
 
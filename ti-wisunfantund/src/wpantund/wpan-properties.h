@@ -66,9 +66,20 @@
 
 /* Tech Specific-TI Wi-SUN NET */
 #define kWPANTUNDProperty_DodagRouteDest                        "DodagRouteDest"
+#define kWPANTUNDProperty_DodagRouteDestBinary                  "DodagRouteDest:Binary"
 #define kWPANTUNDProperty_DodagRoute                            "DodagRoute"
+#define kWPANTUNDProperty_DodagRouteAsValMap                    "DodagRoute:AsValMap"
+#define kWPANTUNDProperty_DodagRouteBinary                      "DodagRoute:Binary"
 #define kWPANTUNDProperty_NumConnectedDevices                   "NumConnected"
 #define kWPANTUNDProperty_ConnectedDevices                      "ConnectedDevices"
+#define kWPANTUNDProperty_ConnectedDevicesAsValMap              "ConnectedDevices:AsValMap"
+#define kWPANTUNDProperty_ConnectedDevicesBinary                "ConnectedDevices:Binary"
+#define kWPANTUNDProperty_ConnectedDevicesAll                   "ConnectedDevices:All"
+#define kWPANTUNDProperty_ConnectedDevicesAllBinary             "ConnectedDevices:All:Binary"
+#define kWPANTUNDProperty_NetworkTopology                       "Network:Topology"
+#define kWPANTUNDProperty_NetworkTopologyAsValMap               "Network:Topology:AsValMap"
+#define kWPANTUNDProperty_NetworkTopologyBinary                 "Network:Topology:Binary"
+#define kWPANTUNDProperty_NetworkTopologyGeneration             "Network:Topology:Generation"
 #define kWPANTUNDProperty_IPv6AllAddresses                      "IPv6:AllAddresses"
 
 
@@ -86,6 +97,14 @@
 #define kWPANTUNDProperty_ConfigDaemonPrivDropToUser            "Config:Daemon:PrivDropToUser"
 #define kWPANTUNDProperty_ConfigDaemonChroot                    "Config:Daemon:Chroot"
 #define kWPANTUNDProperty_ConfigDaemonNetworkRetainCommand      "Config:Daemon:NetworkRetainCommand"
+#define kWPANTUNDProperty_ConfigDaemonInboundFrameBudget        "Config:Daemon:InboundFrameBudget"
+#define kWPANTUNDProperty_ConfigDaemonInboundTimeBudget         "Config:Daemon:InboundTimeBudget"
+#define kWPANTUNDProperty_ConfigDaemonPropertyCachePath         "Config:Daemon:PropertyCachePath"
+#define kWPANTUNDProperty_ConfigDaemonPropertyChangeInterval    "Config:Daemon:PropertyChangeInterval"
+#define kWPANTUNDProperty_ConfigDaemonPropertyChangeBatchSize   "Config:Daemon:PropertyChangeBatchSize"
+#define kWPANTUNDProperty_ConfigDaemonPropChangedInterval       "Config:Daemon:PropChangedInterval"
+#define kWPANTUNDProperty_ConfigDaemonFrameTracePath            "Config:Daemon:FrameTracePath"
+#define kWPANTUNDProperty_ConfigDaemonSerialReaderThread        "Config:Daemon:SerialReaderThread"
 
 #define kWPANTUNDProperty_DaemonVersion                         "Daemon:Version"
 #define kWPANTUNDProperty_DaemonEnabled                         "Daemon:Enabled"
@@ -106,6 +125,18 @@
 #define kWPANTUNDProperty_DaemonOffMeshRouteFilterSelfAutoAdded "Daemon:OffMeshRoute:FilterSelfAutoAdded"
 #define kWPANTUNDProperty_DaemonOnMeshPrefixAutoAddAsIfaceRoute "Daemon:OnMeshPrefix:AutoAddAsInterfaceRoute"
 
+#define kWPANTUNDProperty_DaemonOutboundQueueDepth              "Daemon:OutboundQueue:Depth"
+#define kWPANTUNDProperty_DaemonOutboundQueueDrops              "Daemon:OutboundQueue:Drops"
+#define kWPANTUNDProperty_DaemonOutboundQueueLatency            "Daemon:OutboundQueue:Latency"
+#define kWPANTUNDProperty_DaemonNCPInitTime                     "Daemon:NCPInitTime"
+#define kWPANTUNDProperty_DaemonFileExportBacklog               "Daemon:FileExport:Backlog"
+#define kWPANTUNDProperty_DaemonFileExportLatency               "Daemon:FileExport:Latency"
+#define kWPANTUNDProperty_DaemonPropertyCache                   "Daemon:PropertyCache"
+#define kWPANTUNDProperty_DaemonPropertyChangeStats             "Daemon:PropertyChange:Stats"
+#define kWPANTUNDProperty_DaemonInboundPropertyStats            "Daemon:InboundProperty:Stats"
+#define kWPANTUNDProperty_DaemonFrameTrace                      "Daemon:FrameTrace"
+#define kWPANTUNDProperty_DaemonSerialStats                     "Daemon:Serial:Stats"
+
 #define kWPANTUNDProperty_NCPState                              "NCP:State"
 #define kWPANTUNDProperty_NCPExtendedAddress                    "NCP:ExtendedAddress"
 #define kWPANTUNDProperty_NCPMACAddress                         "NCP:MACAddress"
@@ -387,6 +418,7 @@
 #define kWPANTUNDProperty_StatNode                              "Stat:Node"
 #define kWPANTUNDProperty_StatNodeHistory                       "Stat:Node:History"
 #define kWPANTUNDProperty_StatNodeHistoryID                     "Stat:Node:History:"
+#define kWPANTUNDProperty_StatNodeCapacity                      "Stat:Node:Capacity"
 #define kWPANTUNDProperty_StatShort                             "Stat:Short"
 #define kWPANTUNDProperty_StatLong                              "Stat:Long"
 #define kWPANTUNDProperty_StatAutoLog                           "Stat:AutoLog"
@@ -398,6 +430,7 @@
 #define kWPANTUNDProperty_StatLinkQualityLong                   "Stat:LinkQuality:Long"
 #define kWPANTUNDProperty_StatLinkQualityShort                  "Stat:LinkQuality:Short"
 #define kWPANTUNDProperty_StatLinkQualityPeriod                 "Stat:LinkQuality:Period"
+#define kWPANTUNDProperty_StatInboundDrain                      "Stat:InboundDrain"
 #define kWPANTUNDProperty_StatHelp                              "Stat:Help"
 
 #define kWPANTUNDProperty_ThreadServices                        "Thread:Services"
@@ -625,4 +658,61 @@
 #define kWPANTUNDValueMapKey_CoexMetrics_AvgRxRequestToGrantTime            "AvgRxRequestToGrantTime"            // The average time in usec from rx request to grant.
 #define kWPANTUNDValueMapKey_CoexMetrics_NumRxGrantNone                     "NumRxGrantNone"                     // The number of rx requests that completed without receiving grant.
 
+// ValueMap keys used by the Daemon:OutboundQueue:* properties
+#define kWPANTUNDValueMapKey_OutboundQueue_Control              "Control"              // Control (spinel command) frames
+#define kWPANTUNDValueMapKey_OutboundQueue_Data                 "Data"                 // SPINEL_PROP_STREAM_NET data frames
+#define kWPANTUNDValueMapKey_OutboundQueue_ControlAvg           "ControlAvg"           // Average queueing delay of control frames, in ms
+#define kWPANTUNDValueMapKey_OutboundQueue_ControlMax           "ControlMax"           // Worst queueing delay of control frames, in ms
+#define kWPANTUNDValueMapKey_OutboundQueue_DataAvg              "DataAvg"              // Average queueing delay of data frames, in ms
+#define kWPANTUNDValueMapKey_OutboundQueue_DataMax              "DataMax"              // Worst queueing delay of data frames, in ms
+
+// ValueMap keys used by the Daemon:FileExport:* properties
+#define kWPANTUNDValueMapKey_FileExport_Pending                 "Pending"              // Files waiting to be written
+#define kWPANTUNDValueMapKey_FileExport_Written                 "Written"              // Files written or removed so far
+#define kWPANTUNDValueMapKey_FileExport_Coalesced               "Coalesced"            // Updates superseded before being written
+#define kWPANTUNDValueMapKey_FileExport_Failed                  "Failed"               // Files which could not be written
+#define kWPANTUNDValueMapKey_FileExport_LatencyAvg              "Avg"                  // Average delay before a file is updated, in ms
+#define kWPANTUNDValueMapKey_FileExport_LatencyMax              "Max"                  // Worst delay before a file is updated, in ms
+
+// ValueMap keys used by the Daemon:PropertyChange:Stats property
+#define kWPANTUNDValueMapKey_PropertyChange_Queued              "Queued"               // Property changes reported
+#define kWPANTUNDValueMapKey_PropertyChange_Merged              "Merged"               // Changes folded into a pending one for the same property
+#define kWPANTUNDValueMapKey_PropertyChange_Signals             "Signals"              // Batches of changes flushed out as signals
+#define kWPANTUNDValueMapKey_PropertyChange_Dropped             "Dropped"              // Changes thrown away without being signaled
+
+// ValueMap keys used by the Daemon:PropertyCache property
+#define kWPANTUNDValueMapKey_PropertyCache_State                "State"                // "disabled", "empty", "stale" or "fresh"
+#define kWPANTUNDValueMapKey_PropertyCache_Entries              "Entries"              // Number of cached values
+#define kWPANTUNDValueMapKey_PropertyCache_Age                  "Age"                  // Seconds since the NCP last confirmed them
+#define kWPANTUNDValueMapKey_PropertyCache_NCPVersion           "NCPVersion"           // Version of the NCP they came from
+
+// ValueMap keys used by the Daemon:Serial:Stats property
+#define kWPANTUNDValueMapKey_SerialStats_ReaderThread           "ReaderThread"         // True if a thread is reading the serial port
+#define kWPANTUNDValueMapKey_SerialStats_Reads                  "Reads"                // Reads made by the thread
+#define kWPANTUNDValueMapKey_SerialStats_Frames                 "Frames"               // Frames the thread queued for the main loop
+#define kWPANTUNDValueMapKey_SerialStats_RingDrops              "RingDrops"            // Frames the thread dropped, the main loop being too far behind
+#define kWPANTUNDValueMapKey_SerialStats_RingHighWater          "RingHighWater"        // Most bytes ever queued for the main loop
+#define kWPANTUNDValueMapKey_SerialStats_Oversize               "Oversize"             // Frames dropped for being too big
+#define kWPANTUNDValueMapKey_SerialStats_UartRx                 "UartRx"               // Bytes received by the UART driver, -1 if not a UART
+#define kWPANTUNDValueMapKey_SerialStats_UartOverrun            "UartOverrun"          // UART hardware FIFO overruns, -1 if not a UART
+#define kWPANTUNDValueMapKey_SerialStats_UartBufOverrun         "UartBufOverrun"       // Bytes lost to a full tty buffer, -1 if not a UART
+
+// ValueMap keys used by the ConnectedDevices:AsValMap property
+#define kWPANTUNDValueMapKey_ConnectedDevices_BlockId           "BlockId"              // Index of the block, without the last block flag
+#define kWPANTUNDValueMapKey_ConnectedDevices_LastBlock         "LastBlock"            // True if the NCP has no more blocks to give
+#define kWPANTUNDValueMapKey_ConnectedDevices_Addresses         "Addresses"            // 16 byte IPv6 addresses of the devices in the block
+
+// ValueMap keys used by the DodagRoute:AsValMap property
+#define kWPANTUNDValueMapKey_DodagRoute_PathCost                "PathCost"             // Number of hops from the root
+#define kWPANTUNDValueMapKey_DodagRoute_Address                 "Address"              // 16 byte IPv6 address of the destination
+#define kWPANTUNDValueMapKey_DodagRoute_Hops                    "Hops"                 // 16 byte IPv6 addresses from the root to the destination
+
+// ValueMap keys used by the Network:Topology:AsValMap property and the topology signals
+#define kWPANTUNDValueMapKey_Topology_Address                   "Address"              // IPv6 address of the node
+#define kWPANTUNDValueMapKey_Topology_Parent                    "Parent"               // IPv6 address of the parent, absent for the root
+#define kWPANTUNDValueMapKey_Topology_PathCost                  "PathCost"             // Number of hops from the root
+#define kWPANTUNDValueMapKey_Topology_Children                  "Children"             // IPv6 addresses of the children
+#define kWPANTUNDValueMapKey_Topology_OldParent                 "OldParent"            // Previous parent, in ParentChanged signals
+#define kWPANTUNDValueMapKey_Topology_Generation                "Generation"           // Value of Network:Topology:Generation after the change
+
 #endif
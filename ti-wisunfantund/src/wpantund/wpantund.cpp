@@ -57,6 +57,7 @@
 
 #include "NCPControlInterface.h"
 #include "NCPInstance.h"
+#include "FrameTrace.h"
 
 #include "nlpt.h"
 
@@ -226,6 +227,14 @@ signal_SIGHUP(int sig)
 	// loop decide what to do for hangups.
 }
 
+static void
+signal_SIGUSR1(int sig)
+{
+	// The main loop writes the trace out, `FrameTrace::process()`
+	// isn't async signal safe.
+	nl::FrameTrace::shared().request_dump();
+}
+
 static void
 signal_critical(int sig, siginfo_t * info, void * ucontext)
 {
@@ -552,6 +561,9 @@ public:
 		// Process the NCP instance.
 		mNcpInstance->process();
 
+		// Write out the frame trace if it was asked for.
+		nl::FrameTrace::shared().process();
+
 		// We only expose the interface via IPC after it is
 		// successfully initialized for the first time.
 		if (!mInterfaceAdded) {
@@ -717,6 +729,7 @@ main(int argc, char * argv[])
 	gPreviousHandlerForSIGINT = signal(SIGINT, &signal_SIGINT);
 	gPreviousHandlerForSIGTERM = signal(SIGTERM, &signal_SIGTERM);
 	signal(SIGHUP, &signal_SIGHUP);
+	signal(SIGUSR1, &signal_SIGUSR1);
 
 	// Always ignore SIGPIPE.
 	signal(SIGPIPE, SIG_IGN);
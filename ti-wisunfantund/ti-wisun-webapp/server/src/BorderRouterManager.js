@@ -1,4 +1,4 @@
-const {ClientState, getLatestProp} = require('./ClientState');
+const {ClientState, getLatestProps} = require('./ClientState');
 const chokidar = require('chokidar');
 const {SerialPort} = require('serialport');
 const {borderRouterLogger} = require('./logger');
@@ -95,16 +95,22 @@ class BorderRouterManager {
    * and update the ClientState with their new values
    */
   updateNCPProperties = async () => {
-    for (const property in ClientState.ncpProperties) {
-      try {
-        let propertyValue = await getLatestProp(property);
-        if (JSON.stringify(propertyValue) !== JSON.stringify(ClientState.ncpProperties[property])) {
-          ClientState.ncpProperties[property] = propertyValue;
-        }
-      } catch (error) {
-        borderRouterLogger.debug(`Failed to update property: ${property}. ${error}`);
+    let latest;
+    try {
+      latest = await getLatestProps(Object.keys(ClientState.ncpProperties));
+    } catch (error) {
+      borderRouterLogger.debug(`Failed to update properties. ${error}`);
+      return;
+    }
+    for (const property in latest.values) {
+      const propertyValue = latest.values[property];
+      if (JSON.stringify(propertyValue) !== JSON.stringify(ClientState.ncpProperties[property])) {
+        ClientState.ncpProperties[property] = propertyValue;
       }
     }
+    for (const property in latest.errors) {
+      borderRouterLogger.debug(`Failed to update property: ${property}. Status ${latest.errors[property]}`);
+    }
   };
 
   /**
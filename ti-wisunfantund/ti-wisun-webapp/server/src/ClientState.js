@@ -1,5 +1,5 @@
 const {parseMacFilterList, parseNCPIPv6, parseChList} = require('./parsing.js');
-const {getPropDBUS, setPropDBUS} = require('./dbusCommands.js');
+const {getPropDBUS, getPropsDBUS, setPropDBUS} = require('./dbusCommands.js');
 const {appStateLogger} = require('./logger.js');
 const {observe, generate} = require('fast-json-patch');
 
@@ -135,7 +135,31 @@ function initializeSocketIOEvents(io) {
  * @returns {NCPProperty}
  */
 async function getLatestProp(property) {
-  let propValue = await getPropDBUS(property);
+  return parseProp(property, await getPropDBUS(property));
+}
+
+/**
+ * This function calls on the DBus API to retrieve the most
+ * recent values of all the NCP properties specified at once.
+ * @param {NCPProperty[]} properties
+ * @returns {{values: Object, errors: Object}}
+ */
+async function getLatestProps(properties) {
+  const {values, errors} = await getPropsDBUS(properties);
+  for (const property in values) {
+    values[property] = parseProp(property, values[property]);
+  }
+  return {values, errors};
+}
+
+/**
+ * This function converts the value of an NCP property as
+ * returned by the DBus API into the form kept in the ClientState.
+ * @param {NCPProperty} property
+ * @param {NCPProperty} propValue
+ * @returns {NCPProperty}
+ */
+function parseProp(property, propValue) {
   switch (property) {
     case 'unicastchlist':
     case 'broadcastchlist':
@@ -205,6 +229,7 @@ module.exports = {
   resetTopology,
   setProp,
   getLatestProp,
+  getLatestProps,
   getNetworkIPInfo,
   initializeSocketIOEvents,
   defaultAutoPing,
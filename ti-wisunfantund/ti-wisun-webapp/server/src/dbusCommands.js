@@ -69,6 +69,44 @@ async function getPropDBUS(property) {
   return await sendDBusMessage('PropGet', property, '');
 }
 
+/**
+ * This function gets several NCPProperties with a single
+ * PropGetMany call through the DBus API. The daemon starts
+ * all the gets at once instead of one after the other.
+ * @param {NCPProperty[]} properties
+ * @returns {{values: Object, errors: Object}} values by property,
+ * and the wfantund status of each property which could not be read
+ */
+async function getPropsDBUS(properties) {
+  let methodCall = new dbus.Message({
+    destination: DBUS_BUS_NAME,
+    path: DBUS_OBJECT_PATH,
+    interface: DBUS_INTERFACE,
+    member: 'PropGetMany',
+    signature: 'as',
+    body: [properties],
+  });
+  dbusLogger.debug(`PropGetMany ${properties.length} properties`);
+  try {
+    let dbusReply = await bus.call(methodCall);
+    if (dbusReply === null) {
+      throw Error('DBUS Reply Null');
+    }
+    if (dbusReply.body[0] !== WFANTUND_STATUS.Ok) {
+      const errorKey = getKeyByValue(WFANTUND_STATUS, dbusReply.body[0]);
+      throw Error(`Received not ok status: ${errorKey}`);
+    }
+    const values = {};
+    for (const [property, variant] of Object.entries(dbusReply.body[1])) {
+      values[property] = variant.value;
+    }
+    return {values, errors: dbusReply.body[2]};
+  } catch (error) {
+    dbusLogger.debug(`PropGetMany Failed. ${error.message}`);
+    throw Error(`DBUS Message Call Failure. ${error.message}`);
+  }
+}
+
 /**
  * This function sends a command to set the specified
  * NCPProperty with the newValue through the DBus API
@@ -84,4 +122,5 @@ module.exports = {
   sendDBusMessage,
   setPropDBUS,
   getPropDBUS,
+  getPropsDBUS,
 };
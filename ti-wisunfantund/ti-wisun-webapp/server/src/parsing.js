@@ -103,6 +103,50 @@ function parseDodagRoute(text) {
     .map(expandedIP => expandedIPToCanonicalIP(expandedIP));
 }
 
+/**
+ * This function takes the Network:Topology:AsValMap array
+ * returned from the DBus API and works out the connected
+ * devices and the route from the root to each of them.
+ * The root is the only node with a path cost of zero. Nodes
+ * whose route the daemon could not read have neither a parent
+ * nor a path cost, and are listed without a route.
+ * @param {DBus array of dictionaries} entries
+ * @returns {{devices: Array, routes: Array of Array}}
+ */
+function parseTopologySnapshot(entries) {
+  // dbus-next wraps the values of a{sv} dictionaries in Variants
+  const unwrap = value => (value !== undefined && value !== null && value.signature !== undefined ? value.value : value);
+  const parents = new Map();
+  const devices = [];
+
+  for (const entry of entries) {
+    const address = expandedIPToCanonicalIP(canonicalIPtoExpandedIP(unwrap(entry.Address)));
+    const parent = unwrap(entry.Parent);
+
+    if (parent !== undefined) {
+      parents.set(address, expandedIPToCanonicalIP(canonicalIPtoExpandedIP(parent)));
+    }
+    if (parent !== undefined || unwrap(entry.PathCost) !== 0) {
+      devices.push(address);
+    }
+  }
+  devices.sort();
+
+  const routes = [];
+  for (const device of devices) {
+    if (!parents.has(device)) {
+      continue;
+    }
+    const route = [device];
+    // Guard against a loop left behind by a node changing parent
+    while (parents.has(route[0]) && route.length <= parents.size) {
+      route.unshift(parents.get(route[0]));
+    }
+    routes.push(route);
+  }
+  return {devices, routes};
+}
+
 /**
  * Used in conjunction with the ncp property ipv6:alladdresses
  * @param {string[]}  stringArray
@@ -197,6 +241,7 @@ function parseChList(text) {
 module.exports = {
   parseConnectedDevices,
   parseDodagRoute,
+  parseTopologySnapshot,
   expandedIPToCanonicalIP,
   canonicalIPtoExpandedIP,
   parseMacFilterList,
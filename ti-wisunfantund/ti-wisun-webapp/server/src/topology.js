@@ -1,6 +1,6 @@
-const {getPropDBUS, setPropDBUS} = require('./dbusCommands.js');
+const {getPropDBUS} = require('./dbusCommands.js');
 const {topologyLogger} = require('./logger.js');
-const {parseConnectedDevices, parseDodagRoute, canonicalIPtoExpandedIP} = require('./parsing.js');
+const {parseTopologySnapshot} = require('./parsing.js');
 const {getNetworkIPInfo, getTopology} = require('./ClientState.js');
 const {getPingExecutor} = require('./PingExecutor.js');
 const fetch = require('node-fetch');
@@ -76,34 +76,12 @@ async function getLatestTopology(ClientState) {
   }
 
   try {
-    let numConnected = 0;
-    let connectedDevicesSet = new Set();
+    // The daemon walks ConnectedDevices and the DodagRoute of every node
+    // in one pass and caches the result, so one read gives the whole tree
+    // instead of a dodagroutedest/dodagroute round trip per node.
+    const snapshot = parseTopologySnapshot(await getPropDBUS('Network:Topology:AsValMap'));
+    let numConnected = snapshot.devices.length;
     let rssiValues = new Map();
-    let fetchedAllDevices = false;
-    const MAX_ITERATIONS = 100;
-    let iterations = 0;
-    while (!fetchedAllDevices && iterations < MAX_ITERATIONS) {
-      // the DBUS connecteddevices property is a paginated version of the network's connected devices
-      // Ideally, the numconnected DBUS property would be a good way to check
-      // the number of pages. (at the time of writing numconnected gives no useful output)
-      // The hacky way that is being done here is to keep going until we see an address we have seen before
-      const [numInBatch, connectedDevicesBatch] = parseConnectedDevices(
-        await getPropDBUS('connecteddevices')
-      );
-      if (connectedDevicesBatch.length === 0) {
-        fetchedAllDevices = true;
-      }
-
-      for (const connectedDevice of connectedDevicesBatch) {
-        if (connectedDevicesSet.has(connectedDevice)) {
-          fetchedAllDevices = true;
-        } else {
-          numConnected += 1;
-          connectedDevicesSet.add(connectedDevice);
-        }
-      }
-      iterations++;
-    }
 
     // Get mockDevices
     let mockDevices;
@@ -121,7 +99,7 @@ async function getLatestTopology(ClientState) {
       connectedDevices = mockDevices;
       numConnected = mockDevices.length;
     } else {
-      connectedDevices = Array.from(connectedDevicesSet).sort();
+      connectedDevices = snapshot.devices;
     }
 
     // connectedDevices.push(borderRouterIPInfo.ip);
@@ -148,11 +126,9 @@ async function getLatestTopology(ClientState) {
         rssiValues[deviceIP] = [254, 254];
       });
     } else {
-      for (const ipAddr of connectedDevices) {
-        await setPropDBUS('dodagroutedest', canonicalIPtoExpandedIP(ipAddr));
-        const route = parseDodagRoute(await getPropDBUS('dodagroute'));
-        routes.push(route);
+      routes.push(...snapshot.routes);
 
+      for (const ipAddr of connectedDevices) {
         // Fetch the RSSI values with a coap request
         getRSSIValues(ipAddr);
 